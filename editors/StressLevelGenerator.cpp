@@ -0,0 +1,679 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+/*
+ * Writes synthetic stress levels by scaling up a shipped level.
+ *
+ * Run from the directory that contains "levels":
+ *
+ *   stressLevelGenerator [-base 001] [-first 101] [-count 6] [-factor 2]
+ *                        [-dimensions all]
+ *
+ * Level first + i is the base level scaled by factor^i along each
+ * dimension in the comma-separated -dimensions list:
+ *
+ *   enemies      numberOfEnemies
+ *   pieces       numberOfSculpturePieces
+ *   bullets      enemy and boss bullets per second, and
+ *                maxShipBulletsOnScreen
+ *   grid         world area (gridSizeX and gridSizeY by the square root)
+ *   vertices     triangle and border vertices of every object shape,
+ *                by subdividing triangles and border edges
+ *   reflections  the rotated copies of every object shape
+ *
+ * The scale is also written to a "stressScale" file, which
+ * TranscendHeadless -stressSweep uses as the x axis of its plot.  A level
+ * directory that already exists is only written over if it has a
+ * stressScale file, so that shipped levels are never replaced.
+ *
+ * Levels past the last shipped level are never reached in play, so
+ * generated levels are only loaded when asked for by number.
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+#include "minorGems/io/file/File.h"
+#include "minorGems/math/geometry/Vector3D.h"
+#include "minorGems/graphics/Color.h"
+#include "minorGems/util/SimpleVector.h"
+#include "minorGems/util/stringUtils.h"
+
+
+#include "Transcend/game/LevelDirectoryManager.h"
+#include "Transcend/game/ObjectParameterSpaceControlPoint.h"
+
+
+
+// the files of the level directory that hold object shape spaces
+// (read by ParameterizedObject)
+char *objectSpaceFileNames[] = {
+    "ship",
+    "firstSculpturePiece",
+    "secondSculpturePiece",
+    "portal",
+    "enemyShapeClose",
+    "enemyShapeFar",
+    "enemyExplosionShape",
+    "bossShapeClose",
+    "bossShapeFar",
+    "bossExplosionShape",
+    "shipBulletClose",
+    "shipBulletFar",
+    "enemyBulletClose",
+    "enemyBulletFar",
+    "bossBulletClose",
+    "bossBulletFar",
+    "bossDamageClose",
+    "bossDamageFar" };
+
+int numObjectSpaceFiles =
+    sizeof( objectSpaceFileNames ) / sizeof( char * );
+
+
+
+/**
+ * Copies a directory and everything in it.
+ *
+ * @param inFrom the directory to copy.
+ *   Must be destroyed by caller.
+ * @param inTo the directory to copy into, which is created if needed.
+ *   Must be destroyed by caller.
+ *
+ * @return true on success.
+ */
+static char copyDirectory( File *inFrom, File *inTo ) {
+    if( ! inTo->exists() ) {
+        inTo->makeDirectory();
+        }
+
+    int numChildren;
+    File **children = inFrom->getChildFiles( &numChildren );
+
+    if( children == NULL ) {
+        return false;
+        }
+
+    char success = true;
+
+    for( int i=0; i<numChildren; i++ ) {
+        char *name = children[i]->getFileName();
+        File *target = inTo->getChildFile( name );
+        delete [] name;
+
+        if( children[i]->isDirectory() ) {
+            if( ! copyDirectory( children[i], target ) ) {
+                success = false;
+                }
+            }
+        else {
+            char *contents = children[i]->readFileContents();
+
+            if( contents == NULL || ! target->writeToFile( contents ) ) {
+                success = false;
+                }
+            if( contents != NULL ) {
+                delete [] contents;
+                }
+            }
+
+        delete target;
+        delete children[i];
+        }
+    delete [] children;
+
+    return success;
+    }
+
+
+
+/**
+ * Reads a number from a file.
+ *
+ * @param inDirectory the directory containing the file.
+ *   Must be destroyed by caller.
+ * @param inFileName the name of the file.
+ *   Must be destroyed by caller.
+ * @param outValue pointer to where the number should be returned.
+ *
+ * @return true if the number was read.
+ */
+static char readNumber( File *inDirectory, char *inFileName,
+                        double *outValue ) {
+
+    File *file = inDirectory->getChildFile( inFileName );
+
+    char success = false;
+
+    if( file->exists() ) {
+        char *contents = file->readFileContents();
+
+        if( contents != NULL ) {
+            success = ( sscanf( contents, "%lf", outValue ) == 1 );
+            delete [] contents;
+            }
+        }
+
+    delete file;
+
+    return success;
+    }
+
+
+
+/**
+ * Writes a number to a file, replacing its contents.
+ *
+ * @param inDirectory the directory containing the file.
+ *   Must be destroyed by caller.
+ * @param inFileName the name of the file.
+ *   Must be destroyed by caller.
+ * @param inValue the number.
+ * @param inInteger true to write the number as an integer.
+ *
+ * @return true on success.
+ */
+static char writeNumber( File *inDirectory, char *inFileName,
+                         double inValue, char inInteger ) {
+
+    char contents[64];
+
+    if( inInteger ) {
+        sprintf( contents, "%d", (int)rint( inValue ) );
+        }
+    else {
+        sprintf( contents, "%f", inValue );
+        }
+
+    File *file = inDirectory->getChildFile( inFileName );
+
+    char success = file->writeToFile( contents );
+
+    delete file;
+
+    return success;
+    }
+
+
+
+/**
+ * Multiplies a number in a level file, if the file exists.
+ *
+ * @param inFromDirectory the base level.
+ *   Must be destroyed by caller.
+ * @param inToDirectory the level being generated.
+ *   Must be destroyed by caller.
+ * @param inFileName the name of the file.
+ *   Must be destroyed by caller.
+ * @param inScale the factor to multiply by.
+ * @param inInteger true if the number must be a whole number of at
+ *   least 1.
+ */
+static void scaleNumber( File *inFromDirectory, File *inToDirectory,
+                         char *inFileName, double inScale,
+                         char inInteger ) {
+    double value;
+
+    if( ! readNumber( inFromDirectory, inFileName, &value ) ) {
+        return;
+        }
+
+    value *= inScale;
+
+    if( inInteger && value < 1 ) {
+        value = 1;
+        }
+
+    writeNumber( inToDirectory, inFileName, value, inInteger );
+    }
+
+
+
+/**
+ * Gets the point halfway between two vertices.
+ *
+ * @param inA, inB the vertices.
+ *   Must be destroyed by caller.
+ *
+ * @return the midpoint.
+ *   Must be destroyed by caller.
+ */
+static Vector3D *getMidpoint( Vector3D *inA, Vector3D *inB ) {
+    return new Vector3D( ( inA->mX + inB->mX ) / 2,
+                         ( inA->mY + inB->mY ) / 2,
+                         ( inA->mZ + inB->mZ ) / 2 );
+    }
+
+
+
+/**
+ * Splits each triangle of a control point into four and each border
+ * edge into two, leaving the shape and coloring unchanged.
+ *
+ * @param inPoint the control point.
+ *   Must be destroyed by caller.
+ *
+ * @return the subdivided point.
+ *   Must be destroyed by caller.
+ */
+static ObjectParameterSpaceControlPoint *subdivide(
+    ObjectParameterSpaceControlPoint *inPoint ) {
+
+    int numTriangleVertices = inPoint->mNumTriangleVertices * 4;
+
+    Vector3D **triangleVertices = new Vector3D*[ numTriangleVertices ];
+    Color **triangleColors = new Color*[ numTriangleVertices ];
+
+    int v = 0;
+    for( int t=0; t<inPoint->mNumTriangleVertices; t+=3 ) {
+        Vector3D **corners = &( inPoint->mTriangleVertices[t] );
+        Color **cornerColors = &( inPoint->mTriangleVertexFillColors[t] );
+
+        Vector3D *midpoints[3];
+        Color *midpointColors[3];
+
+        for( int c=0; c<3; c++ ) {
+            int next = ( c + 1 ) % 3;
+
+            midpoints[c] = getMidpoint( corners[c], corners[next] );
+            midpointColors[c] = Color::linearSum( cornerColors[c],
+                                                  cornerColors[next], 0.5 );
+            }
+
+        // a triangle at each corner
+        for( int c=0; c<3; c++ ) {
+            int previous = ( c + 2 ) % 3;
+
+            triangleVertices[v] = new Vector3D( corners[c] );
+            triangleColors[v] = cornerColors[c]->copy();
+            v++;
+            triangleVertices[v] = new Vector3D( midpoints[c] );
+            triangleColors[v] = midpointColors[c]->copy();
+            v++;
+            triangleVertices[v] = new Vector3D( midpoints[previous] );
+            triangleColors[v] = midpointColors[previous]->copy();
+            v++;
+            }
+
+        // and one in the middle
+        for( int c=0; c<3; c++ ) {
+            triangleVertices[v] = midpoints[c];
+            triangleColors[v] = midpointColors[c];
+            v++;
+            }
+        }
+
+
+    int numBorderVertices = inPoint->mNumBorderVertices * 2;
+
+    Vector3D **borderVertices = new Vector3D*[ numBorderVertices ];
+    Color **borderColors = new Color*[ numBorderVertices ];
+
+    // the border is drawn as a closed loop
+    for( int b=0; b<inPoint->mNumBorderVertices; b++ ) {
+        int next = ( b + 1 ) % inPoint->mNumBorderVertices;
+
+        Vector3D *vertex = inPoint->mBorderVertices[b];
+        Color *color = inPoint->mBorderVertexColors[b];
+
+        borderVertices[ 2 * b ] = new Vector3D( vertex );
+        borderColors[ 2 * b ] = color->copy();
+
+        borderVertices[ 2 * b + 1 ] =
+            getMidpoint( vertex, inPoint->mBorderVertices[next] );
+        borderColors[ 2 * b + 1 ] =
+            Color::linearSum( color, inPoint->mBorderVertexColors[next],
+                              0.5 );
+        }
+
+    return new ObjectParameterSpaceControlPoint(
+        numTriangleVertices, triangleVertices, triangleColors,
+        numBorderVertices, borderVertices, borderColors,
+        inPoint->mBorderWidth,
+        inPoint->mNumRotatedCopies,
+        inPoint->mRotatedCopyScaleFactor,
+        inPoint->mRotatedCopyAngleScaleFactor,
+        inPoint->mRotationRate );
+    }
+
+
+
+/**
+ * Rewrites an object space file with more vertices or rotated copies.
+ *
+ * @param inFromDirectory the base level.
+ *   Must be destroyed by caller.
+ * @param inToDirectory the level being generated.
+ *   Must be destroyed by caller.
+ * @param inFileName the name of the file.
+ *   Must be destroyed by caller.
+ * @param inNumSubdivisions the number of times to subdivide each
+ *   control point.
+ * @param inReflectionScale the factor to multiply the number of rotated
+ *   copies by.
+ *
+ * @return true on success, or if the file does not exist in the base
+ *   level.
+ */
+static char scaleObjectSpace( File *inFromDirectory, File *inToDirectory,
+                              char *inFileName, int inNumSubdivisions,
+                              double inReflectionScale ) {
+
+    File *fromFile = inFromDirectory->getChildFile( inFileName );
+
+    if( ! fromFile->exists() ) {
+        delete fromFile;
+        return true;
+        }
+
+    char *fromName = fromFile->getFullFileName();
+    delete fromFile;
+
+    FILE *fromFILE = fopen( fromName, "r" );
+    delete [] fromName;
+
+    if( fromFILE == NULL ) {
+        return false;
+        }
+
+
+    // same format as ParameterizedObject reads:  anchors and control
+    // points until no more can be read
+    SimpleVector<double> *anchors = new SimpleVector<double>();
+    SimpleVector<ObjectParameterSpaceControlPoint *> *points =
+        new SimpleVector<ObjectParameterSpaceControlPoint *>();
+
+    char readError = false;
+
+    while( !readError ) {
+        double anchor;
+
+        if( fscanf( fromFILE, "%lf", &anchor ) != 1 ) {
+            readError = true;
+            }
+        else {
+            ObjectParameterSpaceControlPoint *point =
+                new ObjectParameterSpaceControlPoint( fromFILE, &readError );
+
+            if( !readError ) {
+                anchors->push_back( anchor );
+                points->push_back( point );
+                }
+            else {
+                delete point;
+                }
+            }
+        }
+
+    fclose( fromFILE );
+
+
+    File *toFile = inToDirectory->getChildFile( inFileName );
+    char *toName = toFile->getFullFileName();
+    delete toFile;
+
+    FILE *toFILE = fopen( toName, "w" );
+    delete [] toName;
+
+    char success = ( toFILE != NULL );
+
+    int numPoints = points->size();
+    for( int p=0; p<numPoints; p++ ) {
+        ObjectParameterSpaceControlPoint *point =
+            *( points->getElement( p ) );
+
+        for( int s=0; s<inNumSubdivisions; s++ ) {
+            ObjectParameterSpaceControlPoint *subdivided =
+                subdivide( point );
+            delete point;
+            point = subdivided;
+            }
+
+        point->mNumRotatedCopies *= inReflectionScale;
+
+        if( toFILE != NULL ) {
+            fprintf( toFILE, "%f\n\n", *( anchors->getElement( p ) ) );
+            point->writeToFile( toFILE );
+            fprintf( toFILE, "\n\n" );
+            }
+
+        delete point;
+        }
+
+    if( toFILE != NULL ) {
+        fclose( toFILE );
+        }
+
+    delete anchors;
+    delete points;
+
+    return success;
+    }
+
+
+
+/**
+ * Writes one stress level.
+ *
+ * @param inBaseDirectory the level to scale.
+ *   Must be destroyed by caller.
+ * @param inLevelDirectory the level to write.
+ *   Must be destroyed by caller.
+ * @param inScale the factor to scale by.
+ * @param inDimensions the comma-separated dimensions to scale along,
+ *   or "all".
+ *   Must be destroyed by caller.
+ *
+ * @return true on success.
+ */
+static char generateLevel( File *inBaseDirectory, File *inLevelDirectory,
+                           double inScale, char *inDimensions ) {
+
+    if( ! copyDirectory( inBaseDirectory, inLevelDirectory ) ) {
+        return false;
+        }
+
+    char all = ( strcmp( inDimensions, "all" ) == 0 );
+
+    if( all || strstr( inDimensions, "enemies" ) != NULL ) {
+        scaleNumber( inBaseDirectory, inLevelDirectory,
+                     "numberOfEnemies", inScale, true );
+        }
+
+    if( all || strstr( inDimensions, "pieces" ) != NULL ) {
+        scaleNumber( inBaseDirectory, inLevelDirectory,
+                     "numberOfSculpturePieces", inScale, true );
+        }
+
+    if( all || strstr( inDimensions, "bullets" ) != NULL ) {
+        scaleNumber( inBaseDirectory, inLevelDirectory,
+                     "enemyBulletsPerSecond", inScale, false );
+        scaleNumber( inBaseDirectory, inLevelDirectory,
+                     "bossMinBulletsPerSecond", inScale, false );
+        scaleNumber( inBaseDirectory, inLevelDirectory,
+                     "bossMaxBulletsPerSecond", inScale, false );
+        scaleNumber( inBaseDirectory, inLevelDirectory,
+                     "maxShipBulletsOnScreen", inScale, true );
+        }
+
+    if( all || strstr( inDimensions, "grid" ) != NULL ) {
+        // scale the area, not the width
+        scaleNumber( inBaseDirectory, inLevelDirectory,
+                     "gridSizeX", sqrt( inScale ), true );
+        scaleNumber( inBaseDirectory, inLevelDirectory,
+                     "gridSizeY", sqrt( inScale ), true );
+        }
+
+    int numSubdivisions = 0;
+    double reflectionScale = 1;
+
+    if( all || strstr( inDimensions, "vertices" ) != NULL ) {
+        // each subdivision makes four times as many triangle vertices
+        numSubdivisions = (int)rint( log( inScale ) / log( 4.0 ) );
+
+        if( numSubdivisions < 0 ) {
+            numSubdivisions = 0;
+            }
+        }
+
+    if( all || strstr( inDimensions, "reflections" ) != NULL ) {
+        reflectionScale = inScale;
+        }
+
+    char success = true;
+
+    if( numSubdivisions > 0 || reflectionScale != 1 ) {
+
+        // control points read named colors from the base level
+        LevelDirectoryManager::setLevelDirectory( inBaseDirectory->copy() );
+
+        for( int i=0; i<numObjectSpaceFiles; i++ ) {
+            if( ! scaleObjectSpace( inBaseDirectory, inLevelDirectory,
+                                    objectSpaceFileNames[i],
+                                    numSubdivisions, reflectionScale ) ) {
+                printf( "Failed to scale %s\n", objectSpaceFileNames[i] );
+                success = false;
+                }
+            }
+        }
+
+    if( ! writeNumber( inLevelDirectory, "stressScale", inScale, false ) ) {
+        success = false;
+        }
+
+    return success;
+    }
+
+
+
+int main( int inNumArgs, char **inArgs ) {
+
+    char *baseLevelName = "001";
+    int firstLevel = 101;
+    int numLevels = 6;
+    double factor = 2;
+    char *dimensions = "all";
+
+    for( int a=1; a<inNumArgs; a++ ) {
+        if( strcmp( inArgs[a], "-base" ) == 0 && a + 1 < inNumArgs ) {
+            baseLevelName = inArgs[ a + 1 ];
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-first" ) == 0 && a + 1 < inNumArgs ) {
+            sscanf( inArgs[ a + 1 ], "%d", &firstLevel );
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-count" ) == 0 && a + 1 < inNumArgs ) {
+            sscanf( inArgs[ a + 1 ], "%d", &numLevels );
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-factor" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            sscanf( inArgs[ a + 1 ], "%lf", &factor );
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-dimensions" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            dimensions = inArgs[ a + 1 ];
+            a++;
+            }
+        else {
+            printf( "Usage:  %s [-base 001] [-first 101] [-count 6] "
+                    "[-factor 2] [-dimensions all]\n", inArgs[0] );
+            printf( "Dimensions:  enemies,pieces,bullets,grid,vertices,"
+                    "reflections\n" );
+            return 1;
+            }
+        }
+
+    if( firstLevel < 1 || firstLevel + numLevels - 1 > 999 ) {
+        printf( "Level numbers must be in [1,999]\n" );
+        return 1;
+        }
+
+
+    File *levelsDirectory = new File( NULL, "levels" );
+    File *baseDirectory = levelsDirectory->getChildFile( baseLevelName );
+
+    if( ! baseDirectory->exists() ) {
+        printf( "Base level levels/%s not found\n", baseLevelName );
+        delete baseDirectory;
+        delete levelsDirectory;
+        return 1;
+        }
+
+    // check every level before writing any, so that nothing is written
+    // if one of them would replace a level that we did not generate
+    char safe = true;
+
+    for( int i=0; i<numLevels; i++ ) {
+        char levelName[4];
+        sprintf( levelName, "%03d", firstLevel + i );
+
+        File *levelDirectory = levelsDirectory->getChildFile( levelName );
+
+        if( levelDirectory->exists() ) {
+            File *scaleFile = levelDirectory->getChildFile( "stressScale" );
+
+            if( ! scaleFile->exists() ) {
+                printf( "Error:  levels/%s exists and is not a stress "
+                        "level, not writing over it\n", levelName );
+                safe = false;
+                }
+            delete scaleFile;
+            }
+
+        delete levelDirectory;
+        }
+
+    if( !safe ) {
+        printf( "Use -first to pick unused level numbers\n" );
+
+        delete baseDirectory;
+        delete levelsDirectory;
+        return 1;
+        }
+
+    
+    char success = true;
+    double scale = 1;
+
+    for( int i=0; i<numLevels; i++ ) {
+        char levelName[4];
+        sprintf( levelName, "%03d", firstLevel + i );
+
+        File *levelDirectory = levelsDirectory->getChildFile( levelName );
+
+        printf( "Writing levels/%s (scale %g, %s)\n",
+                levelName, scale, dimensions );
+
+        if( ! generateLevel( baseDirectory, levelDirectory,
+                             scale, dimensions ) ) {
+            printf( "Failed to write levels/%s\n", levelName );
+            success = false;
+            }
+
+        delete levelDirectory;
+
+        scale *= factor;
+        }
+
+    delete baseDirectory;
+    delete levelsDirectory;
+
+    if( !success ) {
+        return 1;
+        }
+    return 0;
+    }
@@ -0,0 +1,630 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "AllocationProfiler.h"
+
+
+
+// nothing here is compiled unless the profiler is turned on, so that
+// the default operator new and delete are left alone
+#ifdef ALLOCATION_PROFILER
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+
+
+#ifdef WIN_32
+    #include <windows.h>
+
+    #define ALLOCATION_PROFILER_THREAD_LOCAL __declspec( thread )
+#else
+    #define ALLOCATION_PROFILER_THREAD_LOCAL __thread
+#endif
+
+
+// exception specifications of the replaced operators, which changed
+// in C++11
+#if __cplusplus >= 201103L
+    #define ALLOCATION_PROFILER_THROWS
+    #define ALLOCATION_PROFILER_NO_THROW noexcept
+#else
+    #define ALLOCATION_PROFILER_THROWS throw( std::bad_alloc )
+    #define ALLOCATION_PROFILER_NO_THROW throw()
+#endif
+
+
+
+// All state here is plain data, which is zero-initialized before any
+// static constructor runs, since static constructors in other files
+// may allocate before this file's constructors would have run.
+
+#define MAX_ALLOCATION_TAGS 64
+
+// tag 0 counts untagged allocations
+static AllocationTag sTags[ MAX_ALLOCATION_TAGS ];
+
+// only grows, and each tag is filled in before it is counted here
+static volatile long sNumTags = 1;
+
+// held while adding a tag
+static volatile long sTagLock = 0;
+
+static ALLOCATION_PROFILER_THREAD_LOCAL AllocationTag *sCurrentTag = NULL;
+
+static volatile char sEnabled = false;
+
+static volatile long sNumDeallocations = 0;
+static volatile long sLiveBytes = 0;
+
+// the rest are only touched by the thread that calls endFrame
+
+static long sLastNumDeallocations = 0;
+static long sPeakLiveBytes = 0;
+
+// false until the first call to endFrame
+static char sFrameStarted = false;
+
+static unsigned long sReportInterval = 0;
+static unsigned long sWindowNumFrames = 0;
+static unsigned long sRunNumFrames = 0;
+static unsigned long sRunDeallocations = 0;
+
+
+
+/**
+ * Atomically adds to a counter.
+ *
+ * @param inCounter the counter.
+ * @param inValue the value to add.
+ */
+static inline void atomicAdd( volatile long *inCounter, long inValue ) {
+    #ifdef WIN_32
+        InterlockedExchangeAdd( (volatile LONG *)inCounter, inValue );
+    #else
+        __sync_fetch_and_add( inCounter, inValue );
+    #endif
+    }
+
+
+
+/**
+ * Atomically reads a counter, with a memory barrier, so that anything
+ * written before the counter was last changed is visible afterward.
+ *
+ * @param inCounter the counter.
+ *
+ * @return the value of the counter.
+ */
+static inline long atomicGet( volatile long *inCounter ) {
+    #ifdef WIN_32
+        return InterlockedExchangeAdd( (volatile LONG *)inCounter, 0 );
+    #else
+        return __sync_fetch_and_add( inCounter, 0 );
+    #endif
+    }
+
+
+
+/**
+ * Atomically sets a flag.
+ *
+ * @param inFlag the flag.
+ *
+ * @return the previous value of the flag.
+ */
+static inline long atomicSet( volatile long *inFlag ) {
+    #ifdef WIN_32
+        return InterlockedExchange( (volatile LONG *)inFlag, 1 );
+    #else
+        return __sync_lock_test_and_set( inFlag, 1 );
+    #endif
+    }
+
+
+
+/**
+ * Atomically clears a flag set with atomicSet.
+ *
+ * @param inFlag the flag.
+ */
+static inline void atomicClear( volatile long *inFlag ) {
+    #ifdef WIN_32
+        InterlockedExchange( (volatile LONG *)inFlag, 0 );
+    #else
+        __sync_lock_release( inFlag );
+    #endif
+    }
+
+
+
+// Each block is preceded by a header holding its size, so that
+// operator delete can count the bytes freed.  16 bytes keeps the
+// block as aligned as malloc made it.
+#define ALLOCATION_HEADER_SIZE 16
+
+
+
+/**
+ * Allocates a counted block.
+ *
+ * @param inNumBytes the size of the block.
+ *
+ * @return the block, or NULL if malloc failed.
+ */
+static void *allocateBlock( size_t inNumBytes ) {
+    if( inNumBytes == 0 ) {
+        inNumBytes = 1;
+        }
+
+    char *header = (char *)malloc( inNumBytes + ALLOCATION_HEADER_SIZE );
+
+    if( header == NULL ) {
+        return NULL;
+        }
+
+    *( (size_t *)header ) = inNumBytes;
+
+    AllocationProfiler::addAllocation( inNumBytes );
+
+    return (void *)( header + ALLOCATION_HEADER_SIZE );
+    }
+
+
+
+/**
+ * Frees a block returned by allocateBlock.
+ *
+ * @param inBlock the block, or NULL.
+ */
+static void freeBlock( void *inBlock ) {
+    if( inBlock == NULL ) {
+        return;
+        }
+
+    char *header = (char *)inBlock - ALLOCATION_HEADER_SIZE;
+
+    AllocationProfiler::addDeallocation( *( (size_t *)header ) );
+
+    free( header );
+    }
+
+
+
+void *operator new( size_t inNumBytes ) ALLOCATION_PROFILER_THROWS {
+    void *block = allocateBlock( inNumBytes );
+
+    if( block == NULL ) {
+        throw std::bad_alloc();
+        }
+    return block;
+    }
+
+
+
+void *operator new[]( size_t inNumBytes ) ALLOCATION_PROFILER_THROWS {
+    void *block = allocateBlock( inNumBytes );
+
+    if( block == NULL ) {
+        throw std::bad_alloc();
+        }
+    return block;
+    }
+
+
+
+// the library's nothrow versions may not call the versions above, and
+// their blocks must have headers too
+
+void *operator new( size_t inNumBytes, const std::nothrow_t & )
+    ALLOCATION_PROFILER_NO_THROW {
+    return allocateBlock( inNumBytes );
+    }
+
+
+
+void *operator new[]( size_t inNumBytes, const std::nothrow_t & )
+    ALLOCATION_PROFILER_NO_THROW {
+    return allocateBlock( inNumBytes );
+    }
+
+
+
+void operator delete( void *inBlock ) ALLOCATION_PROFILER_NO_THROW {
+    freeBlock( inBlock );
+    }
+
+
+
+void operator delete[]( void *inBlock ) ALLOCATION_PROFILER_NO_THROW {
+    freeBlock( inBlock );
+    }
+
+
+
+void operator delete( void *inBlock, const std::nothrow_t & )
+    ALLOCATION_PROFILER_NO_THROW {
+    freeBlock( inBlock );
+    }
+
+
+
+void operator delete[]( void *inBlock, const std::nothrow_t & )
+    ALLOCATION_PROFILER_NO_THROW {
+    freeBlock( inBlock );
+    }
+
+
+
+void AllocationProfiler::setEnabled( char inEnabled ) {
+    sEnabled = inEnabled;
+    }
+
+
+
+char AllocationProfiler::isEnabled() {
+    return sEnabled;
+    }
+
+
+
+void AllocationProfiler::setReportInterval( unsigned long inNumFrames ) {
+    sReportInterval = inNumFrames;
+    }
+
+
+
+AllocationTag *AllocationProfiler::getTag( char *inName ) {
+    // tags are never removed, and each is filled in before it is
+    // counted, so existing ones can be searched without the lock
+    int numTags = atomicGet( &sNumTags );
+
+    for( int i=1; i<numTags; i++ ) {
+        if( strncmp( sTags[i].mName, inName,
+                     sizeof( sTags[i].mName ) - 1 ) == 0 ) {
+            return &( sTags[i] );
+            }
+        }
+
+    while( atomicSet( &sTagLock ) ) {
+        // spin, since adding a tag is quick and happens rarely
+        }
+
+    AllocationTag *tag = NULL;
+
+    // another thread may have added it since we searched
+    numTags = atomicGet( &sNumTags );
+
+    for( int i=1; i<numTags && tag == NULL; i++ ) {
+        if( strncmp( sTags[i].mName, inName,
+                     sizeof( sTags[i].mName ) - 1 ) == 0 ) {
+            tag = &( sTags[i] );
+            }
+        }
+
+    if( tag == NULL && numTags < MAX_ALLOCATION_TAGS ) {
+        tag = &( sTags[ numTags ] );
+        strncpy( tag->mName, inName, sizeof( tag->mName ) - 1 );
+
+        // counts the tag only after its name is visible
+        atomicAdd( &sNumTags, 1 );
+        }
+
+    atomicClear( &sTagLock );
+
+    return tag;
+    }
+
+
+
+AllocationTag *AllocationProfiler::getCurrentTag() {
+    return sCurrentTag;
+    }
+
+
+
+void AllocationProfiler::setCurrentTag( AllocationTag *inTag ) {
+    sCurrentTag = inTag;
+    }
+
+
+
+void AllocationProfiler::addAllocation( unsigned long inNumBytes ) {
+    if( ! sEnabled ) {
+        return;
+        }
+
+    AllocationTag *tag = sCurrentTag;
+
+    if( tag == NULL ) {
+        tag = &( sTags[0] );
+        }
+
+    atomicAdd( &( tag->mNumAllocations ), 1 );
+    atomicAdd( &( tag->mNumBytes ), (long)inNumBytes );
+    atomicAdd( &sLiveBytes, (long)inNumBytes );
+    }
+
+
+
+void AllocationProfiler::addDeallocation( unsigned long inNumBytes ) {
+    if( ! sEnabled ) {
+        return;
+        }
+
+    atomicAdd( &sNumDeallocations, 1 );
+    atomicAdd( &sLiveBytes, - (long)inNumBytes );
+    }
+
+
+
+void AllocationProfiler::getTotals( unsigned long *outNumAllocations,
+                                    unsigned long *outNumBytes ) {
+
+    unsigned long numAllocations = 0;
+    unsigned long numBytes = 0;
+
+    int numTags = atomicGet( &sNumTags );
+
+    for( int i=0; i<numTags; i++ ) {
+        numAllocations +=
+            (unsigned long)atomicGet( &( sTags[i].mNumAllocations ) );
+        numBytes += (unsigned long)atomicGet( &( sTags[i].mNumBytes ) );
+        }
+
+    *outNumAllocations = numAllocations;
+    *outNumBytes = numBytes;
+    }
+
+
+
+void AllocationProfiler::endFrame() {
+    if( ! sEnabled ) {
+        return;
+        }
+
+    int numTags = atomicGet( &sNumTags );
+
+    for( int i=0; i<numTags; i++ ) {
+        AllocationTag *tag = &( sTags[i] );
+
+        long numAllocations = atomicGet( &( tag->mNumAllocations ) );
+        long numBytes = atomicGet( &( tag->mNumBytes ) );
+
+        unsigned long frameAllocations =
+            (unsigned long)( numAllocations - tag->mLastNumAllocations );
+        unsigned long frameBytes =
+            (unsigned long)( numBytes - tag->mLastNumBytes );
+
+        tag->mLastNumAllocations = numAllocations;
+        tag->mLastNumBytes = numBytes;
+
+        if( ! sFrameStarted ) {
+            // everything allocated before the first frame, which would
+            // include startup
+            continue;
+            }
+
+        tag->mWindowAllocations += frameAllocations;
+        tag->mWindowBytes += frameBytes;
+        tag->mRunAllocations += frameAllocations;
+        tag->mRunBytes += frameBytes;
+
+        if( frameAllocations > tag->mWindowMaxFrameAllocations ) {
+            tag->mWindowMaxFrameAllocations = frameAllocations;
+            }
+        if( frameBytes > tag->mWindowMaxFrameBytes ) {
+            tag->mWindowMaxFrameBytes = frameBytes;
+            }
+        if( frameAllocations > tag->mRunMaxFrameAllocations ) {
+            tag->mRunMaxFrameAllocations = frameAllocations;
+            }
+        if( frameBytes > tag->mRunMaxFrameBytes ) {
+            tag->mRunMaxFrameBytes = frameBytes;
+            }
+        }
+
+    long numDeallocations = atomicGet( &sNumDeallocations );
+
+    if( sFrameStarted ) {
+        sRunDeallocations +=
+            (unsigned long)( numDeallocations - sLastNumDeallocations );
+        }
+    sLastNumDeallocations = numDeallocations;
+
+    long liveBytes = atomicGet( &sLiveBytes );
+    if( liveBytes > sPeakLiveBytes ) {
+        sPeakLiveBytes = liveBytes;
+        }
+
+    if( ! sFrameStarted ) {
+        // the first call only starts the first frame
+        sFrameStarted = true;
+        return;
+        }
+
+    sWindowNumFrames++;
+    sRunNumFrames++;
+
+    if( sReportInterval > 0 && sWindowNumFrames >= sReportInterval ) {
+
+        printTable( "Top allocators over the last", true,
+                    sWindowNumFrames, 8 );
+
+        for( int i=0; i<numTags; i++ ) {
+            AllocationTag *tag = &( sTags[i] );
+
+            tag->mWindowAllocations = 0;
+            tag->mWindowBytes = 0;
+            tag->mWindowMaxFrameAllocations = 0;
+            tag->mWindowMaxFrameBytes = 0;
+            }
+        sWindowNumFrames = 0;
+        }
+    }
+
+
+
+// the tags and the stats to sort them by, for printTable
+static char sSortByWindow;
+
+// for qsort, largest byte count first
+static int compareTags( const void *inA, const void *inB ) {
+    AllocationTag *a = *( (AllocationTag **)inA );
+    AllocationTag *b = *( (AllocationTag **)inB );
+
+    unsigned long aBytes = sSortByWindow ? a->mWindowBytes : a->mRunBytes;
+    unsigned long bBytes = sSortByWindow ? b->mWindowBytes : b->mRunBytes;
+
+    if( aBytes > bBytes ) {
+        return -1;
+        }
+    else if( aBytes < bBytes ) {
+        return 1;
+        }
+    else {
+        return 0;
+        }
+    }
+
+
+
+void AllocationProfiler::printTable( char *inTitle, char inWindow,
+                                     unsigned long inNumFrames,
+                                     int inMaxTags ) {
+
+    printf( "%s %lu frames (live %.1f KiB, peak %.1f KiB):\n",
+            inTitle, inNumFrames,
+            atomicGet( &sLiveBytes ) / 1024.0, sPeakLiveBytes / 1024.0 );
+
+    if( inNumFrames == 0 ) {
+        return;
+        }
+
+    printf( "    %-20s %12s %10s %14s %12s\n",
+            "tag", "allocs/frame", "max", "bytes/frame", "max" );
+
+    int numTags = atomicGet( &sNumTags );
+
+    AllocationTag *sorted[ MAX_ALLOCATION_TAGS ];
+    for( int i=0; i<numTags; i++ ) {
+        sorted[i] = &( sTags[i] );
+        }
+
+    sSortByWindow = inWindow;
+    qsort( sorted, numTags, sizeof( AllocationTag * ), compareTags );
+
+    unsigned long totalAllocations = 0;
+    unsigned long totalBytes = 0;
+
+    for( int i=0; i<numTags; i++ ) {
+        AllocationTag *tag = sorted[i];
+
+        unsigned long allocations, bytes, maxAllocations, maxBytes;
+
+        if( inWindow ) {
+            allocations = tag->mWindowAllocations;
+            bytes = tag->mWindowBytes;
+            maxAllocations = tag->mWindowMaxFrameAllocations;
+            maxBytes = tag->mWindowMaxFrameBytes;
+            }
+        else {
+            allocations = tag->mRunAllocations;
+            bytes = tag->mRunBytes;
+            maxAllocations = tag->mRunMaxFrameAllocations;
+            maxBytes = tag->mRunMaxFrameBytes;
+            }
+
+        totalAllocations += allocations;
+        totalBytes += bytes;
+
+        if( i >= inMaxTags || allocations == 0 ) {
+            continue;
+            }
+
+        char *name = tag->mName;
+        if( name[0] == '\0' ) {
+            name = "untagged";
+            }
+
+        printf( "    %-20.20s %12.1f %10lu %14.1f %12lu\n",
+                name,
+                (double)allocations / inNumFrames, maxAllocations,
+                (double)bytes / inNumFrames, maxBytes );
+        }
+
+    printf( "    %-20s %12.1f %10s %14.1f\n",
+            "total",
+            (double)totalAllocations / inNumFrames, "",
+            (double)totalBytes / inNumFrames );
+    }
+
+
+
+void AllocationProfiler::printSummary() {
+    printTable( "Allocations per frame over", false, sRunNumFrames,
+                MAX_ALLOCATION_TAGS );
+
+    if( sRunNumFrames > 0 ) {
+        printf( "    %-20s %12.1f\n",
+                "frees",
+                (double)sRunDeallocations / sRunNumFrames );
+        }
+    }
+
+
+
+char AllocationProfiler::checkBudget( unsigned long inMaxAllocationsPerFrame,
+                                      unsigned long inMaxBytesPerFrame ) {
+
+    if( sRunNumFrames == 0 ) {
+        return true;
+        }
+
+    unsigned long totalAllocations = 0;
+    unsigned long totalBytes = 0;
+
+    int numTags = atomicGet( &sNumTags );
+    for( int i=0; i<numTags; i++ ) {
+        totalAllocations += sTags[i].mRunAllocations;
+        totalBytes += sTags[i].mRunBytes;
+        }
+
+    double allocationsPerFrame = (double)totalAllocations / sRunNumFrames;
+    double bytesPerFrame = (double)totalBytes / sRunNumFrames;
+
+    char withinBudget = true;
+
+    if( inMaxAllocationsPerFrame > 0 &&
+        allocationsPerFrame > inMaxAllocationsPerFrame ) {
+
+        printf( "Error:  %.1f allocations per frame, "
+                "over the budget of %lu\n",
+                allocationsPerFrame, inMaxAllocationsPerFrame );
+        withinBudget = false;
+        }
+
+    if( inMaxBytesPerFrame > 0 &&
+        bytesPerFrame > inMaxBytesPerFrame ) {
+
+        printf( "Error:  %.1f bytes allocated per frame, "
+                "over the budget of %lu\n",
+                bytesPerFrame, inMaxBytesPerFrame );
+        withinBudget = false;
+        }
+
+    return withinBudget;
+    }
+
+
+
+#endif
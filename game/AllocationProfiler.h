@@ -0,0 +1,305 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef ALLOCATION_PROFILER_INCLUDED
+#define ALLOCATION_PROFILER_INCLUDED
+
+
+
+#include <stddef.h>
+
+
+
+/*
+ * The allocation profiler replaces the global operator new and delete,
+ * so it is only compiled in when ALLOCATION_PROFILER is defined (see
+ * ALLOCATION_PROFILER_FLAG in Makefile.common).  Otherwise, the macros
+ * below expand to nothing and the rest of this header goes unused.
+ *
+ * Allocations are counted against the innermost tag opened on the
+ * allocating thread, or against "untagged" if none is open.
+ *
+ * Example:
+ *
+ *   void passTime() {
+ *       ALLOCATION_PROFILER_TAG( "enemies" );
+ *       ...
+ *       }
+ */
+#ifdef ALLOCATION_PROFILER
+
+    // two levels, so that __LINE__ is expanded before it is pasted
+    #define ALLOCATION_PROFILER_CONCAT_INNER( inA, inB ) inA##inB
+    #define ALLOCATION_PROFILER_CONCAT( inA, inB ) \
+        ALLOCATION_PROFILER_CONCAT_INNER( inA, inB )
+
+    // counts allocations in the rest of the enclosing block against a tag
+    #define ALLOCATION_PROFILER_TAG( inName ) \
+        AllocationTagScope ALLOCATION_PROFILER_CONCAT( allocationTagScope, \
+                                                       __LINE__ )( inName )
+
+#else
+
+    #define ALLOCATION_PROFILER_TAG( inName )
+
+#endif
+
+
+
+/**
+ * The allocation counts of one tag.
+ *
+ * Has no constructor, so that the tags can be zero-initialized before
+ * any static constructor allocates.
+ *
+ * @author Jason Rohrer.
+ */
+class AllocationTag {
+
+    public:
+
+        // empty for the untagged tag, and copied rather than pointed to
+        // so that adding a tag never allocates
+        char mName[ 32 ];
+
+        // totals since the program started, updated atomically by every
+        // thread that allocates under this tag
+        volatile long mNumAllocations;
+        volatile long mNumBytes;
+
+        // the rest are only touched by the thread that calls endFrame
+
+        // the totals at the end of the last frame
+        long mLastNumAllocations;
+        long mLastNumBytes;
+
+        // since the last report
+        unsigned long mWindowAllocations;
+        unsigned long mWindowBytes;
+        unsigned long mWindowMaxFrameAllocations;
+        unsigned long mWindowMaxFrameBytes;
+
+        // since counting was enabled
+        unsigned long mRunAllocations;
+        unsigned long mRunBytes;
+        unsigned long mRunMaxFrameAllocations;
+        unsigned long mRunMaxFrameBytes;
+    };
+
+
+
+/**
+ * A class with static functions for counting heap allocations per frame
+ * and per tag.
+ *
+ * Tags are normally opened with the ALLOCATION_PROFILER_TAG macro.
+ *
+ * Tag functions are thread-safe.  The other functions must all be called
+ * from the same thread, normally the main thread.
+ *
+ * @author Jason Rohrer.
+ */
+class AllocationProfiler {
+
+
+    public:
+
+
+
+        /**
+         * Sets whether allocations are counted.  Defaults to false.
+         *
+         * @param inEnabled true to count allocations.
+         */
+        static void setEnabled( char inEnabled );
+
+
+
+        /**
+         * Gets whether allocations are counted.
+         *
+         * @return true if enabled.
+         */
+        static char isEnabled();
+
+
+
+        /**
+         * Sets how often the top allocators are printed by endFrame.
+         *
+         * @param inNumFrames the number of frames between reports, or 0
+         *   to never print them.  Defaults to 0.
+         */
+        static void setReportInterval( unsigned long inNumFrames );
+
+
+
+        /**
+         * Gets a tag, adding it if this is the first use of its name.
+         *
+         * @param inName the name of the tag.  Only the first 31
+         *   characters are used.
+         *   Must be destroyed by caller.
+         *
+         * @return the tag, or NULL if there is no room for more tags.
+         *   Will be destroyed by this class.
+         */
+        static AllocationTag *getTag( char *inName );
+
+
+
+        /**
+         * Gets the innermost tag open on the calling thread.
+         *
+         * @return the tag, or NULL if none is open.
+         *   Will be destroyed by this class.
+         */
+        static AllocationTag *getCurrentTag();
+
+
+
+        /**
+         * Sets the innermost tag open on the calling thread.
+         *
+         * @param inTag the tag, or NULL for none.
+         *   Will be destroyed by this class.
+         */
+        static void setCurrentTag( AllocationTag *inTag );
+
+
+
+        /**
+         * Counts one allocation against the calling thread's tag.
+         *
+         * Called by operator new.
+         *
+         * @param inNumBytes the size of the allocation.
+         */
+        static void addAllocation( unsigned long inNumBytes );
+
+
+
+        /**
+         * Counts one deallocation.
+         *
+         * Called by operator delete.
+         *
+         * @param inNumBytes the size of the allocation being freed.
+         */
+        static void addDeallocation( unsigned long inNumBytes );
+
+
+
+        /**
+         * Gets the allocations counted across all tags since counting was
+         * first enabled.
+         *
+         * Thread-safe.
+         *
+         * @param outNumAllocations, outNumBytes pointers to where the
+         *   number of allocations and their total size should be returned.
+         */
+        static void getTotals( unsigned long *outNumAllocations,
+                               unsigned long *outNumBytes );
+
+
+
+        /**
+         * Ends the current frame, adding the allocations made during it
+         * to the stats, and printing a report if one is due.
+         */
+        static void endFrame();
+
+
+
+        /**
+         * Prints the allocations per frame of each tag since counting was
+         * enabled to standard out, largest allocators first.
+         */
+        static void printSummary();
+
+
+
+        /**
+         * Checks the mean allocations per frame since counting was enabled
+         * against a budget, printing an error if it is exceeded.
+         *
+         * @param inMaxAllocationsPerFrame the largest mean allowed, or 0
+         *   for no limit.
+         * @param inMaxBytesPerFrame the largest mean number of bytes
+         *   allowed, or 0 for no limit.
+         *
+         * @return true if the allocations are within budget.
+         */
+        static char checkBudget( unsigned long inMaxAllocationsPerFrame,
+                                 unsigned long inMaxBytesPerFrame );
+
+
+
+    protected:
+
+
+
+        /**
+         * Prints one table of allocations per frame.
+         *
+         * @param inTitle the title of the table.
+         *   Must be destroyed by caller.
+         * @param inWindow true to print the stats since the last report,
+         *   or false to print the stats since counting was enabled.
+         * @param inNumFrames the number of frames covered by the stats.
+         * @param inMaxTags the largest number of tags to print.
+         */
+        static void printTable( char *inTitle, char inWindow,
+                                unsigned long inNumFrames, int inMaxTags );
+
+    };
+
+
+
+/**
+ * Counts the allocations made during the life of this object against
+ * a tag.
+ *
+ * Normally created with the ALLOCATION_PROFILER_TAG macro.
+ *
+ * @author Jason Rohrer.
+ */
+class AllocationTagScope {
+
+    public:
+
+        /**
+         * Opens a tag on the calling thread.
+         *
+         * @param inName the name of the tag.
+         *   Must be destroyed by caller.
+         */
+        AllocationTagScope( char *inName )
+            : mPreviousTag( AllocationProfiler::getCurrentTag() ) {
+
+            AllocationTag *tag = AllocationProfiler::getTag( inName );
+
+            if( tag != NULL ) {
+                AllocationProfiler::setCurrentTag( tag );
+                }
+            }
+
+        ~AllocationTagScope() {
+            AllocationProfiler::setCurrentTag( mPreviousTag );
+            }
+
+    protected:
+
+        AllocationTag *mPreviousTag;
+    };
+
+
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "AudioLatencyProfile.h"
+
+
+#include "minorGems/util/SettingsManager.h"
+
+
+#include <stdio.h>
+
+
+
+/**
+ * Reads an integer setting within a range.
+ *
+ * @param inSettingName the name of the setting.
+ *   Must be destroyed by caller.
+ * @param inMin the smallest allowed value.
+ * @param inMax the largest allowed value.
+ * @param inOutValue pointer to the default value, which is replaced
+ *   if the setting is present and in range.
+ */
+static void readRangedSetting( char *inSettingName,
+                               unsigned long inMin, unsigned long inMax,
+                               unsigned long *inOutValue ) {
+    char found = false;
+    int value = SettingsManager::getIntSetting( inSettingName, &found );
+
+    if( !found ) {
+        return;
+        }
+
+    if( value < 0 ||
+        (unsigned long)value < inMin || (unsigned long)value > inMax ) {
+
+        fprintf( stderr,
+                 "Setting %s of %d is outside [%lu, %lu], using %lu\n",
+                 inSettingName, value, inMin, inMax, *inOutValue );
+        return;
+        }
+
+    *inOutValue = (unsigned long)value;
+    }
+
+
+
+AudioLatencyProfile::AudioLatencyProfile( unsigned long inSampleRate,
+                                          unsigned long inFramesPerBuffer,
+                                          unsigned long inNumBuffers,
+                                          unsigned long inLookaheadFrames )
+    : mSampleRate( inSampleRate ),
+      mFramesPerBuffer( inFramesPerBuffer ),
+      mNumBuffers( inNumBuffers ),
+      mLookaheadFrames( inLookaheadFrames ) {
+
+    }
+
+
+
+AudioLatencyProfile AudioLatencyProfile::readSettings() {
+    AudioLatencyProfile profile;
+
+    readRangedSetting( "audioSampleRate", 8000, 96000,
+                       &( profile.mSampleRate ) );
+    readRangedSetting( "audioFramesPerBuffer", 16, 16384,
+                       &( profile.mFramesPerBuffer ) );
+    readRangedSetting( "audioNumBuffers", 0, 64,
+                       &( profile.mNumBuffers ) );
+    readRangedSetting( "audioLookaheadFrames", 0, 65536,
+                       &( profile.mLookaheadFrames ) );
+
+    return profile;
+    }
+
+
+
+double AudioLatencyProfile::getBufferMilliseconds() {
+    return 1000.0 * (double)mFramesPerBuffer / (double)mSampleRate;
+    }
+
+
+
+double AudioLatencyProfile::getLatencyMilliseconds() {
+    double lookaheadMilliseconds =
+        1000.0 * (double)mLookaheadFrames / (double)mSampleRate;
+    
+    if( mNumBuffers == 0 ) {
+        return getBufferMilliseconds() + lookaheadMilliseconds;
+        }
+
+    return mNumBuffers * getBufferMilliseconds() + lookaheadMilliseconds;
+    }
+
+
+
+void AudioLatencyProfile::print() {
+    printf( "%lu Hz, %lu frames x ", mSampleRate, mFramesPerBuffer );
+
+    if( mNumBuffers == 0 ) {
+        printf( "default buffers" );
+        }
+    else {
+        printf( "%lu buffers", mNumBuffers );
+        }
+
+    if( mLookaheadFrames > 0 ) {
+        printf( " + %lu frames ahead", mLookaheadFrames );
+        }
+
+    if( mNumBuffers > 0 ) {
+        printf( " (%.1f ms)", getLatencyMilliseconds() );
+        }
+    }
@@ -0,0 +1,99 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef AUDIO_LATENCY_PROFILE_INCLUDED
+#define AUDIO_LATENCY_PROFILE_INCLUDED
+
+
+
+/**
+ * The buffering used for sound output, which trades latency against
+ * safety from underruns.
+ *
+ * Small buffers let sounds start sooner after the game plays them, but
+ * leave the mixer less time to fill each one, so they suit fast machines.
+ * Large buffers suit busy machines.
+ *
+ * @author Jason Rohrer
+ */
+class AudioLatencyProfile {
+
+
+
+    public:
+
+        /**
+         * Constructs a profile.
+         *
+         * @param inSampleRate the number of samples per second.
+         *   Defaults to 11025.
+         * @param inFramesPerBuffer the number of stereo frames mixed by
+         *   each callback.  Defaults to 1024.
+         * @param inNumBuffers the number of buffers the device queues,
+         *   or 0 to let PortAudio pick its minimum.  Defaults to 0.
+         * @param inLookaheadFrames how far ahead of the device to mix on
+         *   a producer thread, or 0 to mix in the device's callback.
+         *   Defaults to 0.
+         */
+        AudioLatencyProfile( unsigned long inSampleRate = 11025,
+                             unsigned long inFramesPerBuffer = 1024,
+                             unsigned long inNumBuffers = 0,
+                             unsigned long inLookaheadFrames = 0 );
+
+
+
+        /**
+         * Reads a profile from the audioSampleRate, audioFramesPerBuffer,
+         * audioNumBuffers, and audioLookaheadFrames settings.
+         *
+         * Settings that are missing or out of range keep their defaults.
+         *
+         * @return the profile.
+         */
+        static AudioLatencyProfile readSettings();
+
+
+
+        /**
+         * Gets the time each buffer takes to play.
+         *
+         * @return the time in milliseconds.
+         */
+        double getBufferMilliseconds();
+
+
+
+        /**
+         * Gets the time all queued buffers and the lookahead take to
+         * play, which is the delay between playing a sound and hearing it.
+         *
+         * @return the time in milliseconds, counting one buffer if
+         *   mNumBuffers is 0 and the number is up to PortAudio.
+         */
+        double getLatencyMilliseconds();
+
+
+
+        /**
+         * Prints this profile on one line, with no newline.
+         */
+        void print();
+
+
+
+        unsigned long mSampleRate;
+        unsigned long mFramesPerBuffer;
+        unsigned long mNumBuffers;
+        unsigned long mLookaheadFrames;
+
+    };
+
+
+
+#endif
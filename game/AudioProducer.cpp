@@ -0,0 +1,288 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "AudioProducer.h"
+#include "SoundPlayer.h"
+
+
+#include "minorGems/system/Thread.h"
+
+
+#include <stdio.h>
+#include <string.h>
+
+
+
+// each frame is a left and a right float
+static const long bytesPerFrame = 2 * sizeof( float );
+
+
+
+/**
+ * Keeps the compiler and CPU from moving sample reads or writes past
+ * the ring index update that hands them to the other thread, which the
+ * pablio ring does not do itself.
+ */
+static inline void ringMemoryBarrier() {
+    #ifdef __GNUC__
+        __sync_synchronize();
+    #endif
+    }
+
+
+
+/**
+ * The mixing thread of an AudioProducer.
+ */
+class AudioProducerThread : public Thread {
+
+    public:
+
+        AudioProducerThread( AudioProducer *inProducer )
+            : mProducer( inProducer ) {
+            }
+
+        // implements the Thread interface
+        virtual void run();
+
+    protected:
+        AudioProducer *mProducer;
+    };
+
+
+
+void AudioProducerThread::run() {
+    mProducer->runProducer();
+    }
+
+
+
+AudioProducer::AudioProducer( SoundPlayer *inPlayer,
+                              unsigned long inFramesPerBlock,
+                              unsigned long inLookaheadFrames )
+    : mPlayer( inPlayer ),
+      mFramesPerBlock( inFramesPerBlock ),
+      mLookaheadFrames( inLookaheadFrames ),
+      mScratchBuffer( new float[ 2 * inFramesPerBlock ] ),
+      mThread( NULL ),
+      mLock( new MutexLock() ),
+      mStopping( false ),
+      mLowWaterFrames( 0 ),
+      mNumUnderruns( 0 ) {
+
+    // with less, the producer could never get a block ahead
+    if( mLookaheadFrames < mFramesPerBlock ) {
+        mLookaheadFrames = mFramesPerBlock;
+        }
+
+    mTargetFillFrames = mFramesPerBlock + mLookaheadFrames;
+
+    long ringBytes = 1;
+    while( ringBytes < (long)mTargetFillFrames * bytesPerFrame ) {
+        ringBytes *= 2;
+        }
+
+    mRingData = new char[ ringBytes ];
+
+    RingBuffer_Init( &mRing, ringBytes, (void *)mRingData );
+    }
+
+
+
+AudioProducer::~AudioProducer() {
+    stop();
+
+    delete mLock;
+    delete [] mRingData;
+    delete [] mScratchBuffer;
+    }
+
+
+
+void AudioProducer::start() {
+    if( mThread != NULL ) {
+        return;
+        }
+
+    RingBuffer_Flush( &mRing );
+
+    // so the first callback finds a full ring
+    while( getFillFrames() + mFramesPerBlock <= mTargetFillFrames ) {
+        produceBlock();
+        }
+
+    mLowWaterFrames = getFillFrames();
+    mNumUnderruns = 0;
+
+    mLock->lock();
+    mStopping = false;
+    mLock->unlock();
+
+    mThread = new AudioProducerThread( this );
+    mThread->start();
+    }
+
+
+
+void AudioProducer::stop() {
+    if( mThread == NULL ) {
+        return;
+        }
+
+    mLock->lock();
+    mStopping = true;
+    mLock->unlock();
+
+    mThread->join();
+    delete mThread;
+    mThread = NULL;
+    }
+
+
+
+char AudioProducer::isStopping() {
+    mLock->lock();
+    char stopping = mStopping;
+    mLock->unlock();
+
+    return stopping;
+    }
+
+
+
+void AudioProducer::produceBlock() {
+    long blockBytes = mFramesPerBlock * bytesPerFrame;
+
+    void *region1;
+    void *region2;
+    long size1;
+    long size2;
+
+    RingBuffer_GetWriteRegions( &mRing, blockBytes,
+                                &region1, &size1, &region2, &size2 );
+
+    if( size1 == blockBytes ) {
+        // mix straight into the ring
+        mPlayer->mixSamples( region1, mFramesPerBlock );
+        }
+    else {
+        // block wraps around the end of the ring
+        mPlayer->mixSamples( (void *)mScratchBuffer, mFramesPerBlock );
+
+        memcpy( region1, (void *)mScratchBuffer, size1 );
+        memcpy( region2, (void *)( (char *)mScratchBuffer + size1 ), size2 );
+        }
+
+    ringMemoryBarrier();
+
+    RingBuffer_AdvanceWriteIndex( &mRing, blockBytes );
+    }
+
+
+
+void AudioProducer::runProducer() {
+    // poll a few times per block, so that the ring is topped up soon
+    // after each callback takes a block out
+    double blockMilliseconds =
+        1000.0 * mFramesPerBlock / mPlayer->getSampleRate();
+
+    unsigned long sleepMilliseconds =
+        (unsigned long)( blockMilliseconds / 4 );
+    if( sleepMilliseconds < 1 ) {
+        sleepMilliseconds = 1;
+        }
+
+    while( !isStopping() ) {
+        if( getFillFrames() + mFramesPerBlock <= mTargetFillFrames ) {
+            produceBlock();
+            }
+        else {
+            Thread::staticSleep( sleepMilliseconds );
+            }
+        }
+    }
+
+
+
+void AudioProducer::readSamples( float *outSamples,
+                                 unsigned long inNumFrames ) {
+    unsigned long fillFrames = getFillFrames();
+
+    if( fillFrames < mLowWaterFrames ) {
+        mLowWaterFrames = fillFrames;
+        }
+
+    long wantedBytes = inNumFrames * bytesPerFrame;
+
+    void *region1;
+    void *region2;
+    long size1;
+    long size2;
+
+    // only whole frames are ever written, so only whole frames are read
+    long readBytes = RingBuffer_GetReadRegions( &mRing, wantedBytes,
+                                                &region1, &size1,
+                                                &region2, &size2 );
+
+    ringMemoryBarrier();
+
+    memcpy( (void *)outSamples, region1, size1 );
+    if( size2 > 0 ) {
+        memcpy( (void *)( (char *)outSamples + size1 ), region2, size2 );
+        }
+
+    ringMemoryBarrier();
+
+    RingBuffer_AdvanceReadIndex( &mRing, readBytes );
+
+    if( readBytes < wantedBytes ) {
+        // the producer fell behind, so play silence for the rest
+        memset( (void *)( (char *)outSamples + readBytes ), 0,
+                wantedBytes - readBytes );
+
+        mNumUnderruns++;
+        }
+    }
+
+
+
+unsigned long AudioProducer::getLookaheadFrames() {
+    return mLookaheadFrames;
+    }
+
+
+
+unsigned long AudioProducer::getFillFrames() {
+    return RingBuffer_GetReadAvailable( &mRing ) / bytesPerFrame;
+    }
+
+
+
+unsigned long AudioProducer::getLowWaterFrames() {
+    return mLowWaterFrames;
+    }
+
+
+
+unsigned long AudioProducer::getNumUnderruns() {
+    return mNumUnderruns;
+    }
+
+
+
+void AudioProducer::printSummary() {
+    double framesPerMillisecond = mPlayer->getSampleRate() / 1000.0;
+
+    printf( "Audio ring:  lookahead %.1f ms, fill %.1f ms, "
+            "low water %.1f ms, %lu underruns\n",
+            mLookaheadFrames / framesPerMillisecond,
+            getFillFrames() / framesPerMillisecond,
+            getLowWaterFrames() / framesPerMillisecond,
+            getNumUnderruns() );
+    }
@@ -0,0 +1,199 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef AUDIO_PRODUCER_INCLUDED
+#define AUDIO_PRODUCER_INCLUDED
+
+
+
+#include "Transcend/portaudio/pablio/ringbuffer.h"
+
+#include "minorGems/system/MutexLock.h"
+
+
+
+class SoundPlayer;
+class AudioProducerThread;
+
+
+
+/**
+ * Mixes sound ahead of time on its own thread, into a ring that the
+ * audio callback only copies out of.
+ *
+ * A spike in mixing time (a burst of new sounds, a reverb filter being
+ * added, the main thread holding the player's lock) then delays only the
+ * producer, which has the lookahead to catch up in, rather than the
+ * device.  The cost is that every sound is heard that much later.
+ *
+ * The ring is a PortAudio pablio ring, which needs no lock with one
+ * writer and one reader, so the audio callback never waits.
+ *
+ * @author Jason Rohrer
+ */
+class AudioProducer {
+
+
+
+    public:
+
+        /**
+         * Constructs a producer.  The thread is not started until start.
+         *
+         * @param inPlayer the player to mix with.
+         *   Must be destroyed by caller after this class is destroyed.
+         * @param inFramesPerBlock the number of stereo frames mixed at a
+         *   time, which should be the device's buffer size.
+         * @param inLookaheadFrames how many frames to keep mixed beyond
+         *   the one block that the device is about to take.  Raised to
+         *   inFramesPerBlock if smaller.
+         */
+        AudioProducer( SoundPlayer *inPlayer,
+                       unsigned long inFramesPerBlock,
+                       unsigned long inLookaheadFrames );
+
+
+
+        ~AudioProducer();
+
+
+
+        /**
+         * Fills the ring and starts the thread.
+         */
+        void start();
+
+
+
+        /**
+         * Stops the thread.  Nothing more is mixed until start.
+         */
+        void stop();
+
+
+
+        /**
+         * Copies mixed samples out of the ring, filling with silence and
+         * counting an underrun if there are not enough.
+         *
+         * Never blocks.  Must only be called by one thread, normally
+         * the audio callback.
+         *
+         * @param outSamples buffer where interleaved stereo float
+         *   samples will be returned.
+         *   Must be destroyed by caller.
+         * @param inNumFrames the number of stereo frames to return.
+         */
+        void readSamples( float *outSamples, unsigned long inNumFrames );
+
+
+
+        /**
+         * Mixes into the ring until stop is called.
+         *
+         * Called by this producer's thread.
+         */
+        void runProducer();
+
+
+
+        /**
+         * Gets the extra latency added by mixing ahead.
+         *
+         * @return the lookahead in frames.
+         */
+        unsigned long getLookaheadFrames();
+
+
+
+        /**
+         * Gets the number of frames mixed and waiting in the ring.
+         *
+         * @return the number of frames.
+         */
+        unsigned long getFillFrames();
+
+
+
+        /**
+         * Gets the fewest frames that were waiting in the ring when
+         * readSamples was called, since start.
+         *
+         * @return the number of frames.
+         */
+        unsigned long getLowWaterFrames();
+
+
+
+        /**
+         * Gets the number of calls to readSamples that found too few
+         * frames in the ring, since start.
+         *
+         * @return the number of underruns.
+         */
+        unsigned long getNumUnderruns();
+
+
+
+        /**
+         * Prints one line summarizing the ring's fill level to standard
+         * out.
+         */
+        void printSummary();
+
+
+
+    protected:
+
+        SoundPlayer *mPlayer;
+
+        unsigned long mFramesPerBlock;
+        unsigned long mLookaheadFrames;
+
+        // the producer keeps the ring filled up to here
+        unsigned long mTargetFillFrames;
+
+        RingBuffer mRing;
+        char *mRingData;
+
+        // for blocks that wrap around the end of the ring
+        float *mScratchBuffer;
+
+        // NULL when stopped
+        AudioProducerThread *mThread;
+
+        // protects mStopping
+        MutexLock *mLock;
+        char mStopping;
+
+        // only changed by the reader
+        volatile unsigned long mLowWaterFrames;
+        volatile unsigned long mNumUnderruns;
+
+
+
+        /**
+         * Gets whether stop has been called.
+         *
+         * @return true if the thread should stop.
+         */
+        char isStopping();
+
+
+
+        /**
+         * Mixes one block into the ring, which must have room for it.
+         */
+        void produceBlock();
+
+    };
+
+
+
+#endif
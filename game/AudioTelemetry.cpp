@@ -0,0 +1,280 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "AudioTelemetry.h"
+
+
+#include <stdlib.h>
+#include <math.h>
+
+
+
+AudioTelemetry::AudioTelemetry( int inMaxRecords )
+    : mNumDropped( 0 ) {
+
+    if( inMaxRecords < 1 ) {
+        inMaxRecords = 1;
+        }
+
+    long ringBytes = 1;
+    while( ringBytes < inMaxRecords * (long)sizeof( AudioCallbackRecord ) ) {
+        ringBytes *= 2;
+        }
+
+    mRingData = new char[ ringBytes ];
+
+    RingBuffer_Init( &mRing, ringBytes, (void *)mRingData );
+    }
+
+
+
+AudioTelemetry::~AudioTelemetry() {
+    delete [] mRingData;
+    }
+
+
+
+void AudioTelemetry::addRecord( AudioCallbackRecord *inRecord ) {
+    long recordBytes = sizeof( AudioCallbackRecord );
+
+    // only whole records are written, so the reader never sees part
+    // of one
+    if( RingBuffer_GetWriteAvailable( &mRing ) < recordBytes ) {
+        mNumDropped++;
+        return;
+        }
+
+    RingBuffer_Write( &mRing, (void *)inRecord, recordBytes );
+    }
+
+
+
+char AudioTelemetry::readRecord( AudioCallbackRecord *outRecord ) {
+    long recordBytes = sizeof( AudioCallbackRecord );
+
+    if( RingBuffer_GetReadAvailable( &mRing ) < recordBytes ) {
+        return false;
+        }
+
+    RingBuffer_Read( &mRing, (void *)outRecord, recordBytes );
+
+    return true;
+    }
+
+
+
+unsigned long AudioTelemetry::getNumDropped() {
+    return mNumDropped;
+    }
+
+
+
+void AudioTelemetry::writeCSVHeader( FILE *inFILE ) {
+    fprintf( inFILE,
+             "startUs,intervalUs,wallUs,lockWaitUs,deadlineUs,frames,"
+             "voices,musicNotes,filters,deadlineMissed\n" );
+    }
+
+
+
+void AudioTelemetry::writeCSVLine( FILE *inFILE,
+                                   AudioCallbackRecord *inRecord ) {
+    fprintf( inFILE, "%.1f,%.1f,%.1f,%.1f,%.1f,%lu,%d,%d,%d,%d\n",
+             inRecord->mStartMicroseconds,
+             inRecord->mIntervalMicroseconds,
+             inRecord->mWallMicroseconds,
+             inRecord->mLockWaitMicroseconds,
+             inRecord->mDeadlineMicroseconds,
+             inRecord->mNumFrames,
+             inRecord->mNumVoices,
+             inRecord->mNumMusicNotes,
+             inRecord->mNumFilters,
+             (int)( inRecord->mDeadlineMissed ) );
+    }
+
+
+
+AudioTelemetrySummary::AudioTelemetrySummary()
+    : mWallTimes( new SimpleVector<double>() ) {
+
+    reset();
+    }
+
+
+
+AudioTelemetrySummary::~AudioTelemetrySummary() {
+    delete mWallTimes;
+    }
+
+
+
+void AudioTelemetrySummary::reset() {
+    mWallTimes->deleteAll();
+
+    mTotalWallTime = 0;
+    mTotalLockWait = 0;
+    mMaxLockWait = 0;
+    mMaxInterval = 0;
+    mNumIntervals = 0;
+    mTotalInterval = 0;
+    mTotalSquaredInterval = 0;
+    mDeadline = 0;
+    mNumDeadlineMisses = 0;
+    mTotalVoices = 0;
+    mMaxVoices = 0;
+    mTotalMusicNotes = 0;
+    mMaxMusicNotes = 0;
+    }
+
+
+
+void AudioTelemetrySummary::addRecord( AudioCallbackRecord *inRecord ) {
+    mWallTimes->push_back( inRecord->mWallMicroseconds );
+
+    mTotalWallTime += inRecord->mWallMicroseconds;
+    mTotalLockWait += inRecord->mLockWaitMicroseconds;
+
+    if( inRecord->mLockWaitMicroseconds > mMaxLockWait ) {
+        mMaxLockWait = inRecord->mLockWaitMicroseconds;
+        }
+    if( inRecord->mIntervalMicroseconds > mMaxInterval ) {
+        mMaxInterval = inRecord->mIntervalMicroseconds;
+        }
+    if( inRecord->mIntervalMicroseconds > 0 ) {
+        double interval = inRecord->mIntervalMicroseconds;
+
+        mNumIntervals++;
+        mTotalInterval += interval;
+        mTotalSquaredInterval += interval * interval;
+        }
+
+    mDeadline = inRecord->mDeadlineMicroseconds;
+
+    if( inRecord->mDeadlineMissed ) {
+        mNumDeadlineMisses++;
+        }
+
+    mTotalVoices += inRecord->mNumVoices;
+    if( inRecord->mNumVoices > mMaxVoices ) {
+        mMaxVoices = inRecord->mNumVoices;
+        }
+
+    mTotalMusicNotes += inRecord->mNumMusicNotes;
+    if( inRecord->mNumMusicNotes > mMaxMusicNotes ) {
+        mMaxMusicNotes = inRecord->mNumMusicNotes;
+        }
+    }
+
+
+
+unsigned long AudioTelemetrySummary::getNumCallbacks() {
+    return mWallTimes->size();
+    }
+
+
+
+double AudioTelemetrySummary::getMeanInterval() {
+    if( mNumIntervals == 0 ) {
+        return 0;
+        }
+
+    return mTotalInterval / mNumIntervals;
+    }
+
+
+
+double AudioTelemetrySummary::getIntervalJitter() {
+    if( mNumIntervals == 0 ) {
+        return 0;
+        }
+
+    double mean = getMeanInterval();
+    double variance = mTotalSquaredInterval / mNumIntervals - mean * mean;
+
+    if( variance < 0 ) {
+        // rounding
+        variance = 0;
+        }
+
+    return sqrt( variance );
+    }
+
+
+
+double AudioTelemetrySummary::getMaxInterval() {
+    return mMaxInterval;
+    }
+
+
+
+unsigned long AudioTelemetrySummary::getNumDeadlineMisses() {
+    return mNumDeadlineMisses;
+    }
+
+
+
+// for qsort
+static int compareDoubles( const void *inA, const void *inB ) {
+    double a = *( (double *)inA );
+    double b = *( (double *)inB );
+
+    if( a < b ) {
+        return -1;
+        }
+    else if( a > b ) {
+        return 1;
+        }
+    else {
+        return 0;
+        }
+    }
+
+
+
+void AudioTelemetrySummary::printSummary( unsigned long inNumDropped ) {
+    int numCallbacks = mWallTimes->size();
+
+    if( numCallbacks == 0 ) {
+        printf( "Audio:  no callbacks\n" );
+        return;
+        }
+
+    double *sorted = mWallTimes->getElementArray();
+
+    qsort( sorted, numCallbacks, sizeof( double ), compareDoubles );
+
+    int p99Index = (int)( 0.99 * ( numCallbacks - 1 ) + 0.5 );
+
+    printf( "Audio:  %d callbacks, wall mean %.0f us, p99 %.0f us, "
+            "max %.0f us of %.0f us deadline, %lu missed, "
+            "lock wait mean %.0f us, max %.0f us, "
+            "max interval %.0f us, "
+            "voices mean %.1f, max %d, "
+            "music notes mean %.1f, max %d",
+            numCallbacks,
+            mTotalWallTime / numCallbacks,
+            sorted[ p99Index ],
+            sorted[ numCallbacks - 1 ],
+            mDeadline,
+            mNumDeadlineMisses,
+            mTotalLockWait / numCallbacks,
+            mMaxLockWait,
+            mMaxInterval,
+            (double)mTotalVoices / numCallbacks,
+            mMaxVoices,
+            (double)mTotalMusicNotes / numCallbacks,
+            mMaxMusicNotes );
+
+    if( inNumDropped > 0 ) {
+        printf( ", %lu records dropped", inNumDropped );
+        }
+    printf( "\n" );
+
+    delete [] sorted;
+    }
@@ -0,0 +1,287 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef AUDIO_TELEMETRY_INCLUDED
+#define AUDIO_TELEMETRY_INCLUDED
+
+
+
+#include "Transcend/portaudio/pablio/ringbuffer.h"
+
+
+#include "minorGems/util/SimpleVector.h"
+
+
+#include <stdio.h>
+
+
+
+/**
+ * Measurements of one call to SoundPlayer::getSamples.
+ *
+ * @author Jason Rohrer.
+ */
+class AudioCallbackRecord {
+
+    public:
+
+        // when the call started, from FrameProfiler::getCurrentMicroseconds
+        double mStartMicroseconds;
+
+        // time since the start of the previous call, or 0 for the
+        // first call
+        double mIntervalMicroseconds;
+
+        // time taken by the whole call
+        double mWallMicroseconds;
+
+        // time spent waiting for the sound player's lock
+        double mLockWaitMicroseconds;
+
+        // the play time of the buffer filled by the call, which the call
+        // must take less than to keep up with the audio device
+        double mDeadlineMicroseconds;
+
+        unsigned long mNumFrames;
+
+        // realtime sounds mixed
+        int mNumVoices;
+
+        // music notes still playing after the call
+        int mNumMusicNotes;
+
+        int mNumFilters;
+
+        char mDeadlineMissed;
+    };
+
+
+
+/**
+ * Passes callback records from the audio thread to one reader thread.
+ *
+ * Records are kept in a PortAudio pablio ring buffer, which needs no
+ * lock when there is only one writer and one reader, so the audio
+ * thread never waits on the reader.  When the ring is full, new records
+ * are dropped and counted.
+ *
+ * @author Jason Rohrer.
+ */
+class AudioTelemetry {
+
+
+    public:
+
+
+
+        /**
+         * Constructs an empty ring.
+         *
+         * @param inMaxRecords the number of records the ring can hold
+         *   before the reader must catch up.  Rounded up so that the ring
+         *   size in bytes is a power of 2.  Defaults to 256, which is about
+         *   20 seconds of callbacks at our buffer size.
+         */
+        AudioTelemetry( int inMaxRecords = 256 );
+
+
+
+        ~AudioTelemetry();
+
+
+
+        /**
+         * Adds a record.  Never blocks.
+         *
+         * Must only be called by the writer thread.
+         *
+         * @param inRecord the record.
+         *   Must be destroyed by caller.
+         */
+        void addRecord( AudioCallbackRecord *inRecord );
+
+
+
+        /**
+         * Takes the oldest record.
+         *
+         * Must only be called by the reader thread.
+         *
+         * @param outRecord pointer to where the record should be returned.
+         *
+         * @return true if a record was returned, or false if the ring
+         *   is empty.
+         */
+        char readRecord( AudioCallbackRecord *outRecord );
+
+
+
+        /**
+         * Gets the number of records dropped because the ring was full.
+         *
+         * @return the number of dropped records.
+         */
+        unsigned long getNumDropped();
+
+
+
+        /**
+         * Writes the column names of writeCSVLine to a file.
+         *
+         * @param inFILE the file.
+         *   Must be closed by caller.
+         */
+        static void writeCSVHeader( FILE *inFILE );
+
+
+
+        /**
+         * Writes a record as one line of comma-separated values.
+         *
+         * @param inFILE the file.
+         *   Must be closed by caller.
+         * @param inRecord the record.
+         *   Must be destroyed by caller.
+         */
+        static void writeCSVLine( FILE *inFILE,
+                                  AudioCallbackRecord *inRecord );
+
+
+
+    protected:
+
+        RingBuffer mRing;
+        char *mRingData;
+
+        // only changed by the writer
+        volatile unsigned long mNumDropped;
+
+    };
+
+
+
+/**
+ * Statistics over a series of callback records.
+ *
+ * @author Jason Rohrer.
+ */
+class AudioTelemetrySummary {
+
+
+    public:
+
+        AudioTelemetrySummary();
+
+        ~AudioTelemetrySummary();
+
+
+
+        /**
+         * Adds a record to the statistics.
+         *
+         * @param inRecord the record.
+         *   Must be destroyed by caller.
+         */
+        void addRecord( AudioCallbackRecord *inRecord );
+
+
+
+        /**
+         * Gets the number of records added.
+         *
+         * @return the number of records.
+         */
+        unsigned long getNumCallbacks();
+
+
+
+        /**
+         * Gets the mean time from the start of one callback to the start
+         * of the next.
+         *
+         * @return the time in microseconds, or 0 if fewer than two
+         *   callbacks were added.
+         */
+        double getMeanInterval();
+
+
+
+        /**
+         * Gets the standard deviation of the time between callbacks,
+         * which is 0 for a perfectly steady device.
+         *
+         * @return the time in microseconds.
+         */
+        double getIntervalJitter();
+
+
+
+        /**
+         * Gets the longest time between callbacks.
+         *
+         * @return the time in microseconds.
+         */
+        double getMaxInterval();
+
+
+
+        /**
+         * Gets the number of callbacks that missed their deadlines.
+         *
+         * @return the number of misses.
+         */
+        unsigned long getNumDeadlineMisses();
+
+
+
+        /**
+         * Prints one line summarizing the records added to standard out.
+         *
+         * @param inNumDropped the number of records that were dropped
+         *   before they could be added.
+         */
+        void printSummary( unsigned long inNumDropped );
+
+
+
+        /**
+         * Clears the statistics.
+         */
+        void reset();
+
+
+
+    protected:
+
+        // for percentiles
+        SimpleVector<double> *mWallTimes;
+
+        double mTotalWallTime;
+        double mTotalLockWait;
+        double mMaxLockWait;
+        double mMaxInterval;
+        // over records that have an interval
+        unsigned long mNumIntervals;
+        double mTotalInterval;
+        double mTotalSquaredInterval;
+        double mDeadline;
+
+        unsigned long mNumDeadlineMisses;
+
+        unsigned long mTotalVoices;
+        int mMaxVoices;
+
+        unsigned long mTotalMusicNotes;
+        int mMaxMusicNotes;
+
+    };
+
+
+
+#endif
@@ -36,11 +36,16 @@
  *
  * 2005-August-29   Jason Rohrer
  * Removed print message.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added interpolation between simulation steps when drawing.
+ * Added a rotated copy stride for drawing with reduced quality.
  */
 
 
 
 #include "BossManager.h"
+#include "RenderInterpolation.h"
 
 
 
@@ -100,6 +105,8 @@ BossManager::BossManager( Enemy *inBossTemplate,
       mCurrentRadius( 0 ),
       mCurrentRotationRate( 0 ),
       mCurrentRotation( new Angle3D( 0, 0, 0 ) ),
+      mPreviousBossPosition( new Vector3D( inBossPosition ) ),
+      mPreviousRotation( new Angle3D( 0, 0, 0 ) ),
       mShipDistanceParameter( 0 ) {
 
     mBossDistanceFromCenter = mBossPosition->getLength();
@@ -113,6 +120,8 @@ BossManager::~BossManager() {
     delete mBossTemplate;
     delete mBossPosition;
     delete mCurrentRotation;
+    delete mPreviousBossPosition;
+    delete mPreviousRotation;
 
     delete mBossExplosionSoundTemplate;
     }
@@ -412,7 +421,18 @@ void BossManager::passTime( double inTimeDeltaInSeconds,
 
 
 
-SimpleVector<DrawableObject *> *BossManager::getDrawableObjects() {
+void BossManager::saveInterpolationState() {
+    delete mPreviousBossPosition;
+    mPreviousBossPosition = new Vector3D( mBossPosition );
+
+    delete mPreviousRotation;
+    mPreviousRotation = new Angle3D( mCurrentRotation );
+    }
+
+
+
+SimpleVector<DrawableObject *> *BossManager::getDrawableObjects(
+    double inInterpolation, int inRotatedCopyStride ) {
 
     double healthFraction = mBossHealth / mMaxBossHealth;
 
@@ -423,7 +443,9 @@ SimpleVector<DrawableObject *> *BossManager::getDrawableObjects() {
             mShipDistanceParameter,
             mExplosionShapeParameter,
             mExplosionProgress,
-            &mCurrentRotationRate );
+            &mCurrentRotationRate,
+            0,
+            inRotatedCopyStride );
     
     // fade out at end of explosion
     double alphaMultiplier = 1 - mExplosionFadeProgress;
@@ -434,6 +456,11 @@ SimpleVector<DrawableObject *> *BossManager::getDrawableObjects() {
         ( 1 - mExplosionProgress ) * mBossScale;
     
     
+    Vector3D *position = RenderInterpolation::interpolatePosition(
+        mPreviousBossPosition, mBossPosition, inInterpolation );
+    Angle3D *rotation = RenderInterpolation::interpolateRotation(
+        mPreviousRotation, mCurrentRotation, inInterpolation );
+    
     int numObjects = bossObjects->size();
         
     // compute the maximum radius of this boss
@@ -445,11 +472,11 @@ SimpleVector<DrawableObject *> *BossManager::getDrawableObjects() {
             *( bossObjects->getElement( j ) );
         
         currentObject->scale( scale );
-        currentObject->rotate( mCurrentRotation );
-        currentObject->move( mBossPosition );
+        currentObject->rotate( rotation );
+        currentObject->move( position );
         currentObject->fade( alphaMultiplier );
         
-        double radius = currentObject->getBorderMaxDistance( mBossPosition );
+        double radius = currentObject->getBorderMaxDistance( position );
 
         if( radius > maxRadius ) {
             maxRadius = radius;
@@ -457,6 +484,9 @@ SimpleVector<DrawableObject *> *BossManager::getDrawableObjects() {
         }    
         
     mCurrentRadius = maxRadius;
+
+    delete position;
+    delete rotation;
     
     return bossObjects;
     }
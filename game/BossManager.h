@@ -15,6 +15,10 @@
  *
  * 2005-August-22   Jason Rohrer
  * Started work on boss damage graphics.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added interpolation between simulation steps when drawing.
+ * Added a rotated copy stride for drawing with reduced quality.
  */
 
 
@@ -129,15 +133,35 @@ class BossManager {
                        Vector3D *inShipPosition,
                        Vector3D *inShipVelocity );
 
+
+
+        /**
+         * Saves the current boss position and rotation so that
+         * drawing can blend between them and the results of the next
+         * simulation step.
+         *
+         * Should be called before each step.
+         */
+        void saveInterpolationState();
+
         
         
         /**
          * Gets drawable objects for the boss.
          *
+         * @param inInterpolation how far to place the boss between its
+         *   saved and current position, in [0,1].
+         *   Defaults to 1 (current position).
+         * @param inRotatedCopyStride how many rotated copies of each
+         *   shape to step over for each one drawn, for reducing quality.
+         *   Collision radii are not changed.  Defaults to 1.
+         *
          * @return boss as a collection of drawable objects.
          *   Vector and objects must be destroyed by caller.
          */
-        SimpleVector<DrawableObject *> *getDrawableObjects();
+        SimpleVector<DrawableObject *> *getDrawableObjects(
+            double inInterpolation = 1,
+            int inRotatedCopyStride = 1 );
 
 
 
@@ -219,6 +243,10 @@ class BossManager {
         double mCurrentRotationRate;
         Angle3D *mCurrentRotation;
 
+        // position and rotation as of the last saveInterpolationState
+        Vector3D *mPreviousBossPosition;
+        Angle3D *mPreviousRotation;
+
         double mShipDistanceParameter;
         
     };
@@ -16,12 +16,19 @@
  *
  * 2004-June-21   Jason Rohrer
  * Added fuction for getting minimum border distance.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added function for comparing the geometry of two objects.
+ * Added rotated instances of one base shape, expanded when drawn.
+ * Transformations now kept as a matrix instead of applied to vertices.
+ * Added functions for getting world vertices without the GL.
  */
 
 
 
 #include <GL/gl.h>
 #include <float.h>
+#include <math.h>
 
 
 #include "DrawableObject.h"
@@ -41,8 +48,45 @@ DrawableObject::DrawableObject( int inNumTriangleVertices,
       mNumBorderVertices( inNumBorderVertices ),
       mBorderVertices( inBorderVertices ),
       mBorderVertexColors( inBorderVertextColors ),
-      mBorderWidth( inBorderWidth ) {
+      mBorderWidth( inBorderWidth ),
+      mNumInstances( 1 ),
+      mInstanceAngles( new double[1] ),
+      mInstanceScales( new double[1] ),
+      mInstanceAlphas( new float[1] ) {
+
+    mInstanceAngles[0] = 0;
+    mInstanceScales[0] = 1;
+    mInstanceAlphas[0] = 1;
+
+    resetTransformation();
+    }
+
+
+
+DrawableObject::DrawableObject( int inNumTriangleVertices,
+                                Vector3D **inTriangleVertices,
+                                Color **inTriangleVertexFillColors,
+                                int inNumBorderVertices,
+                                Vector3D **inBorderVertices,
+                                Color **inBorderVertextColors,
+                                float inBorderWidth,
+                                int inNumInstances,
+                                double *inInstanceAngles,
+                                double *inInstanceScales,
+                                float *inInstanceAlphas )
+    : mNumTriangleVertices( inNumTriangleVertices ),
+      mTriangleVertices( inTriangleVertices ),
+      mTriangleVertexFillColors( inTriangleVertexFillColors ),
+      mNumBorderVertices( inNumBorderVertices ),
+      mBorderVertices( inBorderVertices ),
+      mBorderVertexColors( inBorderVertextColors ),
+      mBorderWidth( inBorderWidth ),
+      mNumInstances( inNumInstances ),
+      mInstanceAngles( inInstanceAngles ),
+      mInstanceScales( inInstanceScales ),
+      mInstanceAlphas( inInstanceAlphas ) {
 
+    resetTransformation();
     }
 
         
@@ -63,63 +107,239 @@ DrawableObject::~DrawableObject() {
     delete [] mTriangleVertexFillColors;
     delete [] mBorderVertices;
     delete [] mBorderVertexColors;
+
+    delete [] mInstanceAngles;
+    delete [] mInstanceScales;
+    delete [] mInstanceAlphas;
     }
 
 
 
-void DrawableObject::rotate( Angle3D *inRotation ) {
-    int i;
-    for( i=0; i<mNumTriangleVertices; i++ ) {
-        mTriangleVertices[i]->rotate( inRotation );
-        }
-    for( i=0; i<mNumBorderVertices; i++ ) {
-        mBorderVertices[i]->rotate( inRotation );
+void DrawableObject::resetTransformation() {
+    mScale = 1;
+
+    for( int i=0; i<9; i++ ) {
+        mAxes[i] = 0;
         }
+    mAxes[0] = 1;
+    mAxes[4] = 1;
+    mAxes[8] = 1;
+
+    mPosition[0] = 0;
+    mPosition[1] = 0;
+    mPosition[2] = 0;
+
+    mAlpha = 1;
     }
 
 
 
-void DrawableObject::move( Vector3D *inPosition ) {
-    int i;
-    for( i=0; i<mNumTriangleVertices; i++ ) {
-        mTriangleVertices[i]->add( inPosition );
+/**
+ * Rotates a vector stored as 3 values.
+ *
+ * Uses Vector3D's rotation so that angles mean the same thing here as
+ * everywhere else.
+ *
+ * @param inOutValues the x, y, and z values to rotate.
+ *   Must be destroyed by caller.
+ * @param inRotation the angle to rotate by.
+ *   Must be destroyed by caller.
+ */
+static void rotateValues( double *inOutValues, Angle3D *inRotation ) {
+    Vector3D vector( inOutValues[0], inOutValues[1], inOutValues[2] );
+
+    vector.rotate( inRotation );
+
+    inOutValues[0] = vector.mX;
+    inOutValues[1] = vector.mY;
+    inOutValues[2] = vector.mZ;
+    }
+
+
+
+/**
+ * Applies a rotation, scale, and move to a transformation of a whole
+ * object, in that order.
+ *
+ * @param inOutScale pointer to the scale of the transformation.
+ * @param inOutAxes the 9 axis values of the transformation.
+ *   Must be destroyed by caller.
+ * @param inOutPosition the 3 position values of the transformation.
+ *   Must be destroyed by caller.
+ * @param inRotation the angle to rotate by, or NULL to not rotate.
+ *   Must be destroyed by caller.
+ * @param inScale the multiplier to scale by.
+ * @param inPosition the vector to move by, or NULL to not move.
+ *   Must be destroyed by caller.
+ */
+static void transform( double *inOutScale, double *inOutAxes,
+                       double *inOutPosition,
+                       Angle3D *inRotation, double inScale,
+                       Vector3D *inPosition ) {
+    if( inRotation != NULL ) {
+        for( int a=0; a<3; a++ ) {
+            rotateValues( &( inOutAxes[ 3 * a ] ), inRotation );
+            }
+        rotateValues( inOutPosition, inRotation );
         }
-    for( i=0; i<mNumBorderVertices; i++ ) {
-        mBorderVertices[i]->add( inPosition );
+
+    if( inScale != 1 ) {
+        *inOutScale *= inScale;
+
+        for( int i=0; i<3; i++ ) {
+            inOutPosition[i] *= inScale;
+            }
+        }
+
+    if( inPosition != NULL ) {
+        inOutPosition[0] += inPosition->mX;
+        inOutPosition[1] += inPosition->mY;
+        inOutPosition[2] += inPosition->mZ;
         }
     }
 
 
 
+void DrawableObject::rotate( Angle3D *inRotation ) {
+    transform( &mScale, mAxes, mPosition, inRotation, 1, NULL );
+    }
+
+
+
+void DrawableObject::move( Vector3D *inPosition ) {
+    transform( &mScale, mAxes, mPosition, NULL, 1, inPosition );
+    }
+
+
+
 void DrawableObject::scale( double inScale ) {
-    int i;
-    for( i=0; i<mNumTriangleVertices; i++ ) {
-        mTriangleVertices[i]->scale( inScale );
-        }
-    for( i=0; i<mNumBorderVertices; i++ ) {
-        mBorderVertices[i]->scale( inScale );
-        }
+    transform( &mScale, mAxes, mPosition, NULL, inScale, NULL );
     }
 
 
 
 void DrawableObject::fade( double inAlphaScale ) {
-    int i;
-    for( i=0; i<mNumTriangleVertices; i++ ) {
-        mTriangleVertexFillColors[i]->a *= inAlphaScale;
+    mAlpha *= inAlphaScale;
+    }
+
+
+
+double DrawableObject::getInstanceMatrix( int inInstance,
+                                          double inScale, double *inAxes,
+                                          double *inPosition,
+                                          double *outMatrix ) {
+
+    double instanceScale = inScale * mInstanceScales[ inInstance ];
+
+    // the instance's own rotation, as images of the x and y axes
+    Angle3D instanceRotation( 0, 0, mInstanceAngles[ inInstance ] );
+
+    double xAxis[3] = { 1, 0, 0 };
+    double yAxis[3] = { 0, 1, 0 };
+
+    rotateValues( xAxis, &instanceRotation );
+    rotateValues( yAxis, &instanceRotation );
+
+    // rotating about z leaves the z axis alone
+    double zAxis[3] = { 0, 0, 1 };
+
+    double *instanceAxes[3] = { xAxis, yAxis, zAxis };
+
+    // each column is the image of one axis under the object's rotation
+    for( int column=0; column<3; column++ ) {
+        double *axis = instanceAxes[ column ];
+
+        for( int row=0; row<3; row++ ) {
+            outMatrix[ column * 4 + row ] =
+                instanceScale *
+                ( inAxes[ row ] * axis[0] +
+                  inAxes[ 3 + row ] * axis[1] +
+                  inAxes[ 6 + row ] * axis[2] );
+            }
+        outMatrix[ column * 4 + 3 ] = 0;
         }
-    for( i=0; i<mNumBorderVertices; i++ ) {
-        mBorderVertexColors[i]->a *= inAlphaScale;
+
+    outMatrix[12] = inPosition[0];
+    outMatrix[13] = inPosition[1];
+    outMatrix[14] = inPosition[2];
+    outMatrix[15] = 1;
+
+    return instanceScale;
+    }
+
+
+
+/**
+ * Moves a world point into the space of the base shape of an instance.
+ *
+ * @param inMatrix the instance's matrix, from getInstanceMatrix.
+ *   Must be destroyed by caller.
+ * @param inScale the scale returned by getInstanceMatrix.  Must not be 0.
+ * @param inPoint the world point.
+ *   Must be destroyed by caller.
+ * @param outPoint the vector to set to the point in the base shape's
+ *   space.
+ *   Must be destroyed by caller.
+ */
+static void moveIntoInstanceSpace( double *inMatrix, double inScale,
+                                   Vector3D *inPoint, Vector3D *outPoint ) {
+    double offset[3] = { inPoint->mX - inMatrix[12],
+                         inPoint->mY - inMatrix[13],
+                         inPoint->mZ - inMatrix[14] };
+
+    // the matrix is a rotation times inScale, so its inverse is its
+    // transpose divided by inScale squared
+    double inverseScaleSquared = 1 / ( inScale * inScale );
+
+    double local[3];
+    for( int column=0; column<3; column++ ) {
+        local[ column ] =
+            ( inMatrix[ column * 4 ] * offset[0] +
+              inMatrix[ column * 4 + 1 ] * offset[1] +
+              inMatrix[ column * 4 + 2 ] * offset[2] ) *
+            inverseScaleSquared;
         }
+
+    outPoint->mX = local[0];
+    outPoint->mY = local[1];
+    outPoint->mZ = local[2];
     }
 
 
 
 char DrawableObject::isBorderInCircle( Vector3D *inCenter,
                                        double inRadius ) {
-    for( int i=0; i<mNumBorderVertices; i++ ) {
-        if( mBorderVertices[i]->getDistance( inCenter ) <= inRadius ) {
-            return true;
+    if( mNumBorderVertices == 0 ) {
+        return false;
+        }
+
+    double matrix[16];
+    Vector3D localCenter( 0, 0, 0 );
+
+    for( int n=0; n<mNumInstances; n++ ) {
+        double instanceScale =
+            getInstanceMatrix( n, mScale, mAxes, mPosition, matrix );
+
+        if( instanceScale == 0 ) {
+            // every vertex is at the position
+            Vector3D position( matrix[12], matrix[13], matrix[14] );
+
+            if( position.getDistance( inCenter ) <= inRadius ) {
+                return true;
+                }
+            continue;
+            }
+
+        moveIntoInstanceSpace( matrix, instanceScale, inCenter,
+                               &localCenter );
+
+        double localRadius = inRadius / fabs( instanceScale );
+
+        for( int i=0; i<mNumBorderVertices; i++ ) {
+            if( mBorderVertices[i]->getDistance( &localCenter ) <=
+                localRadius ) {
+                return true;
+                }
             }
         }
     
@@ -129,15 +349,72 @@ char DrawableObject::isBorderInCircle( Vector3D *inCenter,
 
 
 
-double DrawableObject::getBorderMaxDistance( Vector3D *inPoint ) {
+void DrawableObject::getBorderDistances( Vector3D *inPoint,
+                                         double *outMinDistance,
+                                         double *outMaxDistance ) {
+    double minDistance = DBL_MAX;
     double maxDistance = 0;
-    for( int i=0; i<mNumBorderVertices; i++ ) {
-        double distance = mBorderVertices[i]->getDistance( inPoint );
-        
-        if( distance > maxDistance ) {
-            maxDistance = distance;
+
+    if( mNumBorderVertices == 0 ) {
+        *outMinDistance = minDistance;
+        *outMaxDistance = maxDistance;
+        return;
+        }
+
+    double matrix[16];
+    Vector3D localPoint( 0, 0, 0 );
+
+    for( int n=0; n<mNumInstances; n++ ) {
+        double instanceScale =
+            getInstanceMatrix( n, mScale, mAxes, mPosition, matrix );
+
+        double instanceMin = DBL_MAX;
+        double instanceMax = 0;
+
+        if( instanceScale == 0 ) {
+            // every vertex is at the position
+            Vector3D position( matrix[12], matrix[13], matrix[14] );
+
+            instanceMin = position.getDistance( inPoint );
+            instanceMax = instanceMin;
+            }
+        else {
+            moveIntoInstanceSpace( matrix, instanceScale, inPoint,
+                                   &localPoint );
+
+            for( int i=0; i<mNumBorderVertices; i++ ) {
+                double distance =
+                    mBorderVertices[i]->getDistance( &localPoint );
+
+                if( distance < instanceMin ) {
+                    instanceMin = distance;
+                    }
+                if( distance > instanceMax ) {
+                    instanceMax = distance;
+                    }
+                }
+
+            instanceMin *= fabs( instanceScale );
+            instanceMax *= fabs( instanceScale );
+            }
+
+        if( instanceMin < minDistance ) {
+            minDistance = instanceMin;
+            }
+        if( instanceMax > maxDistance ) {
+            maxDistance = instanceMax;
             }
         }
+
+    *outMinDistance = minDistance;
+    *outMaxDistance = maxDistance;
+    }
+
+
+
+double DrawableObject::getBorderMaxDistance( Vector3D *inPoint ) {
+    double minDistance, maxDistance;
+    getBorderDistances( inPoint, &minDistance, &maxDistance );
     
     return maxDistance;
     }
@@ -145,85 +422,259 @@ double DrawableObject::getBorderMaxDistance( Vector3D *inPoint ) {
 
 
 double DrawableObject::getBorderMinDistance( Vector3D *inPoint ) {
-    double minDistance = DBL_MAX;
-    for( int i=0; i<mNumBorderVertices; i++ ) {
-        double distance = mBorderVertices[i]->getDistance( inPoint );
-        
-        if( distance < minDistance ) {
-            minDistance = distance;
-            }
-        }
+    double minDistance, maxDistance;
+    getBorderDistances( inPoint, &minDistance, &maxDistance );
     
     return minDistance;
     }
 
 
-        
-void DrawableObject::draw( double inScale, Angle3D *inRotation,
-                           Vector3D *inPosition ) {
 
-    Vector3D **worldTriangleVertices = new Vector3D*[ mNumTriangleVertices ];
-    Vector3D **worldBorderVertices = new Vector3D*[ mNumBorderVertices ];
+/**
+ * Gets whether two colors are exactly the same.
+ */
+static char colorsEqual( Color *inA, Color *inB ) {
+    return
+        inA->r == inB->r &&
+        inA->g == inB->g &&
+        inA->b == inB->b &&
+        inA->a == inB->a;
+    }
+
+
+
+/**
+ * Gets whether two vectors are exactly the same.
+ */
+static char vectorsEqual( Vector3D *inA, Vector3D *inB ) {
+    return
+        inA->mX == inB->mX &&
+        inA->mY == inB->mY &&
+        inA->mZ == inB->mZ;
+    }
+
+
+
+char DrawableObject::isSameAs( DrawableObject *inOther ) {
+    if( mNumTriangleVertices != inOther->mNumTriangleVertices ||
+        mNumBorderVertices != inOther->mNumBorderVertices ||
+        mBorderWidth != inOther->mBorderWidth ) {
+        return false;
+        }
+
     int i;
-    
-    // transform the vertices
-    // (do this once here before drawing since we draw them twice,
-    //  once for the filled polygon and once for the border)
     for( i=0; i<mNumTriangleVertices; i++ ) {
-        worldTriangleVertices[i] = new Vector3D( mTriangleVertices[i] );
-        worldTriangleVertices[i]->scale( inScale );
-        worldTriangleVertices[i]->rotate( inRotation );
-        worldTriangleVertices[i]->add( inPosition );
+        if( ! vectorsEqual( mTriangleVertices[i],
+                            inOther->mTriangleVertices[i] ) ||
+            ! colorsEqual( mTriangleVertexFillColors[i],
+                           inOther->mTriangleVertexFillColors[i] ) ) {
+            return false;
+            }
         }
+
     for( i=0; i<mNumBorderVertices; i++ ) {
-        worldBorderVertices[i] = new Vector3D( mBorderVertices[i] );
-        worldBorderVertices[i]->scale( inScale );
-        worldBorderVertices[i]->rotate( inRotation );
-        worldBorderVertices[i]->add( inPosition );
+        if( ! vectorsEqual( mBorderVertices[i],
+                            inOther->mBorderVertices[i] ) ||
+            ! colorsEqual( mBorderVertexColors[i],
+                           inOther->mBorderVertexColors[i] ) ) {
+            return false;
+            }
+        }
+
+    if( mNumInstances != inOther->mNumInstances ) {
+        return false;
         }
     
-    // draw the filled polygon
-    glBegin( GL_TRIANGLES );
+    for( i=0; i<mNumInstances; i++ ) {
+        if( mInstanceAngles[i] != inOther->mInstanceAngles[i] ||
+            mInstanceScales[i] != inOther->mInstanceScales[i] ||
+            mInstanceAlphas[i] != inOther->mInstanceAlphas[i] ) {
+            return false;
+            }
+        }
+
+    if( mScale != inOther->mScale || mAlpha != inOther->mAlpha ) {
+        return false;
+        }
     
-        for( i=0; i<mNumTriangleVertices; i++ ) {
-            glColor4f( mTriangleVertexFillColors[i]->r,
-                       mTriangleVertexFillColors[i]->g,
-                       mTriangleVertexFillColors[i]->b,
-                       mTriangleVertexFillColors[i]->a );
+    for( i=0; i<9; i++ ) {
+        if( mAxes[i] != inOther->mAxes[i] ) {
+            return false;
+            }
+        }
+    for( i=0; i<3; i++ ) {
+        if( mPosition[i] != inOther->mPosition[i] ) {
+            return false;
+            }
+        }
+
+    return true;
+    }
+
+
 
-            glVertex2d( worldTriangleVertices[i]->mX,
-                        worldTriangleVertices[i]->mY );
+int DrawableObject::getNumInstances() {
+    return mNumInstances;
+    }
+
+
+
+double *DrawableObject::getWorldVertices( char inBorder,
+                                          int *outNumVertices ) {
+    int numBaseVertices = mNumTriangleVertices;
+    Vector3D **baseVertices = mTriangleVertices;
+    Color **baseColors = mTriangleVertexFillColors;
+
+    if( inBorder ) {
+        numBaseVertices = mNumBorderVertices;
+        baseVertices = mBorderVertices;
+        baseColors = mBorderVertexColors;
+        }
+
+    int numVertices = numBaseVertices * mNumInstances;
+    double *vertices = new double[ 6 * numVertices ];
+
+    double matrix[16];
+    int v = 0;
+    
+    for( int n=0; n<mNumInstances; n++ ) {
+        getInstanceMatrix( n, mScale, mAxes, mPosition, matrix );
+
+        double alpha = mAlpha * mInstanceAlphas[n];
+
+        for( int i=0; i<numBaseVertices; i++ ) {
+            Vector3D *vertex = baseVertices[i];
+            Color *color = baseColors[i];
+
+            vertices[ v++ ] =
+                matrix[0] * vertex->mX + matrix[4] * vertex->mY +
+                matrix[8] * vertex->mZ + matrix[12];
+            vertices[ v++ ] =
+                matrix[1] * vertex->mX + matrix[5] * vertex->mY +
+                matrix[9] * vertex->mZ + matrix[13];
+            
+            vertices[ v++ ] = color->r;
+            vertices[ v++ ] = color->g;
+            vertices[ v++ ] = color->b;
+            vertices[ v++ ] = color->a * alpha;
             }
+        }
+
+    *outNumVertices = numVertices;
     
-    glEnd();
+    return vertices;
+    }
 
 
-    // draw the border
-    glLineWidth( mBorderWidth );
-    
-    glBegin( GL_LINE_LOOP );
+
+float DrawableObject::getBorderWidth() {
+    return mBorderWidth;
+    }
+
+
+
+        
+void DrawableObject::draw( double inScale, Angle3D *inRotation,
+                           Vector3D *inPosition ) {
+
+    // the object's transformation, followed by the one passed in
+    double scale = mScale;
+    double axes[9];
+    double position[3];
+
+    int i;
+    for( i=0; i<9; i++ ) {
+        axes[i] = mAxes[i];
+        }
+    for( i=0; i<3; i++ ) {
+        position[i] = mPosition[i];
+        }
+
+    transform( &scale, axes, position, inRotation, inScale, inPosition );
+
     
-        for( i=0; i<mNumBorderVertices; i++ ) {
-            glColor4f( mBorderVertexColors[i]->r,
-                       mBorderVertexColors[i]->g,
-                       mBorderVertexColors[i]->b,
-                       mBorderVertexColors[i]->a );
+    // the base shape, in the form the GL takes it
+    // (built once here and shared by all instances)
+    int numVertices = mNumTriangleVertices + mNumBorderVertices;
+
+    double *vertices = new double[ 2 * numVertices ];
+    float *baseColors = new float[ 4 * numVertices ];
+    float *colors = new float[ 4 * numVertices ];
 
-            glVertex2d( worldBorderVertices[i]->mX,
-                        worldBorderVertices[i]->mY );
+    for( i=0; i<numVertices; i++ ) {
+        Vector3D *vertex;
+        Color *color;
+
+        if( i < mNumTriangleVertices ) {
+            vertex = mTriangleVertices[i];
+            color = mTriangleVertexFillColors[i];
+            }
+        else {
+            vertex = mBorderVertices[ i - mNumTriangleVertices ];
+            color = mBorderVertexColors[ i - mNumTriangleVertices ];
             }
-    
-    glEnd();
 
+        vertices[ 2 * i ] = vertex->mX;
+        vertices[ 2 * i + 1 ] = vertex->mY;
 
-    for( i=0; i<mNumTriangleVertices; i++ ) {
-        delete worldTriangleVertices[i];
+        baseColors[ 4 * i ] = color->r;
+        baseColors[ 4 * i + 1 ] = color->g;
+        baseColors[ 4 * i + 2 ] = color->b;
+        baseColors[ 4 * i + 3 ] = color->a;
         }
-    delete [] worldTriangleVertices;
 
-    for( i=0; i<mNumBorderVertices; i++ ) {
-        delete worldBorderVertices[i];
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_COLOR_ARRAY );
+
+    glVertexPointer( 2, GL_DOUBLE, 0, vertices );
+
+    glLineWidth( mBorderWidth );
+
+    double matrix[16];
+
+    for( int n=0; n<mNumInstances; n++ ) {
+        getInstanceMatrix( n, scale, axes, position, matrix );
+
+        // objects are flat, so drop z like glVertex2d would
+        matrix[2] = 0;
+        matrix[6] = 0;
+        matrix[10] = 0;
+        matrix[14] = 0;
+
+        float alpha = (float)( mAlpha * mInstanceAlphas[n] );
+
+        float *instanceColors = baseColors;
+
+        if( alpha != 1 ) {
+            for( i=0; i<numVertices; i++ ) {
+                colors[ 4 * i ] = baseColors[ 4 * i ];
+                colors[ 4 * i + 1 ] = baseColors[ 4 * i + 1 ];
+                colors[ 4 * i + 2 ] = baseColors[ 4 * i + 2 ];
+                colors[ 4 * i + 3 ] = baseColors[ 4 * i + 3 ] * alpha;
+                }
+            instanceColors = colors;
+            }
+
+        glColorPointer( 4, GL_FLOAT, 0, instanceColors );
+
+        // drawScene leaves the modelview matrix current
+        glPushMatrix();
+        glMultMatrixd( matrix );
+
+        // draw the filled polygon
+        glDrawArrays( GL_TRIANGLES, 0, mNumTriangleVertices );
+
+        // draw the border
+        glDrawArrays( GL_LINE_LOOP, mNumTriangleVertices,
+                      mNumBorderVertices );
+
+        glPopMatrix();
         }
-    delete [] worldBorderVertices;
 
+    glDisableClientState( GL_COLOR_ARRAY );
+    glDisableClientState( GL_VERTEX_ARRAY );
+
+    delete [] vertices;
+    delete [] baseColors;
+    delete [] colors;
     }
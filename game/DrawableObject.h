@@ -16,6 +16,12 @@
  *
  * 2004-June-21   Jason Rohrer
  * Added fuction for getting minimum border distance.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added function for comparing the geometry of two objects.
+ * Added rotated instances of one base shape, expanded when drawn.
+ * Transformations now kept as a matrix instead of applied to vertices.
+ * Added functions for getting world vertices without the GL.
  */
 
 
@@ -34,6 +40,15 @@
 /**
  * A 2d object that can draw itself into the current OpenGL context.
  *
+ * An object is one base shape drawn as one or more instances, each
+ * rotated, scaled, and faded from the base shape by its own amount.
+ * Rotations, moves, and scales of the whole object are kept as a
+ * transformation instead of being applied to the vertices, so they cost
+ * the same no matter how many vertices and instances the object has.
+ * Instances are only expanded into world vertices by the GL when drawn,
+ * and distance tests move the test point into each instance's space
+ * instead.
+ *
  * @author Jason Rohrer.
  */
 class DrawableObject {
@@ -74,6 +89,36 @@ class DrawableObject {
                         Color **inBorderVertextColors,
                         float inBorderWidth );
 
+
+
+        /**
+         * Constructs an object made of several instances of a shape.
+         *
+         * Parameters are the same as for the other constructor, except:
+         *
+         * @param inNumInstances the number of instances.
+         * @param inInstanceAngles the angle, in radians, that each
+         *   instance is rotated around the z axis from the base shape.
+         *   Will be destroyed by this class.
+         * @param inInstanceScales the amount that each instance is scaled
+         *   from the base shape.
+         *   Will be destroyed by this class.
+         * @param inInstanceAlphas the value that the alpha of each
+         *   instance's colors is multiplied by.
+         *   Will be destroyed by this class.
+         */
+        DrawableObject( int inNumTriangleVertices,
+                        Vector3D **inTriangleVertices,
+                        Color **inTriangleVertexFillColors,
+                        int inNumBorderVertices,
+                        Vector3D **inBorderVertices,
+                        Color **inBorderVertextColors,
+                        float inBorderWidth,
+                        int inNumInstances,
+                        double *inInstanceAngles,
+                        double *inInstanceScales,
+                        float *inInstanceAlphas );
+
         
 
         virtual ~DrawableObject();
@@ -150,6 +195,56 @@ class DrawableObject {
          */
         double getBorderMinDistance( Vector3D *inPoint );
 
+
+
+        /**
+         * Gets whether this object has exactly the same vertices, colors,
+         * and border width as another object.
+         *
+         * @param inOther the object to compare to.
+         *   Must be destroyed by caller.
+         *
+         * @return true if the objects are identical.
+         */
+        char isSameAs( DrawableObject *inOther );
+
+
+
+        /**
+         * Gets the number of instances of the base shape in this object.
+         *
+         * @return the number of instances.
+         */
+        int getNumInstances();
+
+
+
+        /**
+         * Gets the vertices of every instance of this object in the
+         * world, as draw( 1, no rotation, no move ) would draw them, for
+         * drawing without the GL.
+         *
+         * @param inBorder true to get the border vertices, or false to get
+         *   the triangle vertices.
+         * @param outNumVertices pointer to where the number of vertices
+         *   should be returned.  Border vertices form one loop per
+         *   instance, getNumInstances() loops in all.
+         *
+         * @return x, y, r, g, b, and a for each vertex, instance after
+         *   instance.
+         *   Must be destroyed by caller.
+         */
+        double *getWorldVertices( char inBorder, int *outNumVertices );
+
+
+
+        /**
+         * Gets the width of this object's border.
+         *
+         * @return the width, in pixels.
+         */
+        float getBorderWidth();
+
         
         
         /**
@@ -176,6 +271,69 @@ class DrawableObject {
 
         float mBorderWidth;
 
+        int mNumInstances;
+        double *mInstanceAngles;
+        double *mInstanceScales;
+        float *mInstanceAlphas;
+
+        // the transformation of the whole object, applied after each
+        // instance's own rotation and scale
+        double mScale;
+        // the images of the x, y, and z axes under the rotation, 3
+        // values each
+        double mAxes[9];
+        double mPosition[3];
+        double mAlpha;
+
+
+
+        /**
+         * Sets up the transformation of the whole object to leave it
+         * unchanged.
+         */
+        void resetTransformation();
+
+
+
+        /**
+         * Gets the matrix that maps the base shape to one instance in the
+         * world.
+         *
+         * @param inInstance the index of the instance.
+         * @param inScale the scale of the whole object.
+         * @param inAxes the rotation of the whole object, as in mAxes.
+         *   Must be destroyed by caller.
+         * @param inPosition the position of the whole object.
+         *   Must be destroyed by caller.
+         * @param outMatrix the 16 values of the matrix, in GL's
+         *   column-major order.
+         *   Must be destroyed by caller.
+         *
+         * @return the amount that the matrix scales distances by, which
+         *   can be 0 or negative.
+         */
+        double getInstanceMatrix( int inInstance,
+                                  double inScale, double *inAxes,
+                                  double *inPosition,
+                                  double *outMatrix );
+
+
+
+        /**
+         * Gets the distances of the border vertices from a point across
+         * all instances.
+         *
+         * @param inPoint the point to get the distance from.
+         *   Must be destroyed by caller.
+         * @param outMinDistance pointer to where the minimum distance
+         *   should be returned.
+         * @param outMaxDistance pointer to where the maximum distance
+         *   should be returned.
+         */
+        void getBorderDistances( Vector3D *inPoint,
+                                 double *outMinDistance,
+                                 double *outMaxDistance );
+
         
         
     };
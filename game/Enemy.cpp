@@ -9,6 +9,12 @@
  *
  * 2004-August-30   Jason Rohrer
  * Optimization:  avoid object blending whenever possible.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added reduced detail for enemies that are small on screen.
+ * Added a rotated copy stride parameter for drawing.
+ * Added a function for getting the radius without the shape.
+ * Changed reduced detail to blend points built when loading.
  */
 
 
@@ -130,6 +136,13 @@ Enemy::Enemy( FILE *inFILE, char *outError )
     fclose( enemyCloseFILE );
     fclose( enemyFarFILE );
     fclose( explosionFILE );    
+
+
+    // all three shapes are blended together
+    ParameterizedObject *shapeObjects[3] = { mEnemyCloseShapeObject,
+                                             mEnemyFarShapeObject,
+                                             mExplosionShapeObject };
+    ParameterizedObject::buildDetailLevels( shapeObjects, 3 );
     }
 
 
@@ -147,7 +160,38 @@ SimpleVector<DrawableObject *> *Enemy::getDrawableObjects(
     double inEnemyDistanceFromShipParameter,
     double inExplosionShapeParameter,
     double inExplosionProgress,
-    double *outRotationRate ) {
+    double *outRotationRate,
+    double inPixelsPerUnit,
+    int inRotatedCopyStride ) {
+
+    ObjectParameterSpaceControlPoint *blendedPoint =
+        getBlendedControlPoint(
+            inEnemyShapeParameter,
+            inEnemyDistanceFromShipParameter,
+            inExplosionShapeParameter,
+            inExplosionProgress,
+            ObjectParameterSpaceControlPoint::getDetailTolerance(
+                inPixelsPerUnit ) );
+
+    *outRotationRate = blendedPoint->getRotationRate();
+
+    SimpleVector<DrawableObject*> *drawableObjects =
+            blendedPoint->extractDrawableObjects( inPixelsPerUnit,
+                                                  inRotatedCopyStride );
+        
+    delete blendedPoint;
+        
+    return drawableObjects;
+    }
+
+
+
+ObjectParameterSpaceControlPoint *Enemy::getBlendedControlPoint(
+    double inEnemyShapeParameter,
+    double inEnemyDistanceFromShipParameter,
+    double inExplosionShapeParameter,
+    double inExplosionProgress,
+    double inTolerance ) {
 
     double explosionWeight = inExplosionProgress;
 
@@ -166,13 +210,13 @@ SimpleVector<DrawableObject *> *Enemy::getDrawableObjects(
             // use close control point
             
             enemyControlPoint = mEnemyCloseShapeObject->getBlendedControlPoint(
-                inEnemyShapeParameter );
+                inEnemyShapeParameter, inTolerance );
             }
         else if( inEnemyDistanceFromShipParameter == 1 ) {
             // use far control point
 
             enemyControlPoint = mEnemyFarShapeObject->getBlendedControlPoint(
-                inEnemyShapeParameter );
+                inEnemyShapeParameter, inTolerance );
             }
         else {
             // use a blend of the points
@@ -180,11 +224,11 @@ SimpleVector<DrawableObject *> *Enemy::getDrawableObjects(
             
             ObjectParameterSpaceControlPoint *enemyCloseControlPoint =
                 mEnemyCloseShapeObject->getBlendedControlPoint(
-                    inEnemyShapeParameter );
+                    inEnemyShapeParameter, inTolerance );
             
             ObjectParameterSpaceControlPoint *enemyFarControlPoint =
                 mEnemyFarShapeObject->getBlendedControlPoint(
-                    inEnemyShapeParameter );
+                    inEnemyShapeParameter, inTolerance );
             
             enemyControlPoint =
                 (ObjectParameterSpaceControlPoint*)(
@@ -215,7 +259,7 @@ SimpleVector<DrawableObject *> *Enemy::getDrawableObjects(
         
         blendedPoint = 
             mExplosionShapeObject->getBlendedControlPoint(
-                inExplosionShapeParameter );
+                inExplosionShapeParameter, inTolerance );
         }
     else {
 
@@ -223,7 +267,7 @@ SimpleVector<DrawableObject *> *Enemy::getDrawableObjects(
         
         ObjectParameterSpaceControlPoint *explosionControlPoint =
             mExplosionShapeObject->getBlendedControlPoint(
-                inExplosionShapeParameter );
+                inExplosionShapeParameter, inTolerance );
 
         blendedPoint =
             (ObjectParameterSpaceControlPoint *)(
@@ -234,13 +278,30 @@ SimpleVector<DrawableObject *> *Enemy::getDrawableObjects(
         delete explosionControlPoint;
         }
 
+    return blendedPoint;
+    }
+
 
-    SimpleVector<DrawableObject*> *drawableObjects =
-            blendedPoint->getDrawableObjects();
-        
+
+double Enemy::getRadius( double inEnemyShapeParameter,
+                         double inEnemyDistanceFromShipParameter,
+                         double inExplosionShapeParameter,
+                         double inExplosionProgress,
+                         double *outRotationRate ) {
+
+    // full detail, for collisions
+    ObjectParameterSpaceControlPoint *blendedPoint =
+        getBlendedControlPoint( inEnemyShapeParameter,
+                                inEnemyDistanceFromShipParameter,
+                                inExplosionShapeParameter,
+                                inExplosionProgress,
+                                0 );
+
+    double radius = blendedPoint->getRadius();
+    
     *outRotationRate = blendedPoint->getRotationRate();
-        
+
     delete blendedPoint;
-        
-    return drawableObjects;
+
+    return radius;
     }
@@ -6,6 +6,12 @@
  *
  * 2004-August-24   Jason Rohrer
  * Added extra parameter for enemy distance from ship.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added reduced detail for enemies that are small on screen.
+ * Added a rotated copy stride parameter for drawing.
+ * Added a function for getting the radius without the shape.
+ * Changed reduced detail to blend points built when loading.
  */
 
 
@@ -64,6 +70,13 @@ class Enemy {
          *   completed explosion, in the range [0,1].
          * @param outRotationRate pointer to where the enemy rotation
          *   rate should be returned.
+         * @param inPixelsPerUnit how many pixels one unit of the shape
+         *   will cover on screen, for reducing detail, or 0 for full
+         *   detail.  Defaults to 0.
+         * @param inRotatedCopyStride how many rotated copies to step over
+         *   for each one returned, as for
+         *   ObjectParameterSpaceControlPoint::getDrawableObjects.
+         *   Defaults to 1.
          *
          * @return this enemy as a collection of drawable objects.
          *   Vector and objects must be destroyed by caller.
@@ -73,7 +86,26 @@ class Enemy {
             double inEnemyDistanceFromShipParameter,
             double inExplosionShapeParameter,
             double inExplosionProgress,
-            double *outRotationRate );
+            double *outRotationRate,
+            double inPixelsPerUnit = 0,
+            int inRotatedCopyStride = 1 );
+
+
+
+        /**
+         * Gets the radius and rotation rate of this enemy, as
+         * getDrawableObjects would give them, without building its shape.
+         *
+         * Parameters are the same as for getDrawableObjects.
+         *
+         * @return the largest distance of any border vertex of any
+         *   rotated copy from the center of the enemy, before scaling.
+         */
+        double getRadius( double inEnemyShapeParameter,
+                          double inEnemyDistanceFromShipParameter,
+                          double inExplosionShapeParameter,
+                          double inExplosionProgress,
+                          double *outRotationRate );
 
 
         
@@ -83,6 +115,28 @@ class Enemy {
         ParameterizedObject *mEnemyFarShapeObject;
         ParameterizedObject *mExplosionShapeObject;
 
+
+
+        
+        /**
+         * Blends the enemy and explosion shapes.
+         *
+         * Parameters are the same as for getDrawableObjects, except:
+         *
+         * @param inTolerance the detail tolerance to blend reduced points
+         *   for, as for ParameterizedObject::getBlendedControlPoint, or 0
+         *   for full detail.
+         *
+         * @return the blended control point.
+         *   Must be destroyed by caller.
+         */
+        ObjectParameterSpaceControlPoint *getBlendedControlPoint(
+            double inEnemyShapeParameter,
+            double inEnemyDistanceFromShipParameter,
+            double inExplosionShapeParameter,
+            double inExplosionProgress,
+            double inTolerance );
+
         
     };
 
@@ -44,12 +44,23 @@
  * Added fade-in upon enemy creation.
  * Fixed bug when enemy distance to target is 0.
  * Made target-switching rotations smooth.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added interpolation between simulation steps when drawing.
+ * Changed to update batches of enemies in parallel, holding fired
+ * bullets and explosion sounds until all enemies are updated.
+ * Added skipping of enemies that are off screen when drawing.
+ * Added reduced detail for enemies that are small on screen.
+ * Added a rotated copy stride for drawing with reduced quality.
+ * Radius and rotation rate measured in each step rather than when
+ * drawing, so that collisions do not depend on what is on screen.
  */
 
 
 
 #include "EnemyManager.h"
 #include "ShipBulletManager.h"
+#include "RenderInterpolation.h"
 
 
 
@@ -57,6 +68,98 @@
 
 
 
+// the number of enemies updated by each job in passTime
+// levels with fewer enemies than this are updated on the calling thread
+static const int enemiesPerUpdateJob = 64;
+
+
+
+/**
+ * A job that updates one batch of enemies.
+ */
+class EnemyUpdateJob : public ThreadPoolJob {
+
+    public:
+
+        EnemyUpdateJob( EnemyManager *inManager,
+                        int inStartIndex, int inEndIndex,
+                        double inTimeDeltaInSeconds,
+                        Vector3D *inShipPosition )
+            : mManager( inManager ),
+              mStartIndex( inStartIndex ), mEndIndex( inEndIndex ),
+              mTimeDeltaInSeconds( inTimeDeltaInSeconds ),
+              mShipPosition( inShipPosition ),
+              mEvents( new SimpleVector<EnemyStepEvent *>() ) {
+            }
+
+        
+        ~EnemyUpdateJob() {
+            int numEvents = mEvents->size();
+            for( int i=0; i<numEvents; i++ ) {
+                delete *( mEvents->getElement( i ) );
+                }
+            delete mEvents;
+            }
+
+        
+        // implements the ThreadPoolJob interface
+        virtual void run( int inThreadIndex ) {
+            mManager->updateEnemies( mStartIndex, mEndIndex,
+                                     mTimeDeltaInSeconds, mShipPosition,
+                                     mEvents );
+            }
+
+        
+        EnemyManager *mManager;
+        int mStartIndex;
+        int mEndIndex;
+        double mTimeDeltaInSeconds;
+        Vector3D *mShipPosition;
+
+        // the events of this batch, in enemy order
+        SimpleVector<EnemyStepEvent *> *mEvents;
+    };
+
+
+
+EnemyStepEvent::EnemyStepEvent( int inEnemyIndex )
+    : mEnemyIndex( inEnemyIndex ),
+      mIsBullet( false ),
+      mBulletPosition( NULL ), mBulletRotation( NULL ),
+      mBulletVelocity( NULL ) {
+
+    }
+
+
+
+EnemyStepEvent::EnemyStepEvent( int inEnemyIndex,
+                                Vector3D *inBulletPosition,
+                                Angle3D *inBulletRotation,
+                                Vector3D *inBulletVelocity )
+    : mEnemyIndex( inEnemyIndex ),
+      mIsBullet( true ),
+      mBulletPosition( inBulletPosition ),
+      mBulletRotation( inBulletRotation ),
+      mBulletVelocity( inBulletVelocity ) {
+
+    }
+
+
+
+EnemyStepEvent::~EnemyStepEvent() {
+    if( mBulletPosition != NULL ) {
+        delete mBulletPosition;
+        }
+    if( mBulletRotation != NULL ) {
+        delete mBulletRotation;
+        }
+    if( mBulletVelocity != NULL ) {
+        delete mBulletVelocity;
+        }
+    }
+
+
+
 EnemyManager::EnemyManager( Enemy *inEnemyTemplate,
                             double inEnemyScale,
                             double inExplosionScale,
@@ -96,7 +199,12 @@ EnemyManager::EnemyManager( Enemy *inEnemyTemplate,
       mCurrentPositions( new SimpleVector<Vector3D*>() ),
       mCurrentAnglesToPointAt( new SimpleVector<Angle3D*>() ),
       mCurrentRadii( new SimpleVector<double>() ),
+      mViewBounds( NULL ),
+      mNumCulled( 0 ),
+      mNumDrawn( 0 ),
       mCurrentRotations( new SimpleVector<Angle3D*>() ),
+      mPreviousPositions( new SimpleVector<Vector3D*>() ),
+      mPreviousRotations( new SimpleVector<Angle3D*>() ),
       mCurrentRotationRates( new SimpleVector<double>() ),
       mSholdBeDestroyedFlags( new SimpleVector<char>() ),
       mShipDistanceParameters( new SimpleVector<double>() ) {
@@ -153,11 +261,15 @@ EnemyManager::~EnemyManager() {
         delete *( mCurrentPositions->getElement( i ) );
         delete *( mCurrentAnglesToPointAt->getElement( i ) );
         delete *( mCurrentRotations->getElement( i ) );
+        delete *( mPreviousPositions->getElement( i ) );
+        delete *( mPreviousRotations->getElement( i ) );
         }
 
     delete mCurrentPositions;
     delete mCurrentAnglesToPointAt;
     delete mCurrentRotations;
+    delete mPreviousPositions;
+    delete mPreviousRotations;
     delete mCurrentRadii;
     
     delete mCurrentRotationRates;
@@ -199,6 +311,10 @@ void EnemyManager::addEnemy(
     mCurrentPositions->push_back( inStartingPosition );
     mCurrentAnglesToPointAt->push_back( new Angle3D( inStartingRotation ) );
     mCurrentRadii->push_back( 0 );
+
+    // new enemies have no earlier state to blend from
+    mPreviousPositions->push_back( new Vector3D( inStartingPosition ) );
+    mPreviousRotations->push_back( new Angle3D( inStartingRotation ) );
     
     mSholdBeDestroyedFlags->push_back( false );
 
@@ -224,18 +340,140 @@ int EnemyManager::getEnemyCount() {
 
 
 void EnemyManager::passTime( double inTimeDeltaInSeconds,
-                             Vector3D *inShipPosition ) {
+                             Vector3D *inShipPosition,
+                             WorkStealingThreadPool *inPool,
+                             int inThreadIndex ) {
 
     int numEnemies = mCurrentPositions->size();
 
+    int numJobs =
+        ( numEnemies + enemiesPerUpdateJob - 1 ) / enemiesPerUpdateJob;
+
+    EnemyUpdateJob **jobs = new EnemyUpdateJob*[ numJobs ];
+
+    int i;
+    for( i=0; i<numJobs; i++ ) {
+        int endIndex = ( i + 1 ) * enemiesPerUpdateJob;
+        if( endIndex > numEnemies ) {
+            endIndex = numEnemies;
+            }
+        
+        jobs[i] = new EnemyUpdateJob( this, i * enemiesPerUpdateJob,
+                                      endIndex,
+                                      inTimeDeltaInSeconds,
+                                      inShipPosition );
+        }
+
+    if( inPool == NULL || numJobs < 2 ) {
+        for( i=0; i<numJobs; i++ ) {
+            jobs[i]->run( inThreadIndex );
+            }
+        }
+    else {
+        ThreadPoolJobGroup *group = new ThreadPoolJobGroup();
+        group->addJobs( numJobs );
+
+        // add in reverse so that we start on the first batch ourself
+        for( i=numJobs-1; i>=0; i-- ) {
+            inPool->addJob( jobs[i], group, inThreadIndex );
+            }
+
+        inPool->runUntilDone( group, inThreadIndex );
+
+        delete group;
+        }
+
+    
+    // fire bullets and play sounds in enemy order, exactly as if the
+    // enemies had been updated one at a time
+    for( i=0; i<numJobs; i++ ) {
+        SimpleVector<EnemyStepEvent *> *events = jobs[i]->mEvents;
+
+        int numEvents = events->size();
+        for( int e=0; e<numEvents; e++ ) {
+            applyStepEvent( *( events->getElement( e ) ) );
+            }
+        
+        delete jobs[i];
+        }
+    delete [] jobs;
+
+    // walk through vectors and destroy enemies that are flagged
+    // note that our loop range is adjusted as the vector length shrinks
+    for( i=0; i<mEnemyShapeParameters->size(); i++ ) {
+        if( *( mSholdBeDestroyedFlags->getElement( i ) ) ) {
+
+            mEnemyShapeParameters->deleteElement( i );
+            mExplosionShapeParameters->deleteElement( i );
+
+            mCurrentlyExplodingFlags->deleteElement( i );
+            mExplosionTimesInSeconds->deleteElement( i );
+            mExplosionProgress->deleteElement( i );
+            mFadeProgress->deleteElement( i );
+
+            mBulletCloseParameters->deleteElement( i );
+            mBulletFarParameters->deleteElement( i );
+            mTimesSinceLastBullet->deleteElement( i );
+            
+            delete *( mCurrentRotations->getElement( i ) );
+            mCurrentRotations->deleteElement( i );
+
+            mCurrentRotationRates->deleteElement( i );
+
+            delete *( mCurrentPositions->getElement( i ) );
+            mCurrentPositions->deleteElement( i );
+
+            delete *( mCurrentAnglesToPointAt->getElement( i ) );
+            mCurrentAnglesToPointAt->deleteElement( i );
+            
+            mCurrentRadii->deleteElement( i );
+
+            delete *( mPreviousPositions->getElement( i ) );
+            mPreviousPositions->deleteElement( i );
+
+            delete *( mPreviousRotations->getElement( i ) );
+            mPreviousRotations->deleteElement( i );
+            
+            mSholdBeDestroyedFlags->deleteElement( i );
+            mShipDistanceParameters->deleteElement( i );
+            }
+        }
+    }
+
+
+
+void EnemyManager::updateEnemies(
+    int inStartIndex, int inEndIndex,
+    double inTimeDeltaInSeconds,
+    Vector3D *inShipPosition,
+    SimpleVector<EnemyStepEvent *> *outEvents ) {
+
     Vector3D *centerPosition = new Vector3D( 0, 0, 0 );
     
     int i;
-    for( i=0; i<numEnemies; i++ ) {
+    for( i=inStartIndex; i<inEndIndex; i++ ) {
     
-        Angle3D *currentRotation = *( mCurrentRotations->getElement( i ) );
+        // measure our shape here rather than when drawing, so that
+        // collisions do not depend on which enemies are on screen
+        double explosionProgress = *( mExplosionProgress->getElement( i ) );
+        double scale =
+            explosionProgress * mExplosionScale +
+            ( 1 - explosionProgress ) * mEnemyScale;
+
+        double rotationRate;
+        double radius =
+            mEnemyTemplate->getRadius(
+                *( mEnemyShapeParameters->getElement( i ) ),
+                *( mShipDistanceParameters->getElement( i ) ),
+                *( mExplosionShapeParameters->getElement( i ) ),
+                explosionProgress,
+                &rotationRate );
+
+        *( mCurrentRadii->getElement( i ) ) = fabs( scale ) * radius;
+        *( mCurrentRotationRates->getElement( i ) ) = rotationRate;
 
-        double rotationRate = *( mCurrentRotationRates->getElement( i ) );
+        
+        Angle3D *currentRotation = *( mCurrentRotations->getElement( i ) );
         
         currentRotation->mZ += rotationRate * inTimeDeltaInSeconds;
 
@@ -486,14 +724,11 @@ void EnemyManager::passTime( double inTimeDeltaInSeconds,
                         new Vector3D( 0, -bulletMoveRate, 0 );
                     bulletVelocityVector->rotate( angleToPointAt );
                     
-                    mEnemyBulletManager->addBullet(
-                        *( mBulletCloseParameters->getElement( i ) ),
-                        *( mBulletFarParameters->getElement( i ) ),
-                        1,
-                        mEnemyBulletRange,
-                        new Vector3D( currentPosition ),
-                        new Angle3D( angleToPointAt ),
-                        bulletVelocityVector );
+                    outEvents->push_back(
+                        new EnemyStepEvent( i,
+                                            new Vector3D( currentPosition ),
+                                            new Angle3D( angleToPointAt ),
+                                            bulletVelocityVector ) );
                 
                     timeSinceLastFire = 0;
                     }
@@ -525,18 +760,7 @@ void EnemyManager::passTime( double inTimeDeltaInSeconds,
                 *( mCurrentlyExplodingFlags->getElement( i ) ) = true;
 
                 // play the sound
-                PlayableSound *sound =
-                    mEnemyExplosionSoundTemplate->getPlayableSound(
-                        *( mBulletCloseParameters->getElement( i ) ),
-                        *( mBulletFarParameters->getElement( i ) ),
-                        mSoundPlayer->getSampleRate() );
-
-                // enemy explosion is low priority
-                mSoundPlayer->playSoundNow(
-                    sound, false, 1 );
-                //*( mExplosionShapeParameters->getElement( i ) ) );
-
-                delete sound;
+                outEvents->push_back( new EnemyStepEvent( i ) );
                 }
             }
         
@@ -642,55 +866,110 @@ void EnemyManager::passTime( double inTimeDeltaInSeconds,
         
         }
 
-    
-    // walk through vectors and destroy enemies that are flagged
-    // note that our loop range is adjusted as the vector length shrinks
-    for( i=0; i<mEnemyShapeParameters->size(); i++ ) {
-        if( *( mSholdBeDestroyedFlags->getElement( i ) ) ) {
+    delete centerPosition;
+    }
 
-            mEnemyShapeParameters->deleteElement( i );
-            mExplosionShapeParameters->deleteElement( i );
 
-            mCurrentlyExplodingFlags->deleteElement( i );
-            mExplosionTimesInSeconds->deleteElement( i );
-            mExplosionProgress->deleteElement( i );
-            mFadeProgress->deleteElement( i );
 
-            mBulletCloseParameters->deleteElement( i );
-            mBulletFarParameters->deleteElement( i );
-            mTimesSinceLastBullet->deleteElement( i );
-            
-            delete *( mCurrentRotations->getElement( i ) );
-            mCurrentRotations->deleteElement( i );
+void EnemyManager::applyStepEvent( EnemyStepEvent *inEvent ) {
+    int i = inEvent->mEnemyIndex;
+    
+    if( inEvent->mIsBullet ) {
+        // bullet manager takes the bullet's vectors
+        mEnemyBulletManager->addBullet(
+            *( mBulletCloseParameters->getElement( i ) ),
+            *( mBulletFarParameters->getElement( i ) ),
+            1,
+            mEnemyBulletRange,
+            inEvent->mBulletPosition,
+            inEvent->mBulletRotation,
+            inEvent->mBulletVelocity );
+
+        inEvent->mBulletPosition = NULL;
+        inEvent->mBulletRotation = NULL;
+        inEvent->mBulletVelocity = NULL;
+        }
+    else {
+        // explosion sound
+        PlayableSound *sound =
+            mEnemyExplosionSoundTemplate->getPlayableSound(
+                *( mBulletCloseParameters->getElement( i ) ),
+                *( mBulletFarParameters->getElement( i ) ),
+                mSoundPlayer->getSampleRate() );
+
+        // enemy explosion is low priority
+        mSoundPlayer->playSoundNow(
+            sound, false, 1 );
+        //*( mExplosionShapeParameters->getElement( i ) ) );
+
+        delete sound;
+        }
+    }
 
-            mCurrentRotationRates->deleteElement( i );
 
-            delete *( mCurrentPositions->getElement( i ) );
-            mCurrentPositions->deleteElement( i );
 
-            delete *( mCurrentAnglesToPointAt->getElement( i ) );
-            mCurrentAnglesToPointAt->deleteElement( i );
-            
-            mCurrentRadii->deleteElement( i );
-            
-            mSholdBeDestroyedFlags->deleteElement( i );
-            mShipDistanceParameters->deleteElement( i );
-            }
-        }
+void EnemyManager::saveInterpolationState() {
+    int numEnemies = mCurrentPositions->size();
+
+    for( int i=0; i<numEnemies; i++ ) {
+        delete *( mPreviousPositions->getElement( i ) );
+        *( mPreviousPositions->getElement( i ) ) =
+            new Vector3D( *( mCurrentPositions->getElement( i ) ) );
 
-    delete centerPosition;        
+        delete *( mPreviousRotations->getElement( i ) );
+        *( mPreviousRotations->getElement( i ) ) =
+            new Angle3D( *( mCurrentRotations->getElement( i ) ) );
+        }
     }
 
 
 
-SimpleVector<DrawableObject*> *EnemyManager::getDrawableObjects() {
+SimpleVector<DrawableObject*> *EnemyManager::getDrawableObjects(
+    double inInterpolation, int inRotatedCopyStride ) {
 
     SimpleVector<DrawableObject*> *returnVector =
         new SimpleVector<DrawableObject*>();
     
     int numEnemies = mEnemyShapeParameters->size();
 
+    mNumCulled = 0;
+    mNumDrawn = 0;
+    
     for( int i=0; i<numEnemies; i++ ) {
+        Vector3D *position = RenderInterpolation::interpolatePosition(
+            *( mPreviousPositions->getElement( i ) ),
+            *( mCurrentPositions->getElement( i ) ),
+            inInterpolation );
+
+        // skip enemies that are entirely off screen, but not exploding
+        // ones, which grow between steps
+        double radius = *( mCurrentRadii->getElement( i ) );
+        
+        if( mViewBounds != NULL &&
+            radius > 0 &&
+            *( mExplosionProgress->getElement( i ) ) == 0 &&
+            ! mViewBounds->isCircleVisible( position, radius ) ) {
+
+            mNumCulled++;
+            
+            delete position;
+            continue;
+            }
+
+        mNumDrawn++;
+        
+        // compute the scale by weighting the enemy and explosion scales
+        double explosionProgress = *( mExplosionProgress->getElement( i ) );
+        double scale =
+            explosionProgress * mExplosionScale +
+            ( 1 - explosionProgress ) * mEnemyScale;
+
+        // full detail unless we know how large the enemy is on screen
+        double pixelsPerUnit = 0;
+        if( mViewBounds != NULL ) {
+            pixelsPerUnit = mViewBounds->mPixelsPerUnit * scale;
+            }
+        
         double currentRotationRate;
         
         SimpleVector<DrawableObject *> *enemyObjects =
@@ -698,52 +977,59 @@ SimpleVector<DrawableObject*> *EnemyManager::getDrawableObjects() {
                 *( mEnemyShapeParameters->getElement( i ) ),
                 *( mShipDistanceParameters->getElement( i ) ),
                 *( mExplosionShapeParameters->getElement( i ) ),
-                *( mExplosionProgress->getElement( i ) ),
-                &currentRotationRate );
-
-        *( mCurrentRotationRates->getElement( i ) ) = currentRotationRate;
+                explosionProgress,
+                &currentRotationRate,
+                pixelsPerUnit,
+                inRotatedCopyStride );
 
         // fade out at end of explosion
         double fadeValue = *( mFadeProgress->getElement( i ) );
         double alphaMultiplier = 1 - fadeValue;
 
         
-        // compute the scale by weighting the enemy and explosion scales
-        double explosionProgress = *( mExplosionProgress->getElement( i ) );
-        double scale =
-            explosionProgress * mExplosionScale +
-            ( 1 - explosionProgress ) * mEnemyScale;
+        Angle3D *rotation = RenderInterpolation::interpolateRotation(
+            *( mPreviousRotations->getElement( i ) ),
+            *( mCurrentRotations->getElement( i ) ),
+            inInterpolation );
 
         
         int numObjects = enemyObjects->size();
 
-        // compute the maximum radius of this enemy
-        double maxRadius = 0;
-        
         for( int j=0; j<numObjects; j++ ) {
 
             DrawableObject *currentObject =
                 *( enemyObjects->getElement( j ) );
 
             currentObject->scale( scale );
-            currentObject->rotate( *( mCurrentRotations->getElement( i ) ) );
-            currentObject->move( *( mCurrentPositions->getElement( i ) ) );
+            currentObject->rotate( rotation );
+            currentObject->move( position );
             currentObject->fade( alphaMultiplier );
 
-            double radius = currentObject->getBorderMaxDistance(
-                *( mCurrentPositions->getElement( i ) ) );
-
-            if( radius > maxRadius ) {
-                maxRadius = radius;
-                }
-            
             returnVector->push_back( currentObject );
             }
 
-        *( mCurrentRadii->getElement( i ) ) = maxRadius;
-        
+        delete position;
+        delete rotation;
         delete enemyObjects;
         }
 
     return returnVector;
     }
+
+
+
+void EnemyManager::setViewBounds( ViewBounds *inBounds ) {
+    mViewBounds = inBounds;
+    }
+
+
+
+int EnemyManager::getNumCulled() {
+    return mNumCulled;
+    }
+
+
+
+int EnemyManager::getNumDrawn() {
+    return mNumDrawn;
+    }
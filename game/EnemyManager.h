@@ -19,6 +19,16 @@
  * 2005-August-21   Jason Rohrer
  * Added fade-in upon enemy creation.
  * Made target-switching rotations smooth.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added interpolation between simulation steps when drawing.
+ * Changed to update batches of enemies in parallel, holding fired
+ * bullets and explosion sounds until all enemies are updated.
+ * Added skipping of enemies that are off screen when drawing.
+ * Added reduced detail for enemies that are small on screen.
+ * Added a rotated copy stride for drawing with reduced quality.
+ * Radius and rotation rate measured in each step rather than when
+ * drawing, so that collisions do not depend on what is on screen.
  */
 
 
@@ -34,6 +44,8 @@
 #include "SculptureManager.h"
 #include "SoundPlayer.h"
 #include "SoundSamples.h"
+#include "WorkStealingThreadPool.h"
+#include "ViewBounds.h"
 
 #include "minorGems/util/SimpleVector.h"
 #include "minorGems/math/geometry/Vector3D.h"
@@ -41,6 +53,59 @@
 
 
 
+/**
+ * A bullet fired or an explosion sound started by one enemy, held
+ * until all enemies have been updated.
+ *
+ * @author Jason Rohrer.
+ */
+class EnemyStepEvent {
+
+    public:
+
+
+        
+        /**
+         * Constructs an explosion sound event.
+         *
+         * @param inEnemyIndex the index of the exploding enemy.
+         */
+        EnemyStepEvent( int inEnemyIndex );
+
+
+
+        /**
+         * Constructs a fired bullet event.
+         *
+         * @param inEnemyIndex the index of the firing enemy.
+         * @param inBulletPosition, inBulletRotation, inBulletVelocity the
+         *   starting state of the bullet.
+         *   Will be destroyed by this class.
+         */
+        EnemyStepEvent( int inEnemyIndex,
+                        Vector3D *inBulletPosition,
+                        Angle3D *inBulletRotation,
+                        Vector3D *inBulletVelocity );
+
+
+
+        ~EnemyStepEvent();
+
+
+        
+        int mEnemyIndex;
+
+        // true for a fired bullet, false for an explosion sound
+        char mIsBullet;
+
+        // NULL for explosion sounds
+        Vector3D *mBulletPosition;
+        Angle3D *mBulletRotation;
+        Vector3D *mBulletVelocity;
+    };
+
+
+
 /**
  * A class that manages and draws all enemies in the environment.
  *
@@ -147,13 +212,60 @@ class EnemyManager {
         /**
          * Tell this manager that time has passed.
          *
+         * Enemies are updated in batches that can run on different
+         * threads.  Results are the same no matter how many threads
+         * are used.
+         *
          * @param inTimeDeltaInSeconds the amount of time that has passed.
          * @param inShipPosition the position of the ship (enemies head
          *   toward it).
          *   Must be destroyed by caller.
+         * @param inPool the pool to update batches on, or NULL to update
+         *   all enemies on the calling thread.
+         *   Defaults to NULL.
+         *   Must be destroyed by caller.
+         * @param inThreadIndex the index of the calling thread in
+         *   inPool.  Defaults to 0.
          */
         void passTime( double inTimeDeltaInSeconds,
-                       Vector3D *inShipPosition );
+                       Vector3D *inShipPosition,
+                       WorkStealingThreadPool *inPool = NULL,
+                       int inThreadIndex = 0 );
+
+
+
+        /**
+         * Updates one batch of enemies.  Called by the jobs started
+         * in passTime.
+         *
+         * Touches only the state of enemies in the batch, so batches
+         * can be updated at the same time.
+         *
+         * @param inStartIndex the index of the first enemy in the batch.
+         * @param inEndIndex the index one past the last enemy in
+         *   the batch.
+         * @param inTimeDeltaInSeconds the amount of time that has passed.
+         * @param inShipPosition the position of the ship.
+         *   Must be destroyed by caller.
+         * @param outEvents the vector to add bullets fired and sounds
+         *   started by the batch to, in enemy order.
+         *   Must be destroyed by caller.
+         */
+        void updateEnemies( int inStartIndex, int inEndIndex,
+                            double inTimeDeltaInSeconds,
+                            Vector3D *inShipPosition,
+                            SimpleVector<EnemyStepEvent *> *outEvents );
+
+
+
+        /**
+         * Saves the current enemy positions and rotations so that
+         * drawing can blend between them and the results of the next
+         * simulation step.
+         *
+         * Should be called before each step.
+         */
+        void saveInterpolationState();
 
         
         
@@ -161,10 +273,58 @@ class EnemyManager {
          * Gets drawable objects for all enemies in their current
          * positions/states.
          *
+         * @param inInterpolation how far to place enemies between their
+         *   saved and current positions, in [0,1].
+         *   Defaults to 1 (current positions).
+         * @param inRotatedCopyStride how many rotated copies of each
+         *   shape to step over for each one drawn, for reducing quality.
+         *   Collision radii are not changed.  Defaults to 1.
+         *
          * @return all enemies as a collection of drawable objects.
          *   Vector and objects must be destroyed by caller.
          */
-        SimpleVector<DrawableObject *> *getDrawableObjects();
+        SimpleVector<DrawableObject *> *getDrawableObjects(
+            double inInterpolation = 1,
+            int inRotatedCopyStride = 1 );
+
+
+
+        /**
+         * Sets the part of the world that is on screen, so that
+         * getDrawableObjects can skip enemies outside of it, and draw
+         * enemies that are small on screen with less detail.
+         *
+         * Collision radii and rotation rates are measured in
+         * updateEnemies, so skipping an enemy does not change how it
+         * moves or collides.  Enemies that have not been stepped yet, or
+         * that are exploding, are never skipped, since their radius is
+         * unknown or changing.
+         *
+         * @param inBounds the bounds, or NULL to draw every enemy.
+         *   Must be destroyed by caller after it is replaced by another
+         *   call.
+         */
+        void setViewBounds( ViewBounds *inBounds );
+
+
+
+        /**
+         * Gets how many enemies the last call to getDrawableObjects
+         * skipped.
+         *
+         * @return the number skipped.
+         */
+        int getNumCulled();
+
+
+
+        /**
+         * Gets how many enemies the last call to getDrawableObjects
+         * returned objects for.
+         *
+         * @return the number drawn.
+         */
+        int getNumDrawn();
 
 
         
@@ -218,12 +378,23 @@ class EnemyManager {
         
         SimpleVector<double> *mCurrentRadii;
 
+        // NULL to draw everything
+        ViewBounds *mViewBounds;
+
+        // counts from the last getDrawableObjects
+        int mNumCulled;
+        int mNumDrawn;
+
 
         // rotation rates can vary across a enemy's lifespan, so we must
         // keep a current angle for each enemy and adjust the angle
         // for each time delta
         SimpleVector<Angle3D *> *mCurrentRotations;
 
+        // positions and rotations as of the last saveInterpolationState
+        SimpleVector<Vector3D *> *mPreviousPositions;
+        SimpleVector<Angle3D *> *mPreviousRotations;
+
 
         SimpleVector<double> *mCurrentRotationRates;
 
@@ -232,6 +403,17 @@ class EnemyManager {
         // parameters for each enemy in the range [0,1] representing
         // distance of enemy from the ship
         SimpleVector<double> *mShipDistanceParameters;
+
+
+
+        /**
+         * Fires the bullet or plays the sound of an event.
+         *
+         * @param inEvent the event.  Its bullet vectors are passed to
+         *   the bullet manager.
+         *   Must be destroyed by caller.
+         */
+        void applyStepEvent( EnemyStepEvent *inEvent );
     };
 
 
@@ -0,0 +1,650 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "FrameProfiler.h"
+
+
+#include "minorGems/util/stringUtils.h"
+
+
+#include <string.h>
+#include <stdlib.h>
+
+
+#ifdef WIN_32
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <sys/time.h>
+    #include <time.h>
+#endif
+
+
+
+// static init
+StaticFrameProfilerWrapper FrameProfiler::mWrapper;
+
+
+
+// for qsort
+static int compareDoubles( const void *inA, const void *inB ) {
+    double a = *( (double *)inA );
+    double b = *( (double *)inB );
+
+    if( a < b ) {
+        return -1;
+        }
+    else if( a > b ) {
+        return 1;
+        }
+    else {
+        return 0;
+        }
+    }
+
+
+
+// for qsort
+// '/' sorts before any character used in names, so children follow
+// their parents directly
+static int comparePathStats( const void *inA, const void *inB ) {
+    FrameProfilerPathStats *a = *( (FrameProfilerPathStats **)inA );
+    FrameProfilerPathStats *b = *( (FrameProfilerPathStats **)inB );
+
+    return strcmp( a->mPath, b->mPath );
+    }
+
+
+
+/**
+ * Gets an ID for the calling thread.
+ */
+static unsigned long getCurrentThreadID() {
+    #ifdef WIN_32
+        return (unsigned long)GetCurrentThreadId();
+    #else
+        return (unsigned long)pthread_self();
+    #endif
+    }
+
+
+
+FrameProfilerPathStats::FrameProfilerPathStats( char *inPath,
+                                                int inHistoryLength )
+    : mPath( stringDuplicate( inPath ) ), mDepth( 0 ),
+      mNumFrames( 0 ), mNumCalls( 0 ),
+      mHistory( new double[ inHistoryLength ] ),
+      mHistoryLength( inHistoryLength ),
+      mNumKept( 0 ), mNextIndex( 0 ) {
+
+    for( int i=0; mPath[i] != '\0'; i++ ) {
+        if( mPath[i] == '/' ) {
+            mDepth++;
+            }
+        }
+    }
+
+
+
+FrameProfilerPathStats::~FrameProfilerPathStats() {
+    delete [] mPath;
+    delete [] mHistory;
+    }
+
+
+
+void FrameProfilerPathStats::addFrame( double inMicroseconds,
+                                       int inNumCalls ) {
+    mHistory[ mNextIndex ] = inMicroseconds;
+    mNextIndex = ( mNextIndex + 1 ) % mHistoryLength;
+
+    if( mNumKept < mHistoryLength ) {
+        mNumKept++;
+        }
+
+    mNumFrames++;
+    mNumCalls += inNumCalls;
+    }
+
+
+
+int FrameProfilerPathStats::getSummary( double *outMin, double *outMean,
+                                        double *outP99 ) {
+    *outMin = 0;
+    *outMean = 0;
+    *outP99 = 0;
+
+    if( mNumKept == 0 ) {
+        return 0;
+        }
+
+    // the oldest frames are overwritten first, so order does not matter
+    double *sorted = new double[ mNumKept ];
+    memcpy( sorted, mHistory, mNumKept * sizeof( double ) );
+
+    qsort( sorted, mNumKept, sizeof( double ), compareDoubles );
+
+    double sum = 0;
+    for( int i=0; i<mNumKept; i++ ) {
+        sum += sorted[i];
+        }
+
+    int p99Index = (int)( 0.99 * ( mNumKept - 1 ) + 0.5 );
+
+    *outMin = sorted[0];
+    *outMean = sum / mNumKept;
+    *outP99 = sorted[ p99Index ];
+
+    delete [] sorted;
+
+    return mNumKept;
+    }
+
+
+
+StaticFrameProfilerWrapper::StaticFrameProfilerWrapper()
+    : mEnabled( false ),
+      mLock( new MutexLock() ),
+      mThreads( new SimpleVector<FrameProfilerThread *>() ),
+      mRecords( new SimpleVector<FrameProfilerRecord *>() ),
+      mFrameStartMicroseconds( -1 ),
+      mHistoryLength( 1000 ),
+      mPathStats( new SimpleVector<FrameProfilerPathStats *>() ),
+      mTraceFILE( NULL ),
+      mTraceStartMicroseconds( 0 ),
+      mNumTraceEvents( 0 ) {
+
+    }
+
+
+
+StaticFrameProfilerWrapper::~StaticFrameProfilerWrapper() {
+    // a trace left open when the game exits is still finished properly
+    FrameProfiler::stopTrace();
+
+    int i;
+
+    int numThreads = mThreads->size();
+    for( i=0; i<numThreads; i++ ) {
+        delete *( mThreads->getElement( i ) );
+        }
+    delete mThreads;
+
+    int numRecords = mRecords->size();
+    for( i=0; i<numRecords; i++ ) {
+        delete *( mRecords->getElement( i ) );
+        }
+    delete mRecords;
+
+    int numStats = mPathStats->size();
+    for( i=0; i<numStats; i++ ) {
+        delete *( mPathStats->getElement( i ) );
+        }
+    delete mPathStats;
+
+    delete mLock;
+    }
+
+
+
+void FrameProfiler::setEnabled( char inEnabled ) {
+    mWrapper.mEnabled = inEnabled;
+
+    // don't count the time while disabled in the next frame
+    mWrapper.mFrameStartMicroseconds = -1;
+    }
+
+
+
+char FrameProfiler::isEnabled() {
+    return mWrapper.mEnabled;
+    }
+
+
+
+void FrameProfiler::setHistoryLength( int inNumFrames ) {
+    if( inNumFrames < 1 ) {
+        inNumFrames = 1;
+        }
+
+    mWrapper.mHistoryLength = inNumFrames;
+
+    int numStats = mWrapper.mPathStats->size();
+    for( int i=0; i<numStats; i++ ) {
+        delete *( mWrapper.mPathStats->getElement( i ) );
+        }
+    mWrapper.mPathStats->deleteAll();
+    }
+
+
+
+FrameProfilerThread *FrameProfiler::getCallingThread() {
+    unsigned long threadID = getCurrentThreadID();
+
+    int numThreads = mWrapper.mThreads->size();
+    for( int i=0; i<numThreads; i++ ) {
+        FrameProfilerThread *thread = *( mWrapper.mThreads->getElement( i ) );
+
+        if( thread->mThreadID == threadID ) {
+            return thread;
+            }
+        }
+
+    FrameProfilerThread *thread =
+        new FrameProfilerThread( threadID, numThreads );
+    mWrapper.mThreads->push_back( thread );
+
+    return thread;
+    }
+
+
+
+FrameProfilerRecord *FrameProfiler::beginScope(
+    char *inName, FrameProfilerRecord *inParent ) {
+
+    if( ! mWrapper.mEnabled ) {
+        return NULL;
+        }
+
+    mWrapper.mLock->lock();
+
+    FrameProfilerThread *thread = getCallingThread();
+
+    FrameProfilerRecord *parent = inParent;
+
+    if( parent == NULL ) {
+        int numOpen = thread->mOpenScopes->size();
+        if( numOpen > 0 ) {
+            parent = *( thread->mOpenScopes->getElement( numOpen - 1 ) );
+            }
+        }
+
+    char *path;
+    int nameOffset;
+
+    if( parent != NULL ) {
+        nameOffset = strlen( parent->mPath ) + 1;
+
+        path = new char[ nameOffset + strlen( inName ) + 1 ];
+        sprintf( path, "%s/%s", parent->mPath, inName );
+        }
+    else {
+        path = stringDuplicate( inName );
+        nameOffset = 0;
+        }
+
+    FrameProfilerRecord *record =
+        new FrameProfilerRecord( path, nameOffset, thread->mNumber,
+                                 getCurrentMicroseconds() );
+
+    thread->mOpenScopes->push_back( record );
+    mWrapper.mRecords->push_back( record );
+
+    mWrapper.mLock->unlock();
+
+    return record;
+    }
+
+
+
+void FrameProfiler::endScope( FrameProfilerRecord *inRecord ) {
+    if( inRecord == NULL ) {
+        return;
+        }
+
+    double endTime = getCurrentMicroseconds();
+
+    mWrapper.mLock->lock();
+
+    inRecord->mEndMicroseconds = endTime;
+
+    FrameProfilerThread *thread = getCallingThread();
+
+    // scopes end in the reverse order that they began on each thread
+    int numOpen = thread->mOpenScopes->size();
+    if( numOpen > 0 ) {
+        thread->mOpenScopes->deleteElement( numOpen - 1 );
+        }
+
+    mWrapper.mLock->unlock();
+    }
+
+
+
+FrameProfilerRecord *FrameProfiler::getCurrentScope() {
+    if( ! mWrapper.mEnabled ) {
+        return NULL;
+        }
+
+    FrameProfilerRecord *scope = NULL;
+
+    mWrapper.mLock->lock();
+
+    FrameProfilerThread *thread = getCallingThread();
+
+    int numOpen = thread->mOpenScopes->size();
+    if( numOpen > 0 ) {
+        scope = *( thread->mOpenScopes->getElement( numOpen - 1 ) );
+        }
+
+    mWrapper.mLock->unlock();
+
+    return scope;
+    }
+
+
+
+FrameProfilerPathStats *FrameProfiler::getPathStats( char *inPath ) {
+    int numStats = mWrapper.mPathStats->size();
+
+    for( int i=0; i<numStats; i++ ) {
+        FrameProfilerPathStats *stats =
+            *( mWrapper.mPathStats->getElement( i ) );
+
+        if( strcmp( stats->mPath, inPath ) == 0 ) {
+            return stats;
+            }
+        }
+
+    FrameProfilerPathStats *stats =
+        new FrameProfilerPathStats( inPath, mWrapper.mHistoryLength );
+    mWrapper.mPathStats->push_back( stats );
+
+    return stats;
+    }
+
+
+
+void FrameProfiler::endFrame() {
+    double now = getCurrentMicroseconds();
+
+    // take the finished records, leaving those still running
+    SimpleVector<FrameProfilerRecord *> *finished =
+        new SimpleVector<FrameProfilerRecord *>();
+
+    mWrapper.mLock->lock();
+
+    SimpleVector<FrameProfilerRecord *> *stillRunning =
+        new SimpleVector<FrameProfilerRecord *>();
+
+    int numRecords = mWrapper.mRecords->size();
+    int i;
+    for( i=0; i<numRecords; i++ ) {
+        FrameProfilerRecord *record = *( mWrapper.mRecords->getElement( i ) );
+
+        if( record->mEndMicroseconds >= 0 ) {
+            finished->push_back( record );
+            }
+        else {
+            stillRunning->push_back( record );
+            }
+        }
+
+    delete mWrapper.mRecords;
+    mWrapper.mRecords = stillRunning;
+
+    mWrapper.mLock->unlock();
+
+
+    if( mWrapper.mEnabled && mWrapper.mFrameStartMicroseconds >= 0 ) {
+        getPathStats( "frame" )->addFrame(
+            now - mWrapper.mFrameStartMicroseconds, 1 );
+        }
+    mWrapper.mFrameStartMicroseconds = now;
+
+
+    // sum the time of each path, since a scope can run many times in
+    // one frame (like once per simulation step)
+    int numFinished = finished->size();
+
+    SimpleVector<FrameProfilerPathStats *> *framePaths =
+        new SimpleVector<FrameProfilerPathStats *>();
+    SimpleVector<double> *frameTimes = new SimpleVector<double>();
+    SimpleVector<int> *frameCalls = new SimpleVector<int>();
+
+    for( i=0; i<numFinished; i++ ) {
+        FrameProfilerRecord *record = *( finished->getElement( i ) );
+
+        FrameProfilerPathStats *stats = getPathStats( record->mPath );
+
+        double time =
+            record->mEndMicroseconds - record->mStartMicroseconds;
+
+        int index = -1;
+        int numPaths = framePaths->size();
+        for( int p=0; p<numPaths && index == -1; p++ ) {
+            if( *( framePaths->getElement( p ) ) == stats ) {
+                index = p;
+                }
+            }
+
+        if( index == -1 ) {
+            framePaths->push_back( stats );
+            frameTimes->push_back( time );
+            frameCalls->push_back( 1 );
+            }
+        else {
+            *( frameTimes->getElement( index ) ) += time;
+            *( frameCalls->getElement( index ) ) += 1;
+            }
+
+        if( mWrapper.mTraceFILE != NULL ) {
+            writeTraceEvent( record );
+            }
+
+        delete record;
+        }
+    delete finished;
+
+    int numPaths = framePaths->size();
+    for( i=0; i<numPaths; i++ ) {
+        ( *( framePaths->getElement( i ) ) )->addFrame(
+            *( frameTimes->getElement( i ) ),
+            *( frameCalls->getElement( i ) ) );
+        }
+
+    delete framePaths;
+    delete frameTimes;
+    delete frameCalls;
+    }
+
+
+
+char FrameProfiler::startTrace( char *inFileName ) {
+    stopTrace();
+
+    mWrapper.mTraceFILE = fopen( inFileName, "w" );
+
+    if( mWrapper.mTraceFILE == NULL ) {
+        printf( "Failed to open profile trace %s for writing\n",
+                inFileName );
+        return false;
+        }
+
+    mWrapper.mTraceStartMicroseconds = getCurrentMicroseconds();
+    mWrapper.mNumTraceEvents = 0;
+
+    fprintf( mWrapper.mTraceFILE, "{\"traceEvents\":[\n" );
+
+    return true;
+    }
+
+
+
+void FrameProfiler::stopTrace() {
+    if( mWrapper.mTraceFILE == NULL ) {
+        return;
+        }
+
+    fprintf( mWrapper.mTraceFILE, "\n],\"displayTimeUnit\":\"ms\"}\n" );
+    fclose( mWrapper.mTraceFILE );
+    mWrapper.mTraceFILE = NULL;
+
+    printf( "Wrote %lu events to profile trace\n", mWrapper.mNumTraceEvents );
+    }
+
+
+
+char FrameProfiler::isTracing() {
+    return ( mWrapper.mTraceFILE != NULL );
+    }
+
+
+
+void FrameProfiler::addTraceCounter( char *inName, double inValue ) {
+    if( mWrapper.mTraceFILE == NULL ) {
+        return;
+        }
+
+    if( mWrapper.mNumTraceEvents > 0 ) {
+        fprintf( mWrapper.mTraceFILE, ",\n" );
+        }
+
+    fprintf( mWrapper.mTraceFILE,
+             "{\"name\":\"%s\",\"cat\":\"counter\",\"ph\":\"C\","
+             "\"ts\":%.3f,\"pid\":1,\"args\":{\"value\":%f}}",
+             inName,
+             getCurrentMicroseconds() - mWrapper.mTraceStartMicroseconds,
+             inValue );
+
+    mWrapper.mNumTraceEvents++;
+    }
+
+
+
+void FrameProfiler::writeTraceEvent( FrameProfilerRecord *inRecord ) {
+    if( inRecord->mStartMicroseconds < mWrapper.mTraceStartMicroseconds ) {
+        // started before the trace did
+        return;
+        }
+
+    if( mWrapper.mNumTraceEvents > 0 ) {
+        fprintf( mWrapper.mTraceFILE, ",\n" );
+        }
+
+    // names are plain identifiers, so they need no escaping
+    // a complete ("X") event per scope, which the viewer nests by time
+    // on each thread
+    fprintf( mWrapper.mTraceFILE,
+             "{\"name\":\"%s\",\"cat\":\"frame\",\"ph\":\"X\","
+             "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d,"
+             "\"args\":{\"path\":\"%s\"}}",
+             inRecord->mName,
+             inRecord->mStartMicroseconds - mWrapper.mTraceStartMicroseconds,
+             inRecord->mEndMicroseconds - inRecord->mStartMicroseconds,
+             inRecord->mThreadNumber,
+             inRecord->mPath );
+
+    mWrapper.mNumTraceEvents++;
+    }
+
+
+
+// long enough for any line built by getSummaryLines
+static const int summaryLineLength = 200;
+
+
+
+SimpleVector<char *> *FrameProfiler::getSummaryLines() {
+    SimpleVector<char *> *lines = new SimpleVector<char *>();
+
+    char *header = new char[ summaryLineLength ];
+    sprintf( header, "%-36s %7s %7s %9s %9s %9s",
+             "scope (us per frame)", "frames", "calls",
+             "min", "mean", "p99" );
+    lines->push_back( header );
+
+    int numStats = mWrapper.mPathStats->size();
+
+    FrameProfilerPathStats **sorted =
+        mWrapper.mPathStats->getElementArray();
+
+    qsort( sorted, numStats, sizeof( FrameProfilerPathStats * ),
+           comparePathStats );
+
+    for( int i=0; i<numStats; i++ ) {
+        FrameProfilerPathStats *stats = sorted[i];
+
+        double min, mean, p99;
+        int numFrames = stats->getSummary( &min, &mean, &p99 );
+
+        double callsPerFrame = 0;
+        if( stats->mNumFrames > 0 ) {
+            callsPerFrame =
+                (double)stats->mNumCalls / (double)stats->mNumFrames;
+            }
+
+        // show only the last name in the path, indented by depth
+        char *name = strrchr( stats->mPath, '/' );
+        if( name != NULL ) {
+            name = &( name[1] );
+            }
+        else {
+            name = stats->mPath;
+            }
+
+        int indent = 2 * stats->mDepth;
+        if( indent > 30 ) {
+            indent = 30;
+            }
+
+        // names that don't fit the column are cut off
+        char *line = new char[ summaryLineLength ];
+        sprintf( line, "%*s%-*.*s %7d %7.1f %9.1f %9.1f %9.1f",
+                 indent, "", 36 - indent, 36 - indent, name,
+                 numFrames, callsPerFrame, min, mean, p99 );
+        lines->push_back( line );
+        }
+
+    delete [] sorted;
+
+    return lines;
+    }
+
+
+
+void FrameProfiler::printSummary() {
+    SimpleVector<char *> *lines = getSummaryLines();
+
+    int numLines = lines->size();
+    for( int i=0; i<numLines; i++ ) {
+        char *line = *( lines->getElement( i ) );
+
+        printf( "    %s\n", line );
+
+        delete [] line;
+        }
+    delete lines;
+    }
+
+
+
+double FrameProfiler::getCurrentMicroseconds() {
+    #ifdef WIN_32
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER count;
+
+        QueryPerformanceFrequency( &frequency );
+        QueryPerformanceCounter( &count );
+
+        return 1000000.0 * (double)count.QuadPart /
+            (double)frequency.QuadPart;
+    #elif defined( CLOCK_MONOTONIC )
+        // unaffected by changes to the wall clock
+        struct timespec time;
+        clock_gettime( CLOCK_MONOTONIC, &time );
+
+        return 1000000.0 * time.tv_sec + time.tv_nsec / 1000.0;
+    #else
+        struct timeval time;
+        gettimeofday( &time, NULL );
+
+        return 1000000.0 * time.tv_sec + time.tv_usec;
+    #endif
+    }
@@ -0,0 +1,505 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef FRAME_PROFILER_INCLUDED
+#define FRAME_PROFILER_INCLUDED
+
+
+
+#include "minorGems/util/SimpleVector.h"
+#include "minorGems/system/MutexLock.h"
+
+
+#include <stdio.h>
+
+
+
+/*
+ * Scoped timers are placed in code with these macros, which expand to
+ * nothing unless FRAME_PROFILER is defined (see FRAME_PROFILER_FLAG in
+ * Makefile.common), so that the profiler costs nothing when compiled out.
+ *
+ * Example:
+ *
+ *   void drawScene() {
+ *       FRAME_PROFILER_SCOPE( "draw" );
+ *       ...
+ *       }
+ */
+#ifdef FRAME_PROFILER
+
+    // two levels, so that __LINE__ is expanded before it is pasted
+    #define FRAME_PROFILER_CONCAT_INNER( inA, inB ) inA##inB
+    #define FRAME_PROFILER_CONCAT( inA, inB ) \
+        FRAME_PROFILER_CONCAT_INNER( inA, inB )
+
+    // times the rest of the enclosing block, nested inside whatever scope
+    // is open on the calling thread
+    #define FRAME_PROFILER_SCOPE( inName ) \
+        FrameProfilerScope FRAME_PROFILER_CONCAT( frameProfilerScope, \
+                                                  __LINE__ )( inName )
+
+    // times the rest of the enclosing block, nested inside a scope that
+    // was opened on another thread
+    #define FRAME_PROFILER_CHILD_SCOPE( inName, inParent ) \
+        FrameProfilerScope FRAME_PROFILER_CONCAT( frameProfilerScope, \
+                                                  __LINE__ )( inName, \
+                                                              inParent )
+
+    // the innermost scope open on the calling thread, for passing to
+    // FRAME_PROFILER_CHILD_SCOPE on another thread
+    #define FRAME_PROFILER_CURRENT_SCOPE() FrameProfiler::getCurrentScope()
+
+#else
+
+    #define FRAME_PROFILER_SCOPE( inName )
+    #define FRAME_PROFILER_CHILD_SCOPE( inName, inParent )
+    #define FRAME_PROFILER_CURRENT_SCOPE() NULL
+
+#endif
+
+
+
+/**
+ * One timed run of a scope.
+ *
+ * @author Jason Rohrer.
+ */
+class FrameProfilerRecord {
+
+    public:
+
+        /**
+         * Constructs a record for a scope that has just started.
+         *
+         * @param inPath the names of the enclosing scopes and this scope,
+         *   separated by '/'.
+         *   Will be destroyed by this class.
+         * @param inNameOffset the offset in inPath of this scope's name.
+         * @param inThreadNumber the profiler's number for the thread
+         *   that ran the scope.
+         * @param inStartMicroseconds the time the scope started.
+         */
+        FrameProfilerRecord( char *inPath, int inNameOffset,
+                             int inThreadNumber,
+                             double inStartMicroseconds )
+            : mPath( inPath ), mName( &( inPath[ inNameOffset ] ) ),
+              mThreadNumber( inThreadNumber ),
+              mStartMicroseconds( inStartMicroseconds ),
+              mEndMicroseconds( -1 ) {
+            }
+
+        ~FrameProfilerRecord() {
+            delete [] mPath;
+            }
+
+        char *mPath;
+
+        // points into mPath
+        char *mName;
+
+        int mThreadNumber;
+
+        double mStartMicroseconds;
+
+        // -1 while the scope is still running
+        double mEndMicroseconds;
+    };
+
+
+
+/**
+ * The time spent per frame in one path of the scope tree, over a
+ * window of recent frames.
+ *
+ * @author Jason Rohrer.
+ */
+class FrameProfilerPathStats {
+
+    public:
+
+        /**
+         * Constructs empty stats.
+         *
+         * @param inPath the path.
+         *   Must be destroyed by caller.
+         * @param inHistoryLength the number of frames to keep.
+         */
+        FrameProfilerPathStats( char *inPath, int inHistoryLength );
+
+        ~FrameProfilerPathStats();
+
+
+
+        /**
+         * Adds the total time spent in this path during one frame.
+         *
+         * @param inMicroseconds the time.
+         * @param inNumCalls the number of times the path's scope ran
+         *   during the frame.
+         */
+        void addFrame( double inMicroseconds, int inNumCalls );
+
+
+
+        /**
+         * Gets the minimum, mean, and 99th percentile time over the
+         * frames kept.
+         *
+         * @param outMin, outMean, outP99 pointers to where the times
+         *   should be returned.
+         *
+         * @return the number of frames kept.
+         */
+        int getSummary( double *outMin, double *outMean, double *outP99 );
+
+
+
+        char *mPath;
+
+        // the number of '/' separators in mPath
+        int mDepth;
+
+        // totals over all frames added, for the average calls per frame
+        unsigned long mNumFrames;
+        unsigned long mNumCalls;
+
+    protected:
+
+        // ring buffer of per-frame times
+        double *mHistory;
+        int mHistoryLength;
+        int mNumKept;
+        int mNextIndex;
+
+    };
+
+
+
+/**
+ * The open scopes of one thread.
+ */
+class FrameProfilerThread {
+
+    public:
+
+        FrameProfilerThread( unsigned long inThreadID, int inNumber )
+            : mThreadID( inThreadID ), mNumber( inNumber ),
+              mOpenScopes( new SimpleVector<FrameProfilerRecord *>() ) {
+            }
+
+        ~FrameProfilerThread() {
+            delete mOpenScopes;
+            }
+
+        unsigned long mThreadID;
+
+        // numbered in the order that threads are first seen
+        int mNumber;
+
+        // innermost last
+        SimpleVector<FrameProfilerRecord *> *mOpenScopes;
+    };
+
+
+
+/**
+ * A wrapper class to ensure destruction of profiler state at system exit.
+ */
+class StaticFrameProfilerWrapper {
+
+    public:
+
+        StaticFrameProfilerWrapper();
+
+        ~StaticFrameProfilerWrapper();
+
+        char mEnabled;
+
+        // protects mThreads and mRecords
+        MutexLock *mLock;
+
+        SimpleVector<FrameProfilerThread *> *mThreads;
+
+        // the records of the current frame, in the order they started
+        SimpleVector<FrameProfilerRecord *> *mRecords;
+
+        // the rest are only touched by the thread that calls endFrame
+
+        double mFrameStartMicroseconds;
+
+        int mHistoryLength;
+
+        SimpleVector<FrameProfilerPathStats *> *mPathStats;
+
+        // NULL if no trace is being written
+        FILE *mTraceFILE;
+        double mTraceStartMicroseconds;
+        unsigned long mNumTraceEvents;
+    };
+
+
+
+/**
+ * A class with static functions for timing nested scopes of code in
+ * each frame, across all threads.
+ *
+ * The scope records of each frame are combined into a tree by path
+ * (like "draw/drawObjects"), with the per-frame time of each path kept
+ * over a window of recent frames.  Records can also be written to a
+ * trace file in the Chrome trace event format (viewable in
+ * chrome://tracing or Perfetto).
+ *
+ * Scopes are normally opened with the FRAME_PROFILER_SCOPE macro.
+ *
+ * Scope functions are thread-safe.  The other functions must all be
+ * called from the same thread, normally the main thread.
+ *
+ * @author Jason Rohrer.
+ */
+class FrameProfiler {
+
+
+    public:
+
+
+
+        /**
+         * Sets whether scopes are recorded.  Defaults to false.
+         *
+         * @param inEnabled true to record scopes.
+         */
+        static void setEnabled( char inEnabled );
+
+
+
+        /**
+         * Gets whether scopes are recorded.
+         *
+         * @return true if enabled.
+         */
+        static char isEnabled();
+
+
+
+        /**
+         * Sets the number of recent frames that stats are kept for.
+         * Clears existing stats.
+         *
+         * @param inNumFrames the number of frames.  Defaults to 1000.
+         */
+        static void setHistoryLength( int inNumFrames );
+
+
+
+        /**
+         * Starts a scope on the calling thread.
+         *
+         * @param inName the name of the scope.
+         *   Must be destroyed by caller.
+         * @param inParent the scope to nest this scope inside, or NULL
+         *   to nest it inside the innermost scope open on the calling
+         *   thread.  inParent must stay open until this scope ends.
+         *   Defaults to NULL.
+         *
+         * @return a record to pass to endScope, or NULL if the profiler
+         *   is disabled.
+         */
+        static FrameProfilerRecord *beginScope(
+            char *inName, FrameProfilerRecord *inParent = NULL );
+
+
+
+        /**
+         * Ends a scope on the thread that began it.
+         *
+         * @param inRecord the record returned by beginScope, or NULL.
+         *   Will be destroyed by this class.
+         */
+        static void endScope( FrameProfilerRecord *inRecord );
+
+
+
+        /**
+         * Gets the innermost scope open on the calling thread.
+         *
+         * Used to nest scopes run on other threads (like thread pool
+         * jobs) inside the scope that started them.
+         *
+         * @return the scope, or NULL if none is open.
+         *   Will be destroyed by this class when the scope ends.
+         */
+        static FrameProfilerRecord *getCurrentScope();
+
+
+
+        /**
+         * Ends the current frame, adding the scopes that finished during
+         * it to the stats and the trace.
+         *
+         * Scopes still running on other threads are counted in the frame
+         * in which they finish.
+         *
+         * The time since the last call is counted under the path "frame".
+         */
+        static void endFrame();
+
+
+
+        /**
+         * Starts writing scope records to a trace file.
+         *
+         * @param inFileName the name of the file.
+         *   Must be destroyed by caller.
+         *
+         * @return true if the file was opened.
+         */
+        static char startTrace( char *inFileName );
+
+
+
+        /**
+         * Finishes and closes the trace file, if one is being written.
+         */
+        static void stopTrace();
+
+
+
+        /**
+         * Gets whether a trace is being written.
+         *
+         * @return true if tracing.
+         */
+        static char isTracing();
+
+
+
+
+        /**
+         * Writes the value of a counter to the trace file, if one is
+         * being written.  Shown as a graph alongside the scopes.
+         *
+         * @param inName the name of the counter, a plain identifier.
+         *   Must be destroyed by caller.
+         * @param inValue the current value.
+         */
+        static void addTraceCounter( char *inName, double inValue );
+
+
+
+        /**
+         * Gets the stats as lines of text, one per path, in tree order
+         * with children indented under their parents.
+         *
+         * @return the lines, with a header line first.
+         *   Must be destroyed by caller, along with the strings in it.
+         */
+        static SimpleVector<char *> *getSummaryLines();
+
+
+
+        /**
+         * Prints the stats to standard out.
+         */
+        static void printSummary();
+
+
+
+        /**
+         * Gets the current time from a monotonic clock, which the wall
+         * clock being set does not move.  All of the game's timings use
+         * this clock.
+         *
+         * @return the time in microseconds since an arbitrary start point.
+         */
+        static double getCurrentMicroseconds();
+
+
+
+    protected:
+
+        static StaticFrameProfilerWrapper mWrapper;
+
+
+
+        /**
+         * Gets the open scopes of the calling thread, adding them if
+         * this is the thread's first scope.
+         *
+         * Must be called with the profiler lock held.
+         *
+         * @return the thread's scopes.
+         *   Will be destroyed by this class.
+         */
+        static FrameProfilerThread *getCallingThread();
+
+
+
+        /**
+         * Finds the stats of a path, adding them if needed.
+         *
+         * @param inPath the path.
+         *   Must be destroyed by caller.
+         *
+         * @return the stats.
+         *   Will be destroyed by this class.
+         */
+        static FrameProfilerPathStats *getPathStats( char *inPath );
+
+
+
+        /**
+         * Writes one record to the trace file.
+         *
+         * @param inRecord the record.
+         *   Must be destroyed by caller.
+         */
+        static void writeTraceEvent( FrameProfilerRecord *inRecord );
+
+    };
+
+
+
+/**
+ * Times the life of this object as a profiler scope.
+ *
+ * Normally created with the FRAME_PROFILER_SCOPE macro.
+ *
+ * @author Jason Rohrer.
+ */
+class FrameProfilerScope {
+
+    public:
+
+        /**
+         * Begins a scope.
+         *
+         * @param inName the name of the scope.
+         *   Must be destroyed by caller.
+         * @param inParent the scope to nest inside, or NULL for the
+         *   innermost scope open on the calling thread.
+         *   Defaults to NULL.
+         */
+        FrameProfilerScope( char *inName,
+                            FrameProfilerRecord *inParent = NULL )
+            : mRecord( FrameProfiler::beginScope( inName, inParent ) ) {
+            }
+
+        ~FrameProfilerScope() {
+            FrameProfiler::endScope( mRecord );
+            }
+
+    protected:
+
+        FrameProfilerRecord *mRecord;
+    };
+
+
+
+#endif
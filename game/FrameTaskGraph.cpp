@@ -0,0 +1,171 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "FrameTaskGraph.h"
+#include "AllocationProfiler.h"
+
+
+#include "minorGems/util/stringUtils.h"
+
+
+#include <stdio.h>
+
+
+
+FrameTask::FrameTask( char *inName )
+    : mName( stringDuplicate( inName ) ),
+      mDependencies( new SimpleVector<FrameTask *>() ),
+      mDependents( new SimpleVector<FrameTask *>() ),
+      mRunMicroseconds( 0 ),
+      mPool( NULL ),
+      mProfilerParent( NULL ),
+      mLock( new MutexLock() ),
+      mNumUnfinishedDependencies( 0 ) {
+
+    }
+
+
+
+FrameTask::~FrameTask() {
+    delete [] mName;
+    delete mDependencies;
+    delete mDependents;
+    delete mLock;
+    }
+
+
+
+void FrameTask::addDependency( FrameTask *inTask ) {
+    mDependencies->push_back( inTask );
+    inTask->mDependents->push_back( this );
+    }
+
+
+
+void FrameTask::run( int inThreadIndex ) {
+    double startTime = FrameProfiler::getCurrentMicroseconds();
+
+    // profiled under the scope that ran the graph, whichever thread
+    // we are on
+    {
+        FRAME_PROFILER_CHILD_SCOPE( mName, mProfilerParent );
+        ALLOCATION_PROFILER_TAG( mName );
+
+        doWork( inThreadIndex );
+        }
+
+    mRunMicroseconds =
+        FrameProfiler::getCurrentMicroseconds() - startTime;
+
+
+    // queue dependents that were only waiting on us
+    // these are counted in the group from the start of the run, so
+    // the group cannot finish before they do
+    int numDependents = mDependents->size();
+    for( int i=0; i<numDependents; i++ ) {
+        FrameTask *dependent = *( mDependents->getElement( i ) );
+
+        dependent->mLock->lock();
+        dependent->mNumUnfinishedDependencies--;
+        char ready = ( dependent->mNumUnfinishedDependencies == 0 );
+        dependent->mLock->unlock();
+
+        if( ready ) {
+            mPool->addJob( dependent, mGroup, inThreadIndex );
+            }
+        }
+    }
+
+
+
+FrameTaskGraph::FrameTaskGraph()
+    : mTasks( new SimpleVector<FrameTask *>() ),
+      mGroup( new ThreadPoolJobGroup() ) {
+
+    }
+
+
+
+FrameTaskGraph::~FrameTaskGraph() {
+    int numTasks = mTasks->size();
+
+    for( int i=0; i<numTasks; i++ ) {
+        delete *( mTasks->getElement( i ) );
+        }
+    delete mTasks;
+
+    delete mGroup;
+    }
+
+
+
+void FrameTaskGraph::addTask( FrameTask *inTask ) {
+    mTasks->push_back( inTask );
+    }
+
+
+
+int FrameTaskGraph::getNumTasks() {
+    return mTasks->size();
+    }
+
+
+
+FrameTask *FrameTaskGraph::getTask( int inIndex ) {
+    return *( mTasks->getElement( inIndex ) );
+    }
+
+
+
+void FrameTaskGraph::run( WorkStealingThreadPool *inPool ) {
+    int numTasks = mTasks->size();
+
+    if( numTasks == 0 ) {
+        return;
+        }
+
+    FrameProfilerRecord *profilerParent = FRAME_PROFILER_CURRENT_SCOPE();
+
+    int numReady = 0;
+
+    int i;
+    for( i=0; i<numTasks; i++ ) {
+        FrameTask *task = *( mTasks->getElement( i ) );
+
+        task->mPool = inPool;
+        task->mProfilerParent = profilerParent;
+        task->mRunMicroseconds = 0;
+        task->mNumUnfinishedDependencies = task->mDependencies->size();
+
+        if( task->mNumUnfinishedDependencies == 0 ) {
+            numReady++;
+            }
+        }
+
+    if( numReady == 0 ) {
+        printf( "Error:  frame task graph has no task that can "
+                "start first\n" );
+        return;
+        }
+
+    mGroup->addJobs( numTasks );
+
+    // add in reverse, since each thread runs the newest job in its own
+    // queue first, so that tasks start in the order they were added
+    // when running on a single thread
+    for( i=numTasks-1; i>=0; i-- ) {
+        FrameTask *task = *( mTasks->getElement( i ) );
+
+        if( task->mNumUnfinishedDependencies == 0 ) {
+            inPool->addJob( task, mGroup, 0 );
+            }
+        }
+
+    inPool->runUntilDone( mGroup );
+    }
@@ -0,0 +1,187 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef FRAME_TASK_GRAPH_INCLUDED
+#define FRAME_TASK_GRAPH_INCLUDED
+
+
+
+#include "WorkStealingThreadPool.h"
+#include "FrameProfiler.h"
+
+
+#include "minorGems/util/SimpleVector.h"
+
+
+
+/**
+ * One update in a simulation step, like passing time in one manager.
+ *
+ * Subclasses implement doWork.
+ *
+ * @author Jason Rohrer.
+ */
+class FrameTask : public ThreadPoolJob {
+
+
+    public:
+
+
+
+        /**
+         * Constructs a task.
+         *
+         * @param inName the name of this task, used when reporting
+         *   problems.
+         *   Must be destroyed by caller.
+         */
+        FrameTask( char *inName );
+
+
+
+        virtual ~FrameTask();
+
+
+
+        /**
+         * Makes this task wait for another task to finish before starting.
+         *
+         * Both tasks must be in the same graph, and dependencies must
+         * not form a cycle.
+         *
+         * @param inTask the task to wait for.
+         *   Must be destroyed by caller after this task is destroyed.
+         */
+        void addDependency( FrameTask *inTask );
+
+
+
+        /**
+         * Performs the work of this task.
+         *
+         * Touches only state that no task running at the same time
+         * modifies.
+         *
+         * @param inThreadIndex the index of the pool thread running
+         *   this task.
+         */
+        virtual void doWork( int inThreadIndex ) = 0;
+
+
+
+        // implements the ThreadPoolJob interface
+        // runs doWork and then starts any dependents that are ready
+        virtual void run( int inThreadIndex );
+
+
+
+        char *mName;
+
+        SimpleVector<FrameTask *> *mDependencies;
+        SimpleVector<FrameTask *> *mDependents;
+
+        // the time taken by doWork during the last run of the graph
+        double mRunMicroseconds;
+
+        // the pool this task is running on
+        // set by FrameTaskGraph::run
+        WorkStealingThreadPool *mPool;
+
+        // the profiler scope that ran the graph, which the scope of this
+        // task is nested inside
+        // set by FrameTaskGraph::run
+        FrameProfilerRecord *mProfilerParent;
+
+        // protects mNumUnfinishedDependencies
+        MutexLock *mLock;
+        int mNumUnfinishedDependencies;
+
+    };
+
+
+
+/**
+ * A fixed set of tasks and their dependencies, run once per simulation
+ * step on a thread pool.
+ *
+ * Tasks with no path between them in the graph may run at the same time
+ * on different threads.  A task that becomes ready when another task
+ * finishes is queued on the thread that finished the other task, so
+ * chains of dependent tasks tend to stay on one thread.
+ *
+ * @author Jason Rohrer.
+ */
+class FrameTaskGraph {
+
+
+    public:
+
+        FrameTaskGraph();
+
+        ~FrameTaskGraph();
+
+
+
+        /**
+         * Adds a task to this graph.
+         *
+         * @param inTask the task to add.
+         *   Will be destroyed by this class.
+         */
+        void addTask( FrameTask *inTask );
+
+
+
+        /**
+         * Runs every task in this graph once, returning after all have
+         * finished.
+         *
+         * Must be called from the thread that constructed inPool.
+         *
+         * @param inPool the pool to run tasks on.
+         *   Must be destroyed by caller.
+         */
+        void run( WorkStealingThreadPool *inPool );
+
+
+
+        /**
+         * Gets the number of tasks in this graph.
+         *
+         * @return the number of tasks.
+         */
+        int getNumTasks();
+
+
+
+        /**
+         * Gets a task from this graph.
+         *
+         * @param inIndex the index of the task, in the order tasks
+         *   were added.
+         *
+         * @return the task.
+         *   Will be destroyed by this class.
+         */
+        FrameTask *getTask( int inIndex );
+
+
+
+    protected:
+
+        SimpleVector<FrameTask *> *mTasks;
+
+        // counts the tasks that have not finished during a run
+        ThreadPoolJobGroup *mGroup;
+
+    };
+
+
+
+#endif
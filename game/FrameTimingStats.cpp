@@ -0,0 +1,124 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "FrameTimingStats.h"
+
+
+#include "minorGems/util/stringUtils.h"
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+FrameTimingStats::FrameTimingStats( char *inName )
+    : mName( stringDuplicate( inName ) ),
+      mSamples( new SimpleVector<double>() ) {
+
+    }
+
+
+
+FrameTimingStats::~FrameTimingStats() {
+    delete [] mName;
+    delete mSamples;
+    }
+
+
+
+void FrameTimingStats::addSample( double inMicroseconds ) {
+    mSamples->push_back( inMicroseconds );
+    }
+
+
+
+char *FrameTimingStats::getName() {
+    return mName;
+    }
+
+
+
+double FrameTimingStats::getMean() {
+    int numSamples = mSamples->size();
+
+    if( numSamples == 0 ) {
+        return 0;
+        }
+
+    double sum = 0;
+    for( int i=0; i<numSamples; i++ ) {
+        sum += *( mSamples->getElement( i ) );
+        }
+
+    return sum / numSamples;
+    }
+
+
+
+// for qsort
+static int compareDoubles( const void *inA, const void *inB ) {
+    double a = *( (double *)inA );
+    double b = *( (double *)inB );
+
+    if( a < b ) {
+        return -1;
+        }
+    else if( a > b ) {
+        return 1;
+        }
+    else {
+        return 0;
+        }
+    }
+
+
+
+double FrameTimingStats::getPercentile( double *inSorted, int inNumSamples,
+                                        double inPercentile ) {
+    int index = (int)( ( inPercentile / 100 ) * ( inNumSamples - 1 ) + 0.5 );
+
+    return inSorted[ index ];
+    }
+
+
+
+void FrameTimingStats::printSummaryHeader() {
+    printf( "    %-16s %8s %10s %10s %10s %10s %10s\n",
+            "section (us)", "samples", "mean", "p50", "p90", "p99", "max" );
+    }
+
+
+
+void FrameTimingStats::printSummary() {
+    int numSamples = mSamples->size();
+
+    if( numSamples == 0 ) {
+        printf( "    %-16s %8d\n", mName, 0 );
+        return;
+        }
+
+    double *sorted = mSamples->getElementArray();
+
+    qsort( sorted, numSamples, sizeof( double ), compareDoubles );
+
+    double sum = 0;
+    for( int i=0; i<numSamples; i++ ) {
+        sum += sorted[i];
+        }
+
+    printf( "    %-16s %8d %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+            mName, numSamples,
+            sum / numSamples,
+            getPercentile( sorted, numSamples, 50 ),
+            getPercentile( sorted, numSamples, 90 ),
+            getPercentile( sorted, numSamples, 99 ),
+            sorted[ numSamples - 1 ] );
+
+    delete [] sorted;
+    }
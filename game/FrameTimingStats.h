@@ -0,0 +1,114 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef FRAME_TIMING_STATS_INCLUDED
+#define FRAME_TIMING_STATS_INCLUDED
+
+
+
+#include "minorGems/util/SimpleVector.h"
+
+
+
+/**
+ * A series of timings of one section of code, taken once per frame or
+ * once per simulation step, with percentile reporting.
+ *
+ * @author Jason Rohrer.
+ */
+class FrameTimingStats {
+
+
+    public:
+
+
+
+        /**
+         * Constructs an empty series.
+         *
+         * @param inName the name of the timed section, used when printing.
+         *   Must be destroyed by caller.
+         */
+        FrameTimingStats( char *inName );
+
+
+
+        ~FrameTimingStats();
+
+
+
+        /**
+         * Adds a timing to this series.
+         *
+         * @param inMicroseconds the time taken.
+         */
+        void addSample( double inMicroseconds );
+
+
+
+        /**
+         * Gets the name of this series.
+         *
+         * @return the name.
+         *   Will be destroyed by this class.
+         */
+        char *getName();
+
+
+
+        /**
+         * Gets the mean of this series.
+         *
+         * @return the mean in microseconds, or 0 if there are no samples.
+         */
+        double getMean();
+
+
+
+        /**
+         * Prints the mean, median, 90th and 99th percentile, and maximum
+         * of this series to standard out, in microseconds.
+         */
+        void printSummary();
+
+
+
+        /**
+         * Prints the header line for a table of printSummary lines.
+         */
+        static void printSummaryHeader();
+
+
+
+    protected:
+
+        char *mName;
+
+        SimpleVector<double> *mSamples;
+
+
+
+        /**
+         * Gets a percentile from sorted samples.
+         *
+         * @param inSorted the samples, in increasing order.
+         *   Must be destroyed by caller.
+         * @param inNumSamples the number of samples.  Must be at least 1.
+         * @param inPercentile the percentile in [0,100].
+         *
+         * @return the sample at that percentile.
+         */
+        static double getPercentile( double *inSorted, int inNumSamples,
+                                     double inPercentile );
+
+    };
+
+
+
+#endif
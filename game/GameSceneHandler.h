@@ -0,0 +1,718 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef GAME_SCENE_HANDLER_INCLUDED
+#define GAME_SCENE_HANDLER_INCLUDED
+
+
+
+#include "minorGems/graphics/openGL/ScreenGL.h"
+#include "minorGems/graphics/openGL/SceneHandlerGL.h"
+#include "minorGems/graphics/Color.h"
+#include "minorGems/math/geometry/Vector3D.h"
+#include "minorGems/math/geometry/Angle3D.h"
+#include "minorGems/util/SimpleVector.h"
+#include "minorGems/util/random/StdRandomSource.h"
+
+
+#include "ShipBulletManager.h"
+#include "EnemyManager.h"
+#include "SculptureManager.h"
+#include "BossManager.h"
+#include "PortalManager.h"
+#include "SoundPlayer.h"
+#include "SoundOutput.h"
+#include "OfflineSoundOutput.h"
+#include "AudioTelemetry.h"
+#include "MusicPlayer.h"
+#include "ReplayLog.h"
+#include "FrameTimingStats.h"
+#include "WorkStealingThreadPool.h"
+#include "FrameTaskGraph.h"
+#include "QualityGovernor.h"
+#include "GridRenderer.h"
+#include "ViewBounds.h"
+
+
+
+// defined in game.cpp
+class RenderBuildTask;
+
+
+
+/**
+ * The inputs of one simulation step that are shared by all manager
+ * step tasks.
+ */
+class ManagerStepParameters {
+
+    public:
+
+        double mStepSeconds;
+
+        // Must not be modified by tasks.
+        Vector3D *mShipPosition;
+        Vector3D *mShipVelocity;
+    };
+
+
+/**
+ * The scene handler that runs the game, shared by the windowed game and
+ * the headless drivers.
+ *
+ * @author Jason Rohrer.
+ */
+class GameSceneHandler :
+    public SceneHandlerGL, public KeyboardHandlerGL,
+    public RedrawListenerGL { 
+	
+	public:
+
+        /**
+         * Constructs a sceen handler.
+         *
+         * @param inStartingLevel the level to start on.
+         *   Defaults to 0.
+         * @param inSoundOutput where to send sound, or NULL to mix sound
+         *   only as stepSimulation pulls it.  Should use
+         *   soundSampleRate.  Defaults to NULL.
+         *   Will be destroyed by this class.
+         * @param inRandomSeed the seed for all random choices made by
+         *   the game.  Defaults to 0.
+         */
+        GameSceneHandler( int inStartingLevel = 1,
+                          SoundOutput *inSoundOutput = NULL,
+                          unsigned long inRandomSeed = 0 );
+
+        virtual ~GameSceneHandler();
+        
+
+        // NULL when running headless
+        ScreenGL *mScreen;
+
+
+        // records the input and frame times of this game, or NULL
+        // Will be destroyed by this class.
+        ReplayRecorder *mReplayRecorder;
+
+        
+        
+		// implements the SceneHandlerGL interface
+		virtual void drawScene();
+
+        // implements the KeyboardHandlerGL interface
+		virtual void keyPressed( unsigned char inKey, int inX, int inY );
+		virtual void specialKeyPressed( int inKey, int inX, int inY );
+		virtual void keyReleased( unsigned char inKey, int inX, int inY );
+		virtual void specialKeyReleased( int inKey, int inX, int inY );
+
+        // implements the RedrawListener interface
+		virtual void fireRedraw();
+
+
+
+        /**
+         * Loads the next level.
+         */
+        void loadNextLevel();
+
+
+        /**
+         * Destroys the currently loaded level.
+         */
+        void destroyLevel();
+
+
+        /**
+         * Sets how many fixed-length simulation steps make up one second
+         * of game time.
+         *
+         * @param inStepsPerSecond the step rate.  Defaults to 60.
+         */
+        void setSimulationRate( unsigned long inStepsPerSecond );
+
+
+        /**
+         * Gets the simulation step rate.
+         *
+         * @return the number of steps per second.
+         */
+        unsigned long getSimulationRate();
+
+
+        /**
+         * Sets how many threads update the managers during each
+         * simulation step.
+         *
+         * Results do not depend on the number of threads.
+         *
+         * @param inNumThreads the number of threads, including the
+         *   calling thread.  Defaults to 1.
+         */
+        void setNumThreads( int inNumThreads );
+
+
+        /**
+         * Advances the game by one frame without drawing anything.
+         *
+         * Used in place of drawScene and fireRedraw when running headless.
+         * Drawable objects are still built, since the managers measure
+         * object radii as they build them, and the sound that would play
+         * during the frame is mixed and discarded.
+         *
+         * @param inFrameMilliseconds the length of the frame.
+         */
+        void stepSimulation( unsigned long inFrameMilliseconds );
+
+
+
+        /**
+         * Turns on timing of each part of stepSimulation.
+         */
+        void enableBenchmarkTimings();
+
+
+        /**
+         * Prints timing percentiles for each part of stepSimulation,
+         * if timings are enabled.
+         */
+        void printBenchmarkTimings();
+
+
+        /**
+         * Gets the timings of each part of stepSimulation.
+         *
+         * @return the timings, or NULL if timings are not enabled.
+         *   Will be destroyed by this class.
+         */
+        SimpleVector<FrameTimingStats *> *getBenchmarkTimings();
+
+
+        /**
+         * Sets whether the frame rate and a summary of audio callback
+         * telemetry are printed every 100 frames.
+         *
+         * @param inPrint true to print.  Defaults to false.
+         */
+        void setPrintFrameRate( char inPrint );
+
+
+        /**
+         * Turns on a governor that lowers drawing and audio quality when
+         * frames or audio callbacks take too long, and raises it again
+         * when they have room to spare.
+         *
+         * @param inFrameBudgetMilliseconds the time each frame should
+         *   take, not counting time spent waiting for the display.
+         */
+        void enableQualityGovernor( double inFrameBudgetMilliseconds );
+
+
+        /**
+         * Starts writing every audio callback record to a CSV file.
+         *
+         * @param inFileName the name of the file.
+         *   Must be destroyed by caller.
+         */
+        void setAudioTelemetryFile( char *inFileName );
+
+
+        /**
+         * Prints a summary of the audio callback records read since the
+         * last time the frame rate was printed (or since the start, if
+         * it is never printed).
+         */
+        void printAudioTelemetry();
+
+
+        /**
+         * Mixes sound as fast as possible, without stepping the game,
+         * and prints how many times faster than real time it was mixed.
+         *
+         * @param inOutput the output to render with, which must be this
+         *   handler's sound output.
+         *   Will be destroyed by this class.
+         * @param inSeconds the length of sound to mix.
+         */
+        void measureAudioThroughput( OfflineSoundOutput *inOutput,
+                                     double inSeconds );
+
+
+        /**
+         * Prints a short summary of the game state, useful for checking
+         * that two runs of the same replay ended up in the same place.
+         */
+        void printStateSummary();
+
+
+        /**
+         * Turns on checking that the drawable objects built in parallel
+         * by stepSimulation exactly match those built one manager at
+         * a time.
+         */
+        void enableRenderBuildCheck();
+
+
+        /**
+         * Gets the number of frames whose drawable objects did not match
+         * during the check turned on by enableRenderBuildCheck.
+         *
+         * @return the number of mismatched frames.
+         */
+        unsigned long getNumRenderBuildMismatches();
+
+
+        /**
+         * Gets the summary printed by printStateSummary.
+         *
+         * @return the summary.
+         *   Must be destroyed by caller.
+         */
+        char *getStateSummary();
+
+        
+        
+    protected:
+
+        int mLevelNumber;
+        
+        double mFadeLevel;
+        double mFadeTime;
+        
+        // true if ship is in portal to move on to next level
+        char mShipInPortal;
+        
+        double mMaxXPosition;
+        double mMinXPosition;
+        double mMaxYPosition;
+        double mMinYPosition;
+
+        double mGridSpacing;
+        
+        // the time that the last frame was drawn
+        unsigned long mLastFrameSeconds;
+        unsigned long mLastFrameMilliseconds;
+
+        // the length of the last frame
+        unsigned long mFrameMillisecondDelta;
+
+        unsigned long mSimulationStepsPerSecond;
+        double mSimulationStepSeconds;
+
+        // frame time that has passed but has not been simulated yet
+        double mSimulationSecondsOwed;
+
+        // when a frame owes more steps than this, the extra time is
+        // dropped instead of simulated
+        int mMaxSimulationStepsPerFrame;
+
+        // how far between the state before the last step and the
+        // current state to draw things, in [0,1]
+        double mRenderInterpolation;
+
+
+
+        
+        // tracking our current state of movement
+        double mForwardBackwardMoveRate;
+        double mRightLeftMoveRate;
+        double mMaxMoveRate;
+
+        double mShipAccelleration;
+        double mShipFriction;
+        
+        double mRotationRate;
+        double mBaseRotationRate;
+        double mMaxRotationRate;
+        double mShipRotationAccelleration;
+        
+        double mShipScale;
+
+        double mCurrentShipRadius;
+        
+        char mMovingUp;
+        char mMovingDown;
+        char mMovingLeft;
+        char mMovingRight;
+
+        char mZoomingIn;
+        char mZoomingOut;
+
+        char mRotatingClockwise;
+        char mRotatingCounterClockwise;
+
+        Vector3D *mCurrentShipVelocityVector;
+        
+        char mPaused;
+        
+        
+        StdRandomSource *mRandSource;
+
+        ParameterizedObject *mShipParameterSpace;
+        
+        ShipBulletManager *mShipBulletManager;
+        double mShipBulletRange;
+        double mShipBulletBaseVelocity;
+        int mMaxNumShipBullets;
+        
+        ShipBulletManager *mEnemyBulletManager;
+        double mEnemyBulletRange;
+        double mEnemyBulletBaseVelocity;
+        double mEnemyBulletsPerSecond;
+        double mEnemyBulletShipJarPower;
+        double mEnemyBulletSculptureJarPower;
+        double mBossBulletShipJarPower;
+        double mBossBulletSculptureJarPower;
+        double mSculptureFriction;
+        double mCurrentShipJarForce;
+
+        ShipBulletManager *mBossBulletManager;
+        ShipBulletManager *mBossDamageManager;
+        
+        EnemyManager *mEnemyManager;
+        int mNumEnemies;
+        
+        SculptureManager *mSculptureManager;
+
+        BossManager *mBossManager;
+        PortalManager *mPortalManager;
+
+        // runs mManagerTaskGraph
+        WorkStealingThreadPool *mThreadPool;
+
+        // passes time in all managers, rebuilt for each level
+        FrameTaskGraph *mManagerTaskGraph;
+        ManagerStepParameters mManagerStepParameters;
+
+        // the tasks in mManagerTaskGraph, which destroys them
+        FrameTask *mShipBulletTask;
+        FrameTask *mEnemyBulletTask;
+        FrameTask *mEnemyTask;
+        FrameTask *mSculptureTask;
+        FrameTask *mBossBulletTask;
+        FrameTask *mBossDamageTask;
+        FrameTask *mBossTask;
+        FrameTask *mPortalTask;
+
+        // builds the drawable objects of each manager, rebuilt for
+        // each level
+        FrameTaskGraph *mRenderTaskGraph;
+
+        // the tasks in mRenderTaskGraph, which destroys them
+        RenderBuildTask *mSculptureRenderTask;
+        RenderBuildTask *mEnemyBulletRenderTask;
+        RenderBuildTask *mBossBulletRenderTask;
+        RenderBuildTask *mShipBulletRenderTask;
+        RenderBuildTask *mEnemyRenderTask;
+        RenderBuildTask *mBossRenderTask;
+        RenderBuildTask *mBossDamageRenderTask;
+        RenderBuildTask *mPortalRenderTask;
+
+        // the same tasks, in the order their layers are drawn
+        // (bottom layer first)
+        SimpleVector<RenderBuildTask *> *mRenderLayerTasks;
+
+        char mCheckRenderBuild;
+        unsigned long mNumRenderBuildMismatches;
+
+        MusicNoteWaveTable *mWaveTable;
+        MusicPlayer *mMusicPlayer;
+        
+        int mCurrentPieceCarried;
+        double mPiecePickupRadius;
+
+        double mMaxFrameRate;
+
+        char mPrintFrameRate;
+        unsigned long mNumFrames;
+        unsigned long mFrameBatchSize;
+        unsigned long mFrameBatchStartTimeSeconds;
+        unsigned long mFrameBatchStartTimeMilliseconds;
+
+        // objects skipped and drawn by managers during this frame batch
+        unsigned long mNumCulledInBatch;
+        unsigned long mNumDrawnInBatch;
+
+        // toggled with F2 when the frame profiler is compiled in
+        char mShowProfilerOverlay;
+
+        AudioTelemetrySummary *mAudioTelemetrySummary;
+
+        // NULL if records are not being written
+        FILE *mAudioTelemetryFILE;
+
+        // NULL if quality is never changed
+        QualityGovernor *mQualityGovernor;
+
+        // how many rotated copies the managers step over when drawing,
+        // set from mQualityGovernor
+        // never used for building the objects that collisions are
+        // measured from
+        int mRotatedCopyStride;
+
+        // when the simulation and drawing of the current frame started
+        double mFrameWorkStartMicroseconds;
+
+
+
+        /**
+         * Reads the records of audio callbacks since the last call
+         * into the telemetry summary and file, and the quality governor.
+         */
+        void readAudioTelemetry();
+
+
+        /**
+         * Passes the quality governor's current settings on to the
+         * control points and the sound player.
+         */
+        void applyQualityLevels();
+
+
+
+        /**
+         * Sets the on-screen bounds used by managers that skip drawing
+         * objects that are off screen.
+         *
+         * @param inBounds the bounds, or NULL to draw everything.
+         *   Must be destroyed by caller after it is replaced by another
+         *   call.
+         */
+        void setManagerViewBounds( ViewBounds *inBounds );
+
+
+
+        /**
+         * Adds the counts of objects skipped and drawn by managers in the
+         * last build to the totals for this frame batch.
+         */
+        void addManagerCullCounts();
+
+
+        Color *mBackgroundColor;
+        Color *mNearBossGridColor;
+        Color *mFarBossGridColor;
+
+        // draws the grid from arrays built once per level
+        GridRenderer *mGridRenderer;
+
+        Color *mWeakUmbilicalColor;
+        Color *mStrongUmbilicalColor;
+        
+        int mSampleRate;
+
+        double mMusicLoudness;
+        int mMaxSimultaneousSounds;
+        SoundPlayer *mSoundPlayer;
+
+        // the view (ship) position and orientation as of the last
+        // simulation step
+        // mScreen's view is set by blending these with the previous
+        // ones before each frame is drawn
+        Vector3D *mViewPosition;
+        Angle3D *mViewOrientation;
+
+        // the view as of the step before that
+        Vector3D *mPreviousViewPosition;
+        Angle3D *mPreviousViewOrientation;
+
+        // fractional sound frames not yet pulled by stepSimulation
+        double mHeadlessSoundFramesOwed;
+
+        // all of the timings below, or NULL if timings are disabled
+        // The ship and manager timings are taken once per simulation
+        // step, and the rest once per frame.
+        SimpleVector<FrameTimingStats *> *mBenchmarkTimings;
+        
+        FrameTimingStats *mShipBulletTiming;
+        FrameTimingStats *mEnemyBulletTiming;
+        FrameTimingStats *mEnemyTiming;
+        FrameTimingStats *mEnemySpawnTiming;
+        FrameTimingStats *mSculptureTiming;
+        FrameTimingStats *mBossBulletTiming;
+        FrameTimingStats *mBossDamageTiming;
+        FrameTimingStats *mBossTiming;
+        FrameTimingStats *mPortalTiming;
+        FrameTimingStats *mManagerGraphTiming;
+        FrameTimingStats *mShipTiming;
+        FrameTimingStats *mRenderBuildTiming;
+        FrameTimingStats *mAudioTiming;
+        FrameTimingStats *mFrameTiming;
+        
+        void addRandomEnemy();
+
+
+        /**
+         * Functions for the simulated view (ship) position and
+         * orientation, with the same interface as the view functions
+         * of ScreenGL.
+         *
+         * getViewPosition returns a new vector that must be destroyed by
+         * the caller.  getViewOrientation returns an angle that must
+         * not be destroyed by the caller.  The other functions copy their
+         * parameters, which must be destroyed by the caller.
+         */
+        Vector3D *getViewPosition();
+        void setViewPosition( Vector3D *inPosition );
+        void moveView( Vector3D *inPositionChange );
+        Angle3D *getViewOrientation();
+        void rotateView( Angle3D *inOrientationChange );
+
+
+        /**
+         * Gets the view blended between the last two simulation steps
+         * by mRenderInterpolation.
+         *
+         * @return the view position or orientation.
+         *   Must be destroyed by caller.
+         */
+        Vector3D *getInterpolatedViewPosition();
+        Angle3D *getInterpolatedViewOrientation();
+
+
+        /**
+         * Sets the view of mScreen, if any, to the interpolated view.
+         */
+        void updateScreenView();
+
+
+        /**
+         * Runs as many simulation steps as the time that has passed
+         * during a frame calls for, and sets mRenderInterpolation.
+         *
+         * @param inFrameMilliseconds the length of the frame.
+         */
+        void advanceSimulation( unsigned long inFrameMilliseconds );
+
+
+        /**
+         * Runs one fixed-length simulation step.
+         */
+        void simulateStep();
+
+
+        /**
+         * Saves the current state of the ship and all managers so that
+         * drawing can blend between it and the result of the next step.
+         */
+        void saveInterpolationState();
+
+
+        /**
+         * Moves the ship, handles bullet hits on the ship, and handles
+         * level transitions.
+         *
+         * @param inStepSeconds the length of the step.
+         */
+        void stepShip( double inStepSeconds );
+
+
+        /**
+         * Builds mManagerTaskGraph for the managers of the current level.
+         *
+         * Each edge in the graph keeps a manager from running while
+         * another manager whose state it reads or writes is running.
+         * The edges also keep the order in which sounds are started the
+         * same as when the managers are updated one at a time.
+         */
+        void buildManagerTaskGraph();
+
+
+        /**
+         * Builds mRenderTaskGraph for the managers of the current level.
+         */
+        void buildRenderTaskGraph();
+
+
+        /**
+         * Builds the drawable objects of all managers at once, leaving
+         * them in the render tasks to be taken.
+         */
+        void buildDrawableObjects();
+
+
+        /**
+         * Takes the objects built by buildDrawableObjects, concatenated
+         * in the order they are drawn.
+         *
+         * @return the objects.
+         *   Vector and objects must be destroyed by caller.
+         */
+        SimpleVector<DrawableObject *> *takeLayeredDrawableObjects();
+
+
+        /**
+         * Builds the same objects as takeLayeredDrawableObjects one
+         * manager at a time on the calling thread.
+         *
+         * @return the objects.
+         *   Vector and objects must be destroyed by caller.
+         */
+        SimpleVector<DrawableObject *> *buildLayeredDrawableObjectsSerially();
+
+
+        /**
+         * Tells all managers about the time that has passed during
+         * a step, and replenishes enemies.
+         *
+         * @param inStepSeconds the length of the step.
+         * @param inViewPosition the ship position.
+         *   Must be destroyed by caller.
+         */
+        void passTimeInManagers( double inStepSeconds,
+                                 Vector3D *inViewPosition );
+
+
+        /**
+         * Builds the ship's drawable objects, measuring mCurrentShipRadius.
+         *
+         * @param inViewPosition the ship position.
+         *   Must be destroyed by caller.
+         * @param inViewOrientation the ship orientation.
+         *   Must be destroyed by caller.
+         * @param inDraw true to draw the ship, or false to only measure it.
+         */
+        void updateShipRadius( Vector3D *inViewPosition,
+                               Angle3D *inViewOrientation, char inDraw );
+
+
+        /**
+         * Gets a mark to start timing from, if timings are enabled.
+         *
+         * @return the current time in microseconds, or 0 if timings are
+         *   disabled.
+         */
+        double getTimingMark();
+
+        
+        /**
+         * Adds the time since a mark to a series, if timings are enabled.
+         *
+         * @param inTiming the series to add to.
+         * @param inoutMark pointer to the mark.  Will be moved to the
+         *   current time, so that consecutive sections can be timed
+         *   with one mark.
+         */
+        void addTimingSample( FrameTimingStats *inTiming, double *inoutMark );
+
+
+        /**
+         * Records a key event if we are recording a replay.
+         */
+        void recordInputEvent( char inPress, char inSpecial, int inKey );
+        
+	};
+
+
+// the running game, defined in game.cpp
+extern GameSceneHandler *sceneHandler;
+
+
+
+#endif
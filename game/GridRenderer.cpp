@@ -0,0 +1,310 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "GridRenderer.h"
+
+
+#include <GL/gl.h>
+#include <math.h>
+
+
+
+// grid points closer than this to the ship are pulled toward the far color
+static const double shipRadius = 20;
+
+// distance over which the ship's pull falls off
+static const double shipFalloff = 19;
+
+
+
+GridRenderer::GridRenderer( double inMinX, double inMinY,
+                            double inMaxX, double inMaxY,
+                            double inSpacing,
+                            Color *inNearBossColor, Color *inFarBossColor,
+                            double inMoveThreshold )
+    : mMinX( inMinX ), mMinY( inMinY ),
+      mMaxX( inMaxX ), mMaxY( inMaxY ),
+      mSpacing( inSpacing ),
+      mNearBossColor( inNearBossColor->copy() ),
+      mFarBossColor( inFarBossColor->copy() ),
+      mMoveThreshold( inMoveThreshold ),
+      mStride( 0 ),
+      mVertices( NULL ),
+      mColors( NULL ),
+      mBossWeights( NULL ),
+      mLineIndices( NULL ),
+      mNumLineIndices( 0 ),
+      mColorsValid( false ),
+      mBossX( 0 ), mBossY( 0 ),
+      mShipX( 0 ), mShipY( 0 ),
+      mNumFullUpdates( 0 ),
+      mNumShipUpdates( 0 ) {
+
+    buildGeometry( 1 );
+    }
+
+
+
+GridRenderer::~GridRenderer() {
+    delete mNearBossColor;
+    delete mFarBossColor;
+
+    delete [] mVertices;
+    delete [] mColors;
+    delete [] mBossWeights;
+    delete [] mLineIndices;
+    }
+
+
+
+void GridRenderer::buildGeometry( int inStride ) {
+    delete [] mVertices;
+    delete [] mColors;
+    delete [] mBossWeights;
+    delete [] mLineIndices;
+
+    mStride = inStride;
+    mStrideSpacing = mSpacing * inStride;
+
+    // a wider spacing may not land on the far edges
+    // allow for rounding in spacings that do
+    mNumColumns =
+        (int)( ( mMaxX - mMinX ) / mStrideSpacing + 0.000001 ) + 1;
+    mNumRows =
+        (int)( ( mMaxY - mMinY ) / mStrideSpacing + 0.000001 ) + 1;
+
+    int numPoints = mNumColumns * mNumRows;
+
+    mVertices = new float[ 2 * numPoints ];
+    mColors = new float[ 4 * numPoints ];
+    mBossWeights = new float[ numPoints ];
+
+    int p = 0;
+    for( int r=0; r<mNumRows; r++ ) {
+        float y = (float)( mMinY + r * mStrideSpacing );
+
+        for( int c=0; c<mNumColumns; c++ ) {
+            mVertices[ p++ ] = (float)( mMinX + c * mStrideSpacing );
+            mVertices[ p++ ] = y;
+            }
+        }
+
+    mNumLineIndices = 2 * ( mNumColumns * ( mNumRows - 1 ) +
+                            mNumRows * ( mNumColumns - 1 ) );
+    mLineIndices = new unsigned int[ mNumLineIndices ];
+
+    int i = 0;
+
+    // vertical lines
+    for( int c=0; c<mNumColumns; c++ ) {
+        for( int r=0; r<mNumRows - 1; r++ ) {
+            mLineIndices[ i++ ] = r * mNumColumns + c;
+            mLineIndices[ i++ ] = ( r + 1 ) * mNumColumns + c;
+            }
+        }
+
+    // horizontal lines
+    for( int r=0; r<mNumRows; r++ ) {
+        for( int c=0; c<mNumColumns - 1; c++ ) {
+            mLineIndices[ i++ ] = r * mNumColumns + c;
+            mLineIndices[ i++ ] = r * mNumColumns + c + 1;
+            }
+        }
+
+    mColorsValid = false;
+    }
+
+
+
+void GridRenderer::computeBossWeights() {
+    float bossX = (float)mBossX;
+    float bossY = (float)mBossY;
+    float inverseWidth = (float)( 1.0 / ( mMaxX - mMinX ) );
+
+    int numPoints = mNumColumns * mNumRows;
+
+    // no branches, so that the compiler can vectorize this
+    for( int p=0; p<numPoints; p++ ) {
+        float dX = mVertices[ 2 * p ] - bossX;
+        float dY = mVertices[ 2 * p + 1 ] - bossY;
+
+        mBossWeights[p] = 1 - sqrtf( dX * dX + dY * dY ) * inverseWidth;
+        }
+    }
+
+
+
+void GridRenderer::computeColors( int inMinColumn, int inMaxColumn,
+                                  int inMinRow, int inMaxRow ) {
+    float shipX = (float)mShipX;
+    float shipY = (float)mShipY;
+    float shipRadiusSquared = (float)( shipRadius * shipRadius );
+    float inverseShipFalloff = (float)( 1.0 / shipFalloff );
+
+    float nearR = mNearBossColor->r;
+    float nearG = mNearBossColor->g;
+    float nearB = mNearBossColor->b;
+    float nearA = mNearBossColor->a;
+
+    float farR = mFarBossColor->r;
+    float farG = mFarBossColor->g;
+    float farB = mFarBossColor->b;
+    float farA = mFarBossColor->a;
+
+    for( int r=inMinRow; r<=inMaxRow; r++ ) {
+        for( int c=inMinColumn; c<=inMaxColumn; c++ ) {
+            int p = r * mNumColumns + c;
+
+            float nearWeight = mBossWeights[p];
+
+            float dX = mVertices[ 2 * p ] - shipX;
+            float dY = mVertices[ 2 * p + 1 ] - shipY;
+            float shipDistanceSquared = dX * dX + dY * dY;
+
+            if( shipDistanceSquared < shipRadiusSquared ) {
+                // ship overrides boss' effect on grid
+                nearWeight -=
+                    1 - sqrtf( shipDistanceSquared ) * inverseShipFalloff;
+                }
+
+            if( nearWeight < 0 ) {
+                nearWeight = 0;
+                }
+
+            float farWeight = 1 - nearWeight;
+
+            float *color = &( mColors[ 4 * p ] );
+            color[0] = nearWeight * nearR + farWeight * farR;
+            color[1] = nearWeight * nearG + farWeight * farG;
+            color[2] = nearWeight * nearB + farWeight * farB;
+            color[3] = nearWeight * nearA + farWeight * farA;
+            }
+        }
+    }
+
+
+
+void GridRenderer::computeColorsNearShip( double inShipX, double inShipY ) {
+    int minColumn =
+        (int)floor( ( inShipX - shipRadius - mMinX ) / mStrideSpacing );
+    int maxColumn =
+        (int)ceil( ( inShipX + shipRadius - mMinX ) / mStrideSpacing );
+    int minRow =
+        (int)floor( ( inShipY - shipRadius - mMinY ) / mStrideSpacing );
+    int maxRow =
+        (int)ceil( ( inShipY + shipRadius - mMinY ) / mStrideSpacing );
+
+    if( minColumn < 0 ) {
+        minColumn = 0;
+        }
+    if( maxColumn > mNumColumns - 1 ) {
+        maxColumn = mNumColumns - 1;
+        }
+    if( minRow < 0 ) {
+        minRow = 0;
+        }
+    if( maxRow > mNumRows - 1 ) {
+        maxRow = mNumRows - 1;
+        }
+
+    // empty if the ship is outside the grid
+    if( minColumn <= maxColumn && minRow <= maxRow ) {
+        computeColors( minColumn, maxColumn, minRow, maxRow );
+        }
+    }
+
+
+
+void GridRenderer::updateColors( Vector3D *inBossPosition,
+                                 Vector3D *inShipPosition,
+                                 int inStride ) {
+    if( inStride < 1 ) {
+        inStride = 1;
+        }
+    if( inStride != mStride ) {
+        buildGeometry( inStride );
+        }
+
+    double bossMoveX = inBossPosition->mX - mBossX;
+    double bossMoveY = inBossPosition->mY - mBossY;
+    double shipMoveX = inShipPosition->mX - mShipX;
+    double shipMoveY = inShipPosition->mY - mShipY;
+
+    double thresholdSquared = mMoveThreshold * mMoveThreshold;
+
+    if( !mColorsValid ||
+        bossMoveX * bossMoveX + bossMoveY * bossMoveY > thresholdSquared ) {
+
+        mBossX = inBossPosition->mX;
+        mBossY = inBossPosition->mY;
+        mShipX = inShipPosition->mX;
+        mShipY = inShipPosition->mY;
+
+        computeBossWeights();
+        computeColors( 0, mNumColumns - 1, 0, mNumRows - 1 );
+
+        mColorsValid = true;
+        mNumFullUpdates++;
+        }
+    else if( shipMoveX * shipMoveX + shipMoveY * shipMoveY >
+             thresholdSquared ) {
+
+        double oldShipX = mShipX;
+        double oldShipY = mShipY;
+
+        mShipX = inShipPosition->mX;
+        mShipY = inShipPosition->mY;
+
+        // let go of the points the ship has left, and pull on the
+        // points it has reached
+        computeColorsNearShip( oldShipX, oldShipY );
+        computeColorsNearShip( mShipX, mShipY );
+
+        mNumShipUpdates++;
+        }
+    }
+
+
+
+void GridRenderer::draw( Vector3D *inBossPosition, Vector3D *inShipPosition,
+                         int inStride ) {
+    updateColors( inBossPosition, inShipPosition, inStride );
+
+    glLineWidth( 2 );
+
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_COLOR_ARRAY );
+
+    glVertexPointer( 2, GL_FLOAT, 0, mVertices );
+    glColorPointer( 4, GL_FLOAT, 0, mColors );
+
+    glDrawElements( GL_LINES, mNumLineIndices, GL_UNSIGNED_INT,
+                    mLineIndices );
+
+    glDisableClientState( GL_COLOR_ARRAY );
+    glDisableClientState( GL_VERTEX_ARRAY );
+    }
+
+
+
+int GridRenderer::getNumPoints() {
+    return mNumColumns * mNumRows;
+    }
+
+
+
+unsigned long GridRenderer::getNumFullUpdates() {
+    return mNumFullUpdates;
+    }
+
+
+
+unsigned long GridRenderer::getNumShipUpdates() {
+    return mNumShipUpdates;
+    }
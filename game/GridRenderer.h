@@ -0,0 +1,217 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef GRID_RENDERER_INCLUDED
+#define GRID_RENDERER_INCLUDED
+
+
+
+#include "minorGems/graphics/Color.h"
+#include "minorGems/math/geometry/Vector3D.h"
+
+
+
+/**
+ * Draws the background grid from vertex arrays that are built once per
+ * level, coloring each grid point by its distance from the boss and the
+ * ship.
+ *
+ * Colors are kept between frames.  All of them are recomputed only when
+ * the boss moves farther than a threshold, since the boss colors the
+ * whole grid.  The ship only colors points near it, so when it moves
+ * farther than the threshold, only the points around its old and new
+ * positions are recomputed.
+ *
+ * Not thread-safe:  all functions should be called from the main thread.
+ *
+ * @author Jason Rohrer
+ */
+class GridRenderer {
+
+
+
+    public:
+
+        /**
+         * Constructs a renderer for a grid covering a rectangle of the
+         * world.
+         *
+         * @param inMinX the left edge of the grid.
+         * @param inMinY the bottom edge of the grid.
+         * @param inMaxX the right edge of the grid.
+         * @param inMaxY the top edge of the grid.
+         * @param inSpacing the distance between grid lines.
+         * @param inNearBossColor the color of grid points at the boss.
+         *   Must be destroyed by caller.
+         * @param inFarBossColor the color of grid points far from the
+         *   boss or near the ship.
+         *   Must be destroyed by caller.
+         * @param inMoveThreshold how far the boss or ship must move
+         *   before colors are recomputed.  Defaults to 0.25.
+         */
+        GridRenderer( double inMinX, double inMinY,
+                      double inMaxX, double inMaxY,
+                      double inSpacing,
+                      Color *inNearBossColor, Color *inFarBossColor,
+                      double inMoveThreshold = 0.25 );
+
+
+
+        ~GridRenderer();
+
+
+
+        /**
+         * Brings the grid colors up to date.  Called by draw.
+         *
+         * @param inBossPosition the position of the boss.
+         *   Must be destroyed by caller.
+         * @param inShipPosition the position of the ship.
+         *   Must be destroyed by caller.
+         * @param inStride how many spacings apart lines should be drawn.
+         *   Defaults to 1.
+         */
+        void updateColors( Vector3D *inBossPosition,
+                           Vector3D *inShipPosition,
+                           int inStride = 1 );
+
+
+
+        /**
+         * Draws the grid.
+         *
+         * @param inBossPosition the position of the boss.
+         *   Must be destroyed by caller.
+         * @param inShipPosition the position of the ship.
+         *   Must be destroyed by caller.
+         * @param inStride how many spacings apart lines should be drawn.
+         *   Defaults to 1.
+         */
+        void draw( Vector3D *inBossPosition, Vector3D *inShipPosition,
+                   int inStride = 1 );
+
+
+
+        /**
+         * Gets the number of grid points at the current stride.
+         *
+         * @return the number of points.
+         */
+        int getNumPoints();
+
+
+
+        /**
+         * Gets the number of times all colors were recomputed.
+         *
+         * @return the number of updates.
+         */
+        unsigned long getNumFullUpdates();
+
+
+
+        /**
+         * Gets the number of times only the colors near the ship were
+         * recomputed.
+         *
+         * @return the number of updates.
+         */
+        unsigned long getNumShipUpdates();
+
+
+
+    protected:
+
+        double mMinX, mMinY, mMaxX, mMaxY;
+        double mSpacing;
+
+        Color *mNearBossColor;
+        Color *mFarBossColor;
+
+        double mMoveThreshold;
+
+        // the stride that the arrays were built for
+        int mStride;
+
+        // mSpacing * mStride
+        double mStrideSpacing;
+
+        // grid points, row by row from the bottom
+        int mNumColumns;
+        int mNumRows;
+
+        // x, y for each point
+        float *mVertices;
+
+        // r, g, b, a for each point
+        float *mColors;
+
+        // each point's weight toward mNearBossColor, before the ship's
+        // effect, which can be below 0
+        float *mBossWeights;
+
+        // pairs of point indices, vertical lines first
+        unsigned int *mLineIndices;
+        int mNumLineIndices;
+
+        // where the colors were last computed for
+        char mColorsValid;
+        double mBossX, mBossY;
+        double mShipX, mShipY;
+
+        unsigned long mNumFullUpdates;
+        unsigned long mNumShipUpdates;
+
+
+
+        /**
+         * Builds the vertex and index arrays for a stride, and marks the
+         * colors as out of date.
+         *
+         * @param inStride how many spacings apart lines should be drawn.
+         */
+        void buildGeometry( int inStride );
+
+
+
+        /**
+         * Recomputes the boss weight of every point.
+         */
+        void computeBossWeights();
+
+
+
+        /**
+         * Recomputes the colors of points within a range of columns and
+         * rows, using the stored boss weights and ship position.
+         *
+         * @param inMinColumn the first column.
+         * @param inMaxColumn the last column.
+         * @param inMinRow the first row.
+         * @param inMaxRow the last row.
+         */
+        void computeColors( int inMinColumn, int inMaxColumn,
+                            int inMinRow, int inMaxRow );
+
+
+
+        /**
+         * Recomputes the colors of points that a ship at a position
+         * affects.
+         *
+         * @param inShipX the x position of the ship.
+         * @param inShipY the y position of the ship.
+         */
+        void computeColorsNearShip( double inShipX, double inShipY );
+
+    };
+
+
+
+#endif
@@ -0,0 +1,622 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "HeadlessRunner.h"
+#include "GameSceneHandler.h"
+#include "LevelDirectoryManager.h"
+#include "FrameProfiler.h"
+#include "AllocationProfiler.h"
+#include "WorkStealingThreadPool.h"
+
+
+#include "minorGems/system/Time.h"
+#include "minorGems/io/file/File.h"
+
+
+#include <GL/glut.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+
+
+/**
+ * Adds an event to a script.
+ *
+ * @param inScript the script to add to.
+ *   Must be destroyed by caller.
+ */
+static void addHeadlessInputEvent(
+    SimpleVector<HeadlessInputEvent *> *inScript,
+    unsigned long inFrameNumber,
+    char inPress, char inSpecial, int inKey ) {
+
+    inScript->push_back(
+        new HeadlessInputEvent( inFrameNumber, inPress, inSpecial, inKey ) );
+    }
+
+
+
+SimpleVector<HeadlessInputEvent *> *HeadlessRunner::readInputScript(
+    char *inFileName ) {
+
+    FILE *file = fopen( inFileName, "r" );
+
+    if( file == NULL ) {
+        printf( "Failed to open headless input script %s\n", inFileName );
+        return NULL;
+        }
+
+    SimpleVector<HeadlessInputEvent *> *script =
+        new SimpleVector<HeadlessInputEvent *>();
+
+    unsigned long frameNumber;
+    char action[16];
+    char key[16];
+
+    while( fscanf( file, "%lu %15s %15s", &frameNumber, action, key ) == 3 ) {
+
+        char press = ( strcmp( action, "press" ) == 0 );
+        
+        if( !press && strcmp( action, "release" ) != 0 ) {
+            printf( "Unknown action in headless input script:  %s\n",
+                    action );
+            continue;
+            }
+        
+        if( strcmp( key, "up" ) == 0 ) {
+            addHeadlessInputEvent( script, frameNumber, press, true,
+                                   GLUT_KEY_UP );
+            }
+        else if( strcmp( key, "down" ) == 0 ) {
+            addHeadlessInputEvent( script, frameNumber, press, true,
+                                   GLUT_KEY_DOWN );
+            }
+        else if( strcmp( key, "left" ) == 0 ) {
+            addHeadlessInputEvent( script, frameNumber, press, true,
+                                   GLUT_KEY_LEFT );
+            }
+        else if( strcmp( key, "right" ) == 0 ) {
+            addHeadlessInputEvent( script, frameNumber, press, true,
+                                   GLUT_KEY_RIGHT );
+            }
+        else if( strcmp( key, "space" ) == 0 ) {
+            addHeadlessInputEvent( script, frameNumber, press, false, ' ' );
+            }
+        else if( strlen( key ) == 1 ) {
+            addHeadlessInputEvent( script, frameNumber, press, false,
+                                   key[0] );
+            }
+        else {
+            printf( "Unknown key in headless input script:  %s\n", key );
+            }
+        }
+
+    fclose( file );
+
+    return script;
+    }
+
+
+
+SimpleVector<HeadlessInputEvent *> *HeadlessRunner::getDefaultInputScript(
+    unsigned long inNumFrames ) {
+
+    SimpleVector<HeadlessInputEvent *> *script =
+        new SimpleVector<HeadlessInputEvent *>();
+
+    addHeadlessInputEvent( script, 0, true, true, GLUT_KEY_UP );
+    addHeadlessInputEvent( script, 0, true, true, GLUT_KEY_RIGHT );
+
+    for( unsigned long f=0; f<inNumFrames; f+=10 ) {
+        addHeadlessInputEvent( script, f, true, false, ' ' );
+        }
+
+    return script;
+    }
+
+
+
+/**
+ * Passes an input event to the scene handler.
+ *
+ * @param inEvent the event.
+ *   Must be destroyed by caller.
+ *
+ * @return true if the event asks to quit, in which case it is not passed
+ *   on (the handler would exit out from under us).
+ */
+static char applyHeadlessInputEvent( ReplayInputEvent *inEvent ) {
+    if( inEvent->mSpecial ) {
+        if( inEvent->mPress ) {
+            sceneHandler->specialKeyPressed( inEvent->mKey, 0, 0 );
+            }
+        else {
+            sceneHandler->specialKeyReleased( inEvent->mKey, 0, 0 );
+            }
+        }
+    else if( inEvent->mKey == 'q' || inEvent->mKey == 'Q' ) {
+        return true;
+        }
+    else {
+        if( inEvent->mPress ) {
+            sceneHandler->keyPressed( inEvent->mKey, 0, 0 );
+            }
+        else {
+            sceneHandler->keyReleased( inEvent->mKey, 0, 0 );
+            }
+        }
+
+    return false;
+    }
+
+
+
+/**
+ * Prints the results of a headless run.
+ *
+ * @param inNumFrames the number of frames run.
+ * @param inGameMilliseconds the game time covered by those frames.
+ * @param inStartSeconds, inStartMilliseconds the wall clock time
+ *   when the run started.
+ */
+static void printHeadlessRunSummary( unsigned long inNumFrames,
+                                     unsigned long inGameMilliseconds,
+                                     unsigned long inStartSeconds,
+                                     unsigned long inStartMilliseconds ) {
+
+    unsigned long netMilliseconds =
+        Time::getMillisecondsSince( inStartSeconds, inStartMilliseconds );
+
+    double millisecondsPerFrame = 0;
+    if( inNumFrames > 0 ) {
+        millisecondsPerFrame = (double)netMilliseconds / (double)inNumFrames;
+        }
+
+    printf( "Headless run:  %lu frames (%.1f game seconds) "
+            "in %lu ms, %.3f ms per frame\n",
+            inNumFrames, inGameMilliseconds / 1000.0,
+            netMilliseconds, millisecondsPerFrame );
+
+    sceneHandler->printStateSummary();
+    sceneHandler->printBenchmarkTimings();
+    sceneHandler->printAudioTelemetry();
+
+    #ifdef FRAME_PROFILER
+        if( FrameProfiler::isEnabled() ) {
+            FrameProfiler::printSummary();
+            }
+    #endif
+
+    #ifdef ALLOCATION_PROFILER
+        if( AllocationProfiler::isEnabled() ) {
+            AllocationProfiler::printSummary();
+            }
+    #endif
+    }
+
+
+
+unsigned long HeadlessRunner::runHeadless( unsigned long inNumFrames,
+    unsigned long inFrameMilliseconds,
+    SimpleVector<HeadlessInputEvent *> *inScript,
+    char inPrintSummary ) {
+    
+    int numEvents = inScript->size();
+    int nextEvent = 0;
+
+    unsigned long startSeconds, startMilliseconds;
+    Time::getCurrentTime( &startSeconds, &startMilliseconds );
+
+    unsigned long numFramesRun = 0;
+    char quit = false;
+    
+    while( numFramesRun < inNumFrames && !quit ) {
+
+        while( !quit && nextEvent < numEvents &&
+               ( *( inScript->getElement( nextEvent ) ) )->mFrameNumber
+               <= numFramesRun ) {
+
+            quit = applyHeadlessInputEvent(
+                *( inScript->getElement( nextEvent ) ) );
+            nextEvent++;
+            }
+
+        if( !quit ) {
+            sceneHandler->stepSimulation( inFrameMilliseconds );
+            numFramesRun++;
+            }
+        }
+
+    unsigned long netMilliseconds =
+        Time::getMillisecondsSince( startSeconds, startMilliseconds );
+    
+    if( inPrintSummary ) {
+        printHeadlessRunSummary( numFramesRun,
+                                 numFramesRun * inFrameMilliseconds,
+                                 startSeconds, startMilliseconds );
+        }
+
+    return netMilliseconds;
+    }
+
+
+
+char HeadlessRunner::runThreadScaling( int inMaxThreads, int inStartingLevel,
+    unsigned long inRandomSeed, unsigned long inSimulationRate,
+    unsigned long inNumFrames, unsigned long inFrameMilliseconds,
+    SimpleVector<HeadlessInputEvent *> *inScript ) {
+
+    printf( "Thread scaling over %lu frames (%d processors available):\n",
+            inNumFrames, WorkStealingThreadPool::getNumProcessors() );
+    printf( "    threads   ms/frame   speedup   end state\n" );
+
+    char *baseSummary = NULL;
+    double baseMillisecondsPerFrame = 0;
+    char allMatch = true;
+    
+    for( int t=1; t<=inMaxThreads; t++ ) {
+
+        if( t > 1 ) {
+            delete sceneHandler;
+
+            sceneHandler = new GameSceneHandler( inStartingLevel, NULL,
+                                                 inRandomSeed );
+            sceneHandler->setSimulationRate( inSimulationRate );
+            sceneHandler->enableBenchmarkTimings();
+            sceneHandler->loadNextLevel();
+            }
+        sceneHandler->setNumThreads( t );
+
+        unsigned long netMilliseconds =
+            runHeadless( inNumFrames, inFrameMilliseconds, inScript, false );
+
+        double millisecondsPerFrame =
+            (double)netMilliseconds / (double)inNumFrames;
+
+        char *summary = sceneHandler->getStateSummary();
+
+        char match = true;
+        
+        if( baseSummary == NULL ) {
+            baseSummary = summary;
+            baseMillisecondsPerFrame = millisecondsPerFrame;
+            }
+        else {
+            match = ( strcmp( summary, baseSummary ) == 0 );
+            delete [] summary;
+            }
+
+        double speedup = 0;
+        if( millisecondsPerFrame > 0 ) {
+            speedup = baseMillisecondsPerFrame / millisecondsPerFrame;
+            }
+
+        printf( "    %7d   %8.3f   %6.2fx   %s\n",
+                t, millisecondsPerFrame, speedup,
+                match ? "same" : "DIFFERENT" );
+
+        if( !match ) {
+            allMatch = false;
+            }
+        }
+
+    printf( "End state:  %s\n", baseSummary );
+    
+    delete [] baseSummary;
+
+    if( !allMatch ) {
+        printf( "Error:  end state depends on the number of threads\n" );
+        }
+    
+    return allMatch;
+    }
+
+
+// the slowest a section may grow with level size before the sweep
+// calls it superlinear
+#define SUPERLINEAR_EXPONENT 1.25
+
+
+/**
+ * The results of one level of a stress sweep.
+ */
+class StressSweepResult {
+
+    public:
+
+        /**
+         * Constructs a result.
+         *
+         * @param inNumTimings the number of timed sections.
+         */
+        StressSweepResult( int inNumTimings )
+            : mTimingMeans( new double[ inNumTimings ] ) {
+            }
+
+        ~StressSweepResult() {
+            delete [] mTimingMeans;
+            }
+
+        int mLevelNumber;
+
+        // the stressScale of the level, or its entity count if it was
+        // not generated
+        double mSize;
+        
+        // enemies plus sculpture pieces
+        int mNumEntities;
+
+        double mMillisecondsPerFrame;
+
+        // in microseconds, one per benchmark timing
+        double *mTimingMeans;
+    };
+
+
+
+char HeadlessRunner::runStressSweep( int inFirstLevel, int inLastLevel,
+    unsigned long inRandomSeed, unsigned long inSimulationRate,
+    int inNumThreads, unsigned long inNumFrames,
+    unsigned long inFrameMilliseconds,
+    SimpleVector<HeadlessInputEvent *> *inScript, char *inCSVFileName ) {
+
+    SimpleVector<StressSweepResult *> *results =
+        new SimpleVector<StressSweepResult *>();
+
+    int numTimings = 0;
+    
+    for( int level=inFirstLevel; level<=inLastLevel; level++ ) {
+
+        char levelPath[16];
+        sprintf( levelPath, "levels/%03d", level );
+        
+        File *levelDirectory = new File( NULL, levelPath );
+
+        char exists = levelDirectory->exists();
+        delete levelDirectory;
+
+        if( !exists ) {
+            continue;
+            }
+        
+        if( level != inFirstLevel ) {
+            delete sceneHandler;
+
+            sceneHandler = new GameSceneHandler( level, NULL,
+                                                 inRandomSeed );
+            sceneHandler->setSimulationRate( inSimulationRate );
+            sceneHandler->setNumThreads( inNumThreads );
+            sceneHandler->enableBenchmarkTimings();
+            sceneHandler->loadNextLevel();
+            }
+
+        unsigned long netMilliseconds =
+            runHeadless( inNumFrames, inFrameMilliseconds, inScript, false );
+
+        SimpleVector<FrameTimingStats *> *timings =
+            sceneHandler->getBenchmarkTimings();
+        numTimings = timings->size();
+
+        StressSweepResult *result = new StressSweepResult( numTimings );
+        
+        result->mLevelNumber = level;
+        result->mMillisecondsPerFrame =
+            (double)netMilliseconds / (double)inNumFrames;
+
+        for( int t=0; t<numTimings; t++ ) {
+            result->mTimingMeans[t] =
+                ( *( timings->getElement( t ) ) )->getMean();
+            }
+
+        // the loaded level is still the current level directory
+        char error = false;
+        int numEnemies =
+            LevelDirectoryManager::readIntFileContents( "numberOfEnemies",
+                                                        &error );
+        int numPieces =
+            LevelDirectoryManager::readIntFileContents(
+                "numberOfSculpturePieces", &error );
+
+        result->mNumEntities = numEnemies + numPieces;
+
+        char scaleError = false;
+        result->mSize =
+            LevelDirectoryManager::readDoubleFileContents( "stressScale",
+                                                           &scaleError );
+        if( scaleError ) {
+            result->mSize = result->mNumEntities;
+            }
+
+        results->push_back( result );
+        }
+
+    int numResults = results->size();
+
+    if( numResults == 0 ) {
+        printf( "Error:  no levels found in [%d,%d]\n",
+                inFirstLevel, inLastLevel );
+        delete results;
+        return false;
+        }
+
+
+    double maxMillisecondsPerFrame = 0;
+    for( int r=0; r<numResults; r++ ) {
+        StressSweepResult *result = *( results->getElement( r ) );
+
+        if( result->mMillisecondsPerFrame > maxMillisecondsPerFrame ) {
+            maxMillisecondsPerFrame = result->mMillisecondsPerFrame;
+            }
+        }
+    
+    printf( "Stress sweep over %lu frames per level:\n", inNumFrames );
+    printf( "    level      size   entities   ms/frame\n" );
+
+    int maxBarLength = 40;
+    
+    for( int r=0; r<numResults; r++ ) {
+        StressSweepResult *result = *( results->getElement( r ) );
+
+        int barLength = 0;
+        if( maxMillisecondsPerFrame > 0 ) {
+            barLength = (int)( maxBarLength * result->mMillisecondsPerFrame /
+                               maxMillisecondsPerFrame + 0.5 );
+            }
+        
+        printf( "    %5d  %8.2f   %8d   %8.3f  ",
+                result->mLevelNumber, result->mSize, result->mNumEntities,
+                result->mMillisecondsPerFrame );
+
+        for( int b=0; b<barLength; b++ ) {
+            printf( "#" );
+            }
+        printf( "\n" );
+        }
+
+
+    // growth exponent of each section between successive levels:
+    // 1 for linear in size, 2 for quadratic
+    SimpleVector<FrameTimingStats *> *timings =
+        sceneHandler->getBenchmarkTimings();
+
+    StressSweepResult *first = *( results->getElement( 0 ) );
+    StressSweepResult *last = *( results->getElement( numResults - 1 ) );
+
+    printf( "Growth with level size (time ~ size^exponent):\n" );
+    printf( "    %-16s %10s %10s %9s   %s\n",
+            "section (us)", "first", "last", "exponent", "superlinear from" );
+
+    for( int t=0; t<numTimings; t++ ) {
+        char *name = ( *( timings->getElement( t ) ) )->getName();
+
+        double exponent = 0;
+        char hasExponent = false;
+
+        if( first->mTimingMeans[t] > 0 && last->mTimingMeans[t] > 0 &&
+            last->mSize > first->mSize && first->mSize > 0 ) {
+
+            exponent = log( last->mTimingMeans[t] / first->mTimingMeans[t] ) /
+                log( last->mSize / first->mSize );
+            hasExponent = true;
+            }
+
+        int superlinearLevel = -1;
+
+        for( int r=1; r<numResults && superlinearLevel == -1; r++ ) {
+            StressSweepResult *a = *( results->getElement( r - 1 ) );
+            StressSweepResult *b = *( results->getElement( r ) );
+
+            if( a->mTimingMeans[t] > 0 && b->mTimingMeans[t] > 0 &&
+                b->mSize > a->mSize && a->mSize > 0 ) {
+
+                double stepExponent =
+                    log( b->mTimingMeans[t] / a->mTimingMeans[t] ) /
+                    log( b->mSize / a->mSize );
+
+                if( stepExponent > SUPERLINEAR_EXPONENT ) {
+                    superlinearLevel = b->mLevelNumber;
+                    }
+                }
+            }
+
+        printf( "    %-16s %10.1f %10.1f ",
+                name, first->mTimingMeans[t], last->mTimingMeans[t] );
+
+        if( hasExponent ) {
+            printf( "%9.2f   ", exponent );
+            }
+        else {
+            printf( "%9s   ", "-" );
+            }
+
+        if( superlinearLevel != -1 ) {
+            printf( "level %03d\n", superlinearLevel );
+            }
+        else {
+            printf( "-\n" );
+            }
+        }
+
+
+    if( inCSVFileName != NULL ) {
+        FILE *csvFILE = fopen( inCSVFileName, "w" );
+
+        if( csvFILE == NULL ) {
+            printf( "Failed to open %s for writing\n", inCSVFileName );
+            }
+        else {
+            fprintf( csvFILE, "level,size,entities,msPerFrame" );
+            for( int t=0; t<numTimings; t++ ) {
+                fprintf( csvFILE, ",%sUs",
+                         ( *( timings->getElement( t ) ) )->getName() );
+                }
+            fprintf( csvFILE, "\n" );
+
+            for( int r=0; r<numResults; r++ ) {
+                StressSweepResult *result = *( results->getElement( r ) );
+
+                fprintf( csvFILE, "%d,%f,%d,%f",
+                         result->mLevelNumber, result->mSize,
+                         result->mNumEntities,
+                         result->mMillisecondsPerFrame );
+
+                for( int t=0; t<numTimings; t++ ) {
+                    fprintf( csvFILE, ",%f", result->mTimingMeans[t] );
+                    }
+                fprintf( csvFILE, "\n" );
+                }
+
+            fclose( csvFILE );
+            }
+        }
+
+
+    for( int r=0; r<numResults; r++ ) {
+        delete *( results->getElement( r ) );
+        }
+    delete results;
+
+    return true;
+    }
+
+
+
+void HeadlessRunner::runReplay( ReplayPlayer *inPlayer ) {
+
+    unsigned long startSeconds, startMilliseconds;
+    Time::getCurrentTime( &startSeconds, &startMilliseconds );
+
+    unsigned long numFramesRun = 0;
+    unsigned long gameMilliseconds = 0;
+    char quit = false;
+
+    unsigned long frameMilliseconds;
+    
+    while( !quit && inPlayer->readFrame( &frameMilliseconds ) ) {
+
+        SimpleVector<ReplayInputEvent *> *events =
+            inPlayer->getFrameEvents();
+
+        int numEvents = events->size();
+        for( int e=0; e<numEvents && !quit; e++ ) {
+            quit = applyHeadlessInputEvent( *( events->getElement( e ) ) );
+            }
+
+        if( !quit ) {
+            sceneHandler->stepSimulation( frameMilliseconds );
+            numFramesRun++;
+            gameMilliseconds += frameMilliseconds;
+            }
+        }
+
+    printHeadlessRunSummary( numFramesRun, gameMilliseconds,
+                             startSeconds, startMilliseconds );
+    }
+
@@ -0,0 +1,180 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef HEADLESS_RUNNER_INCLUDED
+#define HEADLESS_RUNNER_INCLUDED
+
+
+
+#include "minorGems/util/SimpleVector.h"
+
+
+#include "ReplayLog.h"
+
+
+
+/**
+ * One scripted key event for a headless run.
+ */
+class HeadlessInputEvent : public ReplayInputEvent {
+    public:
+
+        HeadlessInputEvent( unsigned long inFrameNumber,
+                            char inPress, char inSpecial, int inKey )
+            : ReplayInputEvent( inPress, inSpecial, inKey ),
+              mFrameNumber( inFrameNumber ) {
+            }
+
+        unsigned long mFrameNumber;
+    };
+
+
+
+/**
+ * Drivers that run the loaded game in sceneHandler without a display:
+ * scripted runs, thread scaling, stress sweeps, and replays.
+ *
+ * Only built into the headless game.
+ *
+ * @author Jason Rohrer.
+ */
+class HeadlessRunner {
+
+    public:
+
+
+
+        /**
+         * Reads a headless input script.
+         *
+         * Each entry in the script has the form
+         *   frameNumber press|release key
+         * where key is a single character key (like d), space (the fire key),
+         * or one of up, down, left, or right.  The q key ends the run.
+         * Entries must be in frame order.
+         *
+         * @param inFileName the name of the script file.
+         *   Must be destroyed by caller.
+         *
+         * @return the script, or NULL if the file cannot be opened.
+         *   Must be destroyed by caller, along with the events in it.
+         */
+        static SimpleVector<HeadlessInputEvent *> *readInputScript(
+            char *inFileName );
+
+
+
+        /**
+         * Builds the script used when none is given:  the ship flies in a
+         * circle while firing.
+         *
+         * @param inNumFrames the length of the run.
+         *
+         * @return the script.
+         *   Must be destroyed by caller, along with the events in it.
+         */
+        static SimpleVector<HeadlessInputEvent *> *getDefaultInputScript(
+            unsigned long inNumFrames );
+
+
+
+        /**
+         * Runs the loaded game without a display at a fixed timestep.
+         *
+         * @param inNumFrames the number of frames to run.
+         * @param inFrameMilliseconds the length of each frame.
+         * @param inScript the input to feed to the game.
+         *   Must be destroyed by caller.
+         * @param inPrintSummary true to print the results of the run.
+         *   Defaults to true.
+         *
+         * @return the wall clock time taken by the run in milliseconds.
+         */
+        static unsigned long runHeadless( unsigned long inNumFrames,
+            unsigned long inFrameMilliseconds,
+            SimpleVector<HeadlessInputEvent *> *inScript,
+            char inPrintSummary = true );
+
+
+
+        /**
+         * Runs the same headless game with 1 to inMaxThreads manager update
+         * threads, printing the time per frame for each thread count and
+         * checking that every run ends in the same state.
+         *
+         * The loaded game in sceneHandler is used for the 1-thread run, and a
+         * fresh game is loaded for each other run.
+         *
+         * @param inMaxThreads the largest thread count to try.
+         * @param inStartingLevel, inRandomSeed, inSimulationRate the settings
+         *   sceneHandler was created with.
+         * @param inNumFrames the number of frames in each run.
+         * @param inFrameMilliseconds the length of each frame.
+         * @param inScript the input to feed to each run.
+         *   Must be destroyed by caller.
+         *
+         * @return true if all runs ended in the same state.
+         */
+        static char runThreadScaling( int inMaxThreads, int inStartingLevel,
+            unsigned long inRandomSeed, unsigned long inSimulationRate,
+            unsigned long inNumFrames, unsigned long inFrameMilliseconds,
+            SimpleVector<HeadlessInputEvent *> *inScript );
+
+
+
+        /**
+         * Runs the same headless game on each level in a range, printing the
+         * time per frame against the number of entities in the level, and how
+         * fast each timed section grows with the level's size.
+         *
+         * Meant for the levels written by editors/stressLevelGenerator, whose
+         * stressScale files give the size.  Missing levels are skipped.
+         *
+         * The loaded game in sceneHandler is used for inFirstLevel, and a
+         * fresh game is loaded for each other level.
+         *
+         * @param inFirstLevel, inLastLevel the range of levels.
+         * @param inRandomSeed, inSimulationRate, inNumThreads the settings
+         *   sceneHandler was created with.
+         * @param inNumFrames the number of frames in each run.
+         * @param inFrameMilliseconds the length of each frame.
+         * @param inScript the input to feed to each run.
+         *   Must be destroyed by caller.
+         * @param inCSVFileName the name of a file to write the results to, or
+         *   NULL to not write them.
+         *   Must be destroyed by caller.
+         *
+         * @return true if at least one level was run.
+         */
+        static char runStressSweep( int inFirstLevel, int inLastLevel,
+            unsigned long inRandomSeed, unsigned long inSimulationRate,
+            int inNumThreads, unsigned long inNumFrames,
+            unsigned long inFrameMilliseconds,
+            SimpleVector<HeadlessInputEvent *> *inScript,
+            char *inCSVFileName );
+
+
+
+        /**
+         * Replays a recorded game without a display, using its recorded
+         * input and frame times.
+         *
+         * @param inPlayer the replay to run.
+         *   Must be destroyed by caller.
+         */
+        static void runReplay( ReplayPlayer *inPlayer );
+
+
+
+
+    };
+
+
+
+#endif
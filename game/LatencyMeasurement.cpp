@@ -0,0 +1,148 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "LatencyMeasurement.h"
+#include "PortAudioSoundOutput.h"
+#include "SoundPlayer.h"
+#include "AudioTelemetry.h"
+#include "FrameProfiler.h"
+
+
+#include "minorGems/system/Thread.h"
+
+
+#include <stdio.h>
+
+
+
+char LatencyMeasurement::measureProfile( AudioLatencyProfile inProfile,
+                                         double inSeconds ) {
+
+    PortAudioSoundOutput *output = new PortAudioSoundOutput( inProfile );
+
+    // no music or filters, so that only the host's scheduling is measured
+    // the player starts the output, and destroys it
+    SoundPlayer *player = new SoundPlayer( inProfile.mSampleRate, 2, NULL, 0,
+                                           output );
+
+    inProfile.print();
+    printf( ":\n" );
+    
+    AudioTelemetry *telemetry = player->getTelemetry();
+    AudioTelemetrySummary *summary = new AudioTelemetrySummary();
+    AudioCallbackRecord record;
+
+    double startTime = FrameProfiler::getCurrentMicroseconds();
+    double endTime = startTime + 1000000 * inSeconds;
+    
+    while( FrameProfiler::getCurrentMicroseconds() < endTime ) {
+        // often enough that the ring never fills, even with tiny buffers
+        Thread::staticSleep( 10 );
+
+        while( telemetry->readRecord( &record ) ) {
+            summary->addRecord( &record );
+            }
+        }
+
+    // read these while the stream is still running
+    PaTimingInfo hostTiming;
+    output->getTimingInfo( &hostTiming );
+    double cpuLoad = output->getCPULoad();
+    PaThreadInfo hostThread;
+    output->getThreadInfo( &hostThread );
+
+    char opened = ( summary->getNumCallbacks() > 0 );
+    
+    if( opened ) {
+        printf( "    callbacks:  %lu, period mean %.2f ms "
+                "(nominal %.2f ms), jitter %.2f ms, max %.2f ms, "
+                "%lu over deadline\n",
+                summary->getNumCallbacks(),
+                summary->getMeanInterval() / 1000,
+                inProfile.getBufferMilliseconds(),
+                summary->getIntervalJitter() / 1000,
+                summary->getMaxInterval() / 1000,
+                summary->getNumDeadlineMisses() );
+        
+        if( hostTiming.numCallbacks > 0 ) {
+            printf( "    host:  period mean %.2f ms, jitter %.2f ms, "
+                    "max %.2f ms, %ld late, %ld underruns, "
+                    "CPU load %.3f\n",
+                    hostTiming.meanPeriodMsec,
+                    hostTiming.periodJitterMsec,
+                    hostTiming.maxPeriodMsec,
+                    hostTiming.numLateCallbacks,
+                    hostTiming.numUnderruns,
+                    cpuLoad );
+            }
+        else {
+            printf( "    host:  does not measure callback timing, "
+                    "CPU load %.3f\n", cpuLoad );
+            }
+
+        if( hostThread.isSetUp ) {
+            printf( "    thread:  " );
+            
+            if( hostThread.realTimePriority > 0 ) {
+                printf( "real-time priority %d",
+                        hostThread.realTimePriority );
+                }
+            else {
+                printf( "normal priority" );
+                }
+
+            if( hostThread.cpu >= 0 ) {
+                printf( ", pinned to CPU %d", hostThread.cpu );
+                }
+            else {
+                printf( ", not pinned" );
+                }
+
+            printf( ", %ld bytes locked\n", hostThread.numLockedBytes );
+            }
+        }
+    else {
+        printf( "    no callbacks, could not open audio device\n" );
+        }
+
+    delete summary;
+    delete player;
+
+    return opened;
+    }
+
+
+
+char LatencyMeasurement::measureProfiles( AudioLatencyProfile inConfigured,
+                                          double inSeconds ) {
+
+    printf( "Measuring audio latency profiles for %.1f seconds each\n",
+            inSeconds );
+
+    // the device is measured without mixing ahead
+    inConfigured.mLookaheadFrames = 0;
+    
+    if( ! measureProfile( inConfigured, inSeconds ) ) {
+        return false;
+        }
+    
+    unsigned long framesPerBuffer[5] = { 128, 256, 512, 1024, 2048 };
+
+    for( int p=0; p<5; p++ ) {
+        if( framesPerBuffer[p] != inConfigured.mFramesPerBuffer ) {
+            AudioLatencyProfile profile( inConfigured.mSampleRate,
+                                         framesPerBuffer[p],
+                                         inConfigured.mNumBuffers );
+            
+            measureProfile( profile, inSeconds );
+            }
+        }
+
+    return true;
+    }
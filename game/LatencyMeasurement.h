@@ -0,0 +1,70 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef LATENCY_MEASUREMENT_INCLUDED
+#define LATENCY_MEASUREMENT_INCLUDED
+
+
+
+#include "AudioLatencyProfile.h"
+
+
+
+/**
+ * Measures how steadily the audio device calls back with a range of
+ * latency profiles.
+ *
+ * Only built into the windowed game, since it plays through the device.
+ *
+ * @author Jason Rohrer.
+ */
+class LatencyMeasurement {
+
+    public:
+
+
+
+        /**
+         * Measures the configured latency profile and a range of buffer
+         * sizes around it, so that the smallest one that plays without
+         * underruns can be put in the settings.
+         *
+         * @param inConfigured the profile read from the settings.
+         * @param inSeconds how long to play each profile.
+         *
+         * @return true if the device could be opened.
+         */
+        static char measureProfiles( AudioLatencyProfile inConfigured,
+                                     double inSeconds );
+
+
+
+    protected:
+
+
+
+        /**
+         * Plays silence through the audio device with one latency profile
+         * and prints how steadily the device called back for more.
+         *
+         * @param inProfile the profile to open the device with.
+         * @param inSeconds how long to play.
+         *
+         * @return true if the device could be opened.
+         */
+        static char measureProfile( AudioLatencyProfile inProfile,
+                                    double inSeconds );
+
+
+
+    };
+
+
+
+#endif
@@ -0,0 +1,559 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "LevelCache.h"
+#include "LevelDirectoryManager.h"
+
+
+#include "minorGems/util/stringUtils.h"
+
+
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifndef WIN_32
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+#endif
+
+
+
+// every entry file starts with this header, followed by the entry data
+static const char *cacheMagic = "TRC1";
+
+// written in native byte order to detect files from other machines
+static const unsigned int cacheByteOrderTag = 0x01020304;
+
+static const unsigned long cacheHeaderLength = 16;
+
+
+
+// static data members
+StaticLevelCacheWrapper LevelCache::mWrapper;
+
+
+
+LevelCacheEntry::LevelCacheEntry( unsigned char *inMapping,
+                                  unsigned long inMappingLength,
+                                  char inMapped,
+                                  unsigned long inHeaderLength )
+    : mData( &( inMapping[ inHeaderLength ] ) ),
+      mLength( inMappingLength - inHeaderLength ),
+      mMapping( inMapping ),
+      mMappingLength( inMappingLength ),
+      mMapped( inMapped ) {
+
+    }
+
+
+
+LevelCacheEntry::~LevelCacheEntry() {
+    #ifndef WIN_32
+    if( mMapped ) {
+        munmap( mMapping, mMappingLength );
+        return;
+        }
+    #endif
+
+    delete [] mMapping;
+    }
+
+
+
+LevelCacheWriter::LevelCacheWriter( FILE *inFILE, char *inTempPath,
+                                    char *inFinalPath )
+    : mFILE( inFILE ), mTempPath( inTempPath ),
+      mFinalPath( inFinalPath ) {
+
+    }
+
+
+
+LevelCacheWriter::~LevelCacheWriter() {
+    if( mFILE != NULL ) {
+        fclose( mFILE );
+        }
+    delete [] mTempPath;
+    if( mFinalPath != NULL ) {
+        delete [] mFinalPath;
+        }
+    }
+
+
+
+char LevelCacheEntry::readValue( unsigned long *inoutPosition,
+                                 void *outValue, unsigned long inSize ) {
+    if( *inoutPosition + inSize > mLength ) {
+        return false;
+        }
+
+    // memcpy, since the data may not be aligned for this value
+    memcpy( outValue, &( mData[ *inoutPosition ] ), inSize );
+
+    *inoutPosition += inSize;
+
+    return true;
+    }
+
+
+
+void LevelCache::setCacheDirectory( File *inDirectory ) {
+    mWrapper.mLock->lock();
+
+    if( mWrapper.mDirectory != NULL ) {
+        delete mWrapper.mDirectory;
+        }
+
+    mWrapper.mDirectory = inDirectory;
+
+    if( mWrapper.mDirectory != NULL ) {
+        if( !mWrapper.mDirectory->exists() ) {
+            mWrapper.mDirectory->makeDirectory();
+            }
+
+        if( !mWrapper.mDirectory->isDirectory() ) {
+            char *directoryName = mWrapper.mDirectory->getFullFileName();
+            printf( "Error creating cache directory %s, cache disabled\n",
+                    directoryName );
+            delete [] directoryName;
+
+            delete mWrapper.mDirectory;
+            mWrapper.mDirectory = NULL;
+            }
+        }
+
+    mWrapper.mLock->unlock();
+    }
+
+
+
+void LevelCache::setMaxCacheSize( unsigned long inMaxSize ) {
+    mWrapper.mLock->lock();
+    mWrapper.mMaxSize = inMaxSize;
+    mWrapper.mLock->unlock();
+    }
+
+
+
+void LevelCache::setRebuild( char inRebuild ) {
+    mWrapper.mLock->lock();
+    mWrapper.mRebuild = inRebuild;
+    mWrapper.mLock->unlock();
+    }
+
+
+
+char LevelCache::isEnabled() {
+    mWrapper.mLock->lock();
+    char enabled = ( mWrapper.mDirectory != NULL );
+    mWrapper.mLock->unlock();
+
+    return enabled;
+    }
+
+
+
+unsigned long LevelCache::hashData( unsigned char *inData,
+                                    unsigned long inLength,
+                                    unsigned long inPreviousHash ) {
+    // 32-bit FNV-1a
+    unsigned long hash = inPreviousHash;
+
+    for( unsigned long i=0; i<inLength; i++ ) {
+        hash ^= inData[i];
+        hash = ( hash * 16777619U ) & 0xFFFFFFFFU;
+        }
+
+    return hash;
+    }
+
+
+
+unsigned long LevelCache::hashLevelFile( char *inFileName,
+                                         unsigned long inPreviousHash ) {
+
+    // include the name so that swapping the contents of two files
+    // changes the hash
+    unsigned long hash = hashData( (unsigned char *)inFileName,
+                                   strlen( inFileName ) + 1,
+                                   inPreviousHash );
+
+    char *contents = LevelDirectoryManager::readFileContents( inFileName,
+                                                              false );
+    if( contents != NULL ) {
+        hash = hashData( (unsigned char *)contents, strlen( contents ),
+                         hash );
+        delete [] contents;
+        }
+
+    return hash;
+    }
+
+
+
+unsigned long LevelCache::hashLevelDirectory( char *inDirectoryName,
+                                              unsigned long inPreviousHash ) {
+
+    unsigned long hash = hashData( (unsigned char *)inDirectoryName,
+                                   strlen( inDirectoryName ) + 1,
+                                   inPreviousHash );
+
+    File *levelDirectory = LevelDirectoryManager::getLevelDirectory();
+    File *directory = levelDirectory->getChildFile( inDirectoryName );
+    delete levelDirectory;
+
+    if( directory == NULL ) {
+        return hash;
+        }
+
+    if( directory->exists() && directory->isDirectory() ) {
+        int numChildren;
+        File **children = directory->getChildFiles( &numChildren );
+
+        // sum the file hashes so that listing order does not matter
+        unsigned long fileHashSum = 0;
+
+        for( int i=0; i<numChildren; i++ ) {
+            char *name = children[i]->getFileName();
+            unsigned long fileHash =
+                hashData( (unsigned char *)name, strlen( name ) + 1 );
+            delete [] name;
+
+            char *contents = children[i]->readFileContents();
+            if( contents != NULL ) {
+                fileHash = hashData( (unsigned char *)contents,
+                                     strlen( contents ), fileHash );
+                delete [] contents;
+                }
+
+            fileHashSum = ( fileHashSum + fileHash ) & 0xFFFFFFFFU;
+
+            delete children[i];
+            }
+        delete [] children;
+
+        unsigned int sum = (unsigned int)fileHashSum;
+        hash = hashData( (unsigned char *)&sum, sizeof( sum ), hash );
+        }
+
+    delete directory;
+
+    return hash;
+    }
+
+
+
+char *LevelCache::getEntryPath( char *inEntryName, char inTemporary ) {
+
+    char *path = NULL;
+
+    mWrapper.mLock->lock();
+
+    if( mWrapper.mDirectory != NULL ) {
+        char *fileName;
+
+        if( inTemporary ) {
+            fileName = autoSprintf( "%s.%lu.tmp", inEntryName,
+                                    mWrapper.mNextTempFileNumber );
+            mWrapper.mNextTempFileNumber++;
+            }
+        else {
+            fileName = autoSprintf( "%s.cache", inEntryName );
+            }
+
+        File *entryFile = mWrapper.mDirectory->getChildFile( fileName );
+        delete [] fileName;
+
+        path = entryFile->getFullFileName();
+        delete entryFile;
+        }
+
+    mWrapper.mLock->unlock();
+
+    return path;
+    }
+
+
+
+LevelCacheEntry *LevelCache::readEntry( char *inEntryName ) {
+
+    mWrapper.mLock->lock();
+    char rebuild = mWrapper.mRebuild;
+    mWrapper.mLock->unlock();
+
+    if( rebuild ) {
+        return NULL;
+        }
+
+    char *path = getEntryPath( inEntryName, false );
+
+    if( path == NULL ) {
+        return NULL;
+        }
+
+
+    unsigned char *mapping = NULL;
+    unsigned long mappingLength = 0;
+    char mapped = false;
+
+    struct stat fileInfo;
+
+    if( stat( path, &fileInfo ) == 0 &&
+        (unsigned long)( fileInfo.st_size ) >= cacheHeaderLength ) {
+
+        mappingLength = fileInfo.st_size;
+
+        #ifndef WIN_32
+            int fileDescriptor = open( path, O_RDONLY );
+
+            if( fileDescriptor != -1 ) {
+                void *address = mmap( NULL, mappingLength, PROT_READ,
+                                      MAP_PRIVATE, fileDescriptor, 0 );
+                close( fileDescriptor );
+
+                if( address != MAP_FAILED ) {
+                    mapping = (unsigned char *)address;
+                    mapped = true;
+                    }
+                }
+        #else
+            FILE *file = fopen( path, "rb" );
+
+            if( file != NULL ) {
+                mapping = new unsigned char[ mappingLength ];
+
+                if( fread( mapping, 1, mappingLength, file )
+                    != mappingLength ) {
+                    delete [] mapping;
+                    mapping = NULL;
+                    }
+                fclose( file );
+                }
+        #endif
+        }
+
+
+    if( mapping == NULL ) {
+        // missing entry
+        delete [] path;
+        return NULL;
+        }
+
+
+    LevelCacheEntry *entry = new LevelCacheEntry( mapping, mappingLength,
+                                                  mapped,
+                                                  cacheHeaderLength );
+
+    // validate header
+    unsigned int byteOrderTag, dataLength, dataHash;
+    memcpy( &byteOrderTag, &( mapping[4] ), 4 );
+    memcpy( &dataLength, &( mapping[8] ), 4 );
+    memcpy( &dataHash, &( mapping[12] ), 4 );
+
+    if( memcmp( mapping, cacheMagic, 4 ) != 0 ||
+        byteOrderTag != cacheByteOrderTag ||
+        dataLength != entry->mLength ||
+        dataHash != hashData( entry->mData, entry->mLength ) ) {
+
+        printf( "Ignoring invalid cache file %s\n", path );
+
+        delete entry;
+        entry = NULL;
+        }
+
+    delete [] path;
+
+    return entry;
+    }
+
+
+
+LevelCacheWriter *LevelCache::startEntry( char *inEntryName ) {
+    char *tempPath = getEntryPath( inEntryName, true );
+
+    if( tempPath == NULL ) {
+        return NULL;
+        }
+
+    FILE *file = fopen( tempPath, "w+b" );
+
+    if( file == NULL ) {
+        printf( "Error opening cache file %s for writing\n", tempPath );
+
+        delete [] tempPath;
+        return NULL;
+        }
+
+    
+    // header is filled in by finishEntry
+    unsigned char emptyHeader[ cacheHeaderLength ];
+    memset( emptyHeader, 0, cacheHeaderLength );
+    fwrite( emptyHeader, 1, cacheHeaderLength, file );
+
+    return new LevelCacheWriter( file, tempPath,
+                                 getEntryPath( inEntryName, false ) );
+    }
+
+
+
+void LevelCache::finishEntry( LevelCacheWriter *inWriter ) {
+    FILE *file = inWriter->mFILE;
+    
+    fflush( file );
+
+    fseek( file, 0, SEEK_END );
+    unsigned int dataLength =
+        (unsigned int)( ftell( file ) - cacheHeaderLength );
+
+
+    // hash the data
+    fseek( file, cacheHeaderLength, SEEK_SET );
+
+    unsigned long hash = 2166136261U;
+    unsigned char buffer[ 4096 ];
+
+    size_t numRead = fread( buffer, 1, sizeof( buffer ), file );
+    while( numRead > 0 ) {
+        hash = hashData( buffer, numRead, hash );
+        numRead = fread( buffer, 1, sizeof( buffer ), file );
+        }
+    unsigned int dataHash = (unsigned int)hash;
+
+
+    fseek( file, 0, SEEK_SET );
+    fwrite( cacheMagic, 1, 4, file );
+    fwrite( &cacheByteOrderTag, 4, 1, file );
+    fwrite( &dataLength, 4, 1, file );
+    fwrite( &dataHash, 4, 1, file );
+
+    char writeError = ( ferror( file ) != 0 );
+
+    fclose( file );
+    inWriter->mFILE = NULL;
+
+    
+    if( writeError || inWriter->mFinalPath == NULL ) {
+        printf( "Error writing cache file %s\n", inWriter->mTempPath );
+        ::remove( inWriter->mTempPath );
+        }
+    else {
+        mWrapper.mLock->lock();
+
+        // replace any old entry in one step so that readers never
+        // see a partial file
+        ::remove( inWriter->mFinalPath );
+
+        if( rename( inWriter->mTempPath, inWriter->mFinalPath ) != 0 ) {
+            printf( "Error renaming cache file %s to %s\n",
+                    inWriter->mTempPath, inWriter->mFinalPath );
+            ::remove( inWriter->mTempPath );
+            }
+        else if( mWrapper.mDirectory != NULL ) {
+            enforceSizeLimit( inWriter->mFinalPath );
+            }
+        
+        mWrapper.mLock->unlock();
+        }
+
+    delete inWriter;
+    }
+
+
+
+void LevelCache::enforceSizeLimit( char *inKeepPath ) {
+    int numChildren;
+    File **children = mWrapper.mDirectory->getChildFiles( &numChildren );
+
+    char **paths = new char*[ numChildren ];
+    unsigned long *sizes = new unsigned long[ numChildren ];
+    long *times = new long[ numChildren ];
+
+    unsigned long totalSize = 0;
+
+    int i;
+    for( i=0; i<numChildren; i++ ) {
+        paths[i] = children[i]->getFullFileName();
+        delete children[i];
+
+        sizes[i] = 0;
+        times[i] = 0;
+
+        int pathLength = strlen( paths[i] );
+
+        if( pathLength >= 4 &&
+            strcmp( &( paths[i][ pathLength - 4 ] ), ".tmp" ) == 0 ) {
+            // another writer's entry that is not finished yet
+            delete [] paths[i];
+            paths[i] = NULL;
+            continue;
+            }
+
+        struct stat fileInfo;
+        if( stat( paths[i], &fileInfo ) == 0 ) {
+            sizes[i] = fileInfo.st_size;
+            times[i] = fileInfo.st_mtime;
+            }
+        totalSize += sizes[i];
+        }
+    delete [] children;
+
+
+    while( totalSize > mWrapper.mMaxSize ) {
+        // remove the oldest remaining file
+        int oldestIndex = -1;
+        for( i=0; i<numChildren; i++ ) {
+            if( paths[i] != NULL &&
+                strcmp( paths[i], inKeepPath ) != 0 &&
+                ( oldestIndex == -1 || times[i] < times[ oldestIndex ] ) ) {
+                oldestIndex = i;
+                }
+            }
+
+        if( oldestIndex == -1 ) {
+            break;
+            }
+
+        ::remove( paths[ oldestIndex ] );
+        totalSize -= sizes[ oldestIndex ];
+
+        delete [] paths[ oldestIndex ];
+        paths[ oldestIndex ] = NULL;
+        }
+
+    for( i=0; i<numChildren; i++ ) {
+        if( paths[i] != NULL ) {
+            delete [] paths[i];
+            }
+        }
+    delete [] paths;
+    delete [] sizes;
+    delete [] times;
+    }
+
+
+
+StaticLevelCacheWrapper::StaticLevelCacheWrapper()
+    : mDirectory( NULL ),
+      mMaxSize( 32 * 1024 * 1024 ),
+      mRebuild( false ),
+      mNextTempFileNumber( 0 ),
+      mLock( new MutexLock() ) {
+
+    }
+
+
+
+StaticLevelCacheWrapper::~StaticLevelCacheWrapper() {
+    if( mDirectory != NULL ) {
+        delete mDirectory;
+        }
+    delete mLock;
+    }
@@ -0,0 +1,353 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef LEVEL_CACHE_INCLUDED
+#define LEVEL_CACHE_INCLUDED
+
+
+
+#include "minorGems/io/file/File.h"
+#include "minorGems/system/MutexLock.h"
+
+
+#include <stdio.h>
+
+
+
+/**
+ * The data of one entry read back from the cache.
+ *
+ * On platforms that support it, the data is memory-mapped straight from
+ * the cache file, so it stays valid only as long as this entry exists.
+ *
+ * @author Jason Rohrer.
+ */
+class LevelCacheEntry {
+
+    public:
+
+
+
+        /**
+         * Constructs an entry.  Only called by LevelCache.
+         *
+         * @param inMapping the start of the mapped (or read) file.
+         *   Will be destroyed by this class.
+         * @param inMappingLength the length of inMapping in bytes.
+         * @param inMapped true if inMapping is a memory map, or false
+         *   if it was allocated with new[].
+         * @param inHeaderLength the number of bytes at the start of
+         *   inMapping that precede the data.
+         */
+        LevelCacheEntry( unsigned char *inMapping,
+                         unsigned long inMappingLength,
+                         char inMapped,
+                         unsigned long inHeaderLength );
+
+
+
+        ~LevelCacheEntry();
+
+
+
+        // the data stored in this entry
+        // Must not be modified or destroyed by caller.
+        unsigned char *mData;
+        unsigned long mLength;
+
+
+
+        /**
+         * Reads a value from the data of this entry, advancing a
+         * read position.
+         *
+         * @param inoutPosition pointer to the offset in mData to read
+         *   from.  Will be advanced past the value.
+         * @param outValue pointer to where the value should be returned.
+         * @param inSize the size of the value in bytes.
+         *
+         * @return true if the value was read, or false if reading it
+         *   would pass the end of the data.
+         */
+        char readValue( unsigned long *inoutPosition,
+                        void *outValue, unsigned long inSize );
+
+
+
+    protected:
+        unsigned char *mMapping;
+        unsigned long mMappingLength;
+        char mMapped;
+
+    };
+
+
+
+/**
+ * An entry that is being written to the cache.
+ *
+ * @author Jason Rohrer.
+ */
+class LevelCacheWriter {
+
+    public:
+
+
+
+        /**
+         * Constructs a writer.  Only called by LevelCache.
+         *
+         * @param inFILE the open temporary file.
+         *   Will be closed by LevelCache::finishEntry.
+         * @param inTempPath the path of the temporary file.
+         *   Will be destroyed by this class.
+         * @param inFinalPath the path of the finished entry.
+         *   Will be destroyed by this class.
+         */
+        LevelCacheWriter( FILE *inFILE, char *inTempPath,
+                          char *inFinalPath );
+
+
+
+        ~LevelCacheWriter();
+
+
+
+        // the stream to write entry data to
+        // Must not be closed by caller.
+        FILE *mFILE;
+
+        char *mTempPath;
+        char *mFinalPath;
+
+    };
+
+
+
+/**
+ * A wrapper class to ensure destruction of cache state at system exit.
+ */
+class StaticLevelCacheWrapper {
+
+    public:
+
+        StaticLevelCacheWrapper();
+
+        ~StaticLevelCacheWrapper();
+
+        // NULL if cache is disabled
+        File *mDirectory;
+
+        unsigned long mMaxSize;
+
+        char mRebuild;
+
+        // used to give temporary files unique names
+        unsigned long mNextTempFileNumber;
+
+        // protects all members
+        MutexLock *mLock;
+    };
+
+
+
+/**
+ * A class with static functions for storing data computed from level
+ * files on disk so that it need not be recomputed on the next run.
+ *
+ * Entries are named by their creators, and each name should include a
+ * hash of the source data the entry was computed from (see hashData),
+ * so that a changed level file never matches a stale entry.
+ *
+ * All functions are thread-safe.
+ *
+ * @author Jason Rohrer.
+ */
+class LevelCache {
+
+
+    public:
+
+
+
+        /**
+         * Sets the cache directory, creating it if necessary.
+         *
+         * The cache is disabled until this function is called.
+         *
+         * @param inDirectory the directory, or NULL to disable the cache.
+         *   Will be destroyed by this class.
+         */
+        static void setCacheDirectory( File *inDirectory );
+
+
+
+        /**
+         * Sets the maximum total size of all entries.  When a new entry
+         * pushes the cache over this size, the least recently written
+         * entries are removed.
+         *
+         * @param inMaxSize the size in bytes.
+         *   Defaults to 32 MiB.
+         */
+        static void setMaxCacheSize( unsigned long inMaxSize );
+
+
+
+        /**
+         * Sets whether existing entries should be ignored (and
+         * overwritten as they are recomputed).
+         *
+         * @param inRebuild true to rebuild the cache.
+         */
+        static void setRebuild( char inRebuild );
+
+
+
+        /**
+         * Gets whether the cache is enabled.
+         *
+         * @return true if entries will be read and written.
+         */
+        static char isEnabled();
+
+
+
+        /**
+         * Hashes a block of data.
+         *
+         * @param inData the data to hash.
+         *   Must be destroyed by caller.
+         * @param inLength the length of inData in bytes.
+         * @param inPreviousHash a previous return value to combine with,
+         *   allowing several blocks to be hashed together.
+         *   Defaults to the starting hash value.
+         *
+         * @return a 32-bit hash.
+         */
+        static unsigned long hashData( unsigned char *inData,
+                                       unsigned long inLength,
+                                       unsigned long inPreviousHash
+                                           = 2166136261U );
+
+
+
+        /**
+         * Hashes the contents of a file in the current level directory.
+         *
+         * @param inFileName the name of the file.
+         *   Must be destroyed by caller.
+         * @param inPreviousHash a previous hash to combine with.
+         *
+         * @return the combined hash.  A missing file is hashed as
+         *   if it was empty.
+         */
+        static unsigned long hashLevelFile( char *inFileName,
+                                            unsigned long inPreviousHash
+                                                = 2166136261U );
+
+
+
+        /**
+         * Hashes the contents of all files in a subdirectory of the current
+         * level directory.
+         *
+         * @param inDirectoryName the name of the subdirectory.
+         *   Must be destroyed by caller.
+         * @param inPreviousHash a previous hash to combine with.
+         *
+         * @return the combined hash.  The result does not depend on the
+         *   order in which files are listed.
+         */
+        static unsigned long hashLevelDirectory( char *inDirectoryName,
+                                                 unsigned long inPreviousHash
+                                                     = 2166136261U );
+
+
+
+        /**
+         * Reads an entry from the cache.
+         *
+         * @param inEntryName the name of the entry.
+         *   Must be destroyed by caller.
+         *
+         * @return the entry, or NULL if the cache is disabled, being
+         *   rebuilt, or has no valid entry with this name.
+         *   Must be destroyed by caller.
+         */
+        static LevelCacheEntry *readEntry( char *inEntryName );
+
+
+
+        /**
+         * Starts writing an entry to the cache.
+         *
+         * @param inEntryName the name of the entry.
+         *   Must be destroyed by caller.
+         *
+         * @return a writer whose stream the entry data should be written
+         *   to, or NULL if the cache is disabled or the entry cannot be
+         *   written.
+         *   Must be passed to finishEntry.
+         */
+        static LevelCacheWriter *startEntry( char *inEntryName );
+
+
+
+        /**
+         * Finishes writing an entry, making it available to readEntry.
+         *
+         * @param inWriter the writer returned by startEntry.
+         *   Will be destroyed by this call.
+         */
+        static void finishEntry( LevelCacheWriter *inWriter );
+
+
+
+    protected:
+
+        static StaticLevelCacheWrapper mWrapper;
+
+
+
+        /**
+         * Gets the full path of an entry's file.
+         *
+         * @param inEntryName the name of the entry.
+         *   Must be destroyed by caller.
+         * @param inTemporary true to get the path of the temporary file
+         *   used while writing the entry.
+         *
+         * @return the path, or NULL if the cache is disabled.
+         *   Must be destroyed by caller.
+         */
+        static char *getEntryPath( char *inEntryName, char inTemporary );
+
+
+
+        /**
+         * Removes the oldest entries until the cache fits within
+         * its size limit.
+         *
+         * Temporary files of entries that are still being written are
+         * neither counted nor removed.
+         *
+         * Must be called with the cache lock held.
+         *
+         * @param inKeepPath the path of an entry that should not be
+         *   removed (the one just written).
+         *   Must be destroyed by caller.
+         */
+        static void enforceSizeLimit( char *inKeepPath );
+
+    };
+
+
+
+#endif
@@ -9,6 +9,10 @@
  *
  * 2004-June-21   Jason Rohrer
  * Added function for reading int values.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Made thread-safe so that level files can be read by several loading
+ * threads at once.
  */
 
 
@@ -26,19 +30,34 @@ StaticLevelDirectoryFileWrapper LevelDirectoryManager::mFileWrapper;
 
 void LevelDirectoryManager::setLevelDirectory( File *inFile ) {
 
+    mFileWrapper.mLock->lock();
+    
     if( mFileWrapper.mFile != NULL ) {
         delete mFileWrapper.mFile;
         }
 
-    mFileWrapper.mFile = inFile;    
+    mFileWrapper.mFile = inFile;
+
+    mFileWrapper.mLock->unlock();
     }
 
 
 
 File *LevelDirectoryManager::getLevelDirectory() {
 
+    File *returnValue = NULL;
+    
+    mFileWrapper.mLock->lock();
+    
     if( mFileWrapper.mFile != NULL ) {
-        return mFileWrapper.mFile->copy();
+        returnValue = mFileWrapper.mFile->copy();
+        }
+
+    mFileWrapper.mLock->unlock();
+
+    
+    if( returnValue != NULL ) {
+        return returnValue;
         }
     else {
         // return default location... level 1
@@ -224,6 +243,7 @@ int LevelDirectoryManager::readIntFileContents(
 
 StaticLevelDirectoryFileWrapper::StaticLevelDirectoryFileWrapper() {
     mFile = NULL;
+    mLock = new MutexLock();
     }
 
 
@@ -232,4 +252,5 @@ StaticLevelDirectoryFileWrapper::~StaticLevelDirectoryFileWrapper() {
     if( mFile != NULL ) {
         delete mFile;
         }
+    delete mLock;
     }
@@ -9,6 +9,10 @@
  *
  * 2004-June-21   Jason Rohrer
  * Added function for reading int values.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Made thread-safe so that level files can be read by several loading
+ * threads at once.
  */
 
 
@@ -19,6 +23,7 @@
 
 
 #include "minorGems/io/file/File.h"
+#include "minorGems/system/MutexLock.h"
 
 
 #include <stdio.h>
@@ -37,6 +42,9 @@ class StaticLevelDirectoryFileWrapper {
         ~StaticLevelDirectoryFileWrapper();
 
         File *mFile;
+
+        // protects mFile
+        MutexLock *mLock;
     };
 
 
@@ -45,6 +53,10 @@ class StaticLevelDirectoryFileWrapper {
  * A class with static functions for setting and obtaining the current
  * level directory.
  *
+ * All functions are thread-safe.  Callers only ever receive their own
+ * copies of the directory File, so level files can be read from several
+ * threads at once (for example, by the tasks in a LevelLoadTaskGraph).
+ *
  * @author Jason Rohrer.
  */
 class LevelDirectoryManager {
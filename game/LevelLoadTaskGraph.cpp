@@ -0,0 +1,338 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "LevelLoadTaskGraph.h"
+
+
+#include "minorGems/system/Thread.h"
+#include "minorGems/system/Time.h"
+#include "minorGems/util/stringUtils.h"
+
+
+
+/**
+ * A thread that pulls ready tasks from a graph until told to stop.
+ */
+class LevelLoadWorkerThread : public Thread {
+
+    public:
+
+        LevelLoadWorkerThread( LevelLoadTaskGraph *inGraph )
+            : mGraph( inGraph ) {
+            }
+
+        // implements the Thread interface
+        virtual void run();
+
+    protected:
+        LevelLoadTaskGraph *mGraph;
+    };
+
+
+
+void LevelLoadWorkerThread::run() {
+
+    LevelLoadTask *task = mGraph->waitForReadyTask();
+
+    while( task != NULL ) {
+        task->mStartTime = mGraph->getElapsedMilliseconds();
+
+        task->doWork();
+
+        task->mFinishTime = mGraph->getElapsedMilliseconds();
+
+        mGraph->taskDone( task );
+
+        task = mGraph->waitForReadyTask();
+        }
+    }
+
+
+
+LevelLoadTask::LevelLoadTask( char *inName )
+    : mName( stringDuplicate( inName ) ),
+      mDependencies( new SimpleVector<LevelLoadTask *>() ),
+      mDependents( new SimpleVector<LevelLoadTask *>() ),
+      mNumUnfinishedDependencies( 0 ),
+      mStartTime( 0 ), mFinishTime( 0 ) {
+
+    }
+
+
+
+LevelLoadTask::~LevelLoadTask() {
+    delete [] mName;
+    delete mDependencies;
+    delete mDependents;
+    }
+
+
+
+void LevelLoadTask::addDependency( LevelLoadTask *inTask ) {
+    mDependencies->push_back( inTask );
+    inTask->mDependents->push_back( this );
+    }
+
+
+
+LevelLoadTaskGraph::LevelLoadTaskGraph( int inNumThreads )
+    : mNumThreads( inNumThreads ),
+      mTasks( new SimpleVector<LevelLoadTask *>() ),
+      mLock( new MutexLock() ),
+      mReadyTasks( new SimpleVector<LevelLoadTask *>() ),
+      mReadySemaphore( new Semaphore() ),
+      mDoneSemaphore( new Semaphore() ),
+      mNumTasksRemaining( 0 ),
+      mNumTasksRunning( 0 ),
+      mStopping( false ),
+      mStartSeconds( 0 ), mStartMilliseconds( 0 ),
+      mTotalTime( 0 ) {
+
+    if( mNumThreads < 1 ) {
+        mNumThreads = 1;
+        }
+    }
+
+
+
+LevelLoadTaskGraph::~LevelLoadTaskGraph() {
+    int numTasks = mTasks->size();
+
+    for( int i=0; i<numTasks; i++ ) {
+        delete *( mTasks->getElement( i ) );
+        }
+    delete mTasks;
+
+    delete mReadyTasks;
+    delete mReadySemaphore;
+    delete mDoneSemaphore;
+    delete mLock;
+    }
+
+
+
+void LevelLoadTaskGraph::addTask( LevelLoadTask *inTask ) {
+    mTasks->push_back( inTask );
+    }
+
+
+
+unsigned long LevelLoadTaskGraph::getElapsedMilliseconds() {
+    return Time::getMillisecondsSince( mStartSeconds, mStartMilliseconds );
+    }
+
+
+
+void LevelLoadTaskGraph::run() {
+    Time::getCurrentTime( &mStartSeconds, &mStartMilliseconds );
+
+    int numTasks = mTasks->size();
+
+    if( numTasks == 0 ) {
+        return;
+        }
+
+    mStopping = false;
+    mNumTasksRunning = 0;
+    mNumTasksRemaining = numTasks;
+
+    int i;
+    for( i=0; i<numTasks; i++ ) {
+        LevelLoadTask *task = *( mTasks->getElement( i ) );
+
+        task->mNumUnfinishedDependencies = task->mDependencies->size();
+
+        if( task->mNumUnfinishedDependencies == 0 ) {
+            mReadyTasks->push_back( task );
+            mReadySemaphore->signal();
+            }
+        }
+
+    if( mReadyTasks->size() == 0 ) {
+        printf( "Error:  level load task graph has no task that can "
+                "start first\n" );
+        return;
+        }
+
+
+    // never start more threads than there are tasks
+    int numThreads = mNumThreads;
+    if( numThreads > numTasks ) {
+        numThreads = numTasks;
+        }
+
+    LevelLoadWorkerThread **threads = new LevelLoadWorkerThread*[ numThreads ];
+
+    for( i=0; i<numThreads; i++ ) {
+        threads[i] = new LevelLoadWorkerThread( this );
+        threads[i]->start();
+        }
+
+
+    mDoneSemaphore->wait();
+
+
+    // wake each worker so that it sees the stop flag
+    mLock->lock();
+    mStopping = true;
+    mLock->unlock();
+
+    for( i=0; i<numThreads; i++ ) {
+        mReadySemaphore->signal();
+        }
+
+    for( i=0; i<numThreads; i++ ) {
+        threads[i]->join();
+        delete threads[i];
+        }
+    delete [] threads;
+
+    mTotalTime = getElapsedMilliseconds();
+    }
+
+
+
+LevelLoadTask *LevelLoadTaskGraph::waitForReadyTask() {
+    mReadySemaphore->wait();
+
+    LevelLoadTask *task = NULL;
+
+    mLock->lock();
+
+    if( !mStopping && mReadyTasks->size() > 0 ) {
+        task = *( mReadyTasks->getElement( 0 ) );
+        mReadyTasks->deleteElement( 0 );
+
+        mNumTasksRunning++;
+        }
+
+    mLock->unlock();
+
+    return task;
+    }
+
+
+
+void LevelLoadTaskGraph::taskDone( LevelLoadTask *inTask ) {
+    mLock->lock();
+
+    mNumTasksRunning--;
+    mNumTasksRemaining--;
+
+    int numDependents = inTask->mDependents->size();
+    for( int i=0; i<numDependents; i++ ) {
+        LevelLoadTask *dependent = *( inTask->mDependents->getElement( i ) );
+
+        dependent->mNumUnfinishedDependencies--;
+
+        if( dependent->mNumUnfinishedDependencies == 0 ) {
+            mReadyTasks->push_back( dependent );
+            mReadySemaphore->signal();
+            }
+        }
+
+    char done = false;
+
+    if( mNumTasksRemaining == 0 ) {
+        done = true;
+        }
+    else if( mNumTasksRunning == 0 && mReadyTasks->size() == 0 ) {
+        // nothing left that can ever start
+        printf( "Error:  level load task graph contains a dependency "
+                "cycle, %d tasks never ran\n", mNumTasksRemaining );
+        done = true;
+        }
+
+    mLock->unlock();
+
+    if( done ) {
+        mDoneSemaphore->signal();
+        }
+    }
+
+
+
+unsigned long LevelLoadTaskGraph::getCriticalPathLength(
+    LevelLoadTask *inTask,
+    LevelLoadTask **outPrevious ) {
+
+    unsigned long longestDependencyPath = 0;
+    *outPrevious = NULL;
+
+    int numDependencies = inTask->mDependencies->size();
+    for( int i=0; i<numDependencies; i++ ) {
+        LevelLoadTask *dependency =
+            *( inTask->mDependencies->getElement( i ) );
+
+        LevelLoadTask *unusedPrevious;
+        unsigned long length = getCriticalPathLength( dependency,
+                                                      &unusedPrevious );
+        if( length >= longestDependencyPath ) {
+            longestDependencyPath = length;
+            *outPrevious = dependency;
+            }
+        }
+
+    return longestDependencyPath +
+        ( inTask->mFinishTime - inTask->mStartTime );
+    }
+
+
+
+void LevelLoadTaskGraph::printTimings() {
+    int numTasks = mTasks->size();
+
+    printf( "Level load took %lu ms on %d threads:\n",
+            mTotalTime, mNumThreads );
+
+    int i;
+    for( i=0; i<numTasks; i++ ) {
+        LevelLoadTask *task = *( mTasks->getElement( i ) );
+
+        printf( "    %-24s start %5lu ms, finish %5lu ms, took %5lu ms\n",
+                task->mName, task->mStartTime, task->mFinishTime,
+                task->mFinishTime - task->mStartTime );
+        }
+
+
+    // find the task that ends the longest chain
+    LevelLoadTask *criticalEnd = NULL;
+    unsigned long criticalLength = 0;
+
+    for( i=0; i<numTasks; i++ ) {
+        LevelLoadTask *task = *( mTasks->getElement( i ) );
+
+        LevelLoadTask *unusedPrevious;
+        unsigned long length = getCriticalPathLength( task,
+                                                      &unusedPrevious );
+        if( criticalEnd == NULL || length > criticalLength ) {
+            criticalEnd = task;
+            criticalLength = length;
+            }
+        }
+
+    if( criticalEnd != NULL ) {
+        printf( "    Critical path (%lu ms):  ", criticalLength );
+
+        // walk backwards from the end of the path
+        LevelLoadTask *task = criticalEnd;
+        while( task != NULL ) {
+            LevelLoadTask *previous;
+            getCriticalPathLength( task, &previous );
+
+            if( previous != NULL ) {
+                printf( "%s <- ", task->mName );
+                }
+            else {
+                printf( "%s\n", task->mName );
+                }
+            task = previous;
+            }
+        }
+    }
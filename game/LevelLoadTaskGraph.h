@@ -0,0 +1,297 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef LEVEL_LOAD_TASK_GRAPH_INCLUDED
+#define LEVEL_LOAD_TASK_GRAPH_INCLUDED
+
+
+
+#include "LevelDirectoryManager.h"
+
+
+#include "minorGems/util/SimpleVector.h"
+#include "minorGems/system/MutexLock.h"
+#include "minorGems/system/Semaphore.h"
+
+
+#include <stdio.h>
+
+
+
+/**
+ * One unit of work performed while loading a level.
+ *
+ * Subclasses implement doWork.
+ *
+ * @author Jason Rohrer.
+ */
+class LevelLoadTask {
+
+
+    public:
+
+
+
+        /**
+         * Constructs a task.
+         *
+         * @param inName the name of this task, used when printing timings.
+         *   Must be destroyed by caller.
+         */
+        LevelLoadTask( char *inName );
+
+
+
+        virtual ~LevelLoadTask();
+
+
+
+        /**
+         * Makes this task wait until another task has finished.
+         *
+         * Must be called before the graph containing these tasks is run.
+         *
+         * @param inTask the task that must finish before this task starts.
+         *   Must be destroyed by caller (or by the graph it was added to).
+         */
+        void addDependency( LevelLoadTask *inTask );
+
+
+
+        /**
+         * Performs the work of this task.
+         *
+         * Called from a worker thread, so it should only touch
+         * its own members and thread-safe classes like
+         * LevelDirectoryManager.
+         */
+        virtual void doWork() = 0;
+
+
+
+        char *mName;
+
+        // tasks that must finish before this one starts
+        SimpleVector<LevelLoadTask *> *mDependencies;
+
+        // tasks that are waiting for this one to finish
+        SimpleVector<LevelLoadTask *> *mDependents;
+
+        // set and used by LevelLoadTaskGraph
+        int mNumUnfinishedDependencies;
+
+        // in milliseconds since the start of LevelLoadTaskGraph::run
+        unsigned long mStartTime;
+        unsigned long mFinishTime;
+
+    };
+
+
+
+/**
+ * A task that constructs an object by reading from a file in the
+ * current level directory.
+ *
+ * Type must have a constructor of the form ( FILE *inFILE, char *outError )
+ * (for example, ParameterizedObject, ShipBullet, BulletSound, or Enemy).
+ *
+ * @author Jason Rohrer.
+ */
+template <class Type>
+class LevelFileLoadTask : public LevelLoadTask {
+
+
+    public:
+
+
+
+        /**
+         * Constructs a task.
+         *
+         * @param inFileName the name of the file in the level directory.
+         *   Must be destroyed by caller.
+         */
+        LevelFileLoadTask( char *inFileName );
+
+
+
+        // implements the LevelLoadTask interface
+        virtual void doWork();
+
+
+
+        // the constructed object, or NULL before doWork is called
+        // Must be destroyed by caller.
+        Type *mResult;
+
+        // true if constructing mResult failed
+        char mError;
+
+    };
+
+
+
+/**
+ * A dependency graph of level loading tasks that are executed on a small
+ * pool of worker threads.
+ *
+ * @author Jason Rohrer.
+ */
+class LevelLoadTaskGraph {
+
+
+    public:
+
+
+
+        /**
+         * Constructs an empty graph.
+         *
+         * @param inNumThreads the number of worker threads to run
+         *   tasks on.
+         */
+        LevelLoadTaskGraph( int inNumThreads );
+
+
+
+        virtual ~LevelLoadTaskGraph();
+
+
+
+        /**
+         * Adds a task to this graph.
+         *
+         * @param inTask the task to add.
+         *   Will be destroyed by this class.
+         */
+        void addTask( LevelLoadTask *inTask );
+
+
+
+        /**
+         * Runs all tasks, returning after every task has finished.
+         *
+         * Each task is started only after all of its dependencies
+         * have finished.
+         */
+        void run();
+
+
+
+        /**
+         * Prints the timing of each task and the critical path through
+         * the graph to standard out.
+         *
+         * Must be called after run.
+         */
+        void printTimings();
+
+
+
+        /**
+         * Gets the ready task that should be executed next by a worker.
+         *
+         * Only called by worker threads.
+         *
+         * @return a task, or NULL if the worker should stop.
+         */
+        LevelLoadTask *waitForReadyTask();
+
+
+
+        /**
+         * Marks a task as finished and readies any tasks that were
+         * waiting for it.
+         *
+         * Only called by worker threads.
+         *
+         * @param inTask the finished task.
+         */
+        void taskDone( LevelLoadTask *inTask );
+
+
+
+        /**
+         * Gets the time since run was called.
+         *
+         * @return the elapsed time in milliseconds.
+         */
+        unsigned long getElapsedMilliseconds();
+
+
+
+    protected:
+
+        int mNumThreads;
+
+        SimpleVector<LevelLoadTask *> *mTasks;
+
+        // protects all members below
+        MutexLock *mLock;
+
+        SimpleVector<LevelLoadTask *> *mReadyTasks;
+
+        // signaled once for each ready task, and once for each
+        // worker when all tasks are done
+        Semaphore *mReadySemaphore;
+
+        // signaled when all tasks are done
+        Semaphore *mDoneSemaphore;
+
+        int mNumTasksRemaining;
+        int mNumTasksRunning;
+        char mStopping;
+
+        unsigned long mStartSeconds;
+        unsigned long mStartMilliseconds;
+        unsigned long mTotalTime;
+
+
+
+        /**
+         * Gets the length of the longest chain of task durations
+         * ending with a task.
+         *
+         * @param inTask the task to end the chain with.
+         * @param outPrevious pointer to where the previous task in the
+         *   chain should be returned, or NULL if inTask starts the chain.
+         *
+         * @return the total duration of the chain in milliseconds.
+         */
+        unsigned long getCriticalPathLength( LevelLoadTask *inTask,
+                                             LevelLoadTask **outPrevious );
+
+    };
+
+
+
+template <class Type>
+inline LevelFileLoadTask<Type>::LevelFileLoadTask( char *inFileName )
+    : LevelLoadTask( inFileName ),
+      mResult( NULL ), mError( false ) {
+
+    }
+
+
+
+template <class Type>
+inline void LevelFileLoadTask<Type>::doWork() {
+    FILE *file = LevelDirectoryManager::getStdStream( mName, true );
+
+    mError = false;
+    mResult = new Type( file, &mError );
+
+    if( file != NULL ) {
+        fclose( file );
+        }
+    }
+
+
+
+#endif
@@ -6,6 +6,10 @@
  *
  * 2004-August-31   Jason Rohrer
  * Added brief fade-in at note start to reduce clicks.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added support for loading the sample table from the level cache.
+ * Cached samples checked for alignment before being used in place.
  */
 
 
@@ -14,6 +18,7 @@
 #include "LevelDirectoryManager.h"
 
 #include "minorGems/util/SimpleVector.h"
+#include "minorGems/util/stringUtils.h"
 
 #include <stdio.h>
 #include <math.h>
@@ -37,9 +42,35 @@ MusicNote *MusicNote::copy() {
 
 
 
-MusicNoteWaveTable::MusicNoteWaveTable( unsigned long inSamplesPerSecond ){
+MusicNoteWaveTable::MusicNoteWaveTable( unsigned long inSamplesPerSecond )
+    : mCacheEntry( NULL ) {
+
+    char *cacheEntryName = NULL;
+
+    if( LevelCache::isEnabled() ) {
+        // the table depends only on these files and the sample rate
+        unsigned long sourceHash =
+            LevelCache::hashLevelFile( "musicNotePitches" );
+        sourceHash = LevelCache::hashLevelFile( "musicNoteLengths",
+                                                sourceHash );
+
+        cacheEntryName = autoSprintf( "waveTable_%08lx_%lu",
+                                      sourceHash, inSamplesPerSecond );
+
+        mCacheEntry = LevelCache::readEntry( cacheEntryName );
 
+        if( mCacheEntry != NULL ) {
+            if( readFromCacheEntry() ) {
+                delete [] cacheEntryName;
+                return;
+                }
+            
+            delete mCacheEntry;
+            mCacheEntry = NULL;
+            }
+        }
 
+    
     // read frequencies and lengths from files
     
 
@@ -176,6 +207,12 @@ MusicNoteWaveTable::MusicNoteWaveTable( unsigned long inSamplesPerSecond ){
 
     
     delete [] frequencies;
+
+
+    if( cacheEntryName != NULL ) {
+        writeToCache( cacheEntryName );
+        delete [] cacheEntryName;
+        }
     }
 
 
@@ -183,10 +220,13 @@ MusicNoteWaveTable::MusicNoteWaveTable( unsigned long inSamplesPerSecond ){
 MusicNoteWaveTable::~MusicNoteWaveTable(){
 
     for( int F=0; F<mFrequencyCount; F++ ) {
-        for( int L=0; L<mLengthCount; L++ ) {
-
-            delete [] mSampleTable[F][L];
-
+        // arrays are part of the cache entry if we have one
+        if( mCacheEntry == NULL ) {
+            for( int L=0; L<mLengthCount; L++ ) {
+                
+                delete [] mSampleTable[F][L];
+                
+                }
             }
         delete [] mSampleTable[F];
         }
@@ -194,6 +234,135 @@ MusicNoteWaveTable::~MusicNoteWaveTable(){
     delete [] mSampleTable;
     delete [] mSampleCounts;
     delete [] mLengthsInSeconds;
+
+    if( mCacheEntry != NULL ) {
+        delete mCacheEntry;
+        }
+    }
+
+
+
+char MusicNoteWaveTable::readFromCacheEntry() {
+    // Entry layout:
+    //   int frequencyCount, int lengthCount
+    //   double lengthInSeconds[ lengthCount ]
+    //   unsigned int sampleCount[ lengthCount ]
+    //   float samples[ sampleCount[L] ] for each F, for each L
+    // The entry data starts 16 bytes into the mapped (or read) file, so
+    // it is only as aligned as that header leaves it, and the float
+    // arrays start 8 + 12 * lengthCount bytes further in.  They are
+    // used in place when that leaves them aligned for floats, which is
+    // checked below rather than assumed.
+    
+    unsigned long position = 0;
+    int frequencyCount, lengthCount;
+
+    if( ! mCacheEntry->readValue( &position, &frequencyCount,
+                                  sizeof( int ) ) ||
+        ! mCacheEntry->readValue( &position, &lengthCount,
+                                  sizeof( int ) ) ||
+        frequencyCount < 1 || lengthCount < 1 ) {
+        return false;
+        }
+
+    double *lengthsInSeconds = new double[ lengthCount ];
+    unsigned long *sampleCounts = new unsigned long[ lengthCount ];
+    
+    char error = false;
+    
+    int L;
+    for( L=0; L<lengthCount && !error; L++ ) {
+        error = ! mCacheEntry->readValue( &position,
+                                          &( lengthsInSeconds[L] ),
+                                          sizeof( double ) );
+        }
+    for( L=0; L<lengthCount && !error; L++ ) {
+        unsigned int count;
+        error = ! mCacheEntry->readValue( &position, &count,
+                                          sizeof( unsigned int ) );
+        sampleCounts[L] = count;
+        }
+
+    // each array is a whole number of floats, so if the first is
+    // aligned, they all are
+    if( (unsigned long)( &( mCacheEntry->mData[ position ] ) )
+        % sizeof( float ) != 0 ) {
+        error = true;
+        }
+    
+    float ***sampleTable = new float**[ frequencyCount ];
+
+    int F;
+    for( F=0; F<frequencyCount; F++ ) {
+        sampleTable[F] = new float*[ lengthCount ];
+
+        for( L=0; L<lengthCount; L++ ) {
+            sampleTable[F][L] = NULL;
+            
+            unsigned long numBytes = sampleCounts[L] * sizeof( float );
+            
+            if( !error && position + numBytes <= mCacheEntry->mLength ) {
+                sampleTable[F][L] =
+                    (float *)( &( mCacheEntry->mData[ position ] ) );
+                position += numBytes;
+                }
+            else {
+                error = true;
+                }
+            }
+        }
+
+    if( error || position != mCacheEntry->mLength ) {
+        for( F=0; F<frequencyCount; F++ ) {
+            delete [] sampleTable[F];
+            }
+        delete [] sampleTable;
+        delete [] sampleCounts;
+        delete [] lengthsInSeconds;
+
+        return false;
+        }
+
+    mFrequencyCount = frequencyCount;
+    mLengthCount = lengthCount;
+    mLengthsInSeconds = lengthsInSeconds;
+    mSampleCounts = sampleCounts;
+    mSampleTable = sampleTable;
+
+    return true;
+    }
+
+
+
+void MusicNoteWaveTable::writeToCache( char *inEntryName ) {
+    LevelCacheWriter *writer = LevelCache::startEntry( inEntryName );
+
+    if( writer == NULL ) {
+        return;
+        }
+
+    FILE *file = writer->mFILE;
+
+    // see readFromCacheEntry for layout
+    fwrite( &mFrequencyCount, sizeof( int ), 1, file );
+    fwrite( &mLengthCount, sizeof( int ), 1, file );
+
+    fwrite( mLengthsInSeconds, sizeof( double ), mLengthCount, file );
+
+    int L;
+    for( L=0; L<mLengthCount; L++ ) {
+        unsigned int count = mSampleCounts[L];
+        fwrite( &count, sizeof( unsigned int ), 1, file );
+        }
+
+    for( int F=0; F<mFrequencyCount; F++ ) {
+        for( L=0; L<mLengthCount; L++ ) {
+            fwrite( mSampleTable[F][L], sizeof( float ), mSampleCounts[L],
+                    file );
+            }
+        }
+
+    LevelCache::finishEntry( writer );
     }
 
 
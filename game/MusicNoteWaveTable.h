@@ -3,6 +3,10 @@
  *
  * 2004-August-22   Jason Rohrer
  * Created.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added support for loading the sample table from the level cache.
+ * Cached samples checked for alignment before being used in place.
  */
 
 
@@ -12,6 +16,10 @@
 
 
 
+#include "LevelCache.h"
+
+
+
 /**
  * Class representing a note that can be mapped into the wave table.
  */
@@ -69,6 +77,10 @@ class MusicNoteWaveTable {
          * Constructs a wave table.
          * Reads configuration using the LevelDirectoryManager.
          *
+         * If the LevelCache is enabled, a table rendered on a previous run
+         * from the same configuration is mapped from the cache instead of
+         * being rendered again.
+         *
          * @param inSamplesPerSecond the sample rate.
          */
         MusicNoteWaveTable( unsigned long inSamplesPerSecond );
@@ -152,6 +164,31 @@ class MusicNoteWaveTable {
         float ***mSampleTable;
         unsigned long *mSampleCounts;
         double *mLengthsInSeconds;
+
+        // if not NULL, the sample arrays in mSampleTable point into
+        // the data of this entry
+        LevelCacheEntry *mCacheEntry;
+
+
+
+        /**
+         * Sets up the table to use samples from mCacheEntry.
+         *
+         * @return true on success, or false if mCacheEntry is not a
+         *   valid table, or its samples are not aligned for use in place
+         *   (in which case no members are set up).
+         */
+        char readFromCacheEntry();
+
+
+
+        /**
+         * Writes this table to the cache.
+         *
+         * @param inEntryName the name of the cache entry.
+         *   Must be destroyed by caller.
+         */
+        void writeToCache( char *inEntryName );
         
     };
 
@@ -6,6 +6,10 @@
  *
  * 2004-August-26   Jason Rohrer
  * Added parameter to control character of part.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Changed intervals to exclude their ends, so that a note starting
+ * exactly between two buffers is not played twice.
  */
 
 
@@ -139,7 +143,7 @@ int MusicPart::getNotesStartingInInterval(
     double currentNoteStartTime = 0;
     
     for( int i=0;
-         i<numNotes && currentNoteStartTime <= endTimeInSeconds;
+         i<numNotes && currentNoteStartTime < endTimeInSeconds;
          i++ ) {
 
 
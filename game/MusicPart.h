@@ -6,6 +6,10 @@
  *
  * 2004-August-26   Jason Rohrer
  * Added parameter to control character of part.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Changed intervals to exclude their ends, so that a note starting
+ * exactly between two buffers is not played twice.
  */
 
 
@@ -70,7 +74,8 @@ class MusicPart {
          *
          * Note that only notes that *start* in the interval are returned.
          * Notes that are playing during the interval, but that start before
-         * the interval, are ignored.
+         * the interval, are ignored.  The interval includes its start but
+         * not its end, so back-to-back intervals return each note once.
          *
          * @param inStartTimeInSeconds the start of the interval
          *   Must be in the range [ 0, getPartLengthInSeconds() ].
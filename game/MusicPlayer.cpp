@@ -10,6 +10,12 @@
  * 2004-August-24   Jason Rohrer
  * Added missing support for reversed notes and stereo split.
  * Changed to use constant power panning.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added function for counting active notes.
+ * Fixed notes near the start of a piece playing twice when the piece
+ * starts partway through a buffer, which got worse with larger buffers.
+ * Added mixing straight into a view of another buffer.
  */
 
 
@@ -71,10 +77,24 @@ MusicPlayer::~MusicPlayer() {
 
 SoundSamples *MusicPlayer::getMoreMusic( unsigned long inNumSamples ) {
 
+    SoundSamples *returnSamples = new SoundSamples( inNumSamples );
+
+    mixMoreMusic( StereoSampleView( returnSamples ), 1 );
+
+    return returnSamples;
+    }
+
+
+
+void MusicPlayer::mixMoreMusic( StereoSampleView inOutSamples,
+                                float inLoudness ) {
+
+    unsigned long numSamples = inOutSamples.mSampleCount;
+    
     double halfWorldWidth = mWorldWidth / 2;
     
 
-    double bufferLengthInSeconds = (double)inNumSamples / (double)mSampleRate;
+    double bufferLengthInSeconds = (double)numSamples / (double)mSampleRate;
     double bufferLengthInWorldUnits =
         ( bufferLengthInSeconds / mPartLengthInSeconds ) * mGridSpaceWidth;
     
@@ -94,8 +114,8 @@ SoundSamples *MusicPlayer::getMoreMusic( unsigned long inNumSamples ) {
         delete [] positions;
         delete [] musicParts;
 
-        // return silent samples
-        return new SoundSamples( inNumSamples );        
+        // leave the buffer silent
+        return;
         }
 
     
@@ -139,12 +159,14 @@ SoundSamples *MusicPlayer::getMoreMusic( unsigned long inNumSamples ) {
         // buffer but is still playing during this buffer, then play notes
         // from it
         
+        // each x falls in exactly one buffer's [start, end) range,
+        // so a piece is started by exactly one buffer
         char playPiece = false;
         double offsetBeforePiece = 0;
         double offsetIntoPiece = 0;
         
         if( x >= mCurrentPartGridPosition &&
-            x <= mCurrentPartGridPosition + bufferLengthInWorldUnits ) {
+            x < mCurrentPartGridPosition + bufferLengthInWorldUnits ) {
            
             playPiece = true;
             offsetBeforePiece = x - mCurrentPartGridPosition;
@@ -174,10 +196,14 @@ SoundSamples *MusicPlayer::getMoreMusic( unsigned long inNumSamples ) {
             MusicNote **notes;
             double *noteStartOffsets;
                     
+            // only the part of the piece that falls in this buffer, so that
+            // the next buffer does not start the same notes again
+            double intervalLengthInSeconds =
+                bufferLengthInSeconds - offsetBeforePiece;
             
             int numNotes = part->getNotesStartingInInterval( 
                 offsetIntoPiece, 
-                bufferLengthInSeconds,
+                intervalLengthInSeconds,
                 &notes,
                 &noteStartOffsets );
                     
@@ -295,10 +321,6 @@ SoundSamples *MusicPlayer::getMoreMusic( unsigned long inNumSamples ) {
 
     // next mix the samples from active notes that play during this buffer
 
-    SoundSamples *returnSamples = new SoundSamples( inNumSamples );
-    float *returnLeftChannel = returnSamples->mLeftChannel;
-    float *returnRightChannel = returnSamples->mRightChannel;
-    
     for( i=0; i<mActiveNotes->size(); i++ ) {
 
         SoundSamples *noteSamples = *( mActiveNotes->getElement( i ) );
@@ -306,7 +328,7 @@ SoundSamples *MusicPlayer::getMoreMusic( unsigned long inNumSamples ) {
 
         unsigned long numNoteSamples = noteSamples->mSampleCount;
         
-        unsigned long numSamplesToPlay = inNumSamples;
+        unsigned long numSamplesToPlay = numSamples;
 
         char noteFinished = false;
         
@@ -318,16 +340,10 @@ SoundSamples *MusicPlayer::getMoreMusic( unsigned long inNumSamples ) {
             noteFinished = true;
             }
         
-        float *noteLeftChannel = noteSamples->mLeftChannel;
-        float *noteRightChannel = noteSamples->mRightChannel;
-                
-        for( unsigned long j=0; j<numSamplesToPlay; j++ ) {
-            unsigned long noteIndex = j + notePosition;
-            
-            returnLeftChannel[j] += noteLeftChannel[ noteIndex ];
-            returnRightChannel[j] += noteRightChannel[ noteIndex ];
-
-            }
+        inOutSamples.mix(
+            StereoSampleView( noteSamples ).getRegion( notePosition,
+                                                       numSamplesToPlay ),
+            inLoudness );
 
         notePosition += numSamplesToPlay;
 
@@ -348,9 +364,6 @@ SoundSamples *MusicPlayer::getMoreMusic( unsigned long inNumSamples ) {
 
     // advance the grid position
     mCurrentPartGridPosition += bufferLengthInWorldUnits;
-
-    
-    return returnSamples;
     }
 
 
@@ -361,6 +374,12 @@ double MusicPlayer::getCurrentPartGridPosition() {
 
 
 
+int MusicPlayer::getNumActiveNotes() {
+    return mActiveNotes->size();
+    }
+
+
+
 
 
 
@@ -3,6 +3,10 @@
  *
  * 2004-August-22   Jason Rohrer
  * Created.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added function for counting active notes.
+ * Added mixing straight into a view of another buffer.
  */
 
 
@@ -13,6 +17,7 @@
 
 
 #include "SoundSamples.h"
+#include "StereoSampleView.h"
 #include "SculptureManager.h"
 #include "MusicNoteWaveTable.h"
 
@@ -68,6 +73,18 @@ class MusicPlayer {
          */
         SoundSamples *getMoreMusic( unsigned long inNumSamples );
 
+
+
+        
+        /**
+         * Adds more samples of music from this player to a buffer.
+         *
+         * @param inOutSamples the buffer to add to, whose sample count is
+         *   the number of samples to get.
+         * @param inLoudness the gain applied to the music.
+         */
+        void mixMoreMusic( StereoSampleView inOutSamples, float inLoudness );
+
         
 
         /**
@@ -78,6 +95,18 @@ class MusicPlayer {
          */
         double getCurrentPartGridPosition();
 
+
+
+        /**
+         * Gets the number of notes that are still playing.
+         *
+         * Not thread-safe:  should be called from the thread that calls
+         * getMoreMusic or mixMoreMusic.
+         *
+         * @return the number of notes.
+         */
+        int getNumActiveNotes();
+
         
         
     protected:
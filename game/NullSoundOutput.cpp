@@ -0,0 +1,140 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "NullSoundOutput.h"
+#include "SoundPlayer.h"
+#include "FrameProfiler.h"
+
+
+#include "minorGems/system/Thread.h"
+
+
+
+/**
+ * The timer thread of a NullSoundOutput.
+ */
+class NullSoundOutputThread : public Thread {
+
+    public:
+
+        NullSoundOutputThread( NullSoundOutput *inOutput )
+            : mOutput( inOutput ) {
+            }
+
+        // implements the Thread interface
+        virtual void run();
+
+    protected:
+        NullSoundOutput *mOutput;
+    };
+
+
+
+void NullSoundOutputThread::run() {
+    mOutput->runTimer();
+    }
+
+
+
+NullSoundOutput::NullSoundOutput( unsigned long inSampleRate,
+                                  unsigned long inFramesPerBuffer )
+    : mSampleRate( inSampleRate ),
+      mFramesPerBuffer( inFramesPerBuffer ),
+      mPlayer( NULL ),
+      mThread( NULL ),
+      mLock( new MutexLock() ),
+      mStopping( false ) {
+
+    }
+
+
+
+NullSoundOutput::~NullSoundOutput() {
+    stop();
+
+    delete mLock;
+    }
+
+
+
+char NullSoundOutput::start( SoundPlayer *inPlayer ) {
+    if( mThread != NULL ) {
+        return true;
+        }
+
+    mPlayer = inPlayer;
+
+    mLock->lock();
+    mStopping = false;
+    mLock->unlock();
+
+    mThread = new NullSoundOutputThread( this );
+    mThread->start();
+
+    return true;
+    }
+
+
+
+void NullSoundOutput::stop() {
+    if( mThread == NULL ) {
+        return;
+        }
+
+    mLock->lock();
+    mStopping = true;
+    mLock->unlock();
+
+    mThread->join();
+    delete mThread;
+    mThread = NULL;
+    }
+
+
+
+char NullSoundOutput::isStopping() {
+    mLock->lock();
+    char stopping = mStopping;
+    mLock->unlock();
+
+    return stopping;
+    }
+
+
+
+void NullSoundOutput::runTimer() {
+    float *buffer = new float[ 2 * mFramesPerBuffer ];
+
+    double bufferMicroseconds =
+        1000000.0 * (double)mFramesPerBuffer / (double)mSampleRate;
+
+    double nextPullTime = FrameProfiler::getCurrentMicroseconds();
+
+    while( !isStopping() ) {
+        mPlayer->getSamples( (void *)buffer, mFramesPerBuffer );
+
+        // schedule from the last deadline rather than from now, so that
+        // the pull rate does not drift
+        nextPullTime += bufferMicroseconds;
+
+        double now = FrameProfiler::getCurrentMicroseconds();
+
+        if( now < nextPullTime ) {
+            Thread::staticSleep(
+                (unsigned long)( ( nextPullTime - now ) / 1000 ) );
+            }
+        else if( now - nextPullTime > bufferMicroseconds ) {
+            // fell more than a buffer behind, as a sound card would
+            // underrun, so don't try to catch up
+            nextPullTime = now;
+            }
+        }
+
+    delete [] buffer;
+    }
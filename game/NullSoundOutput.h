@@ -0,0 +1,99 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef NULL_SOUND_OUTPUT_INCLUDED
+#define NULL_SOUND_OUTPUT_INCLUDED
+
+
+
+#include "SoundOutput.h"
+
+#include "minorGems/system/MutexLock.h"
+
+
+
+class NullSoundOutputThread;
+
+
+
+/**
+ * Pulls samples from the player on a timer thread at the rate a sound
+ * card would, and discards them.
+ *
+ * Lets the game run in real time, with music and realtime sounds mixed
+ * as usual, on a machine without a sound card.
+ *
+ * @author Jason Rohrer
+ */
+class NullSoundOutput : public SoundOutput {
+
+
+
+    public:
+
+        /**
+         * Constructs an output.  The thread is not started until start.
+         *
+         * @param inSampleRate the number of samples per second.
+         * @param inFramesPerBuffer the number of stereo frames to pull
+         *   at a time.  Defaults to 1024, like the default
+         *   AudioLatencyProfile.
+         */
+        NullSoundOutput( unsigned long inSampleRate,
+                         unsigned long inFramesPerBuffer = 1024 );
+
+
+
+        virtual ~NullSoundOutput();
+
+
+
+        // implements the SoundOutput interface
+        virtual char start( SoundPlayer *inPlayer );
+        virtual void stop();
+
+
+
+        /**
+         * Pulls samples until stop is called.
+         *
+         * Called by this output's thread.
+         */
+        void runTimer();
+
+
+
+    protected:
+
+        unsigned long mSampleRate;
+        unsigned long mFramesPerBuffer;
+
+        SoundPlayer *mPlayer;
+
+        // NULL when stopped
+        NullSoundOutputThread *mThread;
+
+        // protects mStopping
+        MutexLock *mLock;
+        char mStopping;
+
+
+
+        /**
+         * Gets whether stop has been called.
+         *
+         * @return true if the thread should stop.
+         */
+        char isStopping();
+
+    };
+
+
+
+#endif
@@ -28,6 +28,17 @@
  *
  * 2004-August-30   Jason Rohrer
  * Optimization:  avoid object blending whenever possible.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added function for measuring memory use.
+ * Added binary reading and writing for the level cache.
+ * Added a stride for skipping rotated copies when quality is reduced.
+ * Rotated copies now returned as instances of one drawable object.
+ * Added reduced detail for objects that are small on screen.
+ * Changed the rotated copy stride to a parameter, for drawing only.
+ * Added a function for getting the radius without drawable objects.
+ * Changed reduced detail to use points built ahead of time, and added a
+ * way to build drawable objects without copying vertices.
  */
 
 
@@ -42,6 +53,99 @@
 
 
 
+// objects with a radius of at least this many pixels are drawn in full
+static const double fullDetailPixelRadius = 32;
+
+// the farthest, in pixels, that reduced detail may move a border
+static const double detailPixelTolerance = 0.5;
+
+// rotated copies closer than this many pixels apart at the edge of the
+// shape are thinned out
+static const double minRotatedCopyPixelSpacing = 2;
+
+
+
+/**
+ * Reads an array of vertices and colors written by writeBinaryVertices.
+ *
+ * @param inEntry the cache entry to read from.
+ * @param inoutPosition the read position in the entry.
+ * @param outNumVertices pointer to where the number of vertices should
+ *   be returned.
+ * @param outVertices pointer to where the vertex array should be returned.
+ * @param outColors pointer to where the color array should be returned.
+ *
+ * @return true on success.  On failure, the returned arrays are still
+ *   valid (filled with dummy values).
+ */
+static char readBinaryVertices( LevelCacheEntry *inEntry,
+                                unsigned long *inoutPosition,
+                                int *outNumVertices,
+                                Vector3D ***outVertices,
+                                Color ***outColors ) {
+    int numVertices = 0;
+    
+    char success = inEntry->readValue( inoutPosition, &numVertices,
+                                       sizeof( int ) );
+
+    unsigned long vertexSize = 2 * sizeof( double ) + 4 * sizeof( float );
+
+    if( !success || numVertices < 0 ||
+        numVertices * vertexSize > inEntry->mLength - *inoutPosition ) {
+        // don't trust the count
+        numVertices = 0;
+        success = false;
+        }
+
+    *outNumVertices = numVertices;
+    *outVertices = new Vector3D*[ numVertices ];
+    *outColors = new Color*[ numVertices ];
+
+    for( int i=0; i<numVertices; i++ ) {
+        double x = 0, y = 0;
+        float color[4] = { 1, 1, 1, 1 };
+        
+        success = success &&
+            inEntry->readValue( inoutPosition, &x, sizeof( double ) ) &&
+            inEntry->readValue( inoutPosition, &y, sizeof( double ) ) &&
+            inEntry->readValue( inoutPosition, color, 4 * sizeof( float ) );
+
+        ( *outVertices )[i] = new Vector3D( x, y, 0 );
+        ( *outColors )[i] = new Color( color[0], color[1], color[2], color[3],
+                                       false );
+        }
+
+    return success;
+    }
+
+
+
+/**
+ * Writes an array of vertices and colors in binary.
+ *
+ * @param inFILE the file to write to.
+ * @param inNumVertices the number of vertices.
+ * @param inVertices the vertices.
+ * @param inColors the colors.
+ */
+static void writeBinaryVertices( FILE *inFILE,
+                                 int inNumVertices,
+                                 Vector3D **inVertices,
+                                 Color **inColors ) {
+    fwrite( &inNumVertices, sizeof( int ), 1, inFILE );
+
+    for( int i=0; i<inNumVertices; i++ ) {
+        fwrite( &( inVertices[i]->mX ), sizeof( double ), 1, inFILE );
+        fwrite( &( inVertices[i]->mY ), sizeof( double ), 1, inFILE );
+
+        float color[4] = { inColors[i]->r, inColors[i]->g,
+                           inColors[i]->b, inColors[i]->a };
+        fwrite( color, sizeof( float ), 4, inFILE );
+        }
+    }
+
+
+
 ObjectParameterSpaceControlPoint::ObjectParameterSpaceControlPoint(
     int inNumTriangleVertices, Vector3D **inTriangleVertices,
     Color **inTriangleVertexFillColors,
@@ -166,6 +270,40 @@ ObjectParameterSpaceControlPoint::ObjectParameterSpaceControlPoint(
         
 
         
+ObjectParameterSpaceControlPoint::ObjectParameterSpaceControlPoint(
+    LevelCacheEntry *inEntry, unsigned long *inoutPosition,
+    char *outError ) {
+
+    // always read both arrays so that all members are set, even on failure
+    char triangleSuccess =
+        readBinaryVertices( inEntry, inoutPosition,
+                            &mNumTriangleVertices,
+                            &mTriangleVertices,
+                            &mTriangleVertexFillColors );
+
+    char borderSuccess =
+        readBinaryVertices( inEntry, inoutPosition,
+                            &mNumBorderVertices,
+                            &mBorderVertices,
+                            &mBorderVertexColors );
+
+    char success = triangleSuccess && borderSuccess;
+
+    double values[5] = { 0, 0, 0, 0, 0 };
+    success = success &&
+        inEntry->readValue( inoutPosition, values, 5 * sizeof( double ) );
+
+    mBorderWidth = values[0];
+    mNumRotatedCopies = values[1];
+    mRotatedCopyScaleFactor = values[2];
+    mRotatedCopyAngleScaleFactor = values[3];
+    mRotationRate = values[4];
+
+    *outError = !success;
+    }
+
+
+
 ObjectParameterSpaceControlPoint::~ObjectParameterSpaceControlPoint() {
 
     int i;
@@ -223,6 +361,21 @@ void ObjectParameterSpaceControlPoint::writeToFile( FILE *inFILE ) {
 
 
 
+void ObjectParameterSpaceControlPoint::writeToBinaryFile( FILE *inFILE ) {
+    writeBinaryVertices( inFILE, mNumTriangleVertices,
+                         mTriangleVertices, mTriangleVertexFillColors );
+    writeBinaryVertices( inFILE, mNumBorderVertices,
+                         mBorderVertices, mBorderVertexColors );
+
+    double values[5] = { mBorderWidth, mNumRotatedCopies,
+                         mRotatedCopyScaleFactor,
+                         mRotatedCopyAngleScaleFactor,
+                         mRotationRate };
+    fwrite( values, sizeof( double ), 5, inFILE );
+    }
+
+
+
 ParameterSpaceControlPoint *ObjectParameterSpaceControlPoint::copy() {
 
     return new ObjectParameterSpaceControlPoint (
@@ -345,118 +498,513 @@ ObjectParameterSpaceControlPoint::createLinearBlend(
 
 
 SimpleVector<DrawableObject *> *
-ObjectParameterSpaceControlPoint::getDrawableObjects() {
+ObjectParameterSpaceControlPoint::getDrawableObjects(
+    double inPixelsPerUnit, int inRotatedCopyStride ) {
 
-    SimpleVector<DrawableObject *> *returnVector =
-        new SimpleVector<DrawableObject *>();
+    return buildDrawableObjects(
+        getDrawnCopyStride( inPixelsPerUnit, inRotatedCopyStride ),
+        false );
+    }
+
+
+
+SimpleVector<DrawableObject *> *
+ObjectParameterSpaceControlPoint::extractDrawableObjects(
+    double inPixelsPerUnit, int inRotatedCopyStride ) {
+
+    return buildDrawableObjects(
+        getDrawnCopyStride( inPixelsPerUnit, inRotatedCopyStride ),
+        true );
+    }
 
-    Angle3D *angleBetweenRotatedCopies =
-        new Angle3D( 0, 0,
-                     2 * M_PI / ( mNumRotatedCopies + 1 ) );
 
-    angleBetweenRotatedCopies->scale( mRotatedCopyAngleScaleFactor );
+
+double ObjectParameterSpaceControlPoint::getDetailTolerance(
+    double inPixelsPerUnit ) {
+
+    if( inPixelsPerUnit <= 0 ) {
+        return 0;
+        }
+
+    return detailPixelTolerance / inPixelsPerUnit;
+    }
+
+
+
+double ObjectParameterSpaceControlPoint::getFullDetailTolerance(
+    double inRadius ) {
+
+    // the tolerance for a shape that is fullDetailPixelRadius across
+    return detailPixelTolerance * inRadius / fullDetailPixelRadius;
+    }
+
+
+
+int ObjectParameterSpaceControlPoint::getDrawnCopyStride(
+    double inPixelsPerUnit, int inRotatedCopyStride ) {
+
+    if( inRotatedCopyStride < 1 ) {
+        inRotatedCopyStride = 1;
+        }
+
+    if( inPixelsPerUnit <= 0 ) {
+        return inRotatedCopyStride;
+        }
+
+    double radius = 0;
+    for( int i=0; i<mNumBorderVertices; i++ ) {
+        double length = mBorderVertices[i]->getLength();
+
+        if( length > radius ) {
+            radius = length;
+            }
+        }
+
+    double pixelRadius = radius * inPixelsPerUnit;
+
+    if( pixelRadius >= fullDetailPixelRadius ) {
+        return inRotatedCopyStride;
+        }
+
+
+    // thin out copies that would be too close together at the edge,
+    // where neighboring copies differ in both angle and scale
+    double angleBetweenRotatedCopies =
+        2 * M_PI / ( mNumRotatedCopies + 1 ) * mRotatedCopyAngleScaleFactor;
+    double scaleBetweenRotatedCopies = 1 - mRotatedCopyScaleFactor;
     
-    // start out with a copy of the vertices and rotate them,
-    // bit by bit, to create each reflection
-    Vector3D **workingTriangleVertices =
-        duplicateVertextArray( mTriangleVertices,
-                               mNumTriangleVertices );
-    Vector3D **workingBorderVertices =
-        duplicateVertextArray( mBorderVertices,
-                               mNumBorderVertices );
+    double copyPixelSpacing =
+        sqrt( angleBetweenRotatedCopies * angleBetweenRotatedCopies +
+              scaleBetweenRotatedCopies * scaleBetweenRotatedCopies ) *
+        pixelRadius;
+
+    // translucent copies add up where they overlap, so each one shows
+    // even when they are close together
+    char opaque = true;
+    int i;
+    for( i=0; i<mNumTriangleVertices && opaque; i++ ) {
+        if( mTriangleVertexFillColors[i]->a < 1 ) {
+            opaque = false;
+            }
+        }
+    for( i=0; i<mNumBorderVertices && opaque; i++ ) {
+        if( mBorderVertexColors[i]->a < 1 ) {
+            opaque = false;
+            }
+        }
+
+    int copyStride = 1;
+
+    if( opaque &&
+        copyPixelSpacing > 0 &&
+        copyPixelSpacing < minRotatedCopyPixelSpacing ) {
+        copyStride =
+            (int)ceil( minRotatedCopyPixelSpacing / copyPixelSpacing );
+        }
+
+    // large enough for any number of copies that can be drawn
+    if( copyStride > 1000 ) {
+        copyStride = 1000;
+        }
+    if( inRotatedCopyStride > copyStride ) {
+        copyStride = inRotatedCopyStride;
+        }
+
+    return copyStride;
+    }
+
+
+
+SimpleVector<DrawableObject *> *
+ObjectParameterSpaceControlPoint::buildDrawableObjects(
+    int inRotatedCopyStride, char inGiveArrays ) {
+
+    SimpleVector<DrawableObject *> *returnVector =
+        new SimpleVector<DrawableObject *>();
 
+    double angleBetweenRotatedCopies =
+        2 * M_PI / ( mNumRotatedCopies + 1 ) * mRotatedCopyAngleScaleFactor;
     
     // if we have a non-integral number of reflections, draw one
     // extra reflection (it will overlap another of the reflections,
     // but this eliminates reflection "pop-in" when transitioning between two
     // control points that have a different number of reflections
     int numRotatedCopiesToDraw = (int)ceil( mNumRotatedCopies );
-
+    
     char drawingExtraReflection = false;
 
     if( numRotatedCopiesToDraw - mNumRotatedCopies > 0 ) {
         drawingExtraReflection = true;
         }
+
+    // each reflection is an instance of one copy of our shape
+    // room for every copy, although skipped copies leave some unused
+    double *instanceAngles = new double[ numRotatedCopiesToDraw + 1 ];
+    double *instanceScales = new double[ numRotatedCopiesToDraw + 1 ];
+    float *instanceAlphas = new float[ numRotatedCopiesToDraw + 1 ];
+    int numInstances = 0;
+    
+    double copyScale = 1;
     
     for( int s=0; s<=numRotatedCopiesToDraw; s++ ) {
 
-        Color **reflectedFillColors;
-        Color **reflectedBorderColors;
-
-        if( drawingExtraReflection && s == numRotatedCopiesToDraw ) {
-            // this is our extra reflection
-            // alpha-fade it in based on the fractional part of our number
-            // of reflections
-
-            double fractionalPart =
-                mNumRotatedCopies -
-                floor( mNumRotatedCopies );
-
-            reflectedFillColors =
-                duplicateColorArray( mTriangleVertexFillColors,
-                                     mNumTriangleVertices,
-                                     (float)fractionalPart );
-                                                       
-            reflectedBorderColors =
-                duplicateColorArray( mBorderVertexColors,
-                                     mNumBorderVertices,
-                                     (float)fractionalPart );
+        // skipped copies still count toward the angle and scale of later
+        // copies
+        char skipped =
+            ( s % inRotatedCopyStride != 0 &&
+              s != numRotatedCopiesToDraw );
+        
+        if( !skipped ) {
+            float alpha = 1;
+
+            if( drawingExtraReflection && s == numRotatedCopiesToDraw ) {
+                // this is our extra reflection
+                // alpha-fade it in based on the fractional part of our
+                // number of reflections
+                alpha = (float)( mNumRotatedCopies -
+                                 floor( mNumRotatedCopies ) );
+                }
+            
+            instanceAngles[ numInstances ] = s * angleBetweenRotatedCopies;
+            instanceScales[ numInstances ] = copyScale;
+            instanceAlphas[ numInstances ] = alpha;
+            numInstances++;
             }
-        else {
-            // not an extra reflection
-            // do not alpha-fade it at all
-            reflectedFillColors = duplicateColorArray(
-                mTriangleVertexFillColors,
-                mNumTriangleVertices );
-                                                       
-            reflectedBorderColors = duplicateColorArray(
-                mBorderVertexColors,
-                mNumBorderVertices );
+
+        copyScale *= mRotatedCopyScaleFactor;
+        }
+
+    Vector3D **triangleVertices = mTriangleVertices;
+    Color **triangleColors = mTriangleVertexFillColors;
+    Vector3D **borderVertices = mBorderVertices;
+    Color **borderColors = mBorderVertexColors;
+
+    if( !inGiveArrays ) {
+        triangleVertices =
+            duplicateVertextArray( mTriangleVertices, mNumTriangleVertices );
+        triangleColors =
+            duplicateColorArray( mTriangleVertexFillColors,
+                                 mNumTriangleVertices );
+        borderVertices =
+            duplicateVertextArray( mBorderVertices, mNumBorderVertices );
+        borderColors =
+            duplicateColorArray( mBorderVertexColors, mNumBorderVertices );
+        }
+    
+    DrawableObject *reflectedObject =
+        new DrawableObject(
+            mNumTriangleVertices,
+            triangleVertices,
+            triangleColors,
+            mNumBorderVertices,
+            borderVertices,
+            borderColors,
+            mBorderWidth,
+            numInstances,
+            instanceAngles,
+            instanceScales,
+            instanceAlphas );
+
+    if( inGiveArrays ) {
+        // the object destroys them now
+        mNumTriangleVertices = 0;
+        mTriangleVertices = NULL;
+        mTriangleVertexFillColors = NULL;
+        mNumBorderVertices = 0;
+        mBorderVertices = NULL;
+        mBorderVertexColors = NULL;
+        }
+
+    returnVector->push_back( reflectedObject );
+
+    return returnVector;
+    }
+
+
+
+// how far a border color can be from the blend of its neighbors' colors
+// and still have its vertex dropped, per component
+static const float detailColorTolerance = 1.0f / 64;
+
+
+
+/**
+ * Gets the distance from a point to a line segment.
+ *
+ * @param inPoint the point.
+ *   Must be destroyed by caller.
+ * @param inStart the start of the segment.
+ *   Must be destroyed by caller.
+ * @param inEnd the end of the segment.
+ *   Must be destroyed by caller.
+ * @param outT pointer to where the position of the closest point along
+ *   the segment, in [0,1], should be returned.
+ *
+ * @return the distance in the x-y plane.
+ */
+static double getDistanceToSegment( Vector3D *inPoint,
+                                    Vector3D *inStart, Vector3D *inEnd,
+                                    double *outT ) {
+    double segmentX = inEnd->mX - inStart->mX;
+    double segmentY = inEnd->mY - inStart->mY;
+    double pointX = inPoint->mX - inStart->mX;
+    double pointY = inPoint->mY - inStart->mY;
+
+    double lengthSquared = segmentX * segmentX + segmentY * segmentY;
+
+    double t = 0;
+    if( lengthSquared > 0 ) {
+        t = ( pointX * segmentX + pointY * segmentY ) / lengthSquared;
+
+        if( t < 0 ) {
+            t = 0;
+            }
+        else if( t > 1 ) {
+            t = 1;
+            }
+        }
+
+    *outT = t;
+
+    double dX = pointX - t * segmentX;
+    double dY = pointY - t * segmentY;
+
+    return sqrt( dX * dX + dY * dY );
+    }
+
+
+
+ObjectParameterSpaceControlPoint **
+ObjectParameterSpaceControlPoint::createDetailLevels(
+    ObjectParameterSpaceControlPoint **inPoints, int inNumPoints,
+    double inTolerance ) {
+
+    if( inNumPoints < 1 ) {
+        return NULL;
+        }
+    
+    int numTriangleVertices = inPoints[0]->mNumTriangleVertices;
+    int numBorderVertices = inPoints[0]->mNumBorderVertices;
+
+    int i, p;
+    for( p=1; p<inNumPoints; p++ ) {
+        if( inPoints[p]->mNumTriangleVertices != numTriangleVertices ||
+            inPoints[p]->mNumBorderVertices != numBorderVertices ) {
+            return NULL;
+            }
+        }
+
+    
+    // triangles whose area would cover only a fraction of a pixel
+    double minTriangleArea = inTolerance * inTolerance;
+
+    char *keepTriangleVertex = new char[ numTriangleVertices ];
+    int numTriangleVerticesKept = 0;
+    
+    for( i=0; i<numTriangleVertices; i++ ) {
+        // vertices past the last whole triangle are dropped
+        keepTriangleVertex[i] = false;
+        }
+    
+    for( i=0; i<numTriangleVertices - 2; i+=3 ) {
+        char keep = false;
+        
+        for( p=0; p<inNumPoints && !keep; p++ ) {
+            Vector3D **vertices = inPoints[p]->mTriangleVertices;
+            
+            Vector3D *a = vertices[i];
+            Vector3D *b = vertices[ i + 1 ];
+            Vector3D *c = vertices[ i + 2 ];
+
+            double area = 0.5 * fabs(
+                ( b->mX - a->mX ) * ( c->mY - a->mY ) -
+                ( c->mX - a->mX ) * ( b->mY - a->mY ) );
+
+            if( area >= minTriangleArea ) {
+                keep = true;
+                }
             }
+
+        if( keep ) {
+            for( int v=0; v<3; v++ ) {
+                keepTriangleVertex[ i + v ] = true;
+                }
+            numTriangleVerticesKept += 3;
+            }
+        }
+
+
+    // border vertices that lie almost on the line between their
+    // neighbors, with almost the color of that line
+    // never drop two neighbors, so that each dropped vertex is within
+    // inTolerance of the border that is left
+    char *keepBorderVertex = new char[ numBorderVertices ];
+    char *farthestBorderVertex = new char[ numBorderVertices ];
+
+    for( i=0; i<numBorderVertices; i++ ) {
+        keepBorderVertex[i] = true;
+        farthestBorderVertex[i] = false;
+        }
+
+    for( p=0; p<inNumPoints; p++ ) {
+        Vector3D **vertices = inPoints[p]->mBorderVertices;
         
-        DrawableObject *reflectedObject =
-            new DrawableObject( mNumTriangleVertices,
-                                duplicateVertextArray( workingTriangleVertices,
-                                                       mNumTriangleVertices ),
-                                reflectedFillColors,
-                                mNumBorderVertices,
-                                duplicateVertextArray( workingBorderVertices,
-                                                       mNumBorderVertices ),
-                                reflectedBorderColors,
-                                mBorderWidth );
-
-        returnVector->push_back( reflectedObject );
-
-        // rotate the working vertices by one reflection angle
-        int i;
-        for( i=0; i<mNumTriangleVertices; i++ ) {
-            workingTriangleVertices[i]->rotate( angleBetweenRotatedCopies );
-            workingTriangleVertices[i]->scale( mRotatedCopyScaleFactor );
+        int farthestVertex = 0;
+        double farthestLength = 0;
+        for( i=0; i<numBorderVertices; i++ ) {
+            double length = vertices[i]->getLength();
+            if( length > farthestLength ) {
+                farthestLength = length;
+                farthestVertex = i;
+                }
+            }
+
+        if( numBorderVertices > 0 ) {
+            farthestBorderVertex[ farthestVertex ] = true;
             }
-        for( i=0; i<mNumBorderVertices; i++ ) {
-            workingBorderVertices[i]->rotate( angleBetweenRotatedCopies );
-            workingBorderVertices[i]->scale( mRotatedCopyScaleFactor );
+        }
+    
+    int numBorderVerticesKept = numBorderVertices;
+
+    // keep at least a triangle
+    for( i=1; i<numBorderVertices && numBorderVerticesKept > 3; i++ ) {
+        int next = ( i + 1 ) % numBorderVertices;
+
+        if( farthestBorderVertex[i] ||
+            ! keepBorderVertex[ i - 1 ] || ! keepBorderVertex[ next ] ) {
+            continue;
             }
 
+        char canDrop = true;
+        
+        for( p=0; p<inNumPoints && canDrop; p++ ) {
+            Vector3D **vertices = inPoints[p]->mBorderVertices;
+            Color **colors = inPoints[p]->mBorderVertexColors;
+            
+            double t;
+            double distance =
+                getDistanceToSegment( vertices[i],
+                                      vertices[ i - 1 ],
+                                      vertices[ next ], &t );
+
+            if( distance >= inTolerance ) {
+                canDrop = false;
+                continue;
+                }
+
+            // the line is shaded between the neighbors' colors once this
+            // vertex is gone
+            Color *blend = Color::linearSum( colors[ next ],
+                                             colors[ i - 1 ],
+                                             (float)t );
+            Color *color = colors[i];
+
+            char colorMatches =
+                fabs( blend->r - color->r ) < detailColorTolerance &&
+                fabs( blend->g - color->g ) < detailColorTolerance &&
+                fabs( blend->b - color->b ) < detailColorTolerance &&
+                fabs( blend->a - color->a ) < detailColorTolerance;
+
+            delete blend;
+
+            if( !colorMatches ) {
+                canDrop = false;
+                }
+            }
+        
+        if( canDrop ) {
+            keepBorderVertex[i] = false;
+            numBorderVerticesKept--;
+            }
         }
 
-    // delete the working vertices
-    int i;
-    for( i=0; i<mNumTriangleVertices; i++ ) {
-        delete workingTriangleVertices[i];
+    delete [] farthestBorderVertex;
+
+    
+    ObjectParameterSpaceControlPoint **detailPoints =
+        new ObjectParameterSpaceControlPoint*[ inNumPoints ];
+
+    for( p=0; p<inNumPoints; p++ ) {
+        ObjectParameterSpaceControlPoint *point = inPoints[p];
+        
+        Vector3D **triangleVertices =
+            new Vector3D*[ numTriangleVerticesKept ];
+        Color **triangleColors = new Color*[ numTriangleVerticesKept ];
+
+        int numKept = 0;
+        for( i=0; i<numTriangleVertices; i++ ) {
+            if( keepTriangleVertex[i] ) {
+                triangleVertices[ numKept ] =
+                    new Vector3D( point->mTriangleVertices[i] );
+                triangleColors[ numKept ] =
+                    point->mTriangleVertexFillColors[i]->copy();
+                numKept++;
+                }
+            }
+        
+        Vector3D **borderVertices = new Vector3D*[ numBorderVerticesKept ];
+        Color **borderColors = new Color*[ numBorderVerticesKept ];
+
+        numKept = 0;
+        for( i=0; i<numBorderVertices; i++ ) {
+            if( keepBorderVertex[i] ) {
+                borderVertices[ numKept ] =
+                    new Vector3D( point->mBorderVertices[i] );
+                borderColors[ numKept ] =
+                    point->mBorderVertexColors[i]->copy();
+                numKept++;
+                }
+            }
+
+        detailPoints[p] =
+            new ObjectParameterSpaceControlPoint(
+                numTriangleVerticesKept,
+                triangleVertices,
+                triangleColors,
+                numBorderVerticesKept,
+                borderVertices,
+                borderColors,
+                point->mBorderWidth,
+                point->mNumRotatedCopies,
+                point->mRotatedCopyScaleFactor,
+                point->mRotatedCopyAngleScaleFactor,
+                point->mRotationRate );
         }
-    delete [] workingTriangleVertices;
 
-    for( i=0; i<mNumBorderVertices; i++ ) {
-        delete workingBorderVertices[i];
+    delete [] keepTriangleVertex;
+    delete [] keepBorderVertex;
+
+    return detailPoints;
+    }
+
+
+
+double ObjectParameterSpaceControlPoint::getRadius() {
+    double borderRadius = 0;
+    for( int i=0; i<mNumBorderVertices; i++ ) {
+        double length = mBorderVertices[i]->getLength();
+
+        if( length > borderRadius ) {
+            borderRadius = length;
+            }
         }
-    delete [] workingBorderVertices;
 
+    // same copies that buildDrawableObjects makes, which always include
+    // the first and last
+    int numRotatedCopiesToDraw = (int)ceil( mNumRotatedCopies );
+
+    double largestCopyScale = 1;
+    double copyScale = 1;
     
-    delete angleBetweenRotatedCopies;
+    for( int s=1; s<=numRotatedCopiesToDraw; s++ ) {
+        copyScale *= mRotatedCopyScaleFactor;
 
+        if( fabs( copyScale ) > largestCopyScale ) {
+            largestCopyScale = fabs( copyScale );
+            }
+        }
 
-    return returnVector;
+    return borderRadius * largestCopyScale;
     }
 
 
@@ -467,6 +1015,16 @@ double ObjectParameterSpaceControlPoint::getRotationRate() {
 
 
 
+unsigned long ObjectParameterSpaceControlPoint::getMemorySize() {
+    unsigned long vertexSize = sizeof( Vector3D * ) + sizeof( Vector3D ) +
+        sizeof( Color * ) + sizeof( Color );
+
+    return sizeof( ObjectParameterSpaceControlPoint ) +
+        ( mNumTriangleVertices + mNumBorderVertices ) * vertexSize;
+    }
+
+
+
 Vector3D **ObjectParameterSpaceControlPoint::duplicateVertextArray(
     Vector3D **inArray, int inNumTriangleVertices ) {
 
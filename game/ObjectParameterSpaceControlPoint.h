@@ -24,6 +24,17 @@
  * 
  * 2004-August-29   Jason Rohrer
  * Added a scale factor for the angle of rotated copies.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added function for measuring memory use.
+ * Added binary reading and writing for the level cache.
+ * Added a stride for skipping rotated copies when quality is reduced.
+ * Rotated copies now returned as instances of one drawable object.
+ * Added reduced detail for objects that are small on screen.
+ * Changed the rotated copy stride to a parameter, for drawing only.
+ * Added a function for getting the radius without drawable objects.
+ * Changed reduced detail to use points built ahead of time, and added a
+ * way to build drawable objects without copying vertices.
  */
 
 
@@ -39,6 +50,7 @@
 
 #include "ParameterSpaceControlPoint.h"
 #include "DrawableObject.h"
+#include "LevelCache.h"
 
 
 
@@ -117,6 +129,24 @@ class ObjectParameterSpaceControlPoint : public ParameterSpaceControlPoint {
          *   from inFILE fails.
          */
         ObjectParameterSpaceControlPoint( FILE *inFILE, char *outError );
+
+
+
+        /**
+         * Constructs a control point by reading values written with
+         * writeToBinaryFile from a cache entry.
+         *
+         * @param inEntry the entry to read from.
+         *   Must be destroyed by caller.
+         * @param inoutPosition pointer to the position in the entry data
+         *   to read from.  Will be advanced past the control point.
+         * @param outError pointer to where error flag should be returned.
+         *   Destination will be set to true if reading a control point
+         *   from inEntry fails.
+         */
+        ObjectParameterSpaceControlPoint( LevelCacheEntry *inEntry,
+                                          unsigned long *inoutPosition,
+                                          char *outError );
         
 
         
@@ -131,6 +161,17 @@ class ObjectParameterSpaceControlPoint : public ParameterSpaceControlPoint {
          *   Must be closed by caller.
          */
         void writeToFile( FILE *inFILE );
+
+
+
+        /**
+         * Writes this control point out to a binary file stream in
+         * the native byte order.
+         *
+         * @param inFILE the open file to write to.
+         *   Must be closed by caller.
+         */
+        void writeToBinaryFile( FILE *inFILE );
         
         
         
@@ -146,13 +187,118 @@ class ObjectParameterSpaceControlPoint : public ParameterSpaceControlPoint {
         /**
          * Gets drawable objects from this control point.
          *
+         * Rotated copies are returned as instances of one object, rather
+         * than as one object each.
+         *
+         * When the objects will be small on screen, rotated copies that
+         * would be too close together at the edge of the shape to tell
+         * apart are left out.  The first and last copies are always kept.
+         * Vertices are never left out here:  to draw fewer, get this point
+         * from reduced points made by createDetailLevels.
+         *
+         * Objects that are tested for collisions copy by copy must be
+         * built with the default, full detail, so that hits do not depend
+         * on drawing quality.
+         *
+         * @param inPixelsPerUnit how many pixels one unit of this point's
+         *   shape will cover on screen, or 0 for full detail.
+         *   Defaults to 0.
+         * @param inRotatedCopyStride how many rotated copies to step over
+         *   for each one returned:  1 to return every copy, 2 to return
+         *   every other copy, and so on.  The first and last copies are
+         *   always returned.  Defaults to 1.
+         *
          * @return this control point as a collection of drawable objects.
          *   Vector and objects must be destroyed by caller.
          */
-        SimpleVector<DrawableObject *> *getDrawableObjects();
+        SimpleVector<DrawableObject *> *getDrawableObjects(
+            double inPixelsPerUnit = 0, int inRotatedCopyStride = 1 );
+
+
+
+        /**
+         * Gets drawable objects as getDrawableObjects does, but gives them
+         * this point's vertex and color arrays instead of copying them.
+         *
+         * For points that are thrown away after drawing, such as blends.
+         * This point is left without vertices, and can only be destroyed
+         * afterward.
+         *
+         * Parameters and return value are the same as for
+         * getDrawableObjects.
+         */
+        SimpleVector<DrawableObject *> *extractDrawableObjects(
+            double inPixelsPerUnit = 0, int inRotatedCopyStride = 1 );
+
+
+
+        /**
+         * Gets how far the border of a shape can move without the change
+         * being seen, for choosing reduced points from createDetailLevels.
+         *
+         * @param inPixelsPerUnit how many pixels one unit of the shape
+         *   will cover on screen, or 0 for full detail.
+         *
+         * @return the distance in the shape's units, or 0 for full
+         *   detail.
+         */
+        static double getDetailTolerance( double inPixelsPerUnit );
+
+
+
+        /**
+         * Gets the tolerance, as from getDetailTolerance, below which a
+         * shape is always drawn in full.
+         *
+         * @param inRadius the radius of the shape, as from getRadius.
+         *
+         * @return the tolerance in the shape's units.
+         */
+        static double getFullDetailTolerance( double inRadius );
+
+
+
+        /**
+         * Makes copies of points without the triangles and border
+         * vertices that are too small to see at a given detail.
+         *
+         * The same triangles and vertices are left out of every point,
+         * so that blends of the copies line up as blends of the originals
+         * do.  A triangle is kept if it is large enough in any point, and
+         * a border vertex is kept unless it is less than inTolerance from
+         * the line between its neighbors, with nearly the color of that
+         * line, in every point.  No two neighboring vertices are left
+         * out, and the vertex farthest from the center of each point is
+         * kept, so the radius does not change.
+         *
+         * @param inPoints the points to copy.
+         *   Array and points must be destroyed by caller.
+         * @param inNumPoints the number of points.
+         * @param inTolerance how far, in the points' units, the border
+         *   may move, and the square root of how large a triangle can be
+         *   left out.
+         *
+         * @return the reduced copies, in the same order as inPoints, or
+         *   NULL if the points do not all have the same numbers of
+         *   vertices.
+         *   Array and points must be destroyed by caller.
+         */
+        static ObjectParameterSpaceControlPoint **createDetailLevels(
+            ObjectParameterSpaceControlPoint **inPoints, int inNumPoints,
+            double inTolerance );
 
         
 
+        /**
+         * Gets the radius of the objects that getDrawableObjects returns.
+         *
+         * @return the largest distance of any border vertex of any
+         *   rotated copy from the center.
+         */
+        double getRadius();
+
+
+
         /**
          * Gets the rotation rate of this point.
          *
@@ -161,6 +307,16 @@ class ObjectParameterSpaceControlPoint : public ParameterSpaceControlPoint {
         double getRotationRate();
 
 
+
+        /**
+         * Gets the approximate amount of memory used by this point.
+         *
+         * @return the size of this point and its vertex and color
+         *   arrays in bytes.
+         */
+        unsigned long getMemorySize();
+
+
         
         // These internal members are public only to allow this control
         // point to be blended with other control points.
@@ -212,6 +368,35 @@ class ObjectParameterSpaceControlPoint : public ParameterSpaceControlPoint {
 
     protected:
 
+        /**
+         * Gets the stride that getDrawableObjects steps over rotated
+         * copies with.
+         *
+         * Parameters are the same as for getDrawableObjects.
+         *
+         * @return the stride, at least inRotatedCopyStride.
+         */
+        int getDrawnCopyStride( double inPixelsPerUnit,
+                                int inRotatedCopyStride );
+
+        
+
+        /**
+         * Builds drawable objects from this control point with all of its
+         * vertices.
+         *
+         * @param inRotatedCopyStride how many rotated copies to step over
+         *   for each one built, as for getDrawableObjects.
+         * @param inGiveArrays true to give this point's vertex and color
+         *   arrays to the objects, leaving this point without vertices,
+         *   or false to copy them.
+         *
+         * @return the objects.
+         *   Vector and objects must be destroyed by caller.
+         */
+        SimpleVector<DrawableObject *> *buildDrawableObjects(
+            int inRotatedCopyStride, char inGiveArrays );
+
         
         
         /**
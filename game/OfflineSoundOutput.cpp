@@ -0,0 +1,221 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "OfflineSoundOutput.h"
+#include "SoundPlayer.h"
+#include "FrameProfiler.h"
+
+
+#include "minorGems/util/stringUtils.h"
+
+
+#include <string.h>
+
+
+
+// the length of the header written by writeWAVHeader
+static const long wavHeaderLength = 44;
+
+
+
+/**
+ * Writes an integer in little-endian byte order, as WAV files need
+ * regardless of the platform.
+ *
+ * @param inFILE the file to write to.
+ *   Must be closed by caller.
+ * @param inValue the value to write.
+ * @param inNumBytes the number of low bytes of inValue to write.
+ */
+static void writeLittleEndian( FILE *inFILE, unsigned long inValue,
+                               int inNumBytes ) {
+    for( int b=0; b<inNumBytes; b++ ) {
+        fputc( (int)( ( inValue >> ( 8 * b ) ) & 0xFF ), inFILE );
+        }
+    }
+
+
+
+OfflineSoundOutput::OfflineSoundOutput( char *inFileName,
+                                        unsigned long inSampleRate,
+                                        char inRaw,
+                                        unsigned long inFramesPerBuffer )
+    : mFileName( NULL ),
+      mSampleRate( inSampleRate ),
+      mRaw( inRaw ),
+      mFramesPerBuffer( inFramesPerBuffer ),
+      mPlayer( NULL ),
+      mFILE( NULL ),
+      mStarted( false ),
+      mNumFramesWritten( 0 ),
+      mNumBuffersRendered( 0 ),
+      mRenderMicroseconds( 0 ) {
+
+    if( inFileName != NULL ) {
+        mFileName = stringDuplicate( inFileName );
+        }
+    }
+
+
+
+OfflineSoundOutput::~OfflineSoundOutput() {
+    stop();
+
+    if( mFileName != NULL ) {
+        delete [] mFileName;
+        }
+    }
+
+
+
+char OfflineSoundOutput::start( SoundPlayer *inPlayer ) {
+    if( mStarted ) {
+        return true;
+        }
+
+    mPlayer = inPlayer;
+    mNumFramesWritten = 0;
+
+    if( mFileName != NULL ) {
+        mFILE = fopen( mFileName, "wb" );
+
+        if( mFILE == NULL ) {
+            fprintf( stderr, "Failed to open %s for writing\n", mFileName );
+            return false;
+            }
+
+        if( !mRaw ) {
+            // sizes are filled in by stop
+            writeWAVHeader();
+            }
+        }
+
+    mStarted = true;
+
+    return true;
+    }
+
+
+
+void OfflineSoundOutput::stop() {
+    if( !mStarted ) {
+        return;
+        }
+
+    if( mFILE != NULL ) {
+        if( !mRaw ) {
+            fseek( mFILE, 0, SEEK_SET );
+            writeWAVHeader();
+            }
+
+        fclose( mFILE );
+        mFILE = NULL;
+        }
+
+    mStarted = false;
+    }
+
+
+
+void OfflineSoundOutput::writeWAVHeader() {
+    unsigned long bytesPerFrame = 2 * sizeof( float );
+    unsigned long dataLength = mNumFramesWritten * bytesPerFrame;
+
+    fwrite( "RIFF", 1, 4, mFILE );
+    writeLittleEndian( mFILE, wavHeaderLength - 8 + dataLength, 4 );
+    fwrite( "WAVE", 1, 4, mFILE );
+
+    fwrite( "fmt ", 1, 4, mFILE );
+    writeLittleEndian( mFILE, 16, 4 );
+    // 3 is IEEE float
+    writeLittleEndian( mFILE, 3, 2 );
+    // stereo
+    writeLittleEndian( mFILE, 2, 2 );
+    writeLittleEndian( mFILE, mSampleRate, 4 );
+    writeLittleEndian( mFILE, mSampleRate * bytesPerFrame, 4 );
+    writeLittleEndian( mFILE, bytesPerFrame, 2 );
+    writeLittleEndian( mFILE, 8 * sizeof( float ), 2 );
+
+    fwrite( "data", 1, 4, mFILE );
+    writeLittleEndian( mFILE, dataLength, 4 );
+    }
+
+
+
+void OfflineSoundOutput::writeSamples( float *inSamples,
+                                       unsigned long inNumFrames ) {
+    if( !mStarted ) {
+        return;
+        }
+
+    if( mFILE != NULL ) {
+        unsigned long numSamples = 2 * inNumFrames;
+
+        for( unsigned long i=0; i<numSamples; i++ ) {
+            // write the bits of the float, little end first
+            unsigned int bits;
+            memcpy( &bits, &( inSamples[i] ), sizeof( float ) );
+
+            writeLittleEndian( mFILE, bits, sizeof( float ) );
+            }
+        }
+
+    mNumFramesWritten += inNumFrames;
+    }
+
+
+
+void OfflineSoundOutput::render( unsigned long inNumFrames ) {
+    if( !mStarted ) {
+        return;
+        }
+
+    float *buffer = new float[ 2 * mFramesPerBuffer ];
+
+    unsigned long framesLeft = inNumFrames;
+
+    while( framesLeft > 0 ) {
+        unsigned long numFrames = mFramesPerBuffer;
+        if( numFrames > framesLeft ) {
+            numFrames = framesLeft;
+            }
+
+        double startTime = FrameProfiler::getCurrentMicroseconds();
+
+        mPlayer->getSamples( (void *)buffer, numFrames );
+
+        mRenderMicroseconds +=
+            FrameProfiler::getCurrentMicroseconds() - startTime;
+        mNumBuffersRendered++;
+
+        writeSamples( buffer, numFrames );
+
+        framesLeft -= numFrames;
+        }
+
+    delete [] buffer;
+    }
+
+
+
+unsigned long OfflineSoundOutput::getNumBuffersRendered() {
+    return mNumBuffersRendered;
+    }
+
+
+
+double OfflineSoundOutput::getRenderMicroseconds() {
+    return mRenderMicroseconds;
+    }
+
+
+
+unsigned long OfflineSoundOutput::getNumFramesWritten() {
+    return mNumFramesWritten;
+    }
@@ -0,0 +1,143 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef OFFLINE_SOUND_OUTPUT_INCLUDED
+#define OFFLINE_SOUND_OUTPUT_INCLUDED
+
+
+
+#include "SoundOutput.h"
+
+
+#include <stdio.h>
+
+
+
+/**
+ * Writes sound to a file instead of playing it, as 32-bit float stereo
+ * in either a WAV file or a raw file with no header.
+ *
+ * Driven by the caller:  samples are written as the caller pulls them
+ * with SoundPlayer::pullSamples (as headless runs do once per frame),
+ * or as fast as they can be mixed by render.  Either way, the output
+ * depends only on what the game played, not on how fast it ran, so it
+ * can be compared against a known-good recording.
+ *
+ * @author Jason Rohrer
+ */
+class OfflineSoundOutput : public SoundOutput {
+
+
+
+    public:
+
+        /**
+         * Constructs an output.  The file is not opened until start.
+         *
+         * @param inFileName the name of the file to write, or NULL to
+         *   discard the samples (for measuring mixing speed alone).
+         *   Must be destroyed by caller.
+         * @param inSampleRate the number of samples per second.
+         * @param inRaw true to write raw little-endian float samples, or
+         *   false to write a WAV file.  Defaults to false.
+         * @param inFramesPerBuffer the number of stereo frames that
+         *   render pulls at a time.  Defaults to 1024, like the
+         *   default AudioLatencyProfile.
+         */
+        OfflineSoundOutput( char *inFileName,
+                            unsigned long inSampleRate,
+                            char inRaw = false,
+                            unsigned long inFramesPerBuffer = 1024 );
+
+
+
+        virtual ~OfflineSoundOutput();
+
+
+
+        // implements the SoundOutput interface
+        virtual char start( SoundPlayer *inPlayer );
+        virtual void stop();
+        virtual void writeSamples( float *inSamples,
+                                   unsigned long inNumFrames );
+
+
+
+        /**
+         * Pulls samples from the player and writes them as fast as they
+         * can be mixed.
+         *
+         * Must be called between start and stop.
+         *
+         * @param inNumFrames the number of stereo frames to render.
+         */
+        void render( unsigned long inNumFrames );
+
+
+
+        /**
+         * Gets the number of buffers pulled by render.
+         *
+         * @return the number of buffers.
+         */
+        unsigned long getNumBuffersRendered();
+
+
+
+        /**
+         * Gets the time render has spent mixing, not counting the time
+         * spent writing to the file.
+         *
+         * @return the time in microseconds.
+         */
+        double getRenderMicroseconds();
+
+
+
+        /**
+         * Gets the number of stereo frames written since start.
+         *
+         * @return the number of frames.
+         */
+        unsigned long getNumFramesWritten();
+
+
+
+    protected:
+
+        char *mFileName;
+        unsigned long mSampleRate;
+        char mRaw;
+        unsigned long mFramesPerBuffer;
+
+        SoundPlayer *mPlayer;
+
+        // NULL if samples are being discarded
+        FILE *mFILE;
+
+        char mStarted;
+
+        unsigned long mNumFramesWritten;
+
+        unsigned long mNumBuffersRendered;
+        double mRenderMicroseconds;
+
+
+
+        /**
+         * Writes the WAV header, which must be rewritten once the
+         * number of frames is known.
+         */
+        void writeWAVHeader();
+
+    };
+
+
+
+#endif
@@ -6,6 +6,9 @@
  *
  * 2004-August-12   Jason Rohrer
  * Added support for getting blocks of samples.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added mixing straight into a view of another buffer.
  */
 
 
@@ -58,6 +61,31 @@ SoundSamples *OnePointPlayableSound::getMoreSamples(
 
 
 
+unsigned long OnePointPlayableSound::mixMoreSamples(
+    StereoSampleView inOutSamples,
+    float inStartGain, float inGainStep ) {
+
+    unsigned long numSamples = inOutSamples.mSampleCount;
+    
+    if( mCurrentSoundPositionInSamples + numSamples >
+        mSoundLengthInSamples ) {
+
+        numSamples = mSoundLengthInSamples - mCurrentSoundPositionInSamples;
+        }
+
+    mControlPoint->mixSoundSamples( inOutSamples.getRegion( 0, numSamples ),
+                                    inStartGain, inGainStep,
+                                    mCurrentSoundPositionInSamples,
+                                    mSamplesPerSecond,
+                                    mSoundLengthInSeconds );
+
+    mCurrentSoundPositionInSamples += numSamples;
+    
+    return numSamples;
+    }
+
+
+
 PlayableSound *OnePointPlayableSound::copy() {
     return new OnePointPlayableSound(
         (StereoSoundParameterSpaceControlPoint *)(
@@ -3,6 +3,9 @@
  *
  * 2004-August-9   Jason Rohrer
  * Created.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added mixing straight into a view of another buffer.
  */
 
 
@@ -51,6 +54,9 @@ class OnePointPlayableSound : public PlayableSound {
         
         // implements the PlayableSound interface
         virtual SoundSamples *getMoreSamples( unsigned long inNumSamples );
+        virtual unsigned long mixMoreSamples( StereoSampleView inOutSamples,
+                                              float inStartGain,
+                                              float inGainStep );
         virtual PlayableSound *copy();
         
 
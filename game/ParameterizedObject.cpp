@@ -9,6 +9,12 @@
  *
  * 2004-June-22   Jason Rohrer
  * Fixed algorithmic errors in linear blend function.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added support for loading parsed objects from the level cache.
+ * Added a rotated copy stride parameter for drawing.
+ * Added a function for getting the rotation rate without blending.
+ * Added reduced detail control points, built once for each level.
  */
 
 
@@ -16,9 +22,43 @@
 #include "ParameterizedObject.h"
 
 
+#include "minorGems/util/stringUtils.h"
+
+
+
+// how many reduced detail levels buildDetailLevels makes, each with twice
+// the tolerance of the one before
+static const int numDetailLevels = 6;
+
+
+
+ParameterizedObject::ParameterizedObject( FILE *inFILE, char *outError )
+    : mNumDetailLevels( 0 ), mDetailTolerances( NULL ),
+      mDetailControlPoints( NULL ) {
+
+    char *cacheEntryName = NULL;
+    
+    if( inFILE != NULL && LevelCache::isEnabled() ) {
+        cacheEntryName = getCacheEntryName( inFILE );
+
+        LevelCacheEntry *entry = LevelCache::readEntry( cacheEntryName );
 
-ParameterizedObject::ParameterizedObject( FILE *inFILE, char *outError ) {
+        if( entry != NULL ) {
+            char readSuccess = readFromCacheEntry( entry );
+            delete entry;
 
+            if( readSuccess ) {
+                delete [] cacheEntryName;
+
+                // leave the stream where parsing would have left it
+                fseek( inFILE, 0, SEEK_END );
+                
+                *outError = false;
+                return;
+                }
+            }
+        }
+    
     SimpleVector<ParameterSpaceControlPoint *> *controlPoints =
         new SimpleVector<ParameterSpaceControlPoint*>();
     SimpleVector<double> *controlPointParameterAnchors =
@@ -70,22 +110,252 @@ ParameterizedObject::ParameterizedObject( FILE *inFILE, char *outError ) {
         // we didn't read enough control points
         *outError = true;
         }
+
+    if( cacheEntryName != NULL ) {
+        // don't cache broken objects, so that their errors are still
+        // reported on the next run
+        if( ! *outError ) {
+            writeToCache( cacheEntryName );
+            }
+        delete [] cacheEntryName;
+        }
+    }
+
+
+
+ParameterizedObject::~ParameterizedObject() {
+
+    for( int d=0; d<mNumDetailLevels; d++ ) {
+        for( int i=0; i<mNumControlPoints; i++ ) {
+            delete mDetailControlPoints[d][i];
+            }
+        delete [] mDetailControlPoints[d];
+        }
+
+    if( mDetailControlPoints != NULL ) {
+        delete [] mDetailControlPoints;
+        }
+    if( mDetailTolerances != NULL ) {
+        delete [] mDetailTolerances;
+        }
+    }
+
+
+
+void ParameterizedObject::buildDetailLevels( ParameterizedObject **inObjects,
+                                             int inNumObjects ) {
+
+    // reduce all points of all objects together
+    SimpleVector<ObjectParameterSpaceControlPoint *> *points =
+        new SimpleVector<ObjectParameterSpaceControlPoint *>();
+
+    int i, o, d;
+
+    double radius = 0;
+    
+    for( o=0; o<inNumObjects; o++ ) {
+        ParameterizedObject *object = inObjects[o];
+        
+        for( i=0; i<object->mNumControlPoints; i++ ) {
+            ObjectParameterSpaceControlPoint *point =
+                (ObjectParameterSpaceControlPoint *)(
+                    object->mControlPoints[i] );
+
+            points->push_back( point );
+
+            double pointRadius = point->getRadius();
+            if( pointRadius > radius ) {
+                radius = pointRadius;
+                }
+            }
+        }
+
+    int numPoints = points->size();
+
+    ObjectParameterSpaceControlPoint ***levels =
+        new ObjectParameterSpaceControlPoint**[ numDetailLevels ];
+    double *tolerances = new double[ numDetailLevels ];
+
+    // the first level is for shapes that have just become small enough to
+    // reduce
+    double tolerance =
+        ObjectParameterSpaceControlPoint::getFullDetailTolerance( radius );
+
+    int numLevels = 0;
+
+    if( numPoints > 0 && radius > 0 ) {
+        ObjectParameterSpaceControlPoint **pointArray =
+            points->getElementArray();
+        
+        for( d=0; d<numDetailLevels; d++ ) {
+            levels[d] = ObjectParameterSpaceControlPoint::createDetailLevels(
+                pointArray, numPoints, tolerance );
+
+            if( levels[d] == NULL ) {
+                // points cannot be reduced together
+                break;
+                }
+
+            tolerances[d] = tolerance;
+            numLevels++;
+
+            tolerance *= 2;
+            }
+
+        delete [] pointArray;
+        }
+
+    delete points;
+
+    
+    // hand each object its own points from each level
+    if( numLevels > 0 ) {
+        for( o=0; o<inNumObjects; o++ ) {
+            ParameterizedObject *object = inObjects[o];
+
+            object->mNumDetailLevels = numLevels;
+            object->mDetailTolerances = new double[ numLevels ];
+            object->mDetailControlPoints =
+                new ObjectParameterSpaceControlPoint**[ numLevels ];
+            }
+        }
+
+    for( d=0; d<numLevels; d++ ) {
+        int p = 0;
+        
+        for( o=0; o<inNumObjects; o++ ) {
+            ParameterizedObject *object = inObjects[o];
+
+            object->mDetailTolerances[d] = tolerances[d];
+            object->mDetailControlPoints[d] =
+                new ObjectParameterSpaceControlPoint*[
+                    object->mNumControlPoints ];
+
+            for( i=0; i<object->mNumControlPoints; i++ ) {
+                object->mDetailControlPoints[d][i] = levels[d][p];
+                p++;
+                }
+            }
+
+        delete [] levels[d];
+        }
+
+    delete [] levels;
+    delete [] tolerances;
+    }
+
+
+
+char *ParameterizedObject::getCacheEntryName( FILE *inFILE ) {
+    long startPosition = ftell( inFILE );
+
+    // named colors are read from the level, so they are part of our source
+    unsigned long hash = LevelCache::hashLevelDirectory( "colors" );
+
+    unsigned char buffer[ 4096 ];
+    size_t numRead = fread( buffer, 1, sizeof( buffer ), inFILE );
+    while( numRead > 0 ) {
+        hash = LevelCache::hashData( buffer, numRead, hash );
+        numRead = fread( buffer, 1, sizeof( buffer ), inFILE );
+        }
+
+    fseek( inFILE, startPosition, SEEK_SET );
+
+    return autoSprintf( "object_%08lx", hash );
+    }
+
+
+
+char ParameterizedObject::readFromCacheEntry( LevelCacheEntry *inEntry ) {
+    unsigned long position = 0;
+    int numControlPoints;
+
+    if( ! inEntry->readValue( &position, &numControlPoints, sizeof( int ) )
+        || numControlPoints < 2 ) {
+        return false;
+        }
+
+    // bound by the smallest possible point size before allocating
+    if( (unsigned long)numControlPoints * sizeof( double ) >
+        inEntry->mLength ) {
+        return false;
+        }
+    
+    double *anchors = new double[ numControlPoints ];
+    ParameterSpaceControlPoint **points =
+        new ParameterSpaceControlPoint*[ numControlPoints ];
+
+    char error = false;
+    int numPointsRead = 0;
+    
+    while( numPointsRead < numControlPoints && !error ) {
+        error = ! inEntry->readValue( &position,
+                                      &( anchors[ numPointsRead ] ),
+                                      sizeof( double ) );
+        if( !error ) {
+            points[ numPointsRead ] =
+                new ObjectParameterSpaceControlPoint( inEntry, &position,
+                                                      &error );
+            numPointsRead++;
+            }
+        }
+
+    if( error || position != inEntry->mLength ) {
+        for( int i=0; i<numPointsRead; i++ ) {
+            delete points[i];
+            }
+        delete [] points;
+        delete [] anchors;
+
+        return false;
+        }
+
+    mNumControlPoints = numControlPoints;
+    mControlPointParameterAnchors = anchors;
+    mControlPoints = points;
+
+    return true;
+    }
+
+
+
+void ParameterizedObject::writeToCache( char *inEntryName ) {
+    LevelCacheWriter *writer = LevelCache::startEntry( inEntryName );
+
+    if( writer == NULL ) {
+        return;
+        }
+
+    FILE *file = writer->mFILE;
+
+    fwrite( &mNumControlPoints, sizeof( int ), 1, file );
+
+    for( int i=0; i<mNumControlPoints; i++ ) {
+        fwrite( &( mControlPointParameterAnchors[i] ), sizeof( double ), 1,
+                file );
+        
+        ( (ObjectParameterSpaceControlPoint *)( mControlPoints[i] ) )->
+            writeToBinaryFile( file );
+        }
+
+    LevelCache::finishEntry( writer );
     }
 
 
 
 SimpleVector<DrawableObject *> *ParameterizedObject::getDrawableObjects(
-    double inParameter, double *outRotationRate ) {
+    double inParameter, double *outRotationRate,
+    int inRotatedCopyStride ) {
 
     // blend the two points, using the distance to weight them
     ObjectParameterSpaceControlPoint *blendedPoint =
         getBlendedControlPoint( inParameter );
     
     if( blendedPoint != NULL ) {
-        SimpleVector<DrawableObject*> *drawableObjects =
-            blendedPoint->getDrawableObjects();
-        
         *outRotationRate = blendedPoint->getRotationRate();
+
+        SimpleVector<DrawableObject*> *drawableObjects =
+            blendedPoint->extractDrawableObjects( 0, inRotatedCopyStride );
         
         delete blendedPoint;
         
@@ -111,3 +381,71 @@ ObjectParameterSpaceControlPoint *ParameterizedObject::getBlendedControlPoint(
         ParameterizedSpace::getBlendedControlPoint( inParameter );
 
     }
+
+
+
+ObjectParameterSpaceControlPoint *ParameterizedObject::getBlendedControlPoint(
+    double inParameter, double inTolerance ) {
+
+    // the most reduced level within our tolerance
+    int level = -1;
+    for( int d=0; d<mNumDetailLevels; d++ ) {
+        if( mDetailTolerances[d] <= inTolerance ) {
+            level = d;
+            }
+        }
+
+    if( level == -1 ) {
+        return getBlendedControlPoint( inParameter );
+        }
+
+    ObjectParameterSpaceControlPoint **points = mDetailControlPoints[ level ];
+    
+    int firstIndex, secondIndex;
+    double weightOfSecondPoint;
+
+    if( ! getBlendPoints( inParameter, &firstIndex, &secondIndex,
+                          &weightOfSecondPoint ) ) {
+        return NULL;
+        }
+
+    if( secondIndex != -1 ) {
+        return (ObjectParameterSpaceControlPoint *)(
+            points[ firstIndex ]->createLinearBlend( points[ secondIndex ],
+                                                     weightOfSecondPoint ) );
+        }
+    else {
+        return (ObjectParameterSpaceControlPoint *)(
+            points[ firstIndex ]->copy() );
+        }
+    }
+
+
+
+double ParameterizedObject::getRotationRate( double inParameter ) {
+
+    int firstIndex, secondIndex;
+    double weightOfSecondPoint;
+
+    if( ! getBlendPoints( inParameter, &firstIndex, &secondIndex,
+                          &weightOfSecondPoint ) ) {
+        return 0;
+        }
+
+    // same weights as the linear blend of the whole points
+    double rotationRate =
+        ( (ObjectParameterSpaceControlPoint *)
+          ( mControlPoints[ firstIndex ] ) )->getRotationRate();
+
+    if( secondIndex != -1 ) {
+        double secondRotationRate =
+            ( (ObjectParameterSpaceControlPoint *)
+              ( mControlPoints[ secondIndex ] ) )->getRotationRate();
+
+        rotationRate =
+            weightOfSecondPoint * secondRotationRate +
+            ( 1 - weightOfSecondPoint ) * rotationRate;
+        }
+
+    return rotationRate;
+    }
@@ -9,6 +9,12 @@
  *
  * 2004-August-9   Jason Rohrer
  * Made a subclass of ParameterizedSpace.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added support for loading parsed objects from the level cache.
+ * Added a rotated copy stride parameter for drawing.
+ * Added a function for getting the rotation rate without blending.
+ * Added reduced detail control points, built once for each level.
  */
 
 
@@ -44,6 +50,10 @@ class ParameterizedObject : public ParameterizedSpace {
          * Constructs an object by reading values from a text file
          * stream.
          *
+         * If the LevelCache is enabled, an object parsed on a previous run
+         * from the same text (and level colors) is read from the cache
+         * instead of being parsed again.
+         *
          * @param inFILE the open file to read from.
          *   Must be closed by caller.
          * @param outError pointer to where error flag should be returned.
@@ -53,6 +63,30 @@ class ParameterizedObject : public ParameterizedSpace {
         ParameterizedObject( FILE *inFILE, char *outError );
 
 
+        
+        virtual ~ParameterizedObject();
+
+
+
+        /**
+         * Builds reduced detail copies of the control points of objects
+         * that are blended with each other, for
+         * getBlendedControlPoint( double, double ).
+         *
+         * The same vertices are left out of every object's points, as
+         * for ObjectParameterSpaceControlPoint::createDetailLevels, so
+         * that blends between the objects still line up.  If the objects'
+         * points do not all have the same numbers of vertices, no copies
+         * are built, and the objects are always drawn in full.
+         *
+         * @param inObjects the objects.
+         *   Array and objects must be destroyed by caller.
+         * @param inNumObjects the number of objects.
+         */
+        static void buildDetailLevels( ParameterizedObject **inObjects,
+                                       int inNumObjects );
+
+
 
         /**
          * Gets drawable objects from this object space.
@@ -61,13 +95,18 @@ class ParameterizedObject : public ParameterizedSpace {
          *   into the object space.
          * @param outRotationRate pointer to where the mapped rotation
          *   rate should be returned.
+         * @param inRotatedCopyStride how many rotated copies to step over
+         *   for each one returned, as for
+         *   ObjectParameterSpaceControlPoint::getDrawableObjects.
+         *   Defaults to 1.
          *
          * @return this object as a collection of drawable objects.
          *   Can return NULL if this space was not properly initialized.
          *   Vector and objects must be destroyed by caller.
          */
         SimpleVector<DrawableObject *> *getDrawableObjects(
-            double inParameter, double *outRotationRate );
+            double inParameter, double *outRotationRate,
+            int inRotatedCopyStride = 1 );
 
         
 
@@ -85,10 +124,89 @@ class ParameterizedObject : public ParameterizedSpace {
             double inParameter );
 
 
+
+        /**
+         * Gets a blended object control point from this object space,
+         * blended from reduced detail control points.
+         *
+         * @param inParameter the parameter in the range [0,1] to map
+         *   into the object space.
+         * @param inTolerance how far the border may move, as from
+         *   ObjectParameterSpaceControlPoint::getDetailTolerance, or 0
+         *   for full detail.  The most reduced points built by
+         *   buildDetailLevels that stay within inTolerance are used.
+         *
+         * @return the blended control point.
+         *   Can return NULL if this space was not properly initialized.
+         *   Must be destroyed by caller.
+         */
+        ObjectParameterSpaceControlPoint *getBlendedControlPoint(
+            double inParameter, double inTolerance );
+
+
+
+        /**
+         * Gets the rotation rate that getDrawableObjects would return,
+         * without blending whole control points.
+         *
+         * @param inParameter the parameter in the range [0,1] to map
+         *   into the object space.
+         *
+         * @return the mapped rotation rate, or 0 if this space was not
+         *   properly initialized.
+         */
+        double getRotationRate( double inParameter );
+
+
         
     protected:
 
         // inherit all protected members from ParameterizedSpace
+
+
+        // reduced detail copies of mControlPoints, from the least reduced
+        // to the most, or none if buildDetailLevels has not been called
+        int mNumDetailLevels;
+        double *mDetailTolerances;
+        ObjectParameterSpaceControlPoint ***mDetailControlPoints;
+
+
+
+        /**
+         * Gets the name of the cache entry for the rest of a stream.
+         *
+         * Leaves the stream position unchanged.
+         *
+         * @param inFILE the stream.
+         *   Must be closed by caller.
+         *
+         * @return the name.
+         *   Must be destroyed by caller.
+         */
+        static char *getCacheEntryName( FILE *inFILE );
+
+
+        
+        /**
+         * Reads control points from a cache entry.
+         *
+         * @param inEntry the entry.
+         *   Must be destroyed by caller.
+         *
+         * @return true on success, or false if inEntry is invalid (in
+         *   which case no members are set).
+         */
+        char readFromCacheEntry( LevelCacheEntry *inEntry );
+
+
+
+        /**
+         * Writes control points to the cache.
+         *
+         * @param inEntryName the name of the entry.
+         *   Must be destroyed by caller.
+         */
+        void writeToCache( char *inEntryName );
         
         
     };
@@ -3,6 +3,9 @@
  *
  * 2004-August-9   Jason Rohrer
  * Created.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Split out the search for the control points to blend.
  */
 
 
@@ -26,10 +29,13 @@ ParameterizedSpace::~ParameterizedSpace() {
 
 
 
-ParameterSpaceControlPoint *ParameterizedSpace::getBlendedControlPoint(
-    double inParameter ) {
-
+char ParameterizedSpace::getBlendPoints( double inParameter,
+                                         int *outFirstIndex,
+                                         int *outSecondIndex,
+                                         double *outWeightOfSecondPoint ) {
 
+    *outSecondIndex = -1;
+    *outWeightOfSecondPoint = 0;
        
     if( mNumControlPoints >= 2 ) {
         // find the 2 surrounding control points
@@ -80,13 +86,9 @@ ParameterSpaceControlPoint *ParameterizedSpace::getBlendedControlPoint(
                 distanceFromClosestSmallerPoint /
                 distanceBetweenSurroundingPoints;
 
-
-            // blend the two points, using the distance to weight them
-            return 
-                mControlPoints[ indexOfClosestSmallerPoint ]->
-                    createLinearBlend(
-                        mControlPoints[ indexOfClosestLargerPoint ],
-                        weightOnLargerPoint );
+            *outFirstIndex = indexOfClosestSmallerPoint;
+            *outSecondIndex = indexOfClosestLargerPoint;
+            *outWeightOfSecondPoint = weightOnLargerPoint;
             }
         else {
             // found only one point
@@ -105,21 +107,50 @@ ParameterSpaceControlPoint *ParameterizedSpace::getBlendedControlPoint(
                 indexOfPoint = 0;
                 }
 
-            // return copy of this point
-            return mControlPoints[ indexOfPoint ]->copy();
+            *outFirstIndex = indexOfPoint;
             }
+
+        return true;
         }
     else if( mNumControlPoints == 1 ) {
-        // only one anchor point... return its parameters
+        // only one anchor point... use its parameters
         
-        return mControlPoints[0]->copy();
+        *outFirstIndex = 0;
+
+        return true;
         }
     else {
         printf( "Error:  no anchor points in sculpture parameter space.\n" );
 
+        return false;
+        }
+    }
+
+
+
+ParameterSpaceControlPoint *ParameterizedSpace::getBlendedControlPoint(
+    double inParameter ) {
+
+    int firstIndex, secondIndex;
+    double weightOfSecondPoint;
+
+    if( ! getBlendPoints( inParameter, &firstIndex, &secondIndex,
+                          &weightOfSecondPoint ) ) {
         return NULL;
         }
 
+    if( secondIndex != -1 ) {
+        // blend the two points, using the distance to weight them
+        return 
+            mControlPoints[ firstIndex ]->createLinearBlend(
+                mControlPoints[ secondIndex ],
+                weightOfSecondPoint );
+        }
+    else {
+        // return copy of this point
+        return mControlPoints[ firstIndex ]->copy();
+        }
+
     /*
     if( mNumControlPoints >= 2 ) {
         // find the 2 closest control points
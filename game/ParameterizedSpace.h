@@ -3,6 +3,9 @@
  *
  * 2004-August-9   Jason Rohrer
  * Created.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Split out the search for the control points to blend.
  */
 
 
@@ -56,6 +59,30 @@ class ParameterizedSpace {
 
         ParameterSpaceControlPoint **mControlPoints;
 
+
+
+        
+        /**
+         * Finds the control points that getBlendedControlPoint blends for
+         * a parameter.
+         *
+         * @param inParameter the parameter in the range [0,1] to map
+         *   into the space.
+         * @param outFirstIndex pointer to where the index of the first
+         *   point should be returned.
+         * @param outSecondIndex pointer to where the index of the second
+         *   point should be returned, or -1 if the first point is used
+         *   alone.
+         * @param outWeightOfSecondPoint pointer to where the weight of the
+         *   second point in the blend, in [0,1], should be returned.
+         *
+         * @return true if points were found, or false if this space has
+         *   no control points.
+         */
+        char getBlendPoints( double inParameter,
+                             int *outFirstIndex, int *outSecondIndex,
+                             double *outWeightOfSecondPoint );
+
         
         
     };
@@ -3,6 +3,9 @@
  *
  * 2004-August-6   Jason Rohrer
  * Created.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added mixing into a view of another buffer.
  */
 
 
@@ -13,6 +16,7 @@
 
 
 #include "SoundSamples.h"
+#include "StereoSampleView.h"
 
 
 
@@ -41,6 +45,29 @@ class PlayableSound {
         virtual SoundSamples *getMoreSamples( unsigned long inNumSamples ) = 0;
 
 
+
+        /**
+         * Adds more samples from this sound into a buffer, instead of
+         * returning them in a new one.
+         *
+         * The default implementation mixes the result of getMoreSamples.
+         * Sounds that can render straight into the buffer should override
+         * it.
+         *
+         * @param inOutSamples the buffer to add to, whose sample count is
+         *   the number of samples to get.
+         * @param inStartGain the gain for the first sample.
+         * @param inGainStep the change in gain from one sample to the
+         *   next, as for StereoSampleView::mix.
+         *
+         * @return the number of samples added.  If less than the size of
+         *   inOutSamples, the end of the sound has been reached.
+         */
+        virtual unsigned long mixMoreSamples( StereoSampleView inOutSamples,
+                                              float inStartGain,
+                                              float inGainStep );
+
+
         
         /**
          * Makes a copy of this sound.
@@ -66,4 +93,21 @@ inline PlayableSound::~PlayableSound() {
 
 
 
+inline unsigned long PlayableSound::mixMoreSamples(
+    StereoSampleView inOutSamples,
+    float inStartGain, float inGainStep ) {
+
+    SoundSamples *samples = getMoreSamples( inOutSamples.mSampleCount );
+
+    unsigned long numSamples = samples->mSampleCount;
+    
+    inOutSamples.mix( StereoSampleView( samples ), inStartGain, inGainStep );
+
+    delete samples;
+
+    return numSamples;
+    }
+
+
+
 #endif
@@ -0,0 +1,168 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.  Moved stream handling here from SoundPlayer.
+ */
+
+
+
+#include "PortAudioSoundOutput.h"
+#include "SoundPlayer.h"
+
+
+#include <stdio.h>
+#include <string.h>
+
+
+
+// callback passed into portaudio
+static int portaudioCallback( void *inputBuffer, void *outputBuffer,
+                              unsigned long framesPerBuffer,
+                              PaTimestamp outTime, void *userData ) {
+
+
+    SoundPlayer *player = (SoundPlayer *)userData;
+
+    player->getSamples( outputBuffer, framesPerBuffer );
+
+    return 0;
+    }
+
+
+
+PortAudioSoundOutput::PortAudioSoundOutput( AudioLatencyProfile inProfile )
+    : mProfile( inProfile ),
+      mAudioInitialized( false ),
+      mAudioStream( NULL ) {
+
+    }
+
+
+
+PortAudioSoundOutput::~PortAudioSoundOutput() {
+    stop();
+    }
+
+
+
+char PortAudioSoundOutput::start( SoundPlayer *inPlayer ) {
+    if( mAudioInitialized ) {
+        return true;
+        }
+
+    PaError error = Pa_Initialize();
+
+    if( error == paNoError ) {
+
+        error = Pa_OpenStream(
+            &mAudioStream,
+            paNoDevice,// default input device
+            0,              // no input
+            paFloat32,  // 32 bit floating point input
+            NULL,
+            Pa_GetDefaultOutputDeviceID(),
+            2,          // stereo output
+            paFloat32,      // 32 bit floating point output
+            NULL,
+            mProfile.mSampleRate,
+            mProfile.mFramesPerBuffer,
+            mProfile.mNumBuffers,  // if zero then use default minimum
+            paClipOff, // we won't output out of range samples so
+                       // don't bother clipping them
+            portaudioCallback,
+            (void *)inPlayer );  // pass player to callback function
+
+        if( error == paNoError ) {
+
+            error = Pa_StartStream( mAudioStream );
+
+            if( error == paNoError ) {
+                mAudioInitialized = true;
+                }
+            else {
+                fprintf( stderr, "Error starting audio stream\n" );
+                Pa_CloseStream( mAudioStream );
+                }
+            }
+        else {
+            fprintf( stderr, "Error opening audio stream\n" );
+            Pa_Terminate();
+            }
+        }
+    else {
+        fprintf( stderr, "Error initializing audio framework\n" );
+        }
+
+
+    if( error != paNoError ) {
+        fprintf( stderr, "Error number: %d\n", error );
+        fprintf( stderr, "Error message: %s\n", Pa_GetErrorText( error ) );
+        mAudioInitialized = false;
+        }
+
+    return mAudioInitialized;
+    }
+
+
+
+void PortAudioSoundOutput::stop() {
+    if( !mAudioInitialized ) {
+        return;
+        }
+
+    PaError error = Pa_StopStream( mAudioStream );
+
+    if( error == paNoError ) {
+        error = Pa_CloseStream( mAudioStream );
+
+        if( error != paNoError ) {
+            fprintf( stderr, "Error closingaudio stream\n" );
+            }
+        }
+    else {
+        fprintf( stderr, "Error stopping audio stream\n" );
+        }
+
+    Pa_Terminate();
+
+    if( error != paNoError ) {
+        fprintf( stderr, "Error number: %d\n", error);
+        fprintf( stderr, "Error message: %s\n", Pa_GetErrorText( error) );
+        }
+
+    mAudioInitialized = false;
+    }
+
+
+
+double PortAudioSoundOutput::getCPULoad() {
+    if( !mAudioInitialized ) {
+        return 0;
+        }
+
+    return Pa_GetCPULoad( mAudioStream );
+    }
+
+
+
+void PortAudioSoundOutput::getTimingInfo( PaTimingInfo *outInfo ) {
+    if( !mAudioInitialized ) {
+        memset( outInfo, 0, sizeof( PaTimingInfo ) );
+        return;
+        }
+
+    Pa_GetStreamTimingInfo( mAudioStream, outInfo );
+    }
+
+
+
+void PortAudioSoundOutput::getThreadInfo( PaThreadInfo *outInfo ) {
+    if( !mAudioInitialized ) {
+        memset( outInfo, 0, sizeof( PaThreadInfo ) );
+        outInfo->cpu = -1;
+        return;
+        }
+
+    Pa_GetStreamThreadInfo( mAudioStream, outInfo );
+    }
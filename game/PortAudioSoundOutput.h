@@ -0,0 +1,100 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef PORT_AUDIO_SOUND_OUTPUT_INCLUDED
+#define PORT_AUDIO_SOUND_OUTPUT_INCLUDED
+
+
+
+#include "SoundOutput.h"
+#include "AudioLatencyProfile.h"
+
+#include "Transcend/portaudio/pa_common/portaudio.h"
+
+
+
+/**
+ * Sends sound to the default output device through a PortAudio stream,
+ * whose callback pulls samples from the player.
+ *
+ * @author Jason Rohrer
+ */
+class PortAudioSoundOutput : public SoundOutput {
+
+
+
+    public:
+
+        /**
+         * Constructs an output.  The device is not opened until start.
+         *
+         * @param inProfile the sample rate and buffering to open the
+         *   stream with.
+         */
+        PortAudioSoundOutput( AudioLatencyProfile inProfile );
+
+
+
+        virtual ~PortAudioSoundOutput();
+
+
+
+        // implements the SoundOutput interface
+        virtual char start( SoundPlayer *inPlayer );
+        virtual void stop();
+
+
+
+        /**
+         * Gets the fraction of the CPU used by the stream, as measured
+         * by PortAudio.
+         *
+         * @return the load in [0,1], or 0 if the stream is not running.
+         */
+        double getCPULoad();
+
+
+
+        /**
+         * Gets how regularly the stream's callback has been called since
+         * start, as measured by the PortAudio host.
+         *
+         * @param outInfo pointer to where the timing should be returned.
+         *   Its numCallbacks is 0 if the stream is not running or the
+         *   host does not measure callback timing.
+         */
+        void getTimingInfo( PaTimingInfo *outInfo );
+
+
+
+        /**
+         * Gets how the PortAudio host set up the thread that runs the
+         * stream's callback.
+         *
+         * @param outInfo pointer to where the setup should be returned.
+         *   Its isSetUp is 0 if the stream is not running, the thread has
+         *   not started yet, or the host does not set up its thread.
+         */
+        void getThreadInfo( PaThreadInfo *outInfo );
+
+
+
+    protected:
+
+        AudioLatencyProfile mProfile;
+
+        char mAudioInitialized;
+
+        PortAudioStream *mAudioStream;
+
+    };
+
+
+
+#endif
@@ -3,11 +3,16 @@
  *
  * 2004-October-13   Jason Rohrer
  * Created.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added interpolation between simulation steps when drawing.
+ * Added a rotated copy stride for drawing with reduced quality.
  */
 
 
 
 #include "PortalManager.h"
+#include "RenderInterpolation.h"
 
 
 
@@ -22,7 +27,8 @@ PortalManager::PortalManager( ParameterizedObject *inPortalTemplate,
       mGridWidth( inGridWidth ),
       mCurrentPosition( NULL ),
       mCurrentRadius( 0 ),
-      mCurrentRotation( new Angle3D( 0, 0, 0 ) ) {
+      mCurrentRotation( new Angle3D( 0, 0, 0 ) ),
+      mPreviousRotation( new Angle3D( 0, 0, 0 ) ) {
 
     }
   
@@ -35,6 +41,7 @@ PortalManager::~PortalManager() {
         delete mCurrentPosition;
         }
     delete mCurrentRotation;
+    delete mPreviousRotation;
     
     }
 
@@ -119,16 +126,28 @@ char PortalManager::isShipInPortal( Vector3D *inShipPosition ) {
     }
 
 
-SimpleVector<DrawableObject *> *PortalManager::getDrawableObjects() {
+void PortalManager::saveInterpolationState() {
+    delete mPreviousRotation;
+    mPreviousRotation = new Angle3D( mCurrentRotation );
+    }
+
+
+
+SimpleVector<DrawableObject *> *PortalManager::getDrawableObjects(
+    double inInterpolation, int inRotatedCopyStride ) {
 
     // if portal has been shown
     if( mCurrentPosition != NULL ) {
         
         SimpleVector<DrawableObject *> *objects =
             mPortalTemplate->getDrawableObjects(
-                mPortalShapeParameter, &mCurrentRotationRate ); 
+                mPortalShapeParameter, &mCurrentRotationRate,
+                inRotatedCopyStride );
 
         // scale, rotate, position, and fade the objects
+
+        Angle3D *rotation = RenderInterpolation::interpolateRotation(
+            mPreviousRotation, mCurrentRotation, inInterpolation );
     
         int numObjects = objects->size();
     
@@ -141,7 +160,7 @@ SimpleVector<DrawableObject *> *PortalManager::getDrawableObjects() {
                 *( objects->getElement( j ) );
 
             currentObject->scale( mPortalScale );
-            currentObject->rotate( mCurrentRotation );
+            currentObject->rotate( rotation );
             currentObject->move( mCurrentPosition );
             currentObject->fade( mFadeFactor );
 
@@ -155,6 +174,8 @@ SimpleVector<DrawableObject *> *PortalManager::getDrawableObjects() {
 
         mCurrentRadius = maxRadius;        
 
+        delete rotation;
+
         return objects;
         }
     else {
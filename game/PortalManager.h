@@ -3,6 +3,10 @@
  *
  * 2004-October-13   Jason Rohrer
  * Created.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added interpolation between simulation steps when drawing.
+ * Added a rotated copy stride for drawing with reduced quality.
  */
 
 
@@ -95,14 +99,33 @@ class PortalManager {
 
         
         
+        /**
+         * Saves the current portal rotation so that drawing can blend
+         * between it and the result of the next simulation step.
+         *
+         * Should be called before each step.
+         */
+        void saveInterpolationState();
+
+        
+        
         /**
          * Gets drawable objects for the portal in its current
          * positions/states.
          *
+         * @param inInterpolation how far to turn the portal between its
+         *   saved and current rotation, in [0,1].
+         *   Defaults to 1 (current rotation).
+         * @param inRotatedCopyStride how many rotated copies of each
+         *   shape to step over for each one drawn, for reducing quality.
+         *   Collision radii are not changed.  Defaults to 1.
+         *
          * @return portal as a collection of drawable objects.
          *   Vector and objects must be destroyed by caller.
          */
-        SimpleVector<DrawableObject *> *getDrawableObjects();
+        SimpleVector<DrawableObject *> *getDrawableObjects(
+            double inInterpolation = 1,
+            int inRotatedCopyStride = 1 );
 
 
         
@@ -132,6 +155,10 @@ class PortalManager {
         double mCurrentRotationRate;
         Angle3D *mCurrentRotation;
 
+        // rotation as of the last saveInterpolationState
+        // (the portal never moves once shown)
+        Angle3D *mPreviousRotation;
+
     };
 
 
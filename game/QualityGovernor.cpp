@@ -0,0 +1,244 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "QualityGovernor.h"
+
+
+#include <stdio.h>
+
+
+
+// frames per decision
+static const int windowLength = 30;
+
+// windows with headroom needed before raising a level
+static const int headroomWindowsToRaise = 4;
+
+// a window has headroom if it uses less than this fraction of its budget
+static const double headroomFraction = 0.6;
+
+// audio callbacks may use this fraction of their deadline on average
+static const double audioLoadBudget = 0.75;
+
+
+// settings at each visual level, from full quality down
+static const int numVisualLevels = 4;
+static const int gridStrides[ numVisualLevels ] = { 1, 2, 2, 4 };
+static const int rotatedCopyStrides[ numVisualLevels ] = { 1, 1, 2, 4 };
+
+// settings at each audio level, from full quality down
+static const int numAudioLevels = 3;
+static const int maxActiveFilters[ numAudioLevels ] = { -1, 1, 0 };
+static const int soundDivisors[ numAudioLevels ] = { 1, 1, 2 };
+
+
+
+QualityGovernor::QualityGovernor( double inFrameBudgetMicroseconds )
+    : mFrameBudget( inFrameBudgetMicroseconds ),
+      mVisualLevel( 0 ), mAudioLevel( 0 ),
+      mNumWindowFrames( 0 ), mWindowFrameTime( 0 ),
+      mNumWindowCallbacks( 0 ), mWindowCallbackLoad( 0 ),
+      mNumWindowDeadlineMisses( 0 ),
+      mNumVisualHeadroomWindows( 0 ), mNumAudioHeadroomWindows( 0 ),
+      mVisualLevelFrames( new unsigned long[ numVisualLevels ] ),
+      mAudioLevelFrames( new unsigned long[ numAudioLevels ] ),
+      mNumVisualChanges( 0 ), mNumAudioChanges( 0 ) {
+
+    int i;
+    for( i=0; i<numVisualLevels; i++ ) {
+        mVisualLevelFrames[i] = 0;
+        }
+    for( i=0; i<numAudioLevels; i++ ) {
+        mAudioLevelFrames[i] = 0;
+        }
+    }
+
+
+
+QualityGovernor::~QualityGovernor() {
+    delete [] mVisualLevelFrames;
+    delete [] mAudioLevelFrames;
+    }
+
+
+
+void QualityGovernor::addFrameTime( double inMicroseconds ) {
+    mWindowFrameTime += inMicroseconds;
+    mNumWindowFrames++;
+    }
+
+
+
+void QualityGovernor::addAudioCallback( AudioCallbackRecord *inRecord ) {
+    if( inRecord->mDeadlineMicroseconds > 0 ) {
+        mWindowCallbackLoad +=
+            inRecord->mWallMicroseconds / inRecord->mDeadlineMicroseconds;
+        mNumWindowCallbacks++;
+        }
+
+    if( inRecord->mDeadlineMissed ) {
+        mNumWindowDeadlineMisses++;
+        }
+    }
+
+
+
+char QualityGovernor::stepLevel( char *inName, int *inoutLevel,
+                                 int inNumLevels,
+                                 int *inoutNumHeadroomWindows,
+                                 char inOverBudget, char inHeadroom,
+                                 char *inReason ) {
+    int oldLevel = *inoutLevel;
+
+    if( inOverBudget ) {
+        *inoutNumHeadroomWindows = 0;
+
+        if( *inoutLevel < inNumLevels - 1 ) {
+            ( *inoutLevel )++;
+            }
+        }
+    else if( inHeadroom ) {
+        ( *inoutNumHeadroomWindows )++;
+
+        if( *inoutNumHeadroomWindows >= headroomWindowsToRaise &&
+            *inoutLevel > 0 ) {
+
+            ( *inoutLevel )--;
+            *inoutNumHeadroomWindows = 0;
+            }
+        }
+    else {
+        *inoutNumHeadroomWindows = 0;
+        }
+
+    if( *inoutLevel != oldLevel ) {
+        printf( "Quality governor:  %s level %d -> %d (%s)\n",
+                inName, oldLevel, *inoutLevel, inReason );
+        return true;
+        }
+
+    return false;
+    }
+
+
+
+char QualityGovernor::endFrame() {
+    mVisualLevelFrames[ mVisualLevel ]++;
+    mAudioLevelFrames[ mAudioLevel ]++;
+
+    if( mNumWindowFrames < windowLength ) {
+        return false;
+        }
+
+    char changed = false;
+    char reason[100];
+
+    double meanFrameTime = mWindowFrameTime / mNumWindowFrames;
+
+    sprintf( reason, "mean frame %.1f ms of %.1f ms budget",
+             meanFrameTime / 1000, mFrameBudget / 1000 );
+
+    if( stepLevel( "visual", &mVisualLevel, numVisualLevels,
+                   &mNumVisualHeadroomWindows,
+                   meanFrameTime > mFrameBudget,
+                   meanFrameTime < headroomFraction * mFrameBudget,
+                   reason ) ) {
+        mNumVisualChanges++;
+        changed = true;
+        }
+
+    // without callbacks, as when there is no audio device, leave the
+    // audio level alone
+    if( mNumWindowCallbacks > 0 ) {
+        double meanLoad = mWindowCallbackLoad / mNumWindowCallbacks;
+
+        sprintf( reason, "mean callback load %.0f%%, %d deadlines missed",
+                 100 * meanLoad, mNumWindowDeadlineMisses );
+
+        if( stepLevel( "audio", &mAudioLevel, numAudioLevels,
+                       &mNumAudioHeadroomWindows,
+                       mNumWindowDeadlineMisses > 0 ||
+                           meanLoad > audioLoadBudget,
+                       mNumWindowDeadlineMisses == 0 &&
+                           meanLoad < headroomFraction * audioLoadBudget,
+                       reason ) ) {
+            mNumAudioChanges++;
+            changed = true;
+            }
+        }
+
+    mNumWindowFrames = 0;
+    mWindowFrameTime = 0;
+    mNumWindowCallbacks = 0;
+    mWindowCallbackLoad = 0;
+    mNumWindowDeadlineMisses = 0;
+
+    return changed;
+    }
+
+
+
+int QualityGovernor::getVisualLevel() {
+    return mVisualLevel;
+    }
+
+
+
+int QualityGovernor::getAudioLevel() {
+    return mAudioLevel;
+    }
+
+
+
+int QualityGovernor::getRotatedCopyStride() {
+    return rotatedCopyStrides[ mVisualLevel ];
+    }
+
+
+
+int QualityGovernor::getGridStride() {
+    return gridStrides[ mVisualLevel ];
+    }
+
+
+
+int QualityGovernor::getMaxSimultaneousSounds( int inFullQualitySounds ) {
+    int numSounds = inFullQualitySounds / soundDivisors[ mAudioLevel ];
+
+    if( numSounds < 1 ) {
+        numSounds = 1;
+        }
+    return numSounds;
+    }
+
+
+
+int QualityGovernor::getMaxActiveFilters() {
+    return maxActiveFilters[ mAudioLevel ];
+    }
+
+
+
+void QualityGovernor::printSummary() {
+    printf( "Quality:  visual level %d (%lu changes), "
+            "audio level %d (%lu changes), frames at visual levels",
+            mVisualLevel, mNumVisualChanges,
+            mAudioLevel, mNumAudioChanges );
+
+    int i;
+    for( i=0; i<numVisualLevels; i++ ) {
+        printf( " %lu", mVisualLevelFrames[i] );
+        }
+
+    printf( ", at audio levels" );
+    for( i=0; i<numAudioLevels; i++ ) {
+        printf( " %lu", mAudioLevelFrames[i] );
+        }
+    printf( "\n" );
+    }
@@ -0,0 +1,209 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef QUALITY_GOVERNOR_INCLUDED
+#define QUALITY_GOVERNOR_INCLUDED
+
+
+
+#include "AudioTelemetry.h"
+
+
+
+/**
+ * Watches frame times and audio callback times, and lowers or raises
+ * a visual and an audio quality level to keep them within budget.
+ *
+ * Frame times drive the visual level, which thins out rotated copies and
+ * grid lines.  Audio callback times drive the audio level, which limits
+ * simultaneous sounds and reverb filters.  Level 0 is full quality.
+ *
+ * Each level is changed by at most one step per window of frames.  A
+ * level is lowered after one window over budget, but only raised after
+ * several windows with plenty of headroom, so that it does not flip back
+ * and forth.
+ *
+ * Not thread-safe:  all functions should be called from the main thread.
+ *
+ * @author Jason Rohrer.
+ */
+class QualityGovernor {
+
+
+    public:
+
+
+
+        /**
+         * Constructs a governor at full quality.
+         *
+         * @param inFrameBudgetMicroseconds the time each frame should
+         *   take, not counting time spent waiting for the display.
+         */
+        QualityGovernor( double inFrameBudgetMicroseconds );
+
+
+
+        ~QualityGovernor();
+
+
+
+        /**
+         * Adds the time taken by one frame.
+         *
+         * @param inMicroseconds the time taken.
+         */
+        void addFrameTime( double inMicroseconds );
+
+
+
+        /**
+         * Adds the measurements of one audio callback.
+         *
+         * @param inRecord the measurements.
+         *   Must be destroyed by caller.
+         */
+        void addAudioCallback( AudioCallbackRecord *inRecord );
+
+
+
+        /**
+         * Ends a frame, changing the quality levels if a window of frames
+         * has finished.  Changes are printed to standard out.
+         *
+         * @return true if either level changed.
+         */
+        char endFrame();
+
+
+
+        /**
+         * Gets the current visual quality level.
+         *
+         * @return the level, 0 for full quality.
+         */
+        int getVisualLevel();
+
+
+
+        /**
+         * Gets the current audio quality level.
+         *
+         * @return the level, 0 for full quality.
+         */
+        int getAudioLevel();
+
+
+
+        /**
+         * Gets the stride for ObjectParameterSpaceControlPoint's rotated
+         * copies at the current visual level.
+         *
+         * @return 1 to draw every copy, 2 for every other copy, etc.
+         */
+        int getRotatedCopyStride();
+
+
+
+        /**
+         * Gets how many grid spacings apart grid lines should be drawn
+         * at the current visual level.
+         *
+         * @return 1 to draw every line, 2 for every other line, etc.
+         */
+        int getGridStride();
+
+
+
+        /**
+         * Gets the number of simultaneous sounds at the current audio
+         * level.
+         *
+         * @param inFullQualitySounds the number at full quality.
+         *
+         * @return the number of sounds.
+         */
+        int getMaxSimultaneousSounds( int inFullQualitySounds );
+
+
+
+        /**
+         * Gets the number of sound filters to apply at the current audio
+         * level.
+         *
+         * @return the number of filters, or -1 for all of them.
+         */
+        int getMaxActiveFilters();
+
+
+
+        /**
+         * Prints the current levels and the time spent at each level
+         * to standard out.
+         */
+        void printSummary();
+
+
+
+    protected:
+
+        double mFrameBudget;
+
+        int mVisualLevel;
+        int mAudioLevel;
+
+        // for the current window
+        int mNumWindowFrames;
+        double mWindowFrameTime;
+
+        int mNumWindowCallbacks;
+        double mWindowCallbackLoad;
+        int mNumWindowDeadlineMisses;
+
+        // windows in a row with headroom at the current level
+        int mNumVisualHeadroomWindows;
+        int mNumAudioHeadroomWindows;
+
+        // frames spent at each level
+        unsigned long *mVisualLevelFrames;
+        unsigned long *mAudioLevelFrames;
+
+        unsigned long mNumVisualChanges;
+        unsigned long mNumAudioChanges;
+
+
+
+        /**
+         * Moves a level one step, given how loaded the last window was.
+         *
+         * @param inName the name of the level, for printing.
+         *   Must be destroyed by caller.
+         * @param inoutLevel pointer to the level.
+         * @param inNumLevels the number of levels.
+         * @param inoutNumHeadroomWindows pointer to the count of windows
+         *   in a row with headroom.
+         * @param inOverBudget true if the window was over budget.
+         * @param inHeadroom true if the window had room to raise quality.
+         * @param inReason a description of the window's load, for
+         *   printing.
+         *   Must be destroyed by caller.
+         *
+         * @return true if the level changed.
+         */
+        static char stepLevel( char *inName, int *inoutLevel,
+                               int inNumLevels,
+                               int *inoutNumHeadroomWindows,
+                               char inOverBudget, char inHeadroom,
+                               char *inReason );
+
+    };
+
+
+
+#endif
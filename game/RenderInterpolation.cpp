@@ -0,0 +1,59 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "RenderInterpolation.h"
+
+
+#include <math.h>
+
+
+
+Vector3D *RenderInterpolation::interpolatePosition( Vector3D *inPrevious,
+                                                    Vector3D *inCurrent,
+                                                    double inInterpolation ) {
+    if( inInterpolation >= 1 ) {
+        return new Vector3D( inCurrent );
+        }
+
+    return Vector3D::linearSum( inCurrent, inPrevious, inInterpolation );
+    }
+
+
+
+Angle3D *RenderInterpolation::interpolateRotation( Angle3D *inPrevious,
+                                                   Angle3D *inCurrent,
+                                                   double inInterpolation ) {
+    if( inInterpolation >= 1 ) {
+        return new Angle3D( inCurrent );
+        }
+
+    return new Angle3D(
+        interpolateAngle( inPrevious->mX, inCurrent->mX, inInterpolation ),
+        interpolateAngle( inPrevious->mY, inCurrent->mY, inInterpolation ),
+        interpolateAngle( inPrevious->mZ, inCurrent->mZ, inInterpolation ) );
+    }
+
+
+
+double RenderInterpolation::interpolateAngle( double inPrevious,
+                                              double inCurrent,
+                                              double inInterpolation ) {
+    double change = inCurrent - inPrevious;
+
+    // rotations are not kept in [0, 2pi], so a step can cross the wrap
+    // point
+    while( change > M_PI ) {
+        change -= 2 * M_PI;
+        }
+    while( change < -M_PI ) {
+        change += 2 * M_PI;
+        }
+
+    return inPrevious + inInterpolation * change;
+    }
@@ -0,0 +1,94 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef RENDER_INTERPOLATION_INCLUDED
+#define RENDER_INTERPOLATION_INCLUDED
+
+
+
+#include "minorGems/math/geometry/Vector3D.h"
+#include "minorGems/math/geometry/Angle3D.h"
+
+
+
+/**
+ * A class with static functions for blending between the state saved
+ * before the last simulation step and the current state, so that objects
+ * can be drawn at times that fall between steps.
+ *
+ * @author Jason Rohrer.
+ */
+class RenderInterpolation {
+
+
+    public:
+
+
+
+        /**
+         * Blends two positions.
+         *
+         * @param inPrevious the position before the last step.
+         *   Must be destroyed by caller.
+         * @param inCurrent the current position.
+         *   Must be destroyed by caller.
+         * @param inInterpolation how far to go from inPrevious towards
+         *   inCurrent, in [0,1].
+         *
+         * @return the blended position.
+         *   Must be destroyed by caller.
+         */
+        static Vector3D *interpolatePosition( Vector3D *inPrevious,
+                                              Vector3D *inCurrent,
+                                              double inInterpolation );
+
+
+
+        /**
+         * Blends two rotations, turning each component the short way
+         * around the circle.
+         *
+         * @param inPrevious the rotation before the last step.
+         *   Must be destroyed by caller.
+         * @param inCurrent the current rotation.
+         *   Must be destroyed by caller.
+         * @param inInterpolation how far to go from inPrevious towards
+         *   inCurrent, in [0,1].
+         *
+         * @return the blended rotation.
+         *   Must be destroyed by caller.
+         */
+        static Angle3D *interpolateRotation( Angle3D *inPrevious,
+                                             Angle3D *inCurrent,
+                                             double inInterpolation );
+
+
+
+    protected:
+
+
+
+        /**
+         * Blends two angles the short way around the circle.
+         *
+         * @param inPrevious the angle before the last step, in radians.
+         * @param inCurrent the current angle, in radians.
+         * @param inInterpolation how far to go from inPrevious towards
+         *   inCurrent, in [0,1].
+         *
+         * @return the blended angle.
+         */
+        static double interpolateAngle( double inPrevious, double inCurrent,
+                                        double inInterpolation );
+
+    };
+
+
+
+#endif
@@ -0,0 +1,312 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "ReplayLog.h"
+
+
+#include <string.h>
+
+
+
+/*
+ * Log format:
+ *
+ * Header:  the magic bytes "TRR2", then the starting level, the random
+ * seed, and the simulation steps per second as 4-byte little-endian
+ * integers.
+ *
+ * Then, for each frame:  the time delta in milliseconds and the number of
+ * events, followed by each event as a flag byte (bit 0 set for a press,
+ * bit 1 set for a special key) and a key number.
+ *
+ * Deltas, counts, and key numbers are variable-length:  7 bits per byte,
+ * low bits first, with the high bit set on all but the last byte.  Most
+ * frames thus take 2 bytes.
+ */
+
+
+
+// bumped from TRR1 when the simulation rate was added to the header
+static const char *replayMagic = "TRR2";
+static const int replayMagicLength = 4;
+
+
+
+/**
+ * Writes a 4-byte little-endian integer.
+ */
+static void writeFixedNumber( FILE *inFILE, unsigned long inValue ) {
+    for( int b=0; b<4; b++ ) {
+        fputc( ( inValue >> ( 8 * b ) ) & 0xFF, inFILE );
+        }
+    }
+
+
+
+/**
+ * Writes a variable-length integer.
+ */
+static void writeNumber( FILE *inFILE, unsigned long inValue ) {
+    while( inValue >= 0x80 ) {
+        fputc( ( inValue & 0x7F ) | 0x80, inFILE );
+        inValue = inValue >> 7;
+        }
+    fputc( inValue, inFILE );
+    }
+
+
+
+ReplayRecorder::ReplayRecorder( char *inFileName, int inStartingLevel,
+                                unsigned long inRandomSeed,
+                                unsigned long inSimulationRate )
+    : mFILE( fopen( inFileName, "wb" ) ),
+      mNumFrames( 0 ),
+      mFrameEvents( new SimpleVector<ReplayInputEvent *>() ) {
+
+    if( mFILE == NULL ) {
+        printf( "Failed to open replay log %s for writing\n", inFileName );
+        return;
+        }
+
+    fwrite( replayMagic, 1, replayMagicLength, mFILE );
+    writeFixedNumber( mFILE, inStartingLevel );
+    writeFixedNumber( mFILE, inRandomSeed );
+    writeFixedNumber( mFILE, inSimulationRate );
+    }
+
+
+
+ReplayRecorder::~ReplayRecorder() {
+    if( mFILE != NULL ) {
+        // events after the last frame are dropped, since they never
+        // affected the game
+        fclose( mFILE );
+        }
+
+    int numEvents = mFrameEvents->size();
+    for( int i=0; i<numEvents; i++ ) {
+        delete *( mFrameEvents->getElement( i ) );
+        }
+    delete mFrameEvents;
+    }
+
+
+
+void ReplayRecorder::addEvent( ReplayInputEvent *inEvent ) {
+    mFrameEvents->push_back( new ReplayInputEvent( inEvent->mPress,
+                                                   inEvent->mSpecial,
+                                                   inEvent->mKey ) );
+    }
+
+
+
+void ReplayRecorder::finishFrame( unsigned long inFrameMilliseconds ) {
+    int numEvents = mFrameEvents->size();
+
+    if( mFILE != NULL ) {
+        writeNumber( mFILE, inFrameMilliseconds );
+        writeNumber( mFILE, numEvents );
+
+        for( int i=0; i<numEvents; i++ ) {
+            ReplayInputEvent *event = *( mFrameEvents->getElement( i ) );
+
+            unsigned char flags = 0;
+            if( event->mPress ) {
+                flags |= 0x01;
+                }
+            if( event->mSpecial ) {
+                flags |= 0x02;
+                }
+
+            fputc( flags, mFILE );
+            writeNumber( mFILE, event->mKey );
+            }
+        }
+
+    for( int i=0; i<numEvents; i++ ) {
+        delete *( mFrameEvents->getElement( i ) );
+        }
+    mFrameEvents->deleteAll();
+
+    mNumFrames++;
+    }
+
+
+
+unsigned long ReplayRecorder::getNumFrames() {
+    return mNumFrames;
+    }
+
+
+
+ReplayPlayer::ReplayPlayer( char *inFileName )
+    : mData( NULL ), mLength( 0 ), mPosition( 0 ),
+      mValid( false ), mStartingLevel( 1 ), mRandomSeed( 0 ),
+      mSimulationRate( 60 ),
+      mFrameEvents( new SimpleVector<ReplayInputEvent *>() ) {
+
+    FILE *file = fopen( inFileName, "rb" );
+
+    if( file == NULL ) {
+        printf( "Failed to open replay log %s\n", inFileName );
+        return;
+        }
+
+    fseek( file, 0, SEEK_END );
+    long length = ftell( file );
+    fseek( file, 0, SEEK_SET );
+
+    if( length < replayMagicLength + 12 ) {
+        printf( "Replay log %s is too short\n", inFileName );
+        fclose( file );
+        return;
+        }
+
+    mLength = length;
+    mData = new unsigned char[ mLength ];
+
+    unsigned long numRead = fread( mData, 1, mLength, file );
+    fclose( file );
+
+    if( numRead != mLength ||
+        memcmp( mData, replayMagic, replayMagicLength ) != 0 ) {
+
+        printf( "Replay log %s is not valid\n", inFileName );
+        return;
+        }
+
+    mPosition = replayMagicLength;
+
+    unsigned long header[3] = { 0, 0, 0 };
+    for( int h=0; h<3; h++ ) {
+        for( int b=0; b<4; b++ ) {
+            header[h] |= (unsigned long)( mData[ mPosition ] ) << ( 8 * b );
+            mPosition++;
+            }
+        }
+
+    mStartingLevel = (int)header[0];
+    mRandomSeed = header[1];
+    mSimulationRate = header[2];
+
+    mValid = true;
+    }
+
+
+
+ReplayPlayer::~ReplayPlayer() {
+    if( mData != NULL ) {
+        delete [] mData;
+        }
+
+    clearFrameEvents();
+    delete mFrameEvents;
+    }
+
+
+
+char ReplayPlayer::isValid() {
+    return mValid;
+    }
+
+
+
+int ReplayPlayer::getStartingLevel() {
+    return mStartingLevel;
+    }
+
+
+
+unsigned long ReplayPlayer::getRandomSeed() {
+    return mRandomSeed;
+    }
+
+
+
+unsigned long ReplayPlayer::getSimulationRate() {
+    return mSimulationRate;
+    }
+
+
+
+char ReplayPlayer::readNumber( unsigned long *outValue ) {
+    unsigned long value = 0;
+    int shift = 0;
+
+    while( mPosition < mLength ) {
+        unsigned char byte = mData[ mPosition ];
+        mPosition++;
+
+        value |= (unsigned long)( byte & 0x7F ) << shift;
+        shift += 7;
+
+        if( ( byte & 0x80 ) == 0 ) {
+            *outValue = value;
+            return true;
+            }
+        }
+
+    return false;
+    }
+
+
+
+void ReplayPlayer::clearFrameEvents() {
+    int numEvents = mFrameEvents->size();
+    for( int i=0; i<numEvents; i++ ) {
+        delete *( mFrameEvents->getElement( i ) );
+        }
+    mFrameEvents->deleteAll();
+    }
+
+
+
+char ReplayPlayer::readFrame( unsigned long *outFrameMilliseconds ) {
+    clearFrameEvents();
+
+    if( !mValid ) {
+        return false;
+        }
+
+    unsigned long numEvents;
+
+    if( ! readNumber( outFrameMilliseconds ) ||
+        ! readNumber( &numEvents ) ) {
+        return false;
+        }
+
+    for( unsigned long i=0; i<numEvents; i++ ) {
+        if( mPosition >= mLength ) {
+            printf( "Replay log ends in the middle of a frame\n" );
+            return false;
+            }
+
+        unsigned char flags = mData[ mPosition ];
+        mPosition++;
+
+        unsigned long key;
+        if( ! readNumber( &key ) ) {
+            printf( "Replay log ends in the middle of a frame\n" );
+            return false;
+            }
+
+        mFrameEvents->push_back(
+            new ReplayInputEvent( ( flags & 0x01 ) != 0,
+                                  ( flags & 0x02 ) != 0,
+                                  (int)key ) );
+        }
+
+    return true;
+    }
+
+
+
+SimpleVector<ReplayInputEvent *> *ReplayPlayer::getFrameEvents() {
+    return mFrameEvents;
+    }
@@ -0,0 +1,247 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef REPLAY_LOG_INCLUDED
+#define REPLAY_LOG_INCLUDED
+
+
+
+#include "minorGems/util/SimpleVector.h"
+
+
+#include <stdio.h>
+
+
+
+/**
+ * One keyboard event, as passed to a KeyboardHandlerGL.
+ *
+ * @author Jason Rohrer.
+ */
+class ReplayInputEvent {
+
+    public:
+
+        ReplayInputEvent( char inPress, char inSpecial, int inKey )
+            : mPress( inPress ), mSpecial( inSpecial ), mKey( inKey ) {
+            }
+
+        // true for a key press, false for a release
+        char mPress;
+
+        // true for GLUT special keys (like the arrows)
+        char mSpecial;
+
+        int mKey;
+    };
+
+
+
+/**
+ * Records the input events and time deltas of each frame of a game
+ * to a compact binary log.
+ *
+ * Together with the starting level, random seed, and simulation rate,
+ * which are stored in the log header, these determine everything that
+ * happens in the game.
+ *
+ * @author Jason Rohrer.
+ */
+class ReplayRecorder {
+
+
+    public:
+
+
+
+        /**
+         * Constructs a recorder, opening its log file.
+         *
+         * @param inFileName the name of the log file.
+         *   Must be destroyed by caller.
+         * @param inStartingLevel the level the game starts on.
+         * @param inRandomSeed the seed of the game's random source.
+         * @param inSimulationRate the game's simulation steps per second.
+         */
+        ReplayRecorder( char *inFileName, int inStartingLevel,
+                        unsigned long inRandomSeed,
+                        unsigned long inSimulationRate );
+
+
+
+        /**
+         * Closes the log file.
+         */
+        ~ReplayRecorder();
+
+
+
+        /**
+         * Records an input event for the current frame.
+         *
+         * @param inEvent the event.
+         *   Must be destroyed by caller.
+         */
+        void addEvent( ReplayInputEvent *inEvent );
+
+
+
+        /**
+         * Finishes the current frame, writing it and its events to the log.
+         *
+         * @param inFrameMilliseconds the time delta of the frame.
+         */
+        void finishFrame( unsigned long inFrameMilliseconds );
+
+
+
+        /**
+         * Gets the number of frames recorded so far.
+         *
+         * @return the number of frames.
+         */
+        unsigned long getNumFrames();
+
+
+
+    protected:
+
+        // NULL if log could not be opened
+        FILE *mFILE;
+
+        unsigned long mNumFrames;
+
+        SimpleVector<ReplayInputEvent *> *mFrameEvents;
+
+    };
+
+
+
+/**
+ * Plays back a log written by ReplayRecorder.
+ *
+ * @author Jason Rohrer.
+ */
+class ReplayPlayer {
+
+
+    public:
+
+
+
+        /**
+         * Constructs a player, reading its entire log into memory.
+         *
+         * @param inFileName the name of the log file.
+         *   Must be destroyed by caller.
+         */
+        ReplayPlayer( char *inFileName );
+
+
+
+        ~ReplayPlayer();
+
+
+
+        /**
+         * Gets whether the log was read successfully.
+         *
+         * @return true if the log is valid.
+         */
+        char isValid();
+
+
+
+        /**
+         * Gets the level the recorded game started on.
+         *
+         * @return the level number.
+         */
+        int getStartingLevel();
+
+
+
+        /**
+         * Gets the seed of the recorded game's random source.
+         *
+         * @return the seed.
+         */
+        unsigned long getRandomSeed();
+
+
+
+        /**
+         * Gets the simulation steps per second of the recorded game.
+         *
+         * @return the step rate.
+         */
+        unsigned long getSimulationRate();
+
+
+
+        /**
+         * Reads the next frame of the log.
+         *
+         * @param outFrameMilliseconds pointer to where the time delta of
+         *   the frame should be returned.
+         *
+         * @return true if a frame was read, or false if the end of the log
+         *   was reached.
+         */
+        char readFrame( unsigned long *outFrameMilliseconds );
+
+
+
+        /**
+         * Gets the input events of the frame last read.
+         *
+         * @return the events, in the order they were recorded.
+         *   Must not be modified or destroyed by caller.
+         *   Valid only until the next call to readFrame.
+         */
+        SimpleVector<ReplayInputEvent *> *getFrameEvents();
+
+
+
+    protected:
+
+        unsigned char *mData;
+        unsigned long mLength;
+        unsigned long mPosition;
+
+        char mValid;
+        int mStartingLevel;
+        unsigned long mRandomSeed;
+        unsigned long mSimulationRate;
+
+        SimpleVector<ReplayInputEvent *> *mFrameEvents;
+
+
+
+        /**
+         * Reads a variable-length number from the log.
+         *
+         * @param outValue pointer to where the value should be returned.
+         *
+         * @return true on success, or false if the log ended.
+         */
+        char readNumber( unsigned long *outValue );
+
+
+
+        /**
+         * Destroys the events in mFrameEvents.
+         */
+        void clearFrameEvents();
+
+    };
+
+
+
+#endif
@@ -3,6 +3,10 @@
  *
  * 2004-July-22   Jason Rohrer
  * Created.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added filtering in place.
+ * Added a reset function.
  */
 
 
@@ -30,28 +34,44 @@ ReverbSoundFilter::~ReverbSoundFilter() {
 
 SoundSamples *ReverbSoundFilter::filterSamples( SoundSamples *inSamples ) {
 
-    unsigned long delaySize = mDelayBuffer->mSampleCount;
-
-    unsigned long numSamples = inSamples->mSampleCount;
-
     // pass the input through to the output
     SoundSamples *outputSamples = new SoundSamples( inSamples );
 
+    filterSamplesInPlace( StereoSampleView( outputSamples ) );
+    
+    return outputSamples;    
+    }
+
+
+
+void ReverbSoundFilter::filterSamplesInPlace(
+    StereoSampleView inOutSamples ) {
+
+    unsigned long delaySize = mDelayBuffer->mSampleCount;
+
+    unsigned long numSamples = inOutSamples.mSampleCount;
+    unsigned long stride = inOutSamples.mStride;
+
+    float *leftChannel = inOutSamples.mLeftChannel;
+    float *rightChannel = inOutSamples.mRightChannel;
+    
+    float *delayLeftChannel = mDelayBuffer->mLeftChannel;
+    float *delayRightChannel = mDelayBuffer->mRightChannel;
+    
 
     for( unsigned long i=0; i<numSamples; i++ ) {
 
+        unsigned long index = i * stride;
         
         // add in reverb from the buffer to our output
-        outputSamples->mLeftChannel[i] +=
-            mDelayBuffer->mLeftChannel[ mDelayBufferPosition ];
-        outputSamples->mRightChannel[i] +=
-            mDelayBuffer->mRightChannel[ mDelayBufferPosition ]; 
+        leftChannel[ index ] += delayLeftChannel[ mDelayBufferPosition ];
+        rightChannel[ index ] += delayRightChannel[ mDelayBufferPosition ];
 
         // save our gained output in the delay buffer
-        mDelayBuffer->mLeftChannel[ mDelayBufferPosition ] =
-            mGain * outputSamples->mLeftChannel[i];
-        mDelayBuffer->mRightChannel[ mDelayBufferPosition ] =
-            mGain * outputSamples->mRightChannel[i];
+        delayLeftChannel[ mDelayBufferPosition ] =
+            mGain * leftChannel[ index ];
+        delayRightChannel[ mDelayBufferPosition ] =
+            mGain * rightChannel[ index ];
         
         // step through delay buffer, wrapping around at end
         mDelayBufferPosition++;
@@ -59,6 +79,17 @@ SoundSamples *ReverbSoundFilter::filterSamples( SoundSamples *inSamples ) {
             mDelayBufferPosition = 0;
             }
         }
+    }
 
-    return outputSamples;    
+
+
+void ReverbSoundFilter::reset() {
+    unsigned long delaySize = mDelayBuffer->mSampleCount;
+
+    for( unsigned long i=0; i<delaySize; i++ ) {
+        mDelayBuffer->mLeftChannel[i] = 0;
+        mDelayBuffer->mRightChannel[i] = 0;
+        }
+
+    mDelayBufferPosition = 0;
     }
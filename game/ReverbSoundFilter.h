@@ -3,6 +3,10 @@
  *
  * 2004-July-22   Jason Rohrer
  * Created.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added filtering in place.
+ * Added a reset function.
  */
 
 
@@ -45,6 +49,8 @@ class ReverbSoundFilter : public SoundFilter {
         
         // implements the SoundFilter interface
         virtual SoundSamples *filterSamples( SoundSamples *inSamples );
+        virtual void filterSamplesInPlace( StereoSampleView inOutSamples );
+        virtual void reset();
 
         
 
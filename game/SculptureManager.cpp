@@ -28,15 +28,103 @@
  * 2005-August-22   Jason Rohrer
  * Changed so that isPieceJarred returns true only if jar force is increasing.
  * Added magnet mode to smooth piece pick-up and drop.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added pre-computed animation keyframes for each piece.
+ * Added interpolation between simulation steps when drawing.
+ * Boss bullets are now read from a snapshot so they can be updated at the
+ * same time.
+ * Added skipping of pieces that are off screen when drawing.
+ * Added a rotated copy stride for drawing with reduced quality.
+ * Animation points now give their vertices to drawn objects uncopied.
  */
 
 
 
 #include "SculptureManager.h"
+#include "RenderInterpolation.h"
+#include "LevelLoadTaskGraph.h"
+
 
+#include "minorGems/system/Time.h"
+#include "minorGems/util/stringUtils.h"
 
 
 #include <float.h>
+#include <math.h>
+
+
+
+/**
+ * Task that computes the animation keyframes for one sculpture piece.
+ */
+class SculpturePieceBakeTask : public LevelLoadTask {
+
+    public:
+
+        /**
+         * Constructs a task.
+         *
+         * @param inName the name of the task.
+         *   Must be destroyed by caller.
+         * @param inFirstTemplate, inSecondTemplate the animation
+         *   templates.
+         *   Must be destroyed by caller after this task has run.
+         * @param inParameter the shape parameter of the piece.
+         * @param inNumKeyframes the number of keyframes to compute.
+         * @param outKeyframes the array to fill with keyframes.
+         *   Array must have room for inNumKeyframes points.
+         *   Array and points must be destroyed by caller.
+         */
+        SculpturePieceBakeTask( char *inName,
+                                ParameterizedObject *inFirstTemplate,
+                                ParameterizedObject *inSecondTemplate,
+                                double inParameter,
+                                int inNumKeyframes,
+                                ObjectParameterSpaceControlPoint
+                                **outKeyframes )
+            : LevelLoadTask( inName ),
+              mFirstTemplate( inFirstTemplate ),
+              mSecondTemplate( inSecondTemplate ),
+              mParameter( inParameter ),
+              mNumKeyframes( inNumKeyframes ),
+              mKeyframes( outKeyframes ) {
+            }
+
+        // implements the LevelLoadTask interface
+        virtual void doWork();
+
+    protected:
+        ParameterizedObject *mFirstTemplate;
+        ParameterizedObject *mSecondTemplate;
+        double mParameter;
+        int mNumKeyframes;
+        ObjectParameterSpaceControlPoint **mKeyframes;
+    };
+
+
+
+void SculpturePieceBakeTask::doWork() {
+    ObjectParameterSpaceControlPoint *firstControlPoint =
+        mFirstTemplate->getBlendedControlPoint( mParameter );
+    
+    ObjectParameterSpaceControlPoint *secondControlPoint =
+        mSecondTemplate->getBlendedControlPoint( mParameter );
+
+    for( int k=0; k<mNumKeyframes; k++ ) {
+        double animPosition = (double)k / (double)( mNumKeyframes - 1 );
+
+        // createLinearBlend copies the pure points at the ends
+        mKeyframes[k] =
+            (ObjectParameterSpaceControlPoint *)(
+                firstControlPoint->createLinearBlend(
+                    secondControlPoint,
+                    animPosition ) );
+        }
+
+    delete firstControlPoint;
+    delete secondControlPoint;
+    }
 
 
 
@@ -46,6 +134,7 @@ SculptureManager::SculptureManager(
     double inSculptureScale,
     double inMaxDistanceToBeInSculpture,
     double inAnimationLoopTime,
+    int inNumAnimationKeyframes,
     int inNumSculpturePieces,
     double *inPieceShapeParameters,
     Vector3D **inPieceStartingPositions,
@@ -67,6 +156,8 @@ SculptureManager::SculptureManager(
       mAnimationLoopTime( inAnimationLoopTime ),
       mCurrentAnimationPosition( 0 ),
       mCurrentAnimationDirection( 1 ),
+      mNumAnimationKeyframes( inNumAnimationKeyframes ),
+      mPieceAnimationKeyframes( NULL ),
       mNumSculpturePieces( inNumSculpturePieces ),
       mSculpturePieceParameters( inPieceShapeParameters ),
       mCurrentPiecePositions( inPieceStartingPositions ),
@@ -85,11 +176,18 @@ SculptureManager::SculptureManager(
     mPieceMagnetModes = new char[ mNumSculpturePieces ];
     mCurrentPieceTargetPositions = new Vector3D*[ mNumSculpturePieces ];
     mCurrentTowardTargetVelocities = new double[ mNumSculpturePieces ];
+
+    mPreviousPiecePositions = new Vector3D*[ mNumSculpturePieces ];
+    mPreviousPieceRotations = new Angle3D*[ mNumSculpturePieces ];
     
     mCurrentPieceRotationRates = new double[ mNumSculpturePieces ];
     mCurrentPieceRadii = new double[ mNumSculpturePieces ];
     mCurrentJarForces = new double[ mNumSculpturePieces ];
     mJarForcesIncreasing = new char[ mNumSculpturePieces ];
+
+    mViewBounds = NULL;
+    mNumCulled = 0;
+    mNumDrawn = 0;
     
     mNumPiecesInSculpture = 0;
     mInSculptureFlags = new char[ mNumSculpturePieces ];
@@ -103,6 +201,11 @@ SculptureManager::SculptureManager(
         mCurrentPieceTargetPositions[i] =
             new Vector3D( mCurrentPiecePositions[i] );
         mCurrentTowardTargetVelocities[i] = 0;
+
+        mPreviousPiecePositions[i] =
+            new Vector3D( mCurrentPiecePositions[i] );
+        mPreviousPieceRotations[i] =
+            new Angle3D( mCurrentPieceRotations[i] );
         
         mCurrentPieceRotationRates[i] = 0;
         mCurrentPieceRadii[i] = 0;
@@ -155,6 +258,15 @@ SculptureManager::SculptureManager(
             *outError = true;
             }
         }
+
+
+    if( mNumAnimationKeyframes > 0 ) {
+        if( mNumAnimationKeyframes < 2 ) {
+            // need at least both ends of the animation
+            mNumAnimationKeyframes = 2;
+            }
+        bakeAnimationKeyframes();
+        }
     }
 
 
@@ -162,11 +274,25 @@ SculptureManager::SculptureManager(
 SculptureManager::~SculptureManager() {
     delete mFirstSculpturePieceTemplate;
     delete mSecondSculpturePieceTemplate;
+
+    int i;
     
-    for( int i=0; i<mNumSculpturePieces; i++ ) {
+    if( mPieceAnimationKeyframes != NULL ) {
+        for( i=0; i<mNumSculpturePieces; i++ ) {
+            for( int k=0; k<mNumAnimationKeyframes; k++ ) {
+                delete mPieceAnimationKeyframes[i][k];
+                }
+            delete [] mPieceAnimationKeyframes[i];
+            }
+        delete [] mPieceAnimationKeyframes;
+        }
+    
+    for( i=0; i<mNumSculpturePieces; i++ ) {
         delete mCurrentPiecePositions[i];
         delete mCurrentPieceTargetPositions[i];
         delete mCurrentPieceRotations[i];
+        delete mPreviousPiecePositions[i];
+        delete mPreviousPieceRotations[i];
         delete mPieceMusicParts[i];
         }
 
@@ -178,6 +304,8 @@ SculptureManager::~SculptureManager() {
     delete [] mCurrentTowardTargetVelocities;
     
     delete [] mCurrentPieceRotations;
+    delete [] mPreviousPiecePositions;
+    delete [] mPreviousPieceRotations;
     delete [] mPieceMusicParts;
     delete [] mCurrentPieceRotationRates;
     delete [] mCurrentPieceRadii;
@@ -356,8 +484,10 @@ void SculptureManager::passTime( double inTimeDeltaInSeconds ) {
             mEnemyBulletManager->getBulletPowerInCircle(
                 mCurrentPiecePositions[i],
                 mCurrentPieceRadii[i] );
+        // boss bullets may be moving on another thread right now, so
+        // check them as they were at the start of this step
         double bossBulletPower = 
-            mBossBulletManager->getBulletPowerInCircle(
+            mBossBulletManager->getSnapshotBulletPowerInCircle(
                 mCurrentPiecePositions[i],
                 mCurrentPieceRadii[i] );
 
@@ -756,6 +886,20 @@ Vector3D *SculptureManager::getPiecePositionNeededToRecenter() {
 
 
 
+void SculptureManager::saveInterpolationState() {
+    for( int i=0; i<mNumSculpturePieces; i++ ) {
+        delete mPreviousPiecePositions[i];
+        mPreviousPiecePositions[i] =
+            new Vector3D( mCurrentPiecePositions[i] );
+
+        delete mPreviousPieceRotations[i];
+        mPreviousPieceRotations[i] =
+            new Angle3D( mCurrentPieceRotations[i] );
+        }
+    }
+
+
+
 void SculptureManager::turnMagnetModeOn( int inPieceHandle ) {
     mPieceMagnetModes[ inPieceHandle ] = true;
     }
@@ -784,10 +928,15 @@ void SculptureManager::setPiecePosition( int inPieceHandle,
 
 
 
-SimpleVector<DrawableObject *> *SculptureManager::getDrawableObjects() {
+SimpleVector<DrawableObject *> *SculptureManager::getDrawableObjects(
+    double inInterpolation, int inRotatedCopyStride ) {
+
     SimpleVector<DrawableObject *> *returnVector =
         new SimpleVector<DrawableObject *>();
 
+    mNumCulled = 0;
+    mNumDrawn = 0;
+    
     for( int i=0; i<mNumSculpturePieces; i++ ) {
         double pieceRotationRate;
 
@@ -806,49 +955,42 @@ SimpleVector<DrawableObject *> *SculptureManager::getDrawableObjects() {
             animPosition = mCurrentAnimationPosition;
             }
         
-        // avoid blending if possible
-        ObjectParameterSpaceControlPoint *animationPoint;
+        ObjectParameterSpaceControlPoint *animationPoint =
+            getAnimationControlPoint( i, animPosition );
 
-        if( animPosition == 0 ) {
-            // use pure first point
-            animationPoint =
-                mFirstSculpturePieceTemplate->getBlendedControlPoint(
-                    mSculpturePieceParameters[i] );
-            }
-        else if( animPosition == 1 ) {
-            // use pure second point
-            animationPoint =
-                mSecondSculpturePieceTemplate->getBlendedControlPoint(
-                    mSculpturePieceParameters[i] );
-            }
-        else {
-            ObjectParameterSpaceControlPoint *firstControlPoint =
-                mFirstSculpturePieceTemplate->getBlendedControlPoint(
-                    mSculpturePieceParameters[i] );
+        pieceRotationRate = animationPoint->getRotationRate();
+        
+        mCurrentPieceRotationRates[i] = pieceRotationRate;
 
-            ObjectParameterSpaceControlPoint *secondControlPoint =
-                mSecondSculpturePieceTemplate->getBlendedControlPoint(
-                    mSculpturePieceParameters[i] );
+        Vector3D *position = RenderInterpolation::interpolatePosition(
+            mPreviousPiecePositions[i], mCurrentPiecePositions[i],
+            inInterpolation );
 
+        // a piece that is not animating keeps its shape, so its last
+        // radius still holds
+        if( mViewBounds != NULL &&
+            animPosition == 0 &&
+            mCurrentPieceRadii[i] > 0 &&
+            ! mViewBounds->isCircleVisible( position,
+                                            mCurrentPieceRadii[i] ) ) {
 
-        
-            animationPoint =
-                (ObjectParameterSpaceControlPoint *)(
-                    firstControlPoint->createLinearBlend(
-                        secondControlPoint,
-                        animPosition ) );
-            delete firstControlPoint;
-            delete secondControlPoint;
+            mNumCulled++;
+
+            delete animationPoint;
+            delete position;
+            continue;
             }
 
-        pieceRotationRate = animationPoint->getRotationRate();
+        mNumDrawn++;
         
         SimpleVector<DrawableObject *> *pieceObjects =
-            animationPoint->getDrawableObjects();
+            animationPoint->extractDrawableObjects( 0, inRotatedCopyStride );
 
         delete animationPoint;
         
-        mCurrentPieceRotationRates[i] = pieceRotationRate;
+        Angle3D *rotation = RenderInterpolation::interpolateRotation(
+            mPreviousPieceRotations[i], mCurrentPieceRotations[i],
+            inInterpolation );
 
         int numObjects = pieceObjects->size();
 
@@ -859,14 +1001,12 @@ SimpleVector<DrawableObject *> *SculptureManager::getDrawableObjects() {
 
             currentObject->scale( mSculptureScale );
             
-            currentObject->rotate(
-                mCurrentPieceRotations[i] );
+            currentObject->rotate( rotation );
 
-            currentObject->move( mCurrentPiecePositions[i] );
+            currentObject->move( position );
 
             double radius =
-                currentObject->getBorderMaxDistance(
-                    mCurrentPiecePositions[i] );
+                currentObject->getBorderMaxDistance( position );
 
             if( radius > maxRadius ) {
                 maxRadius = radius;
@@ -876,7 +1016,9 @@ SimpleVector<DrawableObject *> *SculptureManager::getDrawableObjects() {
             }
 
         mCurrentPieceRadii[i] = maxRadius;
-        
+
+        delete position;
+        delete rotation;
         delete pieceObjects;
         }
 
@@ -885,6 +1027,136 @@ SimpleVector<DrawableObject *> *SculptureManager::getDrawableObjects() {
 
 
 
+void SculptureManager::setViewBounds( ViewBounds *inBounds ) {
+    mViewBounds = inBounds;
+    }
+
+
+
+int SculptureManager::getNumCulled() {
+    return mNumCulled;
+    }
+
+
+
+int SculptureManager::getNumDrawn() {
+    return mNumDrawn;
+    }
+
+
+
+ObjectParameterSpaceControlPoint *SculptureManager::getAnimationControlPoint(
+    int inPieceHandle, double inAnimationPosition ) {
+
+    if( mPieceAnimationKeyframes != NULL ) {
+        // blend the two keyframes around our position
+        double keyframePosition =
+            inAnimationPosition * ( mNumAnimationKeyframes - 1 );
+
+        int keyframeIndex = (int)floor( keyframePosition );
+
+        if( keyframeIndex < 0 ) {
+            keyframeIndex = 0;
+            }
+        else if( keyframeIndex > mNumAnimationKeyframes - 2 ) {
+            keyframeIndex = mNumAnimationKeyframes - 2;
+            }
+
+        ObjectParameterSpaceControlPoint **keyframes =
+            mPieceAnimationKeyframes[ inPieceHandle ];
+
+        // createLinearBlend copies without blending when we are
+        // exactly on a keyframe
+        return
+            (ObjectParameterSpaceControlPoint *)(
+                keyframes[ keyframeIndex ]->createLinearBlend(
+                    keyframes[ keyframeIndex + 1 ],
+                    keyframePosition - keyframeIndex ) );
+        }
+
+    
+    double parameter = mSculpturePieceParameters[ inPieceHandle ];
+    
+    // avoid blending if possible
+    if( inAnimationPosition == 0 ) {
+        // use pure first point
+        return mFirstSculpturePieceTemplate->getBlendedControlPoint(
+            parameter );
+        }
+    else if( inAnimationPosition == 1 ) {
+        // use pure second point
+        return mSecondSculpturePieceTemplate->getBlendedControlPoint(
+            parameter );
+        }
+    else {
+        ObjectParameterSpaceControlPoint *firstControlPoint =
+            mFirstSculpturePieceTemplate->getBlendedControlPoint(
+                parameter );
+
+        ObjectParameterSpaceControlPoint *secondControlPoint =
+            mSecondSculpturePieceTemplate->getBlendedControlPoint(
+                parameter );
+        
+        ObjectParameterSpaceControlPoint *animationPoint =
+            (ObjectParameterSpaceControlPoint *)(
+                firstControlPoint->createLinearBlend(
+                    secondControlPoint,
+                    inAnimationPosition ) );
+        delete firstControlPoint;
+        delete secondControlPoint;
+
+        return animationPoint;
+        }
+    }
+
+
+
+void SculptureManager::bakeAnimationKeyframes() {
+    unsigned long startSeconds, startMilliseconds;
+    Time::getCurrentTime( &startSeconds, &startMilliseconds );
+    
+    mPieceAnimationKeyframes =
+        new ObjectParameterSpaceControlPoint**[ mNumSculpturePieces ];
+
+    LevelLoadTaskGraph *bakeGraph = new LevelLoadTaskGraph( 4 );
+
+    int i;
+    for( i=0; i<mNumSculpturePieces; i++ ) {
+        mPieceAnimationKeyframes[i] =
+            new ObjectParameterSpaceControlPoint*[ mNumAnimationKeyframes ];
+
+        char *taskName = autoSprintf( "sculpturePiece%d", i );
+        
+        bakeGraph->addTask(
+            new SculpturePieceBakeTask( taskName,
+                                        mFirstSculpturePieceTemplate,
+                                        mSecondSculpturePieceTemplate,
+                                        mSculpturePieceParameters[i],
+                                        mNumAnimationKeyframes,
+                                        mPieceAnimationKeyframes[i] ) );
+        delete [] taskName;
+        }
+
+    bakeGraph->run();
+    delete bakeGraph;
+
+
+    unsigned long numBytes = 0;
+    for( i=0; i<mNumSculpturePieces; i++ ) {
+        for( int k=0; k<mNumAnimationKeyframes; k++ ) {
+            numBytes += mPieceAnimationKeyframes[i][k]->getMemorySize();
+            }
+        }
+    
+    printf( "Baked %d animation keyframes for %d sculpture pieces "
+            "in %lu ms using %lu KiB\n",
+            mNumAnimationKeyframes, mNumSculpturePieces,
+            Time::getMillisecondsSince( startSeconds, startMilliseconds ),
+            numBytes / 1024 );
+    }
+
+
+
 char SculptureManager::isPieceJarred( int inPieceHandle ) {
     // piece is only being jarred if force is increasing
     if( mJarForcesIncreasing[ inPieceHandle ] > 0 ) {
@@ -22,6 +22,14 @@
  * 2005-August-22   Jason Rohrer
  * Changed so that isPieceJarred returns true only if jar force is increasing.
  * Added magnet mode to smooth piece pick-up and drop.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added pre-computed animation keyframes for each piece.
+ * Added interpolation between simulation steps when drawing.
+ * Boss bullets are now read from a snapshot so they can be updated at the
+ * same time.
+ * Added skipping of pieces that are off screen when drawing.
+ * Added a rotated copy stride for drawing with reduced quality.
  */
 
 
@@ -33,6 +41,7 @@
 #include "ParameterizedObject.h"
 #include "ShipBulletManager.h"
 #include "MusicPart.h"
+#include "ViewBounds.h"
 
 
 #include "minorGems/util/SimpleVector.h"
@@ -67,6 +76,11 @@ class SculptureManager {
          *   other sculpture pieces to be counted as "in" the sculpture.
          * @param inAnimationLoopTime the time in seconds of a full
          *   sculpture animation loop.
+         * @param inNumAnimationKeyframes the number of evenly-spaced
+         *   animation positions to pre-compute piece shapes at.  Shapes
+         *   between keyframes are blended from the closest two keyframes.
+         *   0 disables pre-computation (both templates are blended each
+         *   frame instead).  1 is treated as 2.
          * @param inNumSculpturePieces the number of sculpture pieces.
          * @param inPieceParameters array of shape parameters, one for each
          *   piece.
@@ -91,6 +105,7 @@ class SculptureManager {
          *   Must be destroyed by caller after this class is destroyed.
          * @param inEnemyBulletJarPower the power of enemy bullets.
          * @param inBossBulletManager the manager for boss bullets.
+         *   Its saveSnapshot must be called before each call to passTime.
          *   Must be destroyed by caller after this class is destroyed.
          * @param inBossBulletJarPower the power of boss bullets.
          * @param inFriction the force of friction on jarred pieces.
@@ -102,6 +117,7 @@ class SculptureManager {
                           double inSculptureScale,
                           double inMaxDistanceToBeInSculpture,
                           double inAnimationLoopTime,
+                          int inNumAnimationKeyframes,
                           int inNumSculpturePieces,
                           double *inPieceShapeParameters,
                           Vector3D **inPieceStartingPositions,
@@ -158,6 +174,17 @@ class SculptureManager {
         void passTime( double inTimeDeltaInSeconds );
 
 
+
+        /**
+         * Saves the current piece positions and rotations so that
+         * drawing can blend between them and the results of the next
+         * simulation step.
+         *
+         * Should be called before each step.
+         */
+        void saveInterpolationState();
+
+
         
         /**
          * Gets the sculpture piece that is in a circle.  If more
@@ -310,10 +337,55 @@ class SculptureManager {
          * Gets drawable objects for all sculptures in their current
          * positions/states.
          *
+         * @param inInterpolation how far to place pieces between their
+         *   saved and current positions, in [0,1].
+         *   Defaults to 1 (current positions).
+         * @param inRotatedCopyStride how many rotated copies of each
+         *   shape to step over for each one drawn, for reducing quality.
+         *   Collision radii are not changed.  Defaults to 1.
+         *
          * @return all sculptures as a collection of drawable objects.
          *   Vector and objects must be destroyed by caller.
          */
-        SimpleVector<DrawableObject *> *getDrawableObjects();
+        SimpleVector<DrawableObject *> *getDrawableObjects(
+            double inInterpolation = 1,
+            int inRotatedCopyStride = 1 );
+
+
+
+        /**
+         * Sets the part of the world that is on screen, so that
+         * getDrawableObjects can skip pieces outside of it.
+         *
+         * Only pieces that are not animating are skipped, since their
+         * shape, and so their collision radius, is not changing.  Pieces
+         * that have not been drawn yet are never skipped.
+         *
+         * @param inBounds the bounds, or NULL to draw every piece.
+         *   Must be destroyed by caller after it is replaced by another
+         *   call.
+         */
+        void setViewBounds( ViewBounds *inBounds );
+
+
+
+        /**
+         * Gets how many pieces the last call to getDrawableObjects
+         * skipped.
+         *
+         * @return the number skipped.
+         */
+        int getNumCulled();
+
+
+
+        /**
+         * Gets how many pieces the last call to getDrawableObjects
+         * returned objects for.
+         *
+         * @return the number drawn.
+         */
+        int getNumDrawn();
 
 
         
@@ -328,6 +400,13 @@ class SculptureManager {
 
         double mCurrentAnimationPosition;
         double mCurrentAnimationDirection;
+
+        // 0 if keyframes are not used
+        int mNumAnimationKeyframes;
+
+        // mNumAnimationKeyframes shapes for each piece, or NULL
+        // if keyframes are not used
+        ObjectParameterSpaceControlPoint ***mPieceAnimationKeyframes;
         
         int mNumSculpturePieces;
         double *mSculpturePieceParameters;
@@ -347,10 +426,21 @@ class SculptureManager {
         
         Angle3D **mCurrentPieceRotations;
 
+        // positions and rotations as of the last saveInterpolationState
+        Vector3D **mPreviousPiecePositions;
+        Angle3D **mPreviousPieceRotations;
+
         MusicPart **mPieceMusicParts;
         
         double *mCurrentPieceRotationRates;
         double *mCurrentPieceRadii;
+
+        // NULL to draw everything
+        ViewBounds *mViewBounds;
+
+        // counts from the last getDrawableObjects
+        int mNumCulled;
+        int mNumDrawn;
         double *mCurrentJarForces;
         char *mJarForcesIncreasing;
         
@@ -381,6 +471,29 @@ class SculptureManager {
 
         
 
+        /**
+         * Gets the shape of a piece at an animation position.
+         *
+         * @param inPieceHandle the piece.
+         * @param inAnimationPosition the position in the animation, in
+         *   range [0,1].
+         *
+         * @return the shape.
+         *   Must be destroyed by caller.
+         */
+        ObjectParameterSpaceControlPoint *getAnimationControlPoint(
+            int inPieceHandle, double inAnimationPosition );
+
+
+
+        /**
+         * Pre-computes the animation keyframes for all pieces using
+         * several threads.
+         */
+        void bakeAnimationKeyframes();
+
+        
+
         /**
          * Maps a parameter into the power up space.
          *
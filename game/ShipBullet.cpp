@@ -3,6 +3,13 @@
  *
  * 2004-June-15   Jason Rohrer
  * Created.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added a function for getting the power without the shape.
+ * Added reduced detail for bullets that are small on screen.
+ * Added a rotated copy stride parameter for drawing.
+ * Added a function for getting the rotation rate without the shape.
+ * Changed reduced detail to blend points built when loading.
  */
 
 
@@ -100,6 +107,12 @@ ShipBullet::ShipBullet( FILE *inFILE, char *outError )
 
     fclose( closeRangeFILE );
     fclose( farRangeFILE );    
+
+
+    // close and far shapes are blended together
+    ParameterizedObject *shapeObjects[2] = { mCloseRangeObject,
+                                             mFarRangeObject };
+    ParameterizedObject::buildDetailLevels( shapeObjects, 2 );
     }
 
 
@@ -116,21 +129,26 @@ SimpleVector<DrawableObject *> *ShipBullet::getDrawableObjects(
     double inFarRangeParameter,
     double inPositionInRange,
     double *outPower,
-    double *outRotationRate ) {
+    double *outRotationRate,
+    double inPixelsPerUnit,
+    int inRotatedCopyStride ) {
 
     double farWeight = inPositionInRange;
-    double closeWeight = 1 - inPositionInRange;
     
-    
-    *outPower =
-        farWeight * inFarRangeParameter +
-        closeWeight * inCloseRangeParameter;
+    *outPower = getPower( inCloseRangeParameter, inFarRangeParameter,
+                          inPositionInRange );
 
+    double tolerance =
+        ObjectParameterSpaceControlPoint::getDetailTolerance(
+            inPixelsPerUnit );
+    
     ObjectParameterSpaceControlPoint *closeControlPoint =
-        mCloseRangeObject->getBlendedControlPoint( inCloseRangeParameter );
+        mCloseRangeObject->getBlendedControlPoint( inCloseRangeParameter,
+                                                   tolerance );
 
     ObjectParameterSpaceControlPoint *farControlPoint =
-        mFarRangeObject->getBlendedControlPoint( inFarRangeParameter );
+        mFarRangeObject->getBlendedControlPoint( inFarRangeParameter,
+                                                 tolerance );
 
     ObjectParameterSpaceControlPoint *blendedPoint =
         (ObjectParameterSpaceControlPoint *)(
@@ -141,12 +159,43 @@ SimpleVector<DrawableObject *> *ShipBullet::getDrawableObjects(
     delete farControlPoint;
 
 
-    SimpleVector<DrawableObject*> *drawableObjects =
-            blendedPoint->getDrawableObjects();
-        
     *outRotationRate = blendedPoint->getRotationRate();
+
+    SimpleVector<DrawableObject*> *drawableObjects =
+            blendedPoint->extractDrawableObjects( inPixelsPerUnit,
+                                                  inRotatedCopyStride );
         
     delete blendedPoint;
         
     return drawableObjects;
     }
+
+
+
+double ShipBullet::getPower( double inCloseRangeParameter,
+                             double inFarRangeParameter,
+                             double inPositionInRange ) {
+
+    double farWeight = inPositionInRange;
+    double closeWeight = 1 - inPositionInRange;
+    
+    return
+        farWeight * inFarRangeParameter +
+        closeWeight * inCloseRangeParameter;
+    }
+
+
+
+double ShipBullet::getRotationRate( double inCloseRangeParameter,
+                                    double inFarRangeParameter,
+                                    double inPositionInRange ) {
+
+    double farWeight = inPositionInRange;
+    double closeWeight = 1 - inPositionInRange;
+    
+    return
+        farWeight * mFarRangeObject->getRotationRate(
+            inFarRangeParameter ) +
+        closeWeight * mCloseRangeObject->getRotationRate(
+            inCloseRangeParameter );
+    }
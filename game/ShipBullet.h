@@ -3,6 +3,13 @@
  *
  * 2004-June-15   Jason Rohrer
  * Created.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added a function for getting the power without the shape.
+ * Added reduced detail for bullets that are small on screen.
+ * Added a rotated copy stride parameter for drawing.
+ * Added a function for getting the rotation rate without the shape.
+ * Changed reduced detail to blend points built when loading.
  */
 
 
@@ -59,6 +66,13 @@ class ShipBullet {
          *   [0,1]) should be returned.
          * @param outRotationRate pointer to where the bullet rotation
          *   rate should be returned.
+         * @param inPixelsPerUnit how many pixels one unit of the shape
+         *   will cover on screen, for reducing detail, or 0 for full
+         *   detail.  Defaults to 0.
+         * @param inRotatedCopyStride how many rotated copies to step over
+         *   for each one returned, as for
+         *   ObjectParameterSpaceControlPoint::getDrawableObjects.
+         *   Defaults to 1.
          *
          * @return this bullet as a collection of drawable objects.
          *   Vector and objects must be destroyed by caller.
@@ -68,7 +82,47 @@ class ShipBullet {
             double inFarRangeParameter,
             double inPositionInRange,
             double *outPower,
-            double *outRotationRate );
+            double *outRotationRate,
+            double inPixelsPerUnit = 0,
+            int inRotatedCopyStride = 1 );
+
+
+
+        /**
+         * Gets the power of this bullet, as getDrawableObjects does,
+         * without building its shape.
+         *
+         * @param inCloseRangeParameter a parameter in the range [0,1] to
+         *   control the shape/power of the bullet at close range.
+         * @param inFarRangeParameter a parameter in the range [0,1] to
+         *   control the shape/power of the bullet at far range.
+         * @param inPositionInRange the position of the bullet in its
+         *   range (in the range [0,1], with 0 being close and 1 being far).
+         *
+         * @return the bullet's power, in the range [0,1].
+         */
+        double getPower( double inCloseRangeParameter,
+                         double inFarRangeParameter,
+                         double inPositionInRange );
+
+
+
+        /**
+         * Gets the rotation rate of this bullet, as getDrawableObjects
+         * does, without building its shape.
+         *
+         * @param inCloseRangeParameter a parameter in the range [0,1] to
+         *   control the shape/power of the bullet at close range.
+         * @param inFarRangeParameter a parameter in the range [0,1] to
+         *   control the shape/power of the bullet at far range.
+         * @param inPositionInRange the position of the bullet in its
+         *   range (in the range [0,1], with 0 being close and 1 being far).
+         *
+         * @return the rotation rate in rotations per second.
+         */
+        double getRotationRate( double inCloseRangeParameter,
+                                double inFarRangeParameter,
+                                double inPositionInRange );
 
 
         
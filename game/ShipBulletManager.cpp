@@ -28,11 +28,20 @@
  *
  * 2005-August-23   Jason Rohrer
  * Finished boss damage graphics.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added interpolation between simulation steps when drawing.
+ * Added snapshots for querying bullets while they are being updated.
+ * Added skipping of bullets that are off screen when drawing.
+ * Added reduced detail for bullets that are small on screen.
+ * Added a rotated copy stride for drawing with reduced quality.
+ * Rotation rate computed in each step rather than when drawing.
  */
 
 
 
 #include "ShipBulletManager.h"
+#include "RenderInterpolation.h"
 
 
 
@@ -57,8 +66,20 @@ ShipBulletManager::ShipBulletManager( ShipBullet *inBulletTemplate,
       mVelocitiesInScreenUnitsPerSecond( new SimpleVector<Vector3D*>() ),
       mCurrentPositions( new SimpleVector<Vector3D*>() ),
       mCurrentRotations( new SimpleVector<Angle3D*>() ),
+      mPreviousPositions( new SimpleVector<Vector3D*>() ),
+      mPreviousRotations( new SimpleVector<Angle3D*>() ),
       mCurrentRotationRates( new SimpleVector<double>() ),
-      mSholdBeDestroyedFlags( new SimpleVector<char>() ) {
+      mViewBounds( NULL ),
+      mMaxBulletRadius( 0 ),
+      mNumCulled( 0 ),
+      mNumDrawn( 0 ),
+      mSholdBeDestroyedFlags( new SimpleVector<char>() ),
+      mSnapshotCloseRangeParameters( new SimpleVector<double>() ),
+      mSnapshotFarRangeParameters( new SimpleVector<double>() ),
+      mSnapshotRangeFractions( new SimpleVector<double>() ),
+      mSnapshotPowers( new SimpleVector<double>() ),
+      mSnapshotPositions( new SimpleVector<Vector3D*>() ),
+      mSnapshotRotations( new SimpleVector<Angle3D*>() ) {
 
     mMaxXPosition = inWorldWidth / 2;
     mMinXPosition = -mMaxXPosition;
@@ -93,6 +114,8 @@ ShipBulletManager::~ShipBulletManager() {
         delete *( mVelocitiesInScreenUnitsPerSecond->getElement( i ) );
         delete *( mCurrentPositions->getElement( i ) );
         delete *( mCurrentRotations->getElement( i ) );
+        delete *( mPreviousPositions->getElement( i ) );
+        delete *( mPreviousRotations->getElement( i ) );
         }
 
     
@@ -100,9 +123,19 @@ ShipBulletManager::~ShipBulletManager() {
     delete mVelocitiesInScreenUnitsPerSecond;
     delete mCurrentPositions;
     delete mCurrentRotations;
+    delete mPreviousPositions;
+    delete mPreviousRotations;
     
     delete mCurrentRotationRates;
     delete mSholdBeDestroyedFlags;
+
+    clearSnapshot();
+    delete mSnapshotCloseRangeParameters;
+    delete mSnapshotFarRangeParameters;
+    delete mSnapshotRangeFractions;
+    delete mSnapshotPowers;
+    delete mSnapshotPositions;
+    delete mSnapshotRotations;
     }
 
 
@@ -133,6 +166,10 @@ void ShipBulletManager::addBullet(
         inVelocityInScreenUnitsPerSecond );
     mCurrentPositions->push_back( new Vector3D( inStartingPosition ) );
 
+    // new bullets have no earlier state to blend from
+    mPreviousPositions->push_back( new Vector3D( inStartingPosition ) );
+    mPreviousRotations->push_back( new Angle3D( inStartingRotation ) );
+
     mSholdBeDestroyedFlags->push_back( false );
 
     if( mSoundPlayer != NULL ) {
@@ -159,9 +196,86 @@ int ShipBulletManager::getBulletCount() {
 
 double ShipBulletManager::getBulletPowerInCircle( Vector3D *inCircleCenter,
                                                   double inCircleRadius ) {
+    return getPowerInCircle( inCircleCenter, inCircleRadius,
+                             mCloseRangeParameters,
+                             mFarRangeParameters,
+                             mRangeFractions,
+                             mCurrentPowers,
+                             mCurrentPositions,
+                             mCurrentRotations );
+    }
+
+
+
+double ShipBulletManager::getSnapshotBulletPowerInCircle(
+    Vector3D *inCircleCenter,
+    double inCircleRadius ) {
+
+    return getPowerInCircle( inCircleCenter, inCircleRadius,
+                             mSnapshotCloseRangeParameters,
+                             mSnapshotFarRangeParameters,
+                             mSnapshotRangeFractions,
+                             mSnapshotPowers,
+                             mSnapshotPositions,
+                             mSnapshotRotations );
+    }
+
+
+
+void ShipBulletManager::clearSnapshot() {
+    int numBullets = mSnapshotPositions->size();
+
+    for( int i=0; i<numBullets; i++ ) {
+        delete *( mSnapshotPositions->getElement( i ) );
+        delete *( mSnapshotRotations->getElement( i ) );
+        }
+
+    mSnapshotCloseRangeParameters->deleteAll();
+    mSnapshotFarRangeParameters->deleteAll();
+    mSnapshotRangeFractions->deleteAll();
+    mSnapshotPowers->deleteAll();
+    mSnapshotPositions->deleteAll();
+    mSnapshotRotations->deleteAll();
+    }
+
+
+
+void ShipBulletManager::saveSnapshot() {
+    clearSnapshot();
+
+    int numBullets = mCloseRangeParameters->size();
+
+    for( int i=0; i<numBullets; i++ ) {
+        mSnapshotCloseRangeParameters->push_back(
+            *( mCloseRangeParameters->getElement( i ) ) );
+        mSnapshotFarRangeParameters->push_back(
+            *( mFarRangeParameters->getElement( i ) ) );
+        mSnapshotRangeFractions->push_back(
+            *( mRangeFractions->getElement( i ) ) );
+        mSnapshotPowers->push_back(
+            *( mCurrentPowers->getElement( i ) ) );
+        mSnapshotPositions->push_back(
+            new Vector3D( *( mCurrentPositions->getElement( i ) ) ) );
+        mSnapshotRotations->push_back(
+            new Angle3D( *( mCurrentRotations->getElement( i ) ) ) );
+        }
+    }
+
+
+
+double ShipBulletManager::getPowerInCircle(
+    Vector3D *inCircleCenter,
+    double inCircleRadius,
+    SimpleVector<double> *inCloseRangeParameters,
+    SimpleVector<double> *inFarRangeParameters,
+    SimpleVector<double> *inRangeFractions,
+    SimpleVector<double> *inPowers,
+    SimpleVector<Vector3D *> *inPositions,
+    SimpleVector<Angle3D *> *inRotations ) {
+
     double powerSum = 0;
     
-    int numBullets = mCloseRangeParameters->size();
+    int numBullets = inCloseRangeParameters->size();
 
     for( int i=0; i<numBullets; i++ ) {
         double currentRotationRate;
@@ -169,9 +283,9 @@ double ShipBulletManager::getBulletPowerInCircle( Vector3D *inCircleCenter,
         
         SimpleVector<DrawableObject *> *bulletObjects =
             mBulletTemplate->getDrawableObjects(
-                *( mCloseRangeParameters->getElement( i ) ),
-                *( mFarRangeParameters->getElement( i ) ),
-                *( mRangeFractions->getElement( i ) ),
+                *( inCloseRangeParameters->getElement( i ) ),
+                *( inFarRangeParameters->getElement( i ) ),
+                *( inRangeFractions->getElement( i ) ),
                 &power,
                 &currentRotationRate );
 
@@ -189,13 +303,13 @@ double ShipBulletManager::getBulletPowerInCircle( Vector3D *inCircleCenter,
 
                 currentObject->scale( mBulletScale );
                 currentObject->rotate(
-                    *( mCurrentRotations->getElement( i ) ) );
+                    *( inRotations->getElement( i ) ) );
                 currentObject->move(
-                    *( mCurrentPositions->getElement( i ) ) );
+                    *( inPositions->getElement( i ) ) );
 
                 if( currentObject->isBorderInCircle( inCircleCenter,
                                                      inCircleRadius ) ) {
-                    powerSum += *( mCurrentPowers->getElement( i ) );
+                    powerSum += *( inPowers->getElement( i ) );
                     alreadyHit = true;
                     }
              
@@ -261,7 +375,14 @@ void ShipBulletManager::passTime( double inTimeDeltaInSeconds ) {
 
         Angle3D *currentRotation = *( mCurrentRotations->getElement( i ) );
 
-        double rotationRate = *( mCurrentRotationRates->getElement( i ) );
+        // from the shape rather than from the last time we were drawn, so
+        // that collisions do not depend on which bullets are on screen
+        double rotationRate =
+            mBulletTemplate->getRotationRate(
+                *( mCloseRangeParameters->getElement( i ) ),
+                *( mFarRangeParameters->getElement( i ) ),
+                *( mRangeFractions->getElement( i ) ) );
+        *( mCurrentRotationRates->getElement( i ) ) = rotationRate;
         
         currentRotation->mZ += rotationRate * inTimeDeltaInSeconds;
 
@@ -349,6 +470,12 @@ void ShipBulletManager::passTime( double inTimeDeltaInSeconds ) {
             delete *( mCurrentPositions->getElement( i ) );
             mCurrentPositions->deleteElement( i );
 
+            delete *( mPreviousPositions->getElement( i ) );
+            mPreviousPositions->deleteElement( i );
+
+            delete *( mPreviousRotations->getElement( i ) );
+            mPreviousRotations->deleteElement( i );
+
             mSholdBeDestroyedFlags->deleteElement( i );
             }
         }
@@ -356,17 +483,68 @@ void ShipBulletManager::passTime( double inTimeDeltaInSeconds ) {
 
 
 
-SimpleVector<DrawableObject*> *ShipBulletManager::getDrawableObjects() {
+void ShipBulletManager::saveInterpolationState() {
+    int numBullets = mCurrentPositions->size();
+
+    for( int i=0; i<numBullets; i++ ) {
+        delete *( mPreviousPositions->getElement( i ) );
+        *( mPreviousPositions->getElement( i ) ) =
+            new Vector3D( *( mCurrentPositions->getElement( i ) ) );
+
+        delete *( mPreviousRotations->getElement( i ) );
+        *( mPreviousRotations->getElement( i ) ) =
+            new Angle3D( *( mCurrentRotations->getElement( i ) ) );
+        }
+    }
+
+
+
+SimpleVector<DrawableObject*> *ShipBulletManager::getDrawableObjects(
+    double inInterpolation, int inRotatedCopyStride ) {
 
     SimpleVector<DrawableObject*> *returnVector =
         new SimpleVector<DrawableObject*>();
     
     int numBullets = mCloseRangeParameters->size();
 
+    mNumCulled = 0;
+    mNumDrawn = 0;
+    
     for( int i=0; i<numBullets; i++ ) {
+        Vector3D *position = RenderInterpolation::interpolatePosition(
+            *( mPreviousPositions->getElement( i ) ),
+            *( mCurrentPositions->getElement( i ) ),
+            inInterpolation );
+
+        if( mViewBounds != NULL &&
+            mMaxBulletRadius > 0 &&
+            ! mViewBounds->isCircleVisible( position, mMaxBulletRadius ) ) {
+
+            // off screen, but its power is still needed for collisions
+            *( mCurrentPowers->getElement( i ) ) =
+                mBulletTemplate->getPower(
+                    *( mCloseRangeParameters->getElement( i ) ),
+                    *( mFarRangeParameters->getElement( i ) ),
+                    *( mRangeFractions->getElement( i ) ) ) *
+                *( mPowerModifiers->getElement( i ) );
+
+            mNumCulled++;
+            
+            delete position;
+            continue;
+            }
+
+        mNumDrawn++;
+        
         double power;
         double modifiedPower;
         double currentRotationRate;
+
+        // full detail unless we know how large the bullet is on screen
+        double pixelsPerUnit = 0;
+        if( mViewBounds != NULL ) {
+            pixelsPerUnit = mViewBounds->mPixelsPerUnit * mBulletScale;
+            }
         
         SimpleVector<DrawableObject *> *bulletObjects =
             mBulletTemplate->getDrawableObjects(
@@ -374,7 +552,9 @@ SimpleVector<DrawableObject*> *ShipBulletManager::getDrawableObjects() {
                 *( mFarRangeParameters->getElement( i ) ),
                 *( mRangeFractions->getElement( i ) ),
                 &power,
-                &currentRotationRate );
+                &currentRotationRate,
+                pixelsPerUnit,
+                inRotatedCopyStride );
 
         double powerModifier = *( mPowerModifiers->getElement( i ) );
         
@@ -391,8 +571,12 @@ SimpleVector<DrawableObject*> *ShipBulletManager::getDrawableObjects() {
         double fadeFactor = powerModifier * endOfLifeFadeFactor;
         
         *( mCurrentPowers->getElement( i ) ) = modifiedPower;
-        *( mCurrentRotationRates->getElement( i ) ) = currentRotationRate;
 
+        Angle3D *rotation = RenderInterpolation::interpolateRotation(
+            *( mPreviousRotations->getElement( i ) ),
+            *( mCurrentRotations->getElement( i ) ),
+            inInterpolation );
+        
         int numObjects = bulletObjects->size();
         
         for( int j=0; j<numObjects; j++ ) {
@@ -403,14 +587,44 @@ SimpleVector<DrawableObject*> *ShipBulletManager::getDrawableObjects() {
             currentObject->fade( fadeFactor );
 
             currentObject->scale( mBulletScale );
-            currentObject->rotate( *( mCurrentRotations->getElement( i ) ) );
-            currentObject->move( *( mCurrentPositions->getElement( i ) ) );
+            currentObject->rotate( rotation );
+            currentObject->move( position );
+
+            if( mViewBounds != NULL ) {
+                // only needed for culling
+                double radius =
+                    currentObject->getBorderMaxDistance( position );
 
+                if( radius > mMaxBulletRadius ) {
+                    mMaxBulletRadius = radius;
+                    }
+                }
+            
             returnVector->push_back( currentObject );
             }
 
+        delete position;
+        delete rotation;
         delete bulletObjects;
         }
 
     return returnVector;
     }
+
+
+
+void ShipBulletManager::setViewBounds( ViewBounds *inBounds ) {
+    mViewBounds = inBounds;
+    }
+
+
+
+int ShipBulletManager::getNumCulled() {
+    return mNumCulled;
+    }
+
+
+
+int ShipBulletManager::getNumDrawn() {
+    return mNumDrawn;
+    }
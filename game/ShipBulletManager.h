@@ -18,6 +18,14 @@
  *
  * 2005-August-23   Jason Rohrer
  * Finished boss damage graphics.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added interpolation between simulation steps when drawing.
+ * Added snapshots for querying bullets while they are being updated.
+ * Added skipping of bullets that are off screen when drawing.
+ * Added reduced detail for bullets that are small on screen.
+ * Added a rotated copy stride for drawing with reduced quality.
+ * Rotation rate computed in each step rather than when drawing.
  */
 
 
@@ -30,6 +38,7 @@
 #include "ShipBullet.h"
 #include "SoundPlayer.h"
 #include "BulletSound.h"
+#include "ViewBounds.h"
 
 #include "minorGems/util/SimpleVector.h"
 #include "minorGems/math/geometry/Vector3D.h"
@@ -135,6 +144,34 @@ class ShipBulletManager {
 
         
 
+        /**
+         * Saves a copy of the current bullets that
+         * getSnapshotBulletPowerInCircle can query.
+         *
+         * This lets another thread query the bullets as they were before
+         * a simulation step while passTime runs.  Neither function may
+         * be called while the other runs.
+         */
+        void saveSnapshot();
+
+
+
+        /**
+         * Same as getBulletPowerInCircle, but queries the bullets as of
+         * the last call to saveSnapshot.
+         *
+         * Can be called at the same time as any function except
+         * saveSnapshot.
+         *
+         * @param inCircleCenter the center of the circle.
+         *   Must be destroyed by caller.
+         * @param inCircleRadius the radius of the circle.
+         */
+        double getSnapshotBulletPowerInCircle( Vector3D *inCircleCenter,
+                                               double inCircleRadius );
+
+        
+
         /**
          * Gets the positions of all bullets in a circular region of the world.
          * Wraps around if circle extends off the edge of the world.
@@ -161,16 +198,74 @@ class ShipBulletManager {
          */
         void passTime( double inTimeDeltaInSeconds );
 
+
+
+        /**
+         * Saves the current bullet positions and rotations so that
+         * drawing can blend between them and the results of the next
+         * simulation step.
+         *
+         * Should be called before each step.
+         */
+        void saveInterpolationState();
+
         
         
         /**
          * Gets drawable objects for all bullets in their current
          * positions/states.
          *
+         * @param inInterpolation how far to place bullets between their
+         *   saved and current positions, in [0,1].
+         *   Defaults to 1 (current positions).
+         * @param inRotatedCopyStride how many rotated copies of each
+         *   shape to step over for each one drawn, for reducing quality.
+         *   Collision radii are not changed.  Defaults to 1.
+         *
          * @return all bullets as a collection of drawable objects.
          *   Vector and objects must be destroyed by caller.
          */
-        SimpleVector<DrawableObject *> *getDrawableObjects();
+        SimpleVector<DrawableObject *> *getDrawableObjects(
+            double inInterpolation = 1,
+            int inRotatedCopyStride = 1 );
+
+
+
+        /**
+         * Sets the part of the world that is on screen, so that
+         * getDrawableObjects can skip bullets outside of it, and draw
+         * bullets that are small on screen with less detail.
+         *
+         * Skipped bullets still have their power updated, and their
+         * rotation is stepped in passTime either way.  Bullets are
+         * assumed to be no larger than the largest one drawn so far, so
+         * none are skipped until one has been drawn.
+         *
+         * @param inBounds the bounds, or NULL to draw every bullet.
+         *   Must be destroyed by caller after it is replaced by another
+         *   call.
+         */
+        void setViewBounds( ViewBounds *inBounds );
+
+
+
+        /**
+         * Gets how many bullets the last call to getDrawableObjects
+         * skipped.
+         *
+         * @return the number skipped.
+         */
+        int getNumCulled();
+
+
+
+        /**
+         * Gets how many bullets the last call to getDrawableObjects
+         * returned objects for.
+         *
+         * @return the number drawn.
+         */
+        int getNumDrawn();
 
 
         
@@ -217,11 +312,68 @@ class ShipBulletManager {
         // for each time delta
         SimpleVector<Angle3D *> *mCurrentRotations;
 
+        // positions and rotations as of the last saveInterpolationState
+        SimpleVector<Vector3D *> *mPreviousPositions;
+        SimpleVector<Angle3D *> *mPreviousRotations;
+
 
         SimpleVector<double> *mCurrentRotationRates;
 
+        // NULL to draw everything
+        ViewBounds *mViewBounds;
+
+        // the farthest any drawn bullet has reached from its center,
+        // or 0 before any are drawn
+        double mMaxBulletRadius;
+
+        // counts from the last getDrawableObjects
+        int mNumCulled;
+        int mNumDrawn;
+
         SimpleVector<char> *mSholdBeDestroyedFlags;
 
+
+        // copies of bullet state as of the last saveSnapshot
+        SimpleVector<double> *mSnapshotCloseRangeParameters;
+        SimpleVector<double> *mSnapshotFarRangeParameters;
+        SimpleVector<double> *mSnapshotRangeFractions;
+        SimpleVector<double> *mSnapshotPowers;
+        SimpleVector<Vector3D *> *mSnapshotPositions;
+        SimpleVector<Angle3D *> *mSnapshotRotations;
+
+
+
+        /**
+         * Destroys the bullets saved by saveSnapshot.
+         */
+        void clearSnapshot();
+
+
+
+        /**
+         * Gets the sum of powers of a set of bullets in a circular region.
+         *
+         * Shared by getBulletPowerInCircle and
+         * getSnapshotBulletPowerInCircle.
+         *
+         * @param inCircleCenter the center of the circle.
+         *   Must be destroyed by caller.
+         * @param inCircleRadius the radius of the circle.
+         * @param inCloseRangeParameters, inFarRangeParameters,
+         *   inRangeFractions, inPowers, inPositions, inRotations the
+         *   state of each bullet.
+         *   Must be destroyed by caller.
+         */
+        double getPowerInCircle(
+            Vector3D *inCircleCenter,
+            double inCircleRadius,
+            SimpleVector<double> *inCloseRangeParameters,
+            SimpleVector<double> *inFarRangeParameters,
+            SimpleVector<double> *inRangeFractions,
+            SimpleVector<double> *inPowers,
+            SimpleVector<Vector3D *> *inPositions,
+            SimpleVector<Angle3D *> *inRotations );
+
         
     };
 
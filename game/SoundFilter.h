@@ -3,6 +3,10 @@
  *
  * 2004-July-22   Jason Rohrer
  * Created.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added filtering in place.
+ * Added a reset function.
  */
 
 
@@ -13,6 +17,7 @@
 
 
 #include "SoundSamples.h"
+#include "StereoSampleView.h"
 
 
 
@@ -40,6 +45,31 @@ class SoundFilter {
 
 
 
+        /**
+         * Filters sound samples in place, in whatever layout they are in.
+         *
+         * The default implementation copies the samples through
+         * filterSamples.  Filters that can work in place should override
+         * it.
+         *
+         * @param inOutSamples the samples to filter, which are replaced
+         *   by the result.
+         */
+        virtual void filterSamplesInPlace( StereoSampleView inOutSamples );
+
+
+
+        /**
+         * Forgets any sound held from earlier samples, such as echoes
+         * that have not been played yet.
+         *
+         * The default implementation does nothing.  Filters that hold
+         * sound should override it.
+         */
+        virtual void reset();
+
+
+
         // virtual destructor to ensure proper destruction of classes that
         // implement this interface
         virtual ~SoundFilter();
@@ -57,4 +87,25 @@ inline SoundFilter::~SoundFilter() {
 
 
 
+inline void SoundFilter::reset() {
+
+    }
+
+
+
+inline void SoundFilter::filterSamplesInPlace(
+    StereoSampleView inOutSamples ) {
+
+    SoundSamples *samples = new SoundSamples( inOutSamples.mSampleCount );
+    StereoSampleView( samples ).copy( inOutSamples );
+
+    SoundSamples *filteredSamples = filterSamples( samples );
+    inOutSamples.copy( StereoSampleView( filteredSamples ) );
+
+    delete filteredSamples;
+    delete samples;
+    }
+
+
+
 #endif
@@ -0,0 +1,94 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef SOUND_OUTPUT_INCLUDED
+#define SOUND_OUTPUT_INCLUDED
+
+
+
+// SoundPlayer.h includes this header
+class SoundPlayer;
+
+
+
+/**
+ * Interface for a class that takes the samples mixed by a SoundPlayer
+ * somewhere, like to the speakers or to a file.
+ *
+ * An output either pulls samples from the player itself, with
+ * SoundPlayer::getSamples, or is driven by the caller, who pulls them
+ * with SoundPlayer::pullSamples and has them passed to writeSamples.
+ *
+ * @author Jason Rohrer
+ */
+class SoundOutput {
+
+
+
+    public:
+
+        /**
+         * Starts sending samples from a player to this output.
+         *
+         * @param inPlayer the player to get samples from.
+         *   Must be destroyed by caller after this output is stopped.
+         *
+         * @return true on success.
+         */
+        virtual char start( SoundPlayer *inPlayer ) = 0;
+
+
+
+        /**
+         * Stops sending samples.  Blocks until getSamples is no longer
+         * being called by this output.
+         */
+        virtual void stop() = 0;
+
+
+
+        /**
+         * Takes samples that the caller pulled from the player.
+         *
+         * Defaults to discarding them.
+         *
+         * @param inSamples interleaved stereo float samples.
+         *   Must be destroyed by caller.
+         * @param inNumFrames the number of stereo frames.
+         */
+        virtual void writeSamples( float *inSamples,
+                                   unsigned long inNumFrames );
+
+
+
+        // virtual destructor to ensure proper destruction of classes that
+        // implement this interface
+        virtual ~SoundOutput();
+
+
+
+    };
+
+
+
+inline void SoundOutput::writeSamples( float *inSamples,
+                                       unsigned long inNumFrames ) {
+
+    }
+
+
+
+// does nothing, needed to make compiler happy
+inline SoundOutput::~SoundOutput() {
+
+    }
+
+
+
+#endif
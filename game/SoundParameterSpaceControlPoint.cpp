@@ -15,6 +15,9 @@
  *
  * 2004-September-3   Jason Rohrer
  * Added brief fade in/out at beginning/end of sound to avoid clicks.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added mixing into one channel of a strided buffer.
  */
 
 
@@ -229,6 +232,31 @@ float *SoundParameterSpaceControlPoint::getSoundSamples(
     unsigned long inSamplesPerSecond,
     double inSoundLengthInSeconds ) {
 
+    float *samples = new float[ inSampleCount ];
+
+    for( unsigned long i=0; i<inSampleCount; i++ ) {
+        samples[i] = 0;
+        }
+
+    mixSoundSamples( samples, 1, 1, 0,
+                     inStartSample, inSampleCount,
+                     inSamplesPerSecond, inSoundLengthInSeconds );
+    
+    return samples;
+    }
+
+
+
+void SoundParameterSpaceControlPoint::mixSoundSamples(
+    float *inOutSamples,
+    unsigned long inStride,
+    float inStartGain,
+    float inGainStep,
+    unsigned long inStartSample,
+    unsigned long inSampleCount,
+    unsigned long inSamplesPerSecond,
+    double inSoundLengthInSeconds ) {
+
     if( inStartSample == 0 ) {
         // reset our wave pointer
         mCurrentWavePoint = 0;
@@ -236,9 +264,6 @@ float *SoundParameterSpaceControlPoint::getSoundSamples(
 
     double sampleDeltaInSeconds = 1.0 / inSamplesPerSecond;
 
-    
-    float *samples = new float[ inSampleCount ];
-
 
     unsigned long soundLengthInSamples =
         (unsigned long)( inSoundLengthInSeconds * inSamplesPerSecond );
@@ -313,10 +338,14 @@ float *SoundParameterSpaceControlPoint::getSoundSamples(
                 sin( mWaveComponentFrequencies[j] * adjustedTime );
             }
         
-        samples[i] = (float)( currentLoudness * fadeFactor * componentSum );
+        float gain = inStartGain + i * inGainStep;
+        if( gain < 0 ) {
+            gain = 0;
+            }
+        
+        inOutSamples[ i * inStride ] +=
+            gain * (float)( currentLoudness * fadeFactor * componentSum );
         }
-
-    return samples;
     }
       
 
@@ -12,6 +12,9 @@
  *
  * 2004-August-19   Jason Rohrer
  * Fixed bug in walking through wavetable.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added mixing into one channel of a strided buffer.
  */
 
 
@@ -122,6 +125,34 @@ class SoundParameterSpaceControlPoint : public ParameterSpaceControlPoint {
                                 unsigned long inSampleCount,
                                 unsigned long inSamplesPerSecond,
                                 double inSoundLengthInSeconds );
+
+
+
+        /**
+         * Adds a block of samples from this control point to one channel
+         * of a buffer.
+         *
+         * @param inOutSamples the first sample of the channel to add to.
+         *   Must be destroyed by caller.
+         * @param inStride the distance between neighboring samples of the
+         *   channel, 1 for planar buffers and 2 for interleaved ones.
+         * @param inStartGain the gain for the first sample.
+         * @param inGainStep the change in gain from one sample to the
+         *   next, as for StereoSampleView::mix.
+         * @param inStartSample the index of the first sample to get.
+         * @param inSampleCount the number of samples to get.
+         * @param inSamplesPerSecond the current sample rate.
+         * @param inSoundLengthInSeconds the total length of the sound being
+         *   played.
+         */
+        void mixSoundSamples( float *inOutSamples,
+                              unsigned long inStride,
+                              float inStartGain,
+                              float inGainStep,
+                              unsigned long inStartSample,
+                              unsigned long inSampleCount,
+                              unsigned long inSamplesPerSecond,
+                              double inSoundLengthInSeconds );
         
         
         
@@ -35,32 +35,32 @@
  *
  * 2004-August-31   Jason Rohrer
  * Added function for removing filters.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added option to run without an audio device.
+ * Added a frame profiler scope around mixing.
+ * Added callback telemetry.
+ * Added an allocation profiler tag around mixing.
+ * Added adjustable limits on sounds and filters for quality control.
+ * Moved the PortAudio stream into a pluggable SoundOutput.
+ * Changed dropped sounds to fade out over a fixed time, whatever the
+ * buffer size.
+ * Added optional mixing ahead on a producer thread.
+ * Changed to mix straight into the interleaved output buffer.
+ * Filters that were skipped are reset when they are applied again.
  */
 
 
 
 #include "SoundPlayer.h"
 #include "MusicPlayer.h"
+#include "FrameProfiler.h"
+#include "AllocationProfiler.h"
 
 
 #include <stdio.h>
 
 
-// callback passed into portaudio
-static int portaudioCallback( void *inputBuffer, void *outputBuffer,
-                              unsigned long framesPerBuffer,
-                              PaTimestamp outTime, void *userData ) {
-
-
-    SoundPlayer *player = (SoundPlayer *)userData;
-
-    player->getSamples( outputBuffer, framesPerBuffer );
-
-    return 0;
-    }
-
-
-
 /**
  * Class that wraps SoundSamples in a PlayableSound.
  */
@@ -86,26 +86,58 @@ class SamplesPlayableSound : public PlayableSound {
         
         // implements the PlayableSound interface
         virtual SoundSamples *getMoreSamples( unsigned long inNumSamples );
+        virtual unsigned long mixMoreSamples( StereoSampleView inOutSamples,
+                                              float inStartGain,
+                                              float inGainStep );
         virtual PlayableSound *copy();
         
 
     protected:
 
-        SoundSamples *mRemainingSamples;
+        SoundSamples *mSamples;
 
+        // the index of the next sample to play
+        unsigned long mPosition;
+
+
+        
+        /**
+         * Gets the next samples to play, without advancing.
+         *
+         * @param inNumSamples the most samples to get.
+         *
+         * @return a view of the samples, which may be shorter than
+         *   inNumSamples at the end of the sound.
+         */
+        StereoSampleView getNextSamples( unsigned long inNumSamples );
+        
     };
 
 
 
 SamplesPlayableSound::SamplesPlayableSound( SoundSamples *inSamples )
-    : mRemainingSamples( new SoundSamples( inSamples ) ) {
+    : mSamples( new SoundSamples( inSamples ) ),
+      mPosition( 0 ) {
 
     }
 
 
 
 SamplesPlayableSound::~SamplesPlayableSound() {
-    delete mRemainingSamples;
+    delete mSamples;
+    }
+
+
+
+StereoSampleView SamplesPlayableSound::getNextSamples(
+    unsigned long inNumSamples ) {
+
+    unsigned long numSamples = mSamples->mSampleCount - mPosition;
+    if( numSamples > inNumSamples ) {
+        numSamples = inNumSamples;
+        }
+
+    return StereoSampleView( mSamples ).getRegion( mPosition, numSamples );
     }
 
 
@@ -113,17 +145,43 @@ SamplesPlayableSound::~SamplesPlayableSound() {
 SoundSamples *SamplesPlayableSound::getMoreSamples(
     unsigned long inNumSamples ) {
 
-    SoundSamples *returnSamples = new SoundSamples( mRemainingSamples,
-                                                    inNumSamples );
-    mRemainingSamples->trim( returnSamples->mSampleCount );
+    StereoSampleView nextSamples = getNextSamples( inNumSamples );
+    
+    SoundSamples *returnSamples =
+        new SoundSamples( nextSamples.mSampleCount );
+    StereoSampleView( returnSamples ).copy( nextSamples );
+
+    mPosition += nextSamples.mSampleCount;
 
     return returnSamples;
     }
 
 
 
+unsigned long SamplesPlayableSound::mixMoreSamples(
+    StereoSampleView inOutSamples,
+    float inStartGain, float inGainStep ) {
+
+    // straight from our samples, with no copy
+    StereoSampleView nextSamples =
+        getNextSamples( inOutSamples.mSampleCount );
+
+    inOutSamples.mix( nextSamples, inStartGain, inGainStep );
+
+    mPosition += nextSamples.mSampleCount;
+
+    return nextSamples.mSampleCount;
+    }
+
+
+
 PlayableSound *SamplesPlayableSound::copy() {
-    return new SamplesPlayableSound( mRemainingSamples );
+    SamplesPlayableSound *soundCopy = new SamplesPlayableSound( mSamples );
+
+    // copy picks up where this sound is
+    soundCopy->mPosition = mPosition;
+    
+    return soundCopy;
     }
 
 
@@ -131,9 +189,14 @@ PlayableSound *SamplesPlayableSound::copy() {
 SoundPlayer::SoundPlayer( int inSampleRate,
                           int inMaxSimultaneousRealtimeSounds,
                           void *inMusicPlayer,
-                          double inMusicLoudness )
+                          double inMusicLoudness,
+                          SoundOutput *inOutput,
+                          unsigned long inLookaheadFrames,
+                          unsigned long inFramesPerBlock )
     : mLock( new MutexLock() ),
       mSampleRate( inSampleRate ),
+      mOutput( inOutput ),
+      mProducer( NULL ),
       mMaxSimultaneousRealtimeSounds( inMaxSimultaneousRealtimeSounds ),
       mMusicPlayer( inMusicPlayer ),
       mMusicLoudness( inMusicLoudness ),
@@ -141,82 +204,41 @@ SoundPlayer::SoundPlayer( int inSampleRate,
       mPriorityFlags( new SimpleVector<char>() ),
       mSoundLoudnessModifiers( new SimpleVector<double>() ),      
       mSoundDroppedFlags( new SimpleVector<char>() ),
-      mFilterChain( new SimpleVector<SoundFilter *>() ) {
-
-    PaError error = Pa_Initialize();
-
-    if( error == paNoError ) {
-    
-        error = Pa_OpenStream(
-            &mAudioStream,
-            paNoDevice,// default input device 
-            0,              // no input 
-            paFloat32,  // 32 bit floating point input 
-            NULL,
-            Pa_GetDefaultOutputDeviceID(),
-            2,          // stereo output 
-            paFloat32,      // 32 bit floating point output 
-            NULL,
-            mSampleRate,
-            1024,   // frames per buffer
-            0,    // number of buffers, if zero then use default minimum 
-            paClipOff, // we won't output out of range samples so
-                       // don't bother clipping them 
-            portaudioCallback,
-            (void *)this );  // pass self-pointer to callback function
-        
-        if( error == paNoError ) {
-
-            error = Pa_StartStream( mAudioStream );
-            
-            if( error == paNoError ) {
-                mAudioInitialized = true;
-                }
-            else {
-                fprintf( stderr, "Error starting audio stream\n" );
-                Pa_CloseStream( mAudioStream );
-                }            
-            }
-        else {
-            fprintf( stderr, "Error opening audio stream\n" );
-            Pa_Terminate();
-            }
-        }
-    else {
-        fprintf( stderr, "Error initializing audio framework\n" );
+      mSoundFadePositions( new SimpleVector<unsigned long>() ),
+      // 1/10 second, about as long as our old fixed buffers
+      mDropFadeLength( inSampleRate / 10 + 1 ),
+      mFilterChain( new SimpleVector<SoundFilter *>() ),
+      mMaxActiveFilters( -1 ),
+      mNumFiltersApplied( 0 ),
+      mTelemetry( new AudioTelemetry() ),
+      mLastCallbackStartMicroseconds( -1 ) {
+
+    if( inLookaheadFrames > 0 ) {
+        mProducer = new AudioProducer( this, inFramesPerBlock,
+                                       inLookaheadFrames );
+
+        // fills the ring before the output starts taking from it
+        mProducer->start();
         }
-
     
-    if( error != paNoError ) {
-        fprintf( stderr, "Error number: %d\n", error );
-        fprintf( stderr, "Error message: %s\n", Pa_GetErrorText( error ) );
-        mAudioInitialized = false;
+    if( mOutput != NULL ) {
+        // on failure, the output stays quiet, as if there were none
+        mOutput->start( this );
         }
     }
 
 
 
 SoundPlayer::~SoundPlayer() {
-    if( mAudioInitialized ) {
-        PaError error = Pa_StopStream( mAudioStream );
-
-        if( error == paNoError ) {
-            error = Pa_CloseStream( mAudioStream );
-
-            if( error != paNoError ) {
-                fprintf( stderr, "Error closingaudio stream\n" );
-                }
-            }
-        else {
-            fprintf( stderr, "Error stopping audio stream\n" );
-            }
+    if( mOutput != NULL ) {
+        // no more calls to getSamples after this
+        mOutput->stop();
+        delete mOutput;
+        }
 
-        Pa_Terminate();
-        
-        if( error != paNoError ) {
-            fprintf( stderr, "Error number: %d\n", error);
-            fprintf( stderr, "Error message: %s\n", Pa_GetErrorText( error) );
-            }
+    if( mProducer != NULL ) {
+        // no more calls to mixSamples after this
+        delete mProducer;
         }
 
     delete mLock;
@@ -233,6 +255,7 @@ SoundPlayer::~SoundPlayer() {
     delete mPriorityFlags;
     delete mSoundLoudnessModifiers;
     delete mSoundDroppedFlags;
+    delete mSoundFadePositions;
     
     int numFilters = mFilterChain->size();
 
@@ -240,6 +263,8 @@ SoundPlayer::~SoundPlayer() {
         delete *( mFilterChain->getElement( i ) );
         }
     delete mFilterChain;
+
+    delete mTelemetry;
     }
 
 
@@ -264,12 +289,56 @@ void SoundPlayer::setMusicLoudness( double inMusicLoudness ) {
 void SoundPlayer::getSamples( void *outputBuffer,
                               unsigned long inFramesInBuffer ) {
 
-    SoundSamples *mixingBuffer = new SoundSamples( inFramesInBuffer );
+    if( mProducer != NULL ) {
+        mProducer->readSamples( (float *)outputBuffer, inFramesInBuffer );
+        }
+    else {
+        mixSamples( outputBuffer, inFramesInBuffer );
+        }
+    }
+
+
+
+void SoundPlayer::mixSamples( void *outputBuffer,
+                              unsigned long inFramesInBuffer ) {
+
+    // runs in the audio callback thread, in the producer thread when
+    // mixing ahead, or in the main thread when running without an
+    // audio device
+    FRAME_PROFILER_SCOPE( "audio" );
+    ALLOCATION_PROFILER_TAG( "audio" );
+
+    AudioCallbackRecord record;
+
+    record.mStartMicroseconds = FrameProfiler::getCurrentMicroseconds();
+    
+    record.mIntervalMicroseconds = 0;
+    if( mLastCallbackStartMicroseconds >= 0 ) {
+        record.mIntervalMicroseconds =
+            record.mStartMicroseconds - mLastCallbackStartMicroseconds;
+        }
+    mLastCallbackStartMicroseconds = record.mStartMicroseconds;
+
+    record.mNumFrames = inFramesInBuffer;
+    record.mDeadlineMicroseconds =
+        1000000.0 * (double)inFramesInBuffer / (double)mSampleRate;
+    
+    
+    // everything is mixed straight into the interleaved output, with
+    // no planar buffer to copy out of at the end
+    StereoSampleView output( (float *)outputBuffer, inFramesInBuffer );
+    output.clear();
 
     unsigned long bufferLength = inFramesInBuffer;
 
     
     mLock->lock();
+
+    record.mLockWaitMicroseconds =
+        FrameProfiler::getCurrentMicroseconds() - record.mStartMicroseconds;
+
+    record.mNumVoices = mRealtimeSounds->size();
+    record.mNumMusicNotes = 0;
     // add each pending realtime sound to the buffer
 
     int i = 0;
@@ -280,36 +349,41 @@ void SoundPlayer::getSamples( void *outputBuffer,
         
         PlayableSound *realtimeSound = *( mRealtimeSounds->getElement( i ) );
 
-        double loudnessModifier =
-            *( mSoundLoudnessModifiers->getElement( i ) );
-
-        SoundSamples *samples = realtimeSound->getMoreSamples( bufferLength );
-
-        unsigned long mixLength = samples->mSampleCount;
-
+        float loudnessModifier =
+            (float)*( mSoundLoudnessModifiers->getElement( i ) );
 
         char shouldDrop = *( mSoundDroppedFlags->getElement( i ) ); 
 
-        // fade out if we should drop
-        float fadeFactor = 1;
+        // fade out if we should drop, continuing the fade from where
+        // the last buffer left it, so that it takes the same time no
+        // matter how short the buffers are
+        unsigned long fadePosition = *( mSoundFadePositions->getElement( i ) );
 
-        unsigned long maxJ = mixLength - 1;
-
-        for( unsigned long j=0; j<mixLength; j++ ) {
-            mixingBuffer->mLeftChannel[j] +=
-                loudnessModifier * fadeFactor * samples->mLeftChannel[j];
-            mixingBuffer->mRightChannel[j] +=
-                loudnessModifier * fadeFactor * samples->mRightChannel[j];
+        float startGain = loudnessModifier;
+        float gainStep = 0;
+        
+        if( shouldDrop ) {
+            // the mixer ramps the gain down, stopping at 0
+            startGain = loudnessModifier *
+                ( mDropFadeLength - fadePosition ) / (float)mDropFadeLength;
+            gainStep = -loudnessModifier / (float)mDropFadeLength;
+            }
+        
+        unsigned long mixLength =
+            realtimeSound->mixMoreSamples( output, startGain, gainStep );
 
-            if( shouldDrop ) {
-                fadeFactor = ( maxJ - j ) / (float)maxJ;
+        if( shouldDrop ) {
+            fadePosition += mixLength;
+            if( fadePosition > mDropFadeLength ) {
+                fadePosition = mDropFadeLength;
                 }
             }
-
-        delete samples;
+        
+        *( mSoundFadePositions->getElement( i ) ) = fadePosition;
         
         
-        if( mixLength < bufferLength || shouldDrop ) {
+        if( mixLength < bufferLength ||
+            ( shouldDrop && fadePosition >= mDropFadeLength ) ) {
 
             // we have used up all samples of this sound or
             // it is flagged to be dropped
@@ -318,6 +392,7 @@ void SoundPlayer::getSamples( void *outputBuffer,
             mPriorityFlags->deleteElement( i );
             mSoundLoudnessModifiers->deleteElement( i );
             mSoundDroppedFlags->deleteElement( i );
+            mSoundFadePositions->deleteElement( i );
             
             // don't increment i, since the next element drops into the current
             // index
@@ -334,51 +409,73 @@ void SoundPlayer::getSamples( void *outputBuffer,
         MusicPlayer *player = (MusicPlayer *)mMusicPlayer;
 
         // mix in the music
-        SoundSamples *musicSamples =
-            player->getMoreMusic( inFramesInBuffer );
-
-        for( unsigned long j=0; j<inFramesInBuffer; j++ ) {
-            mixingBuffer->mLeftChannel[j] +=
-                musicSamples->mLeftChannel[j] * mMusicLoudness;
-            mixingBuffer->mRightChannel[j] +=
-                musicSamples->mRightChannel[j] * mMusicLoudness;
-            }
-        delete musicSamples;
+        player->mixMoreMusic( output, (float)mMusicLoudness );
+
+        record.mNumMusicNotes = player->getNumActiveNotes();
         }        
     
     
     // filter the samples
     int numFilters = mFilterChain->size();
-    SoundSamples *filteredSamples = new SoundSamples( mixingBuffer );
-    delete mixingBuffer;
+    if( mMaxActiveFilters >= 0 && numFilters > mMaxActiveFilters ) {
+        numFilters = mMaxActiveFilters;
+        }
+    record.mNumFilters = numFilters;
+
+    // filters coming back into the chain still hold sound from before
+    // they were skipped, which would play back as a burst of echoes
+    for( i=mNumFiltersApplied; i<numFilters; i++ ) {
+        ( *( mFilterChain->getElement( i ) ) )->reset();
+        }
+    mNumFiltersApplied = numFilters;
     
     for( i=0; i<numFilters; i++ ) {
         SoundFilter *filter = *( mFilterChain->getElement( i ) );
         
-        SoundSamples *nextOutput = filter->filterSamples( filteredSamples );
-
-        delete filteredSamples;
-
-        filteredSamples = nextOutput;
+        filter->filterSamplesInPlace( output );
         }
 
     mLock->unlock();
-    
-    
-    float *samples = (float *)outputBuffer;
 
-    unsigned long numSamples = 2 * bufferLength;
-    unsigned long j;
-    unsigned long frameNumber = 0;
-    for( j=0; j<numSamples; j+=2 ) {
 
-        samples[j] = filteredSamples->mLeftChannel[frameNumber];
-        samples[j+1] = filteredSamples->mRightChannel[frameNumber];
+    record.mWallMicroseconds =
+        FrameProfiler::getCurrentMicroseconds() - record.mStartMicroseconds;
+    record.mDeadlineMissed =
+        ( record.mWallMicroseconds > record.mDeadlineMicroseconds );
+
+    mTelemetry->addRecord( &record );
+    }
+
+
+
+void SoundPlayer::pullSamples( unsigned long inNumFrames ) {
+    float *buffer = new float[ 2 * inNumFrames ];
 
-        frameNumber++;
+    getSamples( (void *)buffer, inNumFrames );
+
+    if( mOutput != NULL ) {
+        mOutput->writeSamples( buffer, inNumFrames );
         }
-    
-    delete filteredSamples;        
+
+    delete [] buffer;
+    }
+
+
+
+SoundOutput *SoundPlayer::getOutput() {
+    return mOutput;
+    }
+
+
+
+AudioTelemetry *SoundPlayer::getTelemetry() {
+    return mTelemetry;
+    }
+
+
+
+AudioProducer *SoundPlayer::getProducer() {
+    return mProducer;
     }
 
 
@@ -430,6 +527,7 @@ void SoundPlayer::playSoundNow( SoundSamples *inSamples,
     mPriorityFlags->push_back( inPriorityFlag );
     mSoundLoudnessModifiers->push_back( inLoudnessModifier );
     mSoundDroppedFlags->push_back( false );
+    mSoundFadePositions->push_back( 0 );
 
     checkForExcessSounds();
     
@@ -447,6 +545,7 @@ void SoundPlayer::playSoundNow( PlayableSound *inSound,
     mPriorityFlags->push_back( inPriorityFlag );
     mSoundLoudnessModifiers->push_back( inLoudnessModifier );
     mSoundDroppedFlags->push_back( false );
+    mSoundFadePositions->push_back( 0 );
 
     checkForExcessSounds();
 
@@ -482,7 +581,26 @@ void SoundPlayer::removeAllFilters() {
         }
 
     mFilterChain->deleteAll();
+    mNumFiltersApplied = 0;
+
+    mLock->unlock();
+    }
+
+
 
+void SoundPlayer::setMaxSimultaneousRealtimeSounds(
+    int inMaxSimultaneousRealtimeSounds ) {
+
+    mLock->lock();
+    mMaxSimultaneousRealtimeSounds = inMaxSimultaneousRealtimeSounds;
+    mLock->unlock();
+    }
+
+
+
+void SoundPlayer::setMaxActiveFilters( int inMaxActiveFilters ) {
+    mLock->lock();
+    mMaxActiveFilters = inMaxActiveFilters;
     mLock->unlock();
     }
 
@@ -34,6 +34,15 @@
  *
  * 2004-August-31   Jason Rohrer
  * Added function for removing filters.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added option to run without an audio device.
+ * Added callback telemetry.
+ * Added adjustable limits on sounds and filters for quality control.
+ * Moved the PortAudio stream into a pluggable SoundOutput.
+ * Changed dropped sounds to fade out over a fixed time, whatever the
+ * buffer size.
+ * Added optional mixing ahead on a producer thread.
  */
 
 
@@ -45,9 +54,9 @@
 #include "SoundSamples.h"
 #include "SoundFilter.h"
 #include "PlayableSound.h"
-
-#include "Transcend/portaudio/pa_common/portaudio.h"
-#include "Transcend/portaudio/pablio/pablio.h"
+#include "AudioTelemetry.h"
+#include "SoundOutput.h"
+#include "AudioProducer.h"
 
 
 #include "minorGems/util/SimpleVector.h"
@@ -84,11 +93,26 @@ class SoundPlayer {
          *   Must be destroyed by caller after this class is destroyed.
          * @param inMusicLoudness an adjustment for music loudness in the
          *   range [0,1].  Defaults to 1.
+         * @param inOutput where to send the sound, or NULL for nowhere.
+         *   Outputs driven by the caller, and NULL, mix nothing until the
+         *   caller pulls samples with pullSamples or getSamples.
+         *   Defaults to NULL.
+         *   Will be destroyed by this class.
+         * @param inLookaheadFrames how far ahead of the output to mix on
+         *   a producer thread, or 0 to mix in getSamples itself.
+         *   Mixing ahead only helps outputs that pull samples on their
+         *   own thread.  Defaults to 0.
+         * @param inFramesPerBlock the number of frames the producer
+         *   thread mixes at a time, which should be the output's buffer
+         *   size.  Ignored if inLookaheadFrames is 0.  Defaults to 1024.
          */
         SoundPlayer( int inSampleRate,
                      int inMaxSimultaneousRealtimeSounds,
                      void *inMusicPlayer = NULL,
-                     double inMusicLoudness = 1 );
+                     double inMusicLoudness = 1,
+                     SoundOutput *inOutput = NULL,
+                     unsigned long inLookaheadFrames = 0,
+                     unsigned long inFramesPerBlock = 1024 );
 
         ~SoundPlayer();
 
@@ -157,11 +181,55 @@ class SoundPlayer {
 
 
         /**
-         * Called by the internal portaudio callback function.
+         * Called by outputs that pull samples themselves, or by the
+         * caller if this player's output is driven by the caller.
+         *
+         * When mixing ahead, only copies samples that the producer
+         * thread has already mixed, and never waits on a lock.
+         *
+         * @param outputBuffer buffer where interleaved stereo float
+         *   samples will be returned.
+         *   Must be destroyed by caller.
+         * @param inFramesInBuffer the number of stereo frames to return.
          */
         void getSamples( void *outputBuffer, unsigned long inFramesInBuffer );
 
 
+
+        /**
+         * Mixes samples on the calling thread.
+         *
+         * Called by getSamples, or by the producer thread when mixing
+         * ahead.  Each call is recorded in the telemetry.
+         *
+         * @param outputBuffer buffer where interleaved stereo float
+         *   samples will be returned.
+         *   Must be destroyed by caller.
+         * @param inFramesInBuffer the number of stereo frames to return.
+         */
+        void mixSamples( void *outputBuffer, unsigned long inFramesInBuffer );
+
+
+
+        /**
+         * Mixes samples on the calling thread and passes them to this
+         * player's output, for outputs driven by the caller.
+         *
+         * @param inNumFrames the number of stereo frames to mix.
+         */
+        void pullSamples( unsigned long inNumFrames );
+
+
+
+        /**
+         * Gets the output.
+         *
+         * @return the output, or NULL if there is none.
+         *   Will be destroyed by this class.
+         */
+        SoundOutput *getOutput();
+
+
         
         /**
          * Adds a filter to the end of the chain that will process
@@ -178,6 +246,32 @@ class SoundPlayer {
          * Removes and destroys all filters.
          */
         void removeAllFilters();
+
+
+
+        /**
+         * Sets the number of simultaneous realtime sounds to allow.
+         *
+         * Sounds already playing beyond a lowered limit are allowed to
+         * finish.
+         *
+         * @param inMaxSimultaneousRealtimeSounds the limit.
+         */
+        void setMaxSimultaneousRealtimeSounds(
+            int inMaxSimultaneousRealtimeSounds );
+
+
+
+        /**
+         * Sets how many filters at the start of the chain are applied.
+         * The rest are skipped, and are reset when they are applied
+         * again, so that they do not play back sound held from before
+         * they were skipped.
+         *
+         * @param inMaxActiveFilters the number of filters to apply, or
+         *   -1 to apply all of them.  Defaults to -1.
+         */
+        void setMaxActiveFilters( int inMaxActiveFilters );
         
 
 
@@ -188,6 +282,27 @@ class SoundPlayer {
          */
         unsigned long getSampleRate();
 
+
+
+        /**
+         * Gets the measurements of each call to getSamples.
+         *
+         * @return the telemetry ring, which should be read by only one
+         *   thread.
+         *   Will be destroyed by this class.
+         */
+        AudioTelemetry *getTelemetry();
+
+
+
+        /**
+         * Gets the producer that mixes ahead of the output.
+         *
+         * @return the producer, or NULL if mixing is not done ahead.
+         *   Will be destroyed by this class.
+         */
+        AudioProducer *getProducer();
+
         
         
     protected:
@@ -196,7 +311,11 @@ class SoundPlayer {
 
         unsigned long mSampleRate;
         
-        char mAudioInitialized;
+        // NULL for none
+        SoundOutput *mOutput;
+
+        // NULL if not mixing ahead
+        AudioProducer *mProducer;
 
         int mMaxSimultaneousRealtimeSounds;
 
@@ -204,8 +323,6 @@ class SoundPlayer {
         void *mMusicPlayer;
         double mMusicLoudness;
         
-        
-        PortAudioStream *mAudioStream;
 
         // realtime sounds that should be mixed into the next to-speaker call
         SimpleVector<PlayableSound *> *mRealtimeSounds;
@@ -216,12 +333,32 @@ class SoundPlayer {
         SimpleVector<double> *mSoundLoudnessModifiers;
         
         // one flag for each realtime sound, indicating whether it should
-        // be dropped (faded out) during the next frame 
+        // be dropped (faded out)
         SimpleVector<char> *mSoundDroppedFlags;
 
+        // one for each realtime sound, the number of frames of its fade
+        // that have been mixed so far
+        SimpleVector<unsigned long> *mSoundFadePositions;
+
+        // the length of the fade of a dropped sound, in frames
+        unsigned long mDropFadeLength;
+
         
         SimpleVector<SoundFilter *> *mFilterChain;
 
+        // -1 for all
+        int mMaxActiveFilters;
+
+        // how many filters the last call to mixSamples applied
+        int mNumFiltersApplied;
+
+        AudioTelemetry *mTelemetry;
+
+        // start time of the last call to mixSamples, or -1 before the
+        // first call
+        // only touched by the thread calling mixSamples
+        double mLastCallbackStartMicroseconds;
+
 
         
         /**
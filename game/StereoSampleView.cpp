@@ -0,0 +1,124 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "StereoSampleView.h"
+
+
+
+StereoSampleView::StereoSampleView( unsigned long inSampleCount,
+                                    float *inLeftChannel,
+                                    float *inRightChannel,
+                                    unsigned long inStride )
+    : mSampleCount( inSampleCount ),
+      mLeftChannel( inLeftChannel ),
+      mRightChannel( inRightChannel ),
+      mStride( inStride ) {
+
+    }
+
+
+
+StereoSampleView::StereoSampleView( SoundSamples *inSamples )
+    : mSampleCount( inSamples->mSampleCount ),
+      mLeftChannel( inSamples->mLeftChannel ),
+      mRightChannel( inSamples->mRightChannel ),
+      mStride( 1 ) {
+
+    }
+
+
+
+StereoSampleView::StereoSampleView( float *inFrames,
+                                    unsigned long inNumFrames )
+    : mSampleCount( inNumFrames ),
+      mLeftChannel( inFrames ),
+      mRightChannel( &( inFrames[1] ) ),
+      mStride( 2 ) {
+
+    }
+
+
+
+StereoSampleView StereoSampleView::getRegion( unsigned long inStartSample,
+                                              unsigned long inSampleCount ) {
+    unsigned long offset = inStartSample * mStride;
+    
+    return StereoSampleView( inSampleCount,
+                             &( mLeftChannel[ offset ] ),
+                             &( mRightChannel[ offset ] ),
+                             mStride );
+    }
+
+
+
+void StereoSampleView::clear() {
+    unsigned long end = mSampleCount * mStride;
+    
+    for( unsigned long i=0; i<end; i+=mStride ) {
+        mLeftChannel[i] = 0;
+        mRightChannel[i] = 0;
+        }
+    }
+
+
+
+void StereoSampleView::copy( StereoSampleView inSource ) {
+    unsigned long numSamples = mSampleCount;
+    if( inSource.mSampleCount < numSamples ) {
+        numSamples = inSource.mSampleCount;
+        }
+
+    unsigned long stride = mStride;
+    unsigned long sourceStride = inSource.mStride;
+    
+    float *sourceLeft = inSource.mLeftChannel;
+    float *sourceRight = inSource.mRightChannel;
+    
+    for( unsigned long i=0; i<numSamples; i++ ) {
+        mLeftChannel[ i * stride ] = sourceLeft[ i * sourceStride ];
+        mRightChannel[ i * stride ] = sourceRight[ i * sourceStride ];
+        }
+    }
+
+
+
+void StereoSampleView::mix( StereoSampleView inSource, float inStartGain,
+                            float inGainStep ) {
+    unsigned long numSamples = mSampleCount;
+    if( inSource.mSampleCount < numSamples ) {
+        numSamples = inSource.mSampleCount;
+        }
+
+    unsigned long stride = mStride;
+    unsigned long sourceStride = inSource.mStride;
+    
+    float *sourceLeft = inSource.mLeftChannel;
+    float *sourceRight = inSource.mRightChannel;
+
+    if( inGainStep == 0 ) {
+        // the common case, with no fade to track
+        for( unsigned long i=0; i<numSamples; i++ ) {
+            mLeftChannel[ i * stride ] +=
+                inStartGain * sourceLeft[ i * sourceStride ];
+            mRightChannel[ i * stride ] +=
+                inStartGain * sourceRight[ i * sourceStride ];
+            }
+        return;
+        }
+    
+    for( unsigned long i=0; i<numSamples; i++ ) {
+        float gain = inStartGain + i * inGainStep;
+        if( gain < 0 ) {
+            gain = 0;
+            }
+        
+        mLeftChannel[ i * stride ] += gain * sourceLeft[ i * sourceStride ];
+        mRightChannel[ i * stride ] += gain * sourceRight[ i * sourceStride ];
+        }
+    }
@@ -0,0 +1,138 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef STEREO_SAMPLE_VIEW_INCLUDED
+#define STEREO_SAMPLE_VIEW_INCLUDED
+
+
+
+#include "SoundSamples.h"
+
+
+
+/**
+ * A window onto stereo samples that are stored elsewhere, either planar
+ * (in the two channel arrays of a SoundSamples) or interleaved (left and
+ * right alternating, as PortAudio wants them).
+ *
+ * Sample i of the left channel is mLeftChannel[ i * mStride ], and the
+ * same for the right, so mixing code written against a view works on
+ * either layout.  Sounds can then be mixed straight into the output
+ * buffer instead of into a planar buffer that is copied out at the end.
+ *
+ * Views are small and meant to be passed by value.
+ *
+ * @author Jason Rohrer
+ */
+class StereoSampleView {
+
+
+    public:
+
+        unsigned long mSampleCount;
+
+        float *mLeftChannel;
+        float *mRightChannel;
+
+        // distance between neighboring samples of one channel
+        unsigned long mStride;
+
+
+        
+        /**
+         * Constructs a view with an arbitrary layout.
+         *
+         * @param inSampleCount the number of samples in each channel.
+         * @param inLeftChannel the first left sample.
+         *   Must be destroyed by caller after this view is last used.
+         * @param inRightChannel the first right sample.
+         *   Must be destroyed by caller after this view is last used.
+         * @param inStride the distance between neighboring samples of
+         *   one channel.
+         */
+        StereoSampleView( unsigned long inSampleCount,
+                          float *inLeftChannel, float *inRightChannel,
+                          unsigned long inStride );
+
+
+        
+        /**
+         * Constructs a view of planar samples.
+         *
+         * @param inSamples the samples.
+         *   Must be destroyed by caller after this view is last used.
+         */
+        StereoSampleView( SoundSamples *inSamples );
+
+
+        
+        /**
+         * Constructs a view of interleaved samples.
+         *
+         * @param inFrames the samples, left first.
+         *   Must be destroyed by caller after this view is last used.
+         * @param inNumFrames the number of stereo frames in inFrames.
+         */
+        StereoSampleView( float *inFrames, unsigned long inNumFrames );
+
+
+        
+        /**
+         * Gets a view of part of this view.
+         *
+         * @param inStartSample the first sample of the part.
+         * @param inSampleCount the number of samples in the part.
+         *
+         * @return the part.
+         */
+        StereoSampleView getRegion( unsigned long inStartSample,
+                                    unsigned long inSampleCount );
+
+
+        
+        /**
+         * Sets every sample in this view to 0.
+         */
+        void clear();
+
+
+        
+        /**
+         * Copies samples into this view.
+         *
+         * @param inSource the samples to copy, in any layout.  Only as
+         *   many as fit in both views are copied.
+         */
+        void copy( StereoSampleView inSource );
+
+
+        
+        /**
+         * Adds samples to this view, scaled by a gain that changes linearly
+         * from sample to sample and stops at 0.
+         *
+         * Sample i is scaled by inStartGain + i * inGainStep, or by 0 if
+         * that is negative, which makes fade outs a single pass.
+         *
+         * @param inSource the samples to add, in any layout.  Only as
+         *   many as fit in both views are added.
+         * @param inStartGain the gain for the first sample.
+         * @param inGainStep the change in gain from one sample to the next.
+         *   Defaults to 0.
+         */
+        void mix( StereoSampleView inSource, float inStartGain,
+                  float inGainStep = 0 );
+
+
+        
+    };
+
+
+
+#endif
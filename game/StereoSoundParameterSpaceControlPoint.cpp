@@ -9,6 +9,9 @@
  *
  * 2004-August-15   Jason Rohrer
  * Added function that generates a playable sound.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added mixing into a view of another buffer.
  */
 
 
@@ -108,6 +111,32 @@ SoundSamples *StereoSoundParameterSpaceControlPoint::getSoundSamples(
 
 
 
+void StereoSoundParameterSpaceControlPoint::mixSoundSamples(
+    StereoSampleView inOutSamples,
+    float inStartGain,
+    float inGainStep,
+    unsigned long inStartSample,
+    unsigned long inSamplesPerSecond,
+    double inSoundLengthInSeconds ) {
+
+    mLeftPoint->mixSoundSamples( inOutSamples.mLeftChannel,
+                                 inOutSamples.mStride,
+                                 inStartGain, inGainStep,
+                                 inStartSample,
+                                 inOutSamples.mSampleCount,
+                                 inSamplesPerSecond,
+                                 inSoundLengthInSeconds );
+    mRightPoint->mixSoundSamples( inOutSamples.mRightChannel,
+                                  inOutSamples.mStride,
+                                  inStartGain, inGainStep,
+                                  inStartSample,
+                                  inOutSamples.mSampleCount,
+                                  inSamplesPerSecond,
+                                  inSoundLengthInSeconds );
+    }
+
+
+
 PlayableSound *StereoSoundParameterSpaceControlPoint::getPlayableSound(
     unsigned long inSamplesPerSecond,
     double inSoundLengthInSeconds ) {
@@ -9,6 +9,9 @@
  *
  * 2004-August-15   Jason Rohrer
  * Added function that generates a playable sound.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Added mixing into a view of another buffer.
  */
 
 
@@ -20,6 +23,7 @@
 #include "ParameterSpaceControlPoint.h"
 #include "SoundParameterSpaceControlPoint.h"
 #include "SoundSamples.h"
+#include "StereoSampleView.h"
 #include "PlayableSound.h"
 
 
@@ -99,6 +103,30 @@ class StereoSoundParameterSpaceControlPoint :
                                        unsigned long inSamplesPerSecond,
                                        double inSoundLengthInSeconds );
 
+
+
+        
+        /**
+         * Adds a block of samples from this control point to a buffer,
+         * rendering each channel straight into it.
+         *
+         * @param inOutSamples the buffer to add to, whose sample count is
+         *   the number of samples to get.
+         * @param inStartGain the gain for the first sample.
+         * @param inGainStep the change in gain from one sample to the
+         *   next, as for StereoSampleView::mix.
+         * @param inStartSample the index of the first sample to get.
+         * @param inSamplesPerSecond the current sample rate.
+         * @param inSoundLengthInSeconds the total length of the sound being
+         *   played.
+         */
+        void mixSoundSamples( StereoSampleView inOutSamples,
+                              float inStartGain,
+                              float inGainStep,
+                              unsigned long inStartSample,
+                              unsigned long inSamplesPerSecond,
+                              double inSoundLengthInSeconds );
+
         
 
         /**
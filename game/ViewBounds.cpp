@@ -0,0 +1,145 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "ViewBounds.h"
+
+
+#include <GL/gl.h>
+#include <math.h>
+
+
+
+ViewBounds::ViewBounds( double inMinX, double inMinY,
+                        double inMaxX, double inMaxY,
+                        double inPixelsPerUnit )
+    : mMinX( inMinX ), mMinY( inMinY ),
+      mMaxX( inMaxX ), mMaxY( inMaxY ),
+      mPixelsPerUnit( inPixelsPerUnit ) {
+
+    }
+
+
+
+/**
+ * Finds the point on the game plane that a screen corner shows.
+ *
+ * @param inMatrix the projection times the modelview matrix, in GL's
+ *   column-major order.
+ *   Must be destroyed by caller.
+ * @param inScreenX the x position on screen, in [-1,1].
+ * @param inScreenY the y position on screen, in [-1,1].
+ * @param outX pointer to where the x position on the plane should be
+ *   returned.
+ * @param outY pointer to where the y position on the plane should be
+ *   returned.
+ *
+ * @return true if the point is in front of the view.
+ */
+static char unprojectToPlane( double *inMatrix,
+                              double inScreenX, double inScreenY,
+                              double *outX, double *outY ) {
+
+    // (x, y, 0, 1) lands on (inScreenX, inScreenY) where
+    //   clipX = inScreenX * clipW  and  clipY = inScreenY * clipW
+    double *m = inMatrix;
+
+    double a = m[0] - inScreenX * m[3];
+    double b = m[4] - inScreenX * m[7];
+    double c = inScreenX * m[15] - m[12];
+
+    double d = m[1] - inScreenY * m[3];
+    double e = m[5] - inScreenY * m[7];
+    double f = inScreenY * m[15] - m[13];
+
+    double determinant = a * e - b * d;
+
+    if( fabs( determinant ) < 1e-12 ) {
+        // looking along the plane
+        return false;
+        }
+
+    *outX = ( c * e - b * f ) / determinant;
+    *outY = ( a * f - c * d ) / determinant;
+
+    double clipW = m[3] * *outX + m[7] * *outY + m[15];
+
+    return ( clipW > 0 );
+    }
+
+
+
+ViewBounds *ViewBounds::readFromGL() {
+    double projection[16];
+    double modelview[16];
+
+    glGetDoublev( GL_PROJECTION_MATRIX, projection );
+    glGetDoublev( GL_MODELVIEW_MATRIX, modelview );
+
+    double matrix[16];
+
+    for( int column=0; column<4; column++ ) {
+        for( int row=0; row<4; row++ ) {
+            double sum = 0;
+
+            for( int k=0; k<4; k++ ) {
+                sum += projection[ k * 4 + row ] * modelview[ column * 4 + k ];
+                }
+
+            matrix[ column * 4 + row ] = sum;
+            }
+        }
+
+    double minX = HUGE_VAL;
+    double minY = HUGE_VAL;
+    double maxX = -HUGE_VAL;
+    double maxY = -HUGE_VAL;
+
+    for( int corner=0; corner<4; corner++ ) {
+        double screenX = ( corner & 1 ) ? 1 : -1;
+        double screenY = ( corner & 2 ) ? 1 : -1;
+
+        double x, y;
+
+        if( ! unprojectToPlane( matrix, screenX, screenY, &x, &y ) ) {
+            return NULL;
+            }
+
+        if( x < minX ) {
+            minX = x;
+            }
+        if( x > maxX ) {
+            maxX = x;
+            }
+        if( y < minY ) {
+            minY = y;
+            }
+        if( y > maxY ) {
+            maxY = y;
+            }
+        }
+
+    GLint viewport[4];
+    glGetIntegerv( GL_VIEWPORT, viewport );
+
+    double pixelsPerUnit = 0;
+    if( maxX > minX ) {
+        pixelsPerUnit = viewport[2] / ( maxX - minX );
+        }
+
+    return new ViewBounds( minX, minY, maxX, maxY, pixelsPerUnit );
+    }
+
+
+
+char ViewBounds::isCircleVisible( Vector3D *inCenter, double inRadius ) {
+    return ( inCenter->mX + inRadius >= mMinX &&
+             inCenter->mX - inRadius <= mMaxX &&
+             inCenter->mY + inRadius >= mMinY &&
+             inCenter->mY - inRadius <= mMaxY );
+    }
@@ -0,0 +1,87 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef VIEW_BOUNDS_INCLUDED
+#define VIEW_BOUNDS_INCLUDED
+
+
+
+#include "minorGems/math/geometry/Vector3D.h"
+
+
+
+/**
+ * The part of the game plane (z = 0) that is on screen, as an
+ * axis-aligned rectangle, for skipping objects that cannot be seen.
+ *
+ * When the view is rotated, the rectangle bounds the rotated screen, so
+ * it can contain a little that is off screen, but never misses anything
+ * that is on screen.
+ *
+ * @author Jason Rohrer
+ */
+class ViewBounds {
+
+
+
+    public:
+
+        /**
+         * Constructs bounds from a rectangle.
+         *
+         * @param inMinX the left edge of the rectangle.
+         * @param inMinY the bottom edge of the rectangle.
+         * @param inMaxX the right edge of the rectangle.
+         * @param inMaxY the top edge of the rectangle.
+         * @param inPixelsPerUnit how many pixels one world unit covers on
+         *   screen.
+         */
+        ViewBounds( double inMinX, double inMinY,
+                    double inMaxX, double inMaxY,
+                    double inPixelsPerUnit );
+
+
+
+        /**
+         * Reads the bounds of the current view from the GL projection
+         * and modelview matrices and viewport, as set up for drawScene.
+         *
+         * @return the bounds, or NULL if the view does not look at the
+         *   game plane, in which case nothing should be skipped.
+         *   Must be destroyed by caller.
+         */
+        static ViewBounds *readFromGL();
+
+
+
+        /**
+         * Gets whether any part of a circle on the game plane may be on
+         * screen.
+         *
+         * @param inCenter the center of the circle.
+         *   Must be destroyed by caller.
+         * @param inRadius the radius of the circle.
+         *
+         * @return true if the circle overlaps these bounds.
+         */
+        char isCircleVisible( Vector3D *inCenter, double inRadius );
+
+
+
+        double mMinX, mMinY, mMaxX, mMaxY;
+
+        // across the width of the bounds, so an underestimate when the
+        // view is rotated
+        double mPixelsPerUnit;
+
+    };
+
+
+
+#endif
@@ -0,0 +1,388 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#include "WorkStealingThreadPool.h"
+
+
+#include "minorGems/system/Thread.h"
+
+
+#ifdef WIN_32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+
+
+/**
+ * A thread that runs jobs from a pool until the pool stops.
+ */
+class WorkStealingWorkerThread : public Thread {
+
+    public:
+
+        WorkStealingWorkerThread( WorkStealingThreadPool *inPool,
+                                  int inThreadIndex )
+            : mPool( inPool ), mThreadIndex( inThreadIndex ) {
+            }
+
+        // implements the Thread interface
+        virtual void run();
+
+    protected:
+        WorkStealingThreadPool *mPool;
+        int mThreadIndex;
+    };
+
+
+
+void WorkStealingWorkerThread::run() {
+    mPool->runWorker( mThreadIndex );
+    }
+
+
+
+ThreadPoolJobGroup::ThreadPoolJobGroup()
+    : mNumUnfinishedJobs( 0 ),
+      mWaitingThreadIndex( 0 ),
+      mLock( new MutexLock() ) {
+
+    }
+
+
+
+ThreadPoolJobGroup::~ThreadPoolJobGroup() {
+    delete mLock;
+    }
+
+
+
+void ThreadPoolJobGroup::addJobs( int inNumJobs ) {
+    mLock->lock();
+    mNumUnfinishedJobs += inNumJobs;
+    mLock->unlock();
+    }
+
+
+
+char ThreadPoolJobGroup::finishJob( int *outWaitingThreadIndex ) {
+    mLock->lock();
+    mNumUnfinishedJobs--;
+    char done = ( mNumUnfinishedJobs == 0 );
+    *outWaitingThreadIndex = mWaitingThreadIndex;
+    mLock->unlock();
+
+    return done;
+    }
+
+
+
+void ThreadPoolJobGroup::setWaitingThread( int inThreadIndex ) {
+    mLock->lock();
+    mWaitingThreadIndex = inThreadIndex;
+    mLock->unlock();
+    }
+
+
+
+char ThreadPoolJobGroup::isDone() {
+    mLock->lock();
+    char done = ( mNumUnfinishedJobs == 0 );
+    mLock->unlock();
+
+    return done;
+    }
+
+
+
+ThreadPoolJob::ThreadPoolJob()
+    : mGroup( NULL ) {
+
+    }
+
+
+
+ThreadPoolJob::~ThreadPoolJob() {
+    }
+
+
+
+WorkStealingThreadPool::WorkStealingThreadPool( int inNumThreads )
+    : mNumThreads( inNumThreads ),
+      mIdleLock( new MutexLock() ),
+      mStopping( false ) {
+
+    if( mNumThreads < 1 ) {
+        mNumThreads = 1;
+        }
+
+    mQueues = new SimpleVector<ThreadPoolJob *>*[ mNumThreads ];
+    mQueueLocks = new MutexLock*[ mNumThreads ];
+    mWakeSemaphores = new Semaphore*[ mNumThreads ];
+    mIdleFlags = new char[ mNumThreads ];
+    mWorkerThreads = new WorkStealingWorkerThread*[ mNumThreads ];
+
+    int i;
+    for( i=0; i<mNumThreads; i++ ) {
+        mQueues[i] = new SimpleVector<ThreadPoolJob *>();
+        mQueueLocks[i] = new MutexLock();
+        mWakeSemaphores[i] = new Semaphore();
+        mIdleFlags[i] = false;
+        mWorkerThreads[i] = NULL;
+        }
+
+    // start workers only after all of their state exists
+    for( i=1; i<mNumThreads; i++ ) {
+        mWorkerThreads[i] = new WorkStealingWorkerThread( this, i );
+        mWorkerThreads[i]->start();
+        }
+    }
+
+
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    mIdleLock->lock();
+    mStopping = true;
+    mIdleLock->unlock();
+
+    int i;
+    for( i=1; i<mNumThreads; i++ ) {
+        mWakeSemaphores[i]->signal();
+        }
+
+    for( i=1; i<mNumThreads; i++ ) {
+        mWorkerThreads[i]->join();
+        delete mWorkerThreads[i];
+        }
+
+    for( i=0; i<mNumThreads; i++ ) {
+        delete mQueues[i];
+        delete mQueueLocks[i];
+        delete mWakeSemaphores[i];
+        }
+
+    delete [] mQueues;
+    delete [] mQueueLocks;
+    delete [] mWakeSemaphores;
+    delete [] mIdleFlags;
+    delete [] mWorkerThreads;
+
+    delete mIdleLock;
+    }
+
+
+
+int WorkStealingThreadPool::getNumThreads() {
+    return mNumThreads;
+    }
+
+
+
+void WorkStealingThreadPool::addJob( ThreadPoolJob *inJob,
+                                     ThreadPoolJobGroup *inGroup,
+                                     int inThreadIndex ) {
+    inJob->mGroup = inGroup;
+
+    mQueueLocks[ inThreadIndex ]->lock();
+    mQueues[ inThreadIndex ]->push_back( inJob );
+    mQueueLocks[ inThreadIndex ]->unlock();
+
+    wakeIdleThread();
+    }
+
+
+
+ThreadPoolJob *WorkStealingThreadPool::takeJob( int inThreadIndex ) {
+    ThreadPoolJob *job = NULL;
+
+    // newest job from our own queue
+    SimpleVector<ThreadPoolJob *> *queue = mQueues[ inThreadIndex ];
+
+    mQueueLocks[ inThreadIndex ]->lock();
+    int size = queue->size();
+    if( size > 0 ) {
+        job = *( queue->getElement( size - 1 ) );
+        queue->deleteElement( size - 1 );
+        }
+    mQueueLocks[ inThreadIndex ]->unlock();
+
+    if( job != NULL ) {
+        return job;
+        }
+
+
+    // oldest job from another thread's queue, starting with our neighbor
+    for( int i=1; i<mNumThreads && job == NULL; i++ ) {
+        int victim = ( inThreadIndex + i ) % mNumThreads;
+
+        queue = mQueues[ victim ];
+
+        mQueueLocks[ victim ]->lock();
+        if( queue->size() > 0 ) {
+            job = *( queue->getElement( 0 ) );
+            queue->deleteElement( 0 );
+            }
+        mQueueLocks[ victim ]->unlock();
+        }
+
+    return job;
+    }
+
+
+
+void WorkStealingThreadPool::runJob( ThreadPoolJob *inJob,
+                                     int inThreadIndex ) {
+    ThreadPoolJobGroup *group = inJob->mGroup;
+
+    inJob->run( inThreadIndex );
+
+    int waitingThreadIndex;
+    
+    if( group->finishJob( &waitingThreadIndex ) ) {
+        wakeThreadIfIdle( waitingThreadIndex );
+        }
+    }
+
+
+
+void WorkStealingThreadPool::setIdle( int inThreadIndex, char inIdle ) {
+    mIdleLock->lock();
+    mIdleFlags[ inThreadIndex ] = inIdle;
+    mIdleLock->unlock();
+    }
+
+
+
+void WorkStealingThreadPool::wakeIdleThread() {
+    mIdleLock->lock();
+
+    for( int i=0; i<mNumThreads; i++ ) {
+        if( mIdleFlags[i] ) {
+            // clear flag here so that two wake-ups don't go to the
+            // same thread
+            mIdleFlags[i] = false;
+            mWakeSemaphores[i]->signal();
+            break;
+            }
+        }
+
+    mIdleLock->unlock();
+    }
+
+
+
+void WorkStealingThreadPool::wakeThreadIfIdle( int inThreadIndex ) {
+    mIdleLock->lock();
+
+    if( mIdleFlags[ inThreadIndex ] ) {
+        mIdleFlags[ inThreadIndex ] = false;
+        mWakeSemaphores[ inThreadIndex ]->signal();
+        }
+
+    mIdleLock->unlock();
+    }
+
+
+
+void WorkStealingThreadPool::runUntilDone( ThreadPoolJobGroup *inGroup,
+                                           int inThreadIndex ) {
+
+    inGroup->setWaitingThread( inThreadIndex );
+    
+    while( ! inGroup->isDone() ) {
+
+        ThreadPoolJob *job = takeJob( inThreadIndex );
+
+        if( job != NULL ) {
+            runJob( job, inThreadIndex );
+            }
+        else {
+            // mark ourself idle before checking again, so that a job
+            // added or finished after the check is sure to wake us
+            setIdle( inThreadIndex, true );
+
+            if( inGroup->isDone() ) {
+                setIdle( inThreadIndex, false );
+                }
+            else {
+                job = takeJob( inThreadIndex );
+
+                if( job != NULL ) {
+                    setIdle( inThreadIndex, false );
+                    runJob( job, inThreadIndex );
+                    }
+                else {
+                    mWakeSemaphores[ inThreadIndex ]->wait();
+                    }
+                }
+            }
+        }
+
+    // a wake-up that arrives after we stop waiting is left on the
+    // semaphore and only causes one extra pass through the loop above
+    // during the next call
+    }
+
+
+
+void WorkStealingThreadPool::runWorker( int inThreadIndex ) {
+
+    while( true ) {
+
+        ThreadPoolJob *job = takeJob( inThreadIndex );
+
+        if( job != NULL ) {
+            runJob( job, inThreadIndex );
+            continue;
+            }
+
+        // same idle protocol as runUntilDone
+        mIdleLock->lock();
+        if( mStopping ) {
+            mIdleLock->unlock();
+            return;
+            }
+        mIdleFlags[ inThreadIndex ] = true;
+        mIdleLock->unlock();
+
+        job = takeJob( inThreadIndex );
+
+        if( job != NULL ) {
+            setIdle( inThreadIndex, false );
+            runJob( job, inThreadIndex );
+            }
+        else {
+            mWakeSemaphores[ inThreadIndex ]->wait();
+            }
+        }
+    }
+
+
+
+int WorkStealingThreadPool::getNumProcessors() {
+    int numProcessors = 1;
+
+    #ifdef WIN_32
+        SYSTEM_INFO info;
+        GetSystemInfo( &info );
+        numProcessors = (int)( info.dwNumberOfProcessors );
+    #else
+        long count = sysconf( _SC_NPROCESSORS_ONLN );
+        if( count > 0 ) {
+            numProcessors = (int)count;
+            }
+    #endif
+
+    if( numProcessors < 1 ) {
+        numProcessors = 1;
+        }
+
+    return numProcessors;
+    }
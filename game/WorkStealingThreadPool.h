@@ -0,0 +1,304 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+#ifndef WORK_STEALING_THREAD_POOL_INCLUDED
+#define WORK_STEALING_THREAD_POOL_INCLUDED
+
+
+
+#include "minorGems/util/SimpleVector.h"
+#include "minorGems/system/MutexLock.h"
+#include "minorGems/system/Semaphore.h"
+
+
+
+class WorkStealingWorkerThread;
+
+
+
+/**
+ * Counts the unfinished jobs of one batch submitted to a thread pool.
+ *
+ * @author Jason Rohrer.
+ */
+class ThreadPoolJobGroup {
+
+
+    public:
+
+        ThreadPoolJobGroup();
+
+        ~ThreadPoolJobGroup();
+
+
+
+        /**
+         * Adds to the number of unfinished jobs.
+         *
+         * Must be called before the jobs are submitted.
+         *
+         * @param inNumJobs the number of jobs being added.
+         */
+        void addJobs( int inNumJobs );
+
+
+
+        /**
+         * Marks one job as finished.
+         *
+         * @param outWaitingThreadIndex pointer to where the index of the
+         *   thread waiting on this group should be returned.
+         *
+         * @return true if this was the last unfinished job.
+         */
+        char finishJob( int *outWaitingThreadIndex );
+
+
+
+        /**
+         * Sets the thread that waits for this group to finish.
+         *
+         * @param inThreadIndex the index of the waiting thread.
+         */
+        void setWaitingThread( int inThreadIndex );
+
+
+
+        /**
+         * Gets whether all jobs have finished.
+         *
+         * @return true if no jobs are unfinished.
+         */
+        char isDone();
+
+
+
+    protected:
+
+        int mNumUnfinishedJobs;
+
+        // woken when the last job finishes
+        int mWaitingThreadIndex;
+
+        MutexLock *mLock;
+
+    };
+
+
+
+/**
+ * One unit of work run by a thread pool.
+ *
+ * Subclasses implement run.
+ *
+ * @author Jason Rohrer.
+ */
+class ThreadPoolJob {
+
+
+    public:
+
+        ThreadPoolJob();
+
+        virtual ~ThreadPoolJob();
+
+
+
+        /**
+         * Performs the work of this job.
+         *
+         * @param inThreadIndex the index of the pool thread running this
+         *   job, in [0, number of pool threads).  Jobs can use this
+         *   to pick per-thread scratch space.
+         */
+        virtual void run( int inThreadIndex ) = 0;
+
+
+
+        // the group this job was submitted with
+        // set by WorkStealingThreadPool::addJob
+        ThreadPoolJobGroup *mGroup;
+
+    };
+
+
+
+/**
+ * A fixed set of threads that run short jobs, such as the updates
+ * within one simulation step.
+ *
+ * Each thread has its own queue of jobs.  A thread runs the newest job
+ * in its own queue first, and when its queue is empty, it steals the
+ * oldest job from the queue of another thread.  Jobs that submit further
+ * jobs (like finished tasks that free up their dependents) thus keep
+ * related work on the same thread while idle threads pick up the rest.
+ *
+ * The thread that constructs the pool counts as pool thread 0 and runs
+ * jobs while it waits in runUntilDone.  Jobs can also submit jobs of
+ * their own and wait for them in runUntilDone, running other jobs in
+ * the meantime.
+ *
+ * @author Jason Rohrer.
+ */
+class WorkStealingThreadPool {
+
+
+    public:
+
+
+
+        /**
+         * Constructs a pool, starting its worker threads.
+         *
+         * @param inNumThreads the number of threads that run jobs,
+         *   including the calling thread.  1 runs all jobs on the
+         *   calling thread inside runUntilDone.
+         */
+        WorkStealingThreadPool( int inNumThreads );
+
+
+
+        /**
+         * Stops and joins the worker threads.
+         *
+         * No jobs may be unfinished.
+         */
+        ~WorkStealingThreadPool();
+
+
+
+        /**
+         * Gets the number of threads that run jobs.
+         *
+         * @return the number of threads, including the calling thread.
+         */
+        int getNumThreads();
+
+
+
+        /**
+         * Submits a job.
+         *
+         * Can be called by any pool thread, including from inside a
+         * running job.
+         *
+         * @param inJob the job to run.
+         *   Must be destroyed by caller after it has run.
+         * @param inGroup the group to count this job in.  addJobs must
+         *   already have been called on the group for this job.
+         *   Must be destroyed by caller after its jobs have finished.
+         * @param inThreadIndex the thread whose queue should get this job
+         *   (usually the calling thread).
+         */
+        void addJob( ThreadPoolJob *inJob, ThreadPoolJobGroup *inGroup,
+                     int inThreadIndex );
+
+
+
+        /**
+         * Runs jobs on the calling thread until all jobs in a group
+         * have finished.
+         *
+         * @param inGroup the group to wait for.
+         *   Must be destroyed by caller.
+         * @param inThreadIndex the index of the calling thread, which
+         *   is 0 unless called from inside a job.
+         *   Defaults to 0.
+         */
+        void runUntilDone( ThreadPoolJobGroup *inGroup,
+                           int inThreadIndex = 0 );
+
+
+
+        /**
+         * Called by worker threads to do their work.
+         *
+         * @param inThreadIndex the index of the calling worker thread.
+         */
+        void runWorker( int inThreadIndex );
+
+
+
+        /**
+         * Gets the number of processors available to this process.
+         *
+         * @return the number of processors, or 1 if it cannot be
+         *   determined.
+         */
+        static int getNumProcessors();
+
+
+
+    protected:
+
+        int mNumThreads;
+
+        // one queue for each thread, each with its own lock
+        SimpleVector<ThreadPoolJob *> **mQueues;
+        MutexLock **mQueueLocks;
+
+        // one wake-up semaphore for each thread
+        Semaphore **mWakeSemaphores;
+
+        // protects mIdleFlags and mStopping
+        MutexLock *mIdleLock;
+
+        // true for threads that are waiting on their semaphore
+        char *mIdleFlags;
+
+        char mStopping;
+
+        // element 0 is NULL, since thread 0 is the calling thread
+        WorkStealingWorkerThread **mWorkerThreads;
+
+
+
+        /**
+         * Takes the next job for a thread, stealing from other threads
+         * if the thread's own queue is empty.
+         *
+         * @param inThreadIndex the thread.
+         *
+         * @return the job, or NULL if all queues are empty.
+         */
+        ThreadPoolJob *takeJob( int inThreadIndex );
+
+
+
+        /**
+         * Runs a job and marks it finished in its group.
+         */
+        void runJob( ThreadPoolJob *inJob, int inThreadIndex );
+
+
+
+        /**
+         * Marks a thread as idle or busy.
+         */
+        void setIdle( int inThreadIndex, char inIdle );
+
+
+
+        /**
+         * Wakes one idle thread, if any are idle.
+         */
+        void wakeIdleThread();
+
+
+
+        /**
+         * Wakes a specific thread if it is idle.
+         */
+        void wakeThreadIfIdle( int inThreadIndex );
+
+    };
+
+
+
+#endif
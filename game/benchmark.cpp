@@ -0,0 +1,1782 @@
+/*
+ * Modification History
+ *
+ * 2026-October-19   Jason Rohrer
+ * Created.
+ */
+
+
+
+/*
+ * Micro-benchmarks of the game's core primitives, run on the objects of
+ * a shipped level.
+ *
+ * Built with "make bench".  Run from the directory that contains
+ * "levels":
+ *
+ *   TranscendBench [-level 001] [-minTime 500] [-filter name]
+ *                  [-json results.json] [-detailCheck 0.05]
+ *
+ * Each benchmark is timed over several samples, each long enough to make
+ * clock resolution insignificant, and reports the median time per
+ * operation.  Allocations per operation are counted with the
+ * AllocationProfiler, which is always compiled into this target.
+ *
+ * With -detailCheck, the level's bullets and enemies are instead drawn
+ * into images in software at a range of small sizes, both at full and at
+ * reduced detail, and the run fails if any pair of images differs by more
+ * than the given fraction of the object's area.
+ */
+
+
+
+#include "ParameterizedObject.h"
+#include "ObjectParameterSpaceControlPoint.h"
+#include "DrawableObject.h"
+#include "SoundParameterSpaceControlPoint.h"
+#include "SoundSamples.h"
+#include "StereoSampleView.h"
+#include "ReverbSoundFilter.h"
+#include "MusicNoteWaveTable.h"
+#include "MusicPart.h"
+#include "MusicPlayer.h"
+#include "SculptureManager.h"
+#include "GridRenderer.h"
+#include "ShipBullet.h"
+#include "ShipBulletManager.h"
+#include "Enemy.h"
+#include "LevelDirectoryManager.h"
+#include "FrameProfiler.h"
+#include "AllocationProfiler.h"
+
+
+#include "minorGems/io/file/File.h"
+#include "minorGems/math/geometry/Vector3D.h"
+#include "minorGems/math/geometry/Angle3D.h"
+#include "minorGems/util/SimpleVector.h"
+#include "minorGems/util/random/StdRandomSource.h"
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+
+
+// the sample rate the game mixes at
+unsigned long benchmarkSampleRate = 11025;
+
+// the block of samples the game mixes per audio callback
+unsigned long benchmarkSamplesPerBlock = 1024;
+
+// fixed, so that every run does the same work
+unsigned long benchmarkRandomSeed = 1004;
+
+// the grid spacing the game uses
+double benchmarkGridSpacing = 10;
+
+
+
+/**
+ * One operation to time.
+ *
+ * Subclasses implement runOnce.
+ *
+ * @author Jason Rohrer.
+ */
+class Benchmark {
+
+
+    public:
+
+
+
+        /**
+         * Constructs a benchmark.
+         *
+         * @param inName the name of the benchmark.
+         *   Must be a string constant.
+         */
+        Benchmark( char *inName )
+            : mName( inName ) {
+            }
+
+
+
+        virtual ~Benchmark() {
+            }
+
+
+
+        /**
+         * Runs the operation once.
+         *
+         * @param inIteration the number of times the operation has run
+         *   before, for varying its inputs.
+         */
+        virtual void runOnce( unsigned long inIteration ) = 0;
+
+
+
+        char *mName;
+
+    };
+
+
+
+/**
+ * The results of timing one benchmark.
+ */
+class BenchmarkResult {
+
+    public:
+
+        char *mName;
+
+        unsigned long mNumIterations;
+
+        double mMedianNanosecondsPerOp;
+        double mMinNanosecondsPerOp;
+        double mMaxNanosecondsPerOp;
+
+        double mAllocationsPerOp;
+        double mBytesPerOp;
+    };
+
+
+
+// for qsort
+static int compareDoubles( const void *inA, const void *inB ) {
+    double a = *( (double *)inA );
+    double b = *( (double *)inB );
+
+    if( a < b ) {
+        return -1;
+        }
+    else if( a > b ) {
+        return 1;
+        }
+    else {
+        return 0;
+        }
+    }
+
+
+
+/**
+ * Times a benchmark.
+ *
+ * @param inBenchmark the benchmark.
+ *   Must be destroyed by caller.
+ * @param inMinMilliseconds the least time to spend timing it.
+ * @param inNumSamples the number of separately timed samples.
+ * @param outResult pointer to where the results should be returned.
+ */
+static void runBenchmark( Benchmark *inBenchmark,
+                          unsigned long inMinMilliseconds,
+                          int inNumSamples,
+                          BenchmarkResult *outResult ) {
+
+    unsigned long iteration = 0;
+
+    // warm up caches, and find how many iterations fill one sample
+    double sampleMicroseconds = 1000.0 * inMinMilliseconds / inNumSamples;
+
+    unsigned long iterationsPerSample = 1;
+    double elapsed = 0;
+
+    while( true ) {
+        double start = FrameProfiler::getCurrentMicroseconds();
+
+        for( unsigned long i=0; i<iterationsPerSample; i++ ) {
+            inBenchmark->runOnce( iteration++ );
+            }
+
+        elapsed = FrameProfiler::getCurrentMicroseconds() - start;
+
+        if( elapsed >= sampleMicroseconds / 4 ) {
+            break;
+            }
+        iterationsPerSample *= 2;
+        }
+
+    // scale up to the full sample length
+    if( elapsed > 0 ) {
+        double scale = sampleMicroseconds / elapsed;
+
+        if( scale > 1 ) {
+            iterationsPerSample =
+                (unsigned long)( iterationsPerSample * scale );
+            }
+        }
+
+
+    // allocated before counting starts, so not counted
+    double *nanosecondsPerOp = new double[ inNumSamples ];
+
+    unsigned long startAllocations, startBytes;
+    AllocationProfiler::getTotals( &startAllocations, &startBytes );
+
+    for( int s=0; s<inNumSamples; s++ ) {
+        double start = FrameProfiler::getCurrentMicroseconds();
+
+        for( unsigned long i=0; i<iterationsPerSample; i++ ) {
+            inBenchmark->runOnce( iteration++ );
+            }
+
+        elapsed = FrameProfiler::getCurrentMicroseconds() - start;
+
+        nanosecondsPerOp[s] = 1000 * elapsed / iterationsPerSample;
+        }
+
+    unsigned long endAllocations, endBytes;
+    AllocationProfiler::getTotals( &endAllocations, &endBytes );
+
+    qsort( nanosecondsPerOp, inNumSamples, sizeof( double ),
+           compareDoubles );
+
+    unsigned long numIterations = iterationsPerSample * inNumSamples;
+
+    outResult->mName = inBenchmark->mName;
+    outResult->mNumIterations = numIterations;
+    outResult->mMedianNanosecondsPerOp = nanosecondsPerOp[ inNumSamples / 2 ];
+    outResult->mMinNanosecondsPerOp = nanosecondsPerOp[0];
+    outResult->mMaxNanosecondsPerOp = nanosecondsPerOp[ inNumSamples - 1 ];
+    outResult->mAllocationsPerOp =
+        (double)( endAllocations - startAllocations ) / numIterations;
+    outResult->mBytesPerOp =
+        (double)( endBytes - startBytes ) / numIterations;
+
+    delete [] nanosecondsPerOp;
+    }
+
+
+
+/**
+ * Constructs an object from a file in the level directory, as
+ * LevelFileLoadTask does.
+ *
+ * @param inFileName the name of the file.
+ *   Must be destroyed by caller.
+ *
+ * @return the object, or NULL if the file could not be read.
+ *   Must be destroyed by caller.
+ */
+template <class Type>
+static Type *readLevelObject( char *inFileName ) {
+    FILE *file = LevelDirectoryManager::getStdStream( inFileName, true );
+
+    char error = false;
+    Type *object = new Type( file, &error );
+
+    if( file != NULL ) {
+        fclose( file );
+        }
+
+    if( error ) {
+        printf( "Error reading from %s file\n", inFileName );
+        delete object;
+        return NULL;
+        }
+
+    return object;
+    }
+
+
+
+/**
+ * Reads a number from a file in the level directory.
+ *
+ * @param inFileName the name of the file.
+ *   Must be destroyed by caller.
+ * @param inDefault the value to return if the file cannot be read.
+ *
+ * @return the number.
+ */
+static double readLevelDouble( char *inFileName, double inDefault ) {
+    char error = false;
+    double value =
+        LevelDirectoryManager::readDoubleFileContents( inFileName, &error,
+                                                       true );
+    if( error ) {
+        return inDefault;
+        }
+    return value;
+    }
+
+
+
+/**
+ * Gets a parameter in [0,1] that sweeps across the space as the
+ * iterations go by.
+ *
+ * @param inIteration the iteration.
+ *
+ * @return the parameter.
+ */
+static double getSweepParameter( unsigned long inIteration ) {
+    return ( inIteration % 101 ) / 100.0;
+    }
+
+
+
+class BlendedControlPointBenchmark : public Benchmark {
+
+    public:
+
+        BlendedControlPointBenchmark( ParameterizedSpace *inSpace )
+            : Benchmark( "ParameterizedSpace::getBlendedControlPoint" ),
+              mSpace( inSpace ) {
+            }
+
+        // implements the Benchmark interface
+        void runOnce( unsigned long inIteration ) {
+            delete mSpace->getBlendedControlPoint(
+                getSweepParameter( inIteration ) );
+            }
+
+    protected:
+
+        ParameterizedSpace *mSpace;
+    };
+
+
+
+class CreateLinearBlendBenchmark : public Benchmark {
+
+    public:
+
+        CreateLinearBlendBenchmark( ObjectParameterSpaceControlPoint *inA,
+                                    ObjectParameterSpaceControlPoint *inB )
+            : Benchmark(
+                "ObjectParameterSpaceControlPoint::createLinearBlend" ),
+              mA( inA ), mB( inB ) {
+            }
+
+        // implements the Benchmark interface
+        void runOnce( unsigned long inIteration ) {
+            delete mA->createLinearBlend( mB,
+                                          getSweepParameter( inIteration ) );
+            }
+
+    protected:
+
+        ObjectParameterSpaceControlPoint *mA;
+        ObjectParameterSpaceControlPoint *mB;
+    };
+
+
+
+class GetDrawableObjectsBenchmark : public Benchmark {
+
+    public:
+
+        /**
+         * @param inPoint the point to get objects from.
+         *   Must be destroyed by caller after this class is destroyed.
+         * @param inPixelsPerUnit the size on screen to reduce detail for,
+         *   or 0 for full detail.
+         */
+        GetDrawableObjectsBenchmark(
+            ObjectParameterSpaceControlPoint *inPoint,
+            double inPixelsPerUnit )
+            : Benchmark(
+                inPixelsPerUnit == 0 ?
+                (char *)"ObjectParameterSpaceControlPoint::getDrawableObjects" :
+                (char *)"ObjectParameterSpaceControlPoint::getDrawableObjects "
+                "small" ),
+              mPoint( inPoint ), mPixelsPerUnit( inPixelsPerUnit ) {
+            }
+
+        // implements the Benchmark interface
+        void runOnce( unsigned long inIteration ) {
+            SimpleVector<DrawableObject *> *objects =
+                mPoint->getDrawableObjects( mPixelsPerUnit );
+
+            int numObjects = objects->size();
+            for( int i=0; i<numObjects; i++ ) {
+                delete *( objects->getElement( i ) );
+                }
+            delete objects;
+            }
+
+    protected:
+
+        ObjectParameterSpaceControlPoint *mPoint;
+        double mPixelsPerUnit;
+    };
+
+
+
+class EnemyDrawableObjectsBenchmark : public Benchmark {
+
+    public:
+
+        /**
+         * @param inEnemy the enemy to get objects from.
+         *   Must be destroyed by caller after this class is destroyed.
+         * @param inPixelsPerUnit the size on screen to reduce detail for,
+         *   or 0 for full detail.
+         */
+        EnemyDrawableObjectsBenchmark( Enemy *inEnemy,
+                                       double inPixelsPerUnit )
+            : Benchmark(
+                inPixelsPerUnit == 0 ?
+                (char *)"Enemy::getDrawableObjects" :
+                (char *)"Enemy::getDrawableObjects small" ),
+              mEnemy( inEnemy ), mPixelsPerUnit( inPixelsPerUnit ) {
+            }
+
+        // implements the Benchmark interface
+        void runOnce( unsigned long inIteration ) {
+            double parameter = getSweepParameter( inIteration );
+            double rotationRate;
+            
+            SimpleVector<DrawableObject *> *objects =
+                mEnemy->getDrawableObjects( parameter, parameter, 0, 0,
+                                            &rotationRate,
+                                            mPixelsPerUnit );
+
+            int numObjects = objects->size();
+            for( int i=0; i<numObjects; i++ ) {
+                delete *( objects->getElement( i ) );
+                }
+            delete objects;
+            }
+
+    protected:
+
+        Enemy *mEnemy;
+        double mPixelsPerUnit;
+    };
+
+
+
+class IsBorderInCircleBenchmark : public Benchmark {
+
+    public:
+
+        /**
+         * @param inObjects the objects to test.
+         *   Must be destroyed by caller after this class is destroyed.
+         */
+        IsBorderInCircleBenchmark( SimpleVector<DrawableObject *> *inObjects )
+            : Benchmark( "DrawableObject::isBorderInCircle" ),
+              mObjects( inObjects ), mCenter( 0, 0, 0 ) {
+            }
+
+        // implements the Benchmark interface
+        void runOnce( unsigned long inIteration ) {
+            // circles both touching and missing the objects
+            double angle = ( inIteration % 64 ) * ( 2 * M_PI / 64 );
+            double distance = ( inIteration % 7 ) * 0.5;
+
+            mCenter.mX = distance * cos( angle );
+            mCenter.mY = distance * sin( angle );
+
+            DrawableObject *object =
+                *( mObjects->getElement( inIteration % mObjects->size() ) );
+
+            object->isBorderInCircle( &mCenter, 0.5 );
+            }
+
+    protected:
+
+        SimpleVector<DrawableObject *> *mObjects;
+
+        Vector3D mCenter;
+    };
+
+
+
+class GetSoundSamplesBenchmark : public Benchmark {
+
+    public:
+
+        GetSoundSamplesBenchmark( SoundParameterSpaceControlPoint *inPoint,
+                                  double inSoundLengthInSeconds )
+            : Benchmark( "SoundParameterSpaceControlPoint::getSoundSamples" ),
+              mPoint( inPoint ),
+              mSoundLengthInSeconds( inSoundLengthInSeconds ) {
+
+            mSoundLengthInSamples =
+                (unsigned long)( inSoundLengthInSeconds *
+                                 benchmarkSampleRate );
+            if( mSoundLengthInSamples < benchmarkSamplesPerBlock ) {
+                mSoundLengthInSamples = benchmarkSamplesPerBlock;
+                }
+            }
+
+        // implements the Benchmark interface
+        void runOnce( unsigned long inIteration ) {
+            // step through the sound one block at a time
+            unsigned long numBlocks =
+                mSoundLengthInSamples / benchmarkSamplesPerBlock;
+            unsigned long start =
+                ( inIteration % numBlocks ) * benchmarkSamplesPerBlock;
+
+            delete [] mPoint->getSoundSamples( start,
+                                               benchmarkSamplesPerBlock,
+                                               benchmarkSampleRate,
+                                               mSoundLengthInSeconds );
+            }
+
+    protected:
+
+        SoundParameterSpaceControlPoint *mPoint;
+        double mSoundLengthInSeconds;
+        unsigned long mSoundLengthInSamples;
+    };
+
+
+
+class GetMoreMusicBenchmark : public Benchmark {
+
+    public:
+
+        GetMoreMusicBenchmark( MusicPlayer *inPlayer )
+            : Benchmark( "MusicPlayer::getMoreMusic" ),
+              mPlayer( inPlayer ) {
+            }
+
+        // implements the Benchmark interface
+        void runOnce( unsigned long inIteration ) {
+            delete mPlayer->getMoreMusic( benchmarkSamplesPerBlock );
+            }
+
+    protected:
+
+        MusicPlayer *mPlayer;
+    };
+
+
+
+class MixMoreMusicBenchmark : public Benchmark {
+
+    public:
+
+        MixMoreMusicBenchmark( MusicPlayer *inPlayer )
+            : Benchmark( "MusicPlayer::mixMoreMusic interleaved" ),
+              mPlayer( inPlayer ),
+              mFrames( new float[ 2 * benchmarkSamplesPerBlock ] ) {
+            }
+
+        ~MixMoreMusicBenchmark() {
+            delete [] mFrames;
+            }
+
+        // implements the Benchmark interface
+        void runOnce( unsigned long inIteration ) {
+            // as SoundPlayer mixes it, straight into the output
+            StereoSampleView output( mFrames, benchmarkSamplesPerBlock );
+            output.clear();
+            
+            mPlayer->mixMoreMusic( output, 1 );
+            }
+
+    protected:
+
+        MusicPlayer *mPlayer;
+        float *mFrames;
+    };
+
+
+
+class FilterSamplesBenchmark : public Benchmark {
+
+    public:
+
+        /**
+         * @param inFilter the filter.
+         *   Will be destroyed by this class.
+         */
+        FilterSamplesBenchmark( ReverbSoundFilter *inFilter )
+            : Benchmark( "ReverbSoundFilter::filterSamples" ),
+              mFilter( inFilter ),
+              mSamples( new SoundSamples( benchmarkSamplesPerBlock ) ) {
+
+            // a tone, so that the filter works on real values
+            for( unsigned long i=0; i<benchmarkSamplesPerBlock; i++ ) {
+                float value = (float)( 0.5 * sin( i * 0.1 ) );
+                mSamples->mLeftChannel[i] = value;
+                mSamples->mRightChannel[i] = value;
+                }
+            }
+
+        ~FilterSamplesBenchmark() {
+            delete mFilter;
+            delete mSamples;
+            }
+
+        // implements the Benchmark interface
+        void runOnce( unsigned long inIteration ) {
+            delete mFilter->filterSamples( mSamples );
+            }
+
+    protected:
+
+        ReverbSoundFilter *mFilter;
+        SoundSamples *mSamples;
+    };
+
+
+
+class FilterSamplesInPlaceBenchmark : public Benchmark {
+
+    public:
+
+        /**
+         * @param inFilter the filter.
+         *   Will be destroyed by this class.
+         */
+        FilterSamplesInPlaceBenchmark( ReverbSoundFilter *inFilter )
+            : Benchmark(
+                "ReverbSoundFilter::filterSamplesInPlace interleaved" ),
+              mFilter( inFilter ),
+              mFrames( new float[ 2 * benchmarkSamplesPerBlock ] ) {
+            }
+
+        ~FilterSamplesInPlaceBenchmark() {
+            delete mFilter;
+            delete [] mFrames;
+            }
+
+        // implements the Benchmark interface
+        void runOnce( unsigned long inIteration ) {
+            StereoSampleView frames( mFrames, benchmarkSamplesPerBlock );
+
+            // the same tone as FilterSamplesBenchmark, refilled each time
+            // since filtering replaces it
+            for( unsigned long i=0; i<benchmarkSamplesPerBlock; i++ ) {
+                float value = (float)( 0.5 * sin( i * 0.1 ) );
+                frames.mLeftChannel[ 2 * i ] = value;
+                frames.mRightChannel[ 2 * i ] = value;
+                }
+            
+            mFilter->filterSamplesInPlace( frames );
+            }
+
+    protected:
+
+        ReverbSoundFilter *mFilter;
+        float *mFrames;
+    };
+
+
+
+/**
+ * Makes SculptureManager::updateInOutStatusOfAllPieces callable.
+ */
+class BenchmarkSculptureManager : public SculptureManager {
+
+    public:
+
+        // same as SculptureManager constructor
+        BenchmarkSculptureManager(
+            ParameterizedObject *inFirstSculptureTemplate,
+            ParameterizedObject *inSecondSculptureTemplate,
+            double inSculptureScale,
+            double inMaxDistanceToBeInSculpture,
+            double inAnimationLoopTime,
+            int inNumAnimationKeyframes,
+            int inNumSculpturePieces,
+            double *inPieceShapeParameters,
+            Vector3D **inPieceStartingPositions,
+            Angle3D **inPieceStartingRotations,
+            MusicPart **inPieceMusicParts,
+            FILE *inSculpturePowerUpSpaceFILE,
+            char *outError,
+            ShipBulletManager *inEnemyBulletManager,
+            double inEnemyBulletJarPower,
+            ShipBulletManager *inBossBulletManager,
+            double inBossBulletJarPower,
+            double inFriction,
+            double inWorldWidth,
+            double inWorldHeight )
+            : SculptureManager( inFirstSculptureTemplate,
+                                inSecondSculptureTemplate,
+                                inSculptureScale,
+                                inMaxDistanceToBeInSculpture,
+                                inAnimationLoopTime,
+                                inNumAnimationKeyframes,
+                                inNumSculpturePieces,
+                                inPieceShapeParameters,
+                                inPieceStartingPositions,
+                                inPieceStartingRotations,
+                                inPieceMusicParts,
+                                inSculpturePowerUpSpaceFILE,
+                                outError,
+                                inEnemyBulletManager,
+                                inEnemyBulletJarPower,
+                                inBossBulletManager,
+                                inBossBulletJarPower,
+                                inFriction,
+                                inWorldWidth,
+                                inWorldHeight ) {
+            }
+
+        void updateInOutStatus() {
+            updateInOutStatusOfAllPieces();
+            }
+    };
+
+
+
+class UpdateInOutStatusBenchmark : public Benchmark {
+
+    public:
+
+        UpdateInOutStatusBenchmark( BenchmarkSculptureManager *inManager )
+            : Benchmark( "SculptureManager::updateInOutStatusOfAllPieces" ),
+              mManager( inManager ) {
+            }
+
+        // implements the Benchmark interface
+        void runOnce( unsigned long inIteration ) {
+            mManager->updateInOutStatus();
+            }
+
+    protected:
+
+        BenchmarkSculptureManager *mManager;
+    };
+
+
+
+class UpdateGridColorsBenchmark : public Benchmark {
+
+    public:
+
+        /**
+         * @param inRenderer the renderer to update.
+         *   Will be destroyed by this class.
+         * @param inMoveBoss true to move the boss every operation, which
+         *   recolors the whole grid, or false to move only the ship.
+         */
+        UpdateGridColorsBenchmark( GridRenderer *inRenderer,
+                                   char inMoveBoss )
+            : Benchmark( inMoveBoss ?
+                         (char *)"GridRenderer::updateColors boss moving" :
+                         (char *)"GridRenderer::updateColors ship moving" ),
+              mRenderer( inRenderer ), mMoveBoss( inMoveBoss ),
+              mBossPosition( 0, 0, 0 ), mShipPosition( 0, 0, 0 ) {
+            }
+
+        ~UpdateGridColorsBenchmark() {
+            delete mRenderer;
+            }
+
+        // implements the Benchmark interface
+        void runOnce( unsigned long inIteration ) {
+            // back and forth, farther each time than the threshold
+            double offset = ( inIteration % 64 ) - 32;
+
+            if( mMoveBoss ) {
+                mBossPosition.mX = offset;
+                }
+            else {
+                mShipPosition.mX = offset;
+                }
+
+            mRenderer->updateColors( &mBossPosition, &mShipPosition );
+            }
+
+    protected:
+
+        GridRenderer *mRenderer;
+        char mMoveBoss;
+
+        Vector3D mBossPosition;
+        Vector3D mShipPosition;
+    };
+
+
+
+/**
+ * An image drawn in software, for comparing drawings without the GL.
+ *
+ * Objects are drawn with their alpha blended over what is already there,
+ * as the game draws them, with coverage measured at 4x4 samples per pixel.
+ */
+class SoftwareImage {
+
+    public:
+
+        /**
+         * Constructs a black image.
+         *
+         * @param inSize the width and height of the image, in pixels.
+         */
+        SoftwareImage( int inSize )
+            : mSize( inSize ),
+              mPixels( new double[ 3 * inSize * inSize ] ) {
+
+            for( int i=0; i<3 * inSize * inSize; i++ ) {
+                mPixels[i] = 0;
+                }
+            }
+
+        ~SoftwareImage() {
+            delete [] mPixels;
+            }
+
+
+
+        /**
+         * Draws objects centered in this image.
+         *
+         * @param inObjects the objects.
+         *   Must be destroyed by caller.
+         * @param inPixelsPerUnit how many pixels one world unit covers.
+         */
+        void drawObjects( SimpleVector<DrawableObject *> *inObjects,
+                          double inPixelsPerUnit ) {
+
+            int numObjects = inObjects->size();
+            for( int i=0; i<numObjects; i++ ) {
+                DrawableObject *object = *( inObjects->getElement( i ) );
+
+                int numVertices;
+                double *vertices = object->getWorldVertices( false,
+                                                             &numVertices );
+                toPixels( vertices, numVertices, inPixelsPerUnit );
+
+                for( int v=0; v<numVertices - 2; v+=3 ) {
+                    drawTriangle( &( vertices[ 6 * v ] ) );
+                    }
+                delete [] vertices;
+
+
+                vertices = object->getWorldVertices( true, &numVertices );
+                toPixels( vertices, numVertices, inPixelsPerUnit );
+
+                // one loop per instance
+                int numInstances = object->getNumInstances();
+                int loopLength = 0;
+                if( numInstances > 0 ) {
+                    loopLength = numVertices / numInstances;
+                    }
+
+                for( int n=0; n<numInstances; n++ ) {
+                    double *loop = &( vertices[ 6 * n * loopLength ] );
+
+                    for( int v=0; v<loopLength; v++ ) {
+                        drawLine( &( loop[ 6 * v ] ),
+                                  &( loop[ 6 * ( ( v + 1 ) % loopLength ) ] ),
+                                  object->getBorderWidth() );
+                        }
+                    }
+                delete [] vertices;
+                }
+            }
+
+
+
+        /**
+         * Gets how much this image differs from another of the same size.
+         *
+         * @param inOther the other image.
+         *   Must be destroyed by caller.
+         *
+         * @return the sum over all pixels of the mean difference of their
+         *   color components.
+         */
+        double getDifference( SoftwareImage *inOther ) {
+            double difference = 0;
+
+            for( int i=0; i<3 * mSize * mSize; i++ ) {
+                difference += fabs( mPixels[i] - inOther->mPixels[i] );
+                }
+
+            return difference / 3;
+            }
+
+
+
+    protected:
+
+        int mSize;
+
+        // r, g, b for each pixel
+        double *mPixels;
+
+
+
+        /**
+         * Moves world vertices, as returned by getWorldVertices, into
+         * pixel coordinates.
+         */
+        void toPixels( double *inOutVertices, int inNumVertices,
+                       double inPixelsPerUnit ) {
+            double center = mSize / 2.0;
+
+            for( int v=0; v<inNumVertices; v++ ) {
+                inOutVertices[ 6 * v ] =
+                    inOutVertices[ 6 * v ] * inPixelsPerUnit + center;
+                inOutVertices[ 6 * v + 1 ] =
+                    inOutVertices[ 6 * v + 1 ] * inPixelsPerUnit + center;
+                }
+            }
+
+
+
+        /**
+         * Blends a color into a pixel.
+         *
+         * @param inX the x position of the pixel.
+         * @param inY the y position of the pixel.
+         * @param inColor the r, g, b, and a of the color.
+         *   Must be destroyed by caller.
+         * @param inCoverage the fraction of the pixel that is covered.
+         */
+        void blendPixel( int inX, int inY, double *inColor,
+                         double inCoverage ) {
+            if( inX < 0 || inX >= mSize || inY < 0 || inY >= mSize ) {
+                return;
+                }
+
+            double alpha = inColor[3] * inCoverage;
+
+            double *pixel = &( mPixels[ 3 * ( inY * mSize + inX ) ] );
+
+            for( int c=0; c<3; c++ ) {
+                pixel[c] = pixel[c] * ( 1 - alpha ) + inColor[c] * alpha;
+                }
+            }
+
+
+
+        /**
+         * Draws one triangle.
+         *
+         * @param inVertices 3 vertices in pixel coordinates, as returned
+         *   by getWorldVertices.
+         *   Must be destroyed by caller.
+         */
+        void drawTriangle( double *inVertices ) {
+            double *a = inVertices;
+            double *b = &( inVertices[6] );
+            double *c = &( inVertices[12] );
+
+            double area =
+                ( b[0] - a[0] ) * ( c[1] - a[1] ) -
+                ( c[0] - a[0] ) * ( b[1] - a[1] );
+
+            if( area == 0 ) {
+                return;
+                }
+
+            int minX = (int)floor( fmin( a[0], fmin( b[0], c[0] ) ) );
+            int maxX = (int)ceil( fmax( a[0], fmax( b[0], c[0] ) ) );
+            int minY = (int)floor( fmin( a[1], fmin( b[1], c[1] ) ) );
+            int maxY = (int)ceil( fmax( a[1], fmax( b[1], c[1] ) ) );
+
+            for( int y=minY; y<maxY; y++ ) {
+                for( int x=minX; x<maxX; x++ ) {
+
+                    double color[4] = { 0, 0, 0, 0 };
+                    int numCovered = 0;
+
+                    for( int s=0; s<16; s++ ) {
+                        double sampleX = x + ( s % 4 + 0.5 ) / 4;
+                        double sampleY = y + ( s / 4 + 0.5 ) / 4;
+
+                        // barycentric weights of a and b
+                        double weightA =
+                            ( ( b[0] - sampleX ) * ( c[1] - sampleY ) -
+                              ( c[0] - sampleX ) * ( b[1] - sampleY ) ) /
+                            area;
+                        double weightB =
+                            ( ( c[0] - sampleX ) * ( a[1] - sampleY ) -
+                              ( a[0] - sampleX ) * ( c[1] - sampleY ) ) /
+                            area;
+                        double weightC = 1 - weightA - weightB;
+
+                        if( weightA >= 0 && weightB >= 0 && weightC >= 0 ) {
+                            for( int k=0; k<4; k++ ) {
+                                color[k] +=
+                                    weightA * a[ 2 + k ] +
+                                    weightB * b[ 2 + k ] +
+                                    weightC * c[ 2 + k ];
+                                }
+                            numCovered++;
+                            }
+                        }
+
+                    if( numCovered > 0 ) {
+                        for( int k=0; k<4; k++ ) {
+                            color[k] /= numCovered;
+                            }
+                        blendPixel( x, y, color, numCovered / 16.0 );
+                        }
+                    }
+                }
+            }
+
+
+
+        /**
+         * Draws one line segment.
+         *
+         * @param inStart the start vertex in pixel coordinates, as
+         *   returned by getWorldVertices.
+         *   Must be destroyed by caller.
+         * @param inEnd the end vertex.
+         *   Must be destroyed by caller.
+         * @param inWidth the width of the line in pixels.
+         */
+        void drawLine( double *inStart, double *inEnd, double inWidth ) {
+            double halfWidth = inWidth / 2;
+
+            double segmentX = inEnd[0] - inStart[0];
+            double segmentY = inEnd[1] - inStart[1];
+            double lengthSquared = segmentX * segmentX + segmentY * segmentY;
+
+            int minX = (int)floor( fmin( inStart[0], inEnd[0] ) - halfWidth );
+            int maxX = (int)ceil( fmax( inStart[0], inEnd[0] ) + halfWidth );
+            int minY = (int)floor( fmin( inStart[1], inEnd[1] ) - halfWidth );
+            int maxY = (int)ceil( fmax( inStart[1], inEnd[1] ) + halfWidth );
+
+            for( int y=minY; y<maxY; y++ ) {
+                for( int x=minX; x<maxX; x++ ) {
+
+                    double color[4] = { 0, 0, 0, 0 };
+                    int numCovered = 0;
+
+                    for( int s=0; s<16; s++ ) {
+                        double pointX = x + ( s % 4 + 0.5 ) / 4 - inStart[0];
+                        double pointY = y + ( s / 4 + 0.5 ) / 4 - inStart[1];
+
+                        double t = 0;
+                        if( lengthSquared > 0 ) {
+                            t = ( pointX * segmentX + pointY * segmentY ) /
+                                lengthSquared;
+                            t = fmax( 0, fmin( 1, t ) );
+                            }
+
+                        double dX = pointX - t * segmentX;
+                        double dY = pointY - t * segmentY;
+
+                        if( dX * dX + dY * dY <= halfWidth * halfWidth ) {
+                            for( int k=0; k<4; k++ ) {
+                                color[k] += ( 1 - t ) * inStart[ 2 + k ] +
+                                    t * inEnd[ 2 + k ];
+                                }
+                            numCovered++;
+                            }
+                        }
+
+                    if( numCovered > 0 ) {
+                        for( int k=0; k<4; k++ ) {
+                            color[k] /= numCovered;
+                            }
+                        blendPixel( x, y, color, numCovered / 16.0 );
+                        }
+                    }
+                }
+            }
+
+    };
+
+
+
+/**
+ * A shape from the level that can be drawn at full or reduced detail.
+ */
+class DetailCheckShape {
+
+    public:
+
+        DetailCheckShape( char *inName )
+            : mName( inName ) {
+            }
+
+        virtual ~DetailCheckShape() {
+            }
+
+
+
+        /**
+         * Gets drawable objects for the shape.
+         *
+         * @param inParameter a parameter in [0,1] that sweeps across the
+         *   shape's space.
+         * @param inPixelsPerUnit the size on screen to reduce detail for,
+         *   or 0 for full detail.
+         *
+         * @return the objects.
+         *   Vector and objects must be destroyed by caller.
+         */
+        virtual SimpleVector<DrawableObject *> *getObjects(
+            double inParameter, double inPixelsPerUnit ) = 0;
+
+
+
+        char *mName;
+    };
+
+
+
+class BulletDetailCheckShape : public DetailCheckShape {
+
+    public:
+
+        /**
+         * @param inBullet the bullet.
+         *   Must be destroyed by caller after this class is destroyed.
+         */
+        BulletDetailCheckShape( char *inName, ShipBullet *inBullet )
+            : DetailCheckShape( inName ), mBullet( inBullet ) {
+            }
+
+        // implements the DetailCheckShape interface
+        SimpleVector<DrawableObject *> *getObjects(
+            double inParameter, double inPixelsPerUnit ) {
+
+            double power, rotationRate;
+            return mBullet->getDrawableObjects( inParameter,
+                                                1 - inParameter,
+                                                inParameter,
+                                                &power, &rotationRate,
+                                                inPixelsPerUnit );
+            }
+
+    protected:
+
+        ShipBullet *mBullet;
+    };
+
+
+
+class EnemyDetailCheckShape : public DetailCheckShape {
+
+    public:
+
+        /**
+         * @param inEnemy the enemy.
+         *   Must be destroyed by caller after this class is destroyed.
+         */
+        EnemyDetailCheckShape( char *inName, Enemy *inEnemy )
+            : DetailCheckShape( inName ), mEnemy( inEnemy ) {
+            }
+
+        // implements the DetailCheckShape interface
+        SimpleVector<DrawableObject *> *getObjects(
+            double inParameter, double inPixelsPerUnit ) {
+
+            double rotationRate;
+            return mEnemy->getDrawableObjects( inParameter,
+                                               inParameter,
+                                               0, 0,
+                                               &rotationRate,
+                                               inPixelsPerUnit );
+            }
+
+    protected:
+
+        Enemy *mEnemy;
+    };
+
+
+
+/**
+ * Destroys a vector of drawable objects and the objects in it.
+ *
+ * @param inObjects the objects.
+ *   Will be destroyed by this call.
+ */
+static void deleteDrawableObjects( SimpleVector<DrawableObject *> *inObjects ) {
+    int numObjects = inObjects->size();
+    for( int i=0; i<numObjects; i++ ) {
+        delete *( inObjects->getElement( i ) );
+        }
+    delete inObjects;
+    }
+
+
+
+/**
+ * Compares software drawings of shapes at full and reduced detail.
+ *
+ * @param inShapes the shapes to check.
+ *   Must be destroyed by caller.
+ * @param inMaxError the largest allowed difference, as a fraction of the
+ *   area that the shape covers.
+ *
+ * @return true if every difference is within inMaxError.
+ */
+static char runDetailCheck( SimpleVector<DetailCheckShape *> *inShapes,
+                            double inMaxError ) {
+
+    // radii on screen, in pixels, small enough for reduced detail
+    double pixelRadii[] = { 2, 3, 4, 6, 8, 12, 16, 24, 31 };
+    int numRadii = sizeof( pixelRadii ) / sizeof( double );
+
+    int numParameters = 5;
+
+    Vector3D center( 0, 0, 0 );
+
+    char passed = true;
+
+    printf( "Detail check, allowing an error of %.3f of each shape's area:\n",
+            inMaxError );
+    printf( "    %-20s %14s %14s\n", "shape", "worst error", "at radius" );
+
+    int numShapes = inShapes->size();
+    for( int s=0; s<numShapes; s++ ) {
+        DetailCheckShape *shape = *( inShapes->getElement( s ) );
+
+        double worstError = 0;
+        double worstRadius = 0;
+
+        for( int p=0; p<numParameters; p++ ) {
+            double parameter = p / (double)( numParameters - 1 );
+
+            SimpleVector<DrawableObject *> *fullObjects =
+                shape->getObjects( parameter, 0 );
+
+            double radius = 0;
+            float borderWidth = 0;
+            int numObjects = fullObjects->size();
+            for( int i=0; i<numObjects; i++ ) {
+                DrawableObject *object = *( fullObjects->getElement( i ) );
+
+                radius = fmax( radius,
+                               object->getBorderMaxDistance( &center ) );
+                borderWidth = fmax( borderWidth, object->getBorderWidth() );
+                }
+
+            if( radius <= 0 ) {
+                deleteDrawableObjects( fullObjects );
+                continue;
+                }
+
+            for( int r=0; r<numRadii; r++ ) {
+                double pixelsPerUnit = pixelRadii[r] / radius;
+
+                int size = 2 * (int)ceil( pixelRadii[r] + borderWidth ) + 4;
+
+                SoftwareImage fullImage( size );
+                fullImage.drawObjects( fullObjects, pixelsPerUnit );
+
+                SimpleVector<DrawableObject *> *detailObjects =
+                    shape->getObjects( parameter, pixelsPerUnit );
+
+                SoftwareImage detailImage( size );
+                detailImage.drawObjects( detailObjects, pixelsPerUnit );
+
+                deleteDrawableObjects( detailObjects );
+
+                double area = M_PI * pixelRadii[r] * pixelRadii[r];
+                double error = fullImage.getDifference( &detailImage ) / area;
+
+                if( error > worstError ) {
+                    worstError = error;
+                    worstRadius = pixelRadii[r];
+                    }
+                }
+
+            deleteDrawableObjects( fullObjects );
+            }
+
+        char shapePassed = ( worstError <= inMaxError );
+
+        printf( "    %-20s %14.4f %14.0f%s\n",
+                shape->mName, worstError, worstRadius,
+                shapePassed ? "" : "  FAILED" );
+
+        if( !shapePassed ) {
+            passed = false;
+            }
+        }
+
+    return passed;
+    }
+
+
+
+/**
+ * Writes results as JSON, for tracking over time.
+ *
+ * @param inFileName the name of the file to write.
+ *   Must be destroyed by caller.
+ * @param inLevelName the name of the level the benchmarks ran on.
+ *   Must be destroyed by caller.
+ * @param inResults the results.
+ *   Must be destroyed by caller.
+ *
+ * @return true if the file was written.
+ */
+static char writeJSON( char *inFileName, char *inLevelName,
+                       SimpleVector<BenchmarkResult> *inResults ) {
+
+    FILE *file = fopen( inFileName, "w" );
+
+    if( file == NULL ) {
+        printf( "Failed to open %s for writing\n", inFileName );
+        return false;
+        }
+
+    fprintf( file, "{\n" );
+    fprintf( file, "  \"timestamp\": %lu,\n", (unsigned long)time( NULL ) );
+    fprintf( file, "  \"level\": \"%s\",\n", inLevelName );
+    fprintf( file, "  \"benchmarks\": [\n" );
+
+    int numResults = inResults->size();
+    for( int i=0; i<numResults; i++ ) {
+        BenchmarkResult *result = inResults->getElement( i );
+
+        fprintf( file,
+                 "    { \"name\": \"%s\", \"iterations\": %lu, "
+                 "\"nsPerOp\": %.1f, \"minNsPerOp\": %.1f, "
+                 "\"maxNsPerOp\": %.1f, "
+                 "\"allocsPerOp\": %.3f, \"bytesPerOp\": %.1f }%s\n",
+                 result->mName, result->mNumIterations,
+                 result->mMedianNanosecondsPerOp,
+                 result->mMinNanosecondsPerOp,
+                 result->mMaxNanosecondsPerOp,
+                 result->mAllocationsPerOp,
+                 result->mBytesPerOp,
+                 ( i < numResults - 1 ) ? "," : "" );
+        }
+
+    fprintf( file, "  ]\n" );
+    fprintf( file, "}\n" );
+
+    fclose( file );
+
+    return true;
+    }
+
+
+
+int main( int inNumArgs, char **inArgs ) {
+
+    char *levelName = "001";
+    unsigned long minMilliseconds = 500;
+    char *filter = NULL;
+    char *jsonFileName = NULL;
+
+    // negative to time benchmarks instead
+    double detailCheckMaxError = -1;
+    
+    int numSamples = 5;
+
+    for( int a=1; a<inNumArgs; a++ ) {
+        if( strcmp( inArgs[a], "-level" ) == 0 && a + 1 < inNumArgs ) {
+            levelName = inArgs[ a + 1 ];
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-minTime" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            // in milliseconds per benchmark
+            sscanf( inArgs[ a + 1 ], "%lu", &minMilliseconds );
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-filter" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            // only run benchmarks with names containing this
+            filter = inArgs[ a + 1 ];
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-json" ) == 0 && a + 1 < inNumArgs ) {
+            jsonFileName = inArgs[ a + 1 ];
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-detailCheck" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            sscanf( inArgs[ a + 1 ], "%lf", &detailCheckMaxError );
+            a++;
+            }
+        else {
+            printf( "Unknown argument:  %s\n", inArgs[a] );
+            printf( "Usage:  %s [-level 001] [-minTime ms] [-filter name] "
+                    "[-json file] [-detailCheck maxError]\n", inArgs[0] );
+            return 1;
+            }
+        }
+
+    if( minMilliseconds < 1 ) {
+        minMilliseconds = 1;
+        }
+
+
+    File *levelsDirectory = new File( NULL, "levels" );
+    File *levelDirectory = levelsDirectory->getChildFile( levelName );
+    delete levelsDirectory;
+
+    if( ! levelDirectory->exists() ) {
+        printf( "Level directory levels/%s not found\n", levelName );
+        delete levelDirectory;
+        return 1;
+        }
+
+    LevelDirectoryManager::setLevelDirectory( levelDirectory );
+
+
+
+    // load everything before counting allocations
+
+    StdRandomSource *randSource = new StdRandomSource( benchmarkRandomSeed );
+
+    ParameterizedObject *shipSpace =
+        readLevelObject<ParameterizedObject>( "ship" );
+    ParameterizedObject *firstPieceSpace =
+        readLevelObject<ParameterizedObject>( "firstSculpturePiece" );
+    ParameterizedObject *secondPieceSpace =
+        readLevelObject<ParameterizedObject>( "secondSculpturePiece" );
+    ShipBullet *enemyBulletTemplate =
+        readLevelObject<ShipBullet>( "enemyBullet" );
+    ShipBullet *bossBulletTemplate =
+        readLevelObject<ShipBullet>( "bossBullet" );
+
+    if( shipSpace == NULL || firstPieceSpace == NULL ||
+        secondPieceSpace == NULL || enemyBulletTemplate == NULL ||
+        bossBulletTemplate == NULL ) {
+
+        return 1;
+        }
+
+
+    if( detailCheckMaxError >= 0 ) {
+        ShipBullet *shipBulletTemplate =
+            readLevelObject<ShipBullet>( "shipBullet" );
+        Enemy *enemyTemplate = readLevelObject<Enemy>( "enemy" );
+
+        if( shipBulletTemplate == NULL || enemyTemplate == NULL ) {
+            return 1;
+            }
+        
+        SimpleVector<DetailCheckShape *> *shapes =
+            new SimpleVector<DetailCheckShape *>();
+
+        shapes->push_back(
+            new BulletDetailCheckShape( "shipBullet", shipBulletTemplate ) );
+        shapes->push_back(
+            new BulletDetailCheckShape( "enemyBullet",
+                                        enemyBulletTemplate ) );
+        shapes->push_back(
+            new BulletDetailCheckShape( "bossBullet", bossBulletTemplate ) );
+        shapes->push_back(
+            new EnemyDetailCheckShape( "enemy", enemyTemplate ) );
+
+        char passed = runDetailCheck( shapes, detailCheckMaxError );
+
+        for( int i=0; i<shapes->size(); i++ ) {
+            delete *( shapes->getElement( i ) );
+            }
+        delete shapes;
+
+        delete shipBulletTemplate;
+        delete enemyBulletTemplate;
+        delete bossBulletTemplate;
+        delete enemyTemplate;
+        delete shipSpace;
+        delete firstPieceSpace;
+        delete secondPieceSpace;
+        delete randSource;
+
+        if( !passed ) {
+            return 1;
+            }
+        return 0;
+        }
+
+    // the ends of the ship space, to blend between
+    ObjectParameterSpaceControlPoint *shipPointA =
+        shipSpace->getBlendedControlPoint( 0 );
+    ObjectParameterSpaceControlPoint *shipPointB =
+        shipSpace->getBlendedControlPoint( 1 );
+    ObjectParameterSpaceControlPoint *shipPointMiddle =
+        shipSpace->getBlendedControlPoint( 0.5 );
+
+    SimpleVector<DrawableObject *> *shipObjects =
+        shipPointMiddle->getDrawableObjects();
+
+    // the ship at 8 pixels across on screen, for reduced detail
+    Vector3D shipCenter( 0, 0, 0 );
+    double shipRadius = 0;
+    for( int i=0; i<shipObjects->size(); i++ ) {
+        double radius =
+            ( *( shipObjects->getElement( i ) ) )->getBorderMaxDistance(
+                &shipCenter );
+        if( radius > shipRadius ) {
+            shipRadius = radius;
+            }
+        }
+    double smallShipPixelsPerUnit = 1;
+    if( shipRadius > 0 ) {
+        smallShipPixelsPerUnit = 4 / shipRadius;
+        }
+
+
+    // the enemy at full detail and at 8 pixels across on screen, to
+    // compare the cost of a draw with and without its reduced points
+    Enemy *enemyTemplate = readLevelObject<Enemy>( "enemy" );
+
+    if( enemyTemplate == NULL ) {
+        return 1;
+        }
+
+    double enemyRotationRate;
+    double enemyRadius =
+        enemyTemplate->getRadius( 0.5, 0.5, 0, 0, &enemyRotationRate );
+    double smallEnemyPixelsPerUnit = 1;
+    if( enemyRadius > 0 ) {
+        smallEnemyPixelsPerUnit = 4 / enemyRadius;
+        }
+
+
+    // the left channel of the first point of the ship bullet sound
+    SoundParameterSpaceControlPoint *soundPoint = NULL;
+    double soundLengthInSeconds = 0;
+
+    FILE *soundFILE =
+        LevelDirectoryManager::getStdStream( "shipBulletSoundClose", true );
+
+    if( soundFILE != NULL ) {
+        double anchor;
+        char error = false;
+
+        if( fscanf( soundFILE, "%lf", &soundLengthInSeconds ) == 1 &&
+            fscanf( soundFILE, "%lf", &anchor ) == 1 ) {
+
+            soundPoint = new SoundParameterSpaceControlPoint( soundFILE,
+                                                              &error );
+            if( error ) {
+                delete soundPoint;
+                soundPoint = NULL;
+                }
+            }
+        fclose( soundFILE );
+        }
+
+    if( soundPoint == NULL ) {
+        printf( "Error reading from shipBulletSoundClose file\n" );
+        return 1;
+        }
+
+
+    // the first reverb filter of the level
+    double reverbTime = 0.1;
+    double reverbLoudness = 0.5;
+
+    FILE *reverbFILE = LevelDirectoryManager::getStdStream( "reverbFilters",
+                                                            true );
+    if( reverbFILE != NULL ) {
+        if( fscanf( reverbFILE, "%lf", &reverbTime ) != 1 ||
+            fscanf( reverbFILE, "%lf", &reverbLoudness ) != 1 ) {
+            reverbTime = 0.1;
+            reverbLoudness = 0.5;
+            }
+        fclose( reverbFILE );
+        }
+
+    ReverbSoundFilter *reverbFilter =
+        new ReverbSoundFilter(
+            (unsigned long)( benchmarkSampleRate * reverbTime ),
+            reverbLoudness );
+    ReverbSoundFilter *inPlaceReverbFilter =
+        new ReverbSoundFilter(
+            (unsigned long)( benchmarkSampleRate * reverbTime ),
+            reverbLoudness );
+
+
+    // a sculpture laid out as the game lays it out
+    double worldWidth = readLevelDouble( "gridSizeX", 200 );
+    double worldHeight = readLevelDouble( "gridSizeY", 200 );
+
+    int numPieces =
+        (int)readLevelDouble( "numberOfSculpturePieces", 10 );
+
+    MusicNoteWaveTable *waveTable =
+        new MusicNoteWaveTable( benchmarkSampleRate );
+
+    double *pieceParameters = new double[ numPieces ];
+    Vector3D **piecePositions = new Vector3D*[ numPieces ];
+    Angle3D **pieceRotations = new Angle3D*[ numPieces ];
+    MusicPart **pieceMusicParts = new MusicPart*[ numPieces ];
+
+    for( int i=0; i<numPieces; i++ ) {
+        pieceParameters[i] = randSource->getRandomDouble();
+
+        // clustered near the middle, so that some pieces are in the
+        // sculpture and some are not
+        double x = ( randSource->getRandomDouble() - 0.5 ) * worldWidth / 4;
+        double y = ( randSource->getRandomDouble() - 0.5 ) * worldHeight / 4;
+
+        piecePositions[i] = new Vector3D( x, y, 0 );
+        pieceRotations[i] =
+            new Angle3D( 0, 0, randSource->getRandomDouble() * 2 * M_PI );
+        pieceMusicParts[i] =
+            new MusicPart( waveTable, randSource, pieceParameters[i] );
+        }
+
+    ShipBulletManager *enemyBulletManager =
+        new ShipBulletManager( enemyBulletTemplate,
+                               readLevelDouble( "enemyBulletScale", 1 ),
+                               NULL, NULL, worldWidth, worldHeight );
+    ShipBulletManager *bossBulletManager =
+        new ShipBulletManager( bossBulletTemplate,
+                               readLevelDouble( "bossBulletScale", 1 ),
+                               NULL, NULL, worldWidth, worldHeight );
+
+    FILE *powerupFILE =
+        LevelDirectoryManager::getStdStream( "sculpturePiecePowerupSpace",
+                                             true );
+    char error = false;
+    BenchmarkSculptureManager *sculptureManager =
+        new BenchmarkSculptureManager(
+            firstPieceSpace,
+            secondPieceSpace,
+            readLevelDouble( "sculptureScale", 1 ),
+            readLevelDouble( "maxSculptureSeparation", 10 ),
+            readLevelDouble( "sculptureAnimationTime", 4 ),
+            (int)readLevelDouble( "sculptureAnimationKeyframes", 9 ),
+            numPieces,
+            pieceParameters,
+            piecePositions,
+            pieceRotations,
+            pieceMusicParts,
+            powerupFILE,
+            &error,
+            enemyBulletManager,
+            readLevelDouble( "enemyBulletSculptureJarPower", 0.5 ),
+            bossBulletManager,
+            readLevelDouble( "bossBulletSculptureJarPower", 0.5 ),
+            readLevelDouble( "sculptureFriction", 1 ),
+            worldWidth,
+            worldHeight );
+
+    if( powerupFILE != NULL ) {
+        fclose( powerupFILE );
+        }
+    if( error ) {
+        printf( "Error reading from sculpturePiecePowerupSpace file\n" );
+        }
+
+    MusicPlayer *musicPlayer =
+        new MusicPlayer( benchmarkSampleRate, sculptureManager, waveTable,
+                         worldWidth, worldHeight,
+                         benchmarkGridSpacing );
+
+
+
+    SimpleVector<Benchmark *> *benchmarks = new SimpleVector<Benchmark *>();
+
+    benchmarks->push_back( new BlendedControlPointBenchmark( shipSpace ) );
+    benchmarks->push_back( new CreateLinearBlendBenchmark( shipPointA,
+                                                           shipPointB ) );
+    benchmarks->push_back( new GetDrawableObjectsBenchmark(
+                               shipPointMiddle, 0 ) );
+    benchmarks->push_back( new GetDrawableObjectsBenchmark(
+                               shipPointMiddle, smallShipPixelsPerUnit ) );
+    benchmarks->push_back( new EnemyDrawableObjectsBenchmark(
+                               enemyTemplate, 0 ) );
+    benchmarks->push_back( new EnemyDrawableObjectsBenchmark(
+                               enemyTemplate, smallEnemyPixelsPerUnit ) );
+    benchmarks->push_back( new IsBorderInCircleBenchmark( shipObjects ) );
+    benchmarks->push_back( new GetSoundSamplesBenchmark(
+                               soundPoint, soundLengthInSeconds ) );
+    benchmarks->push_back( new GetMoreMusicBenchmark( musicPlayer ) );
+    benchmarks->push_back( new MixMoreMusicBenchmark( musicPlayer ) );
+    benchmarks->push_back( new FilterSamplesBenchmark( reverbFilter ) );
+    benchmarks->push_back( new FilterSamplesInPlaceBenchmark(
+                               inPlaceReverbFilter ) );
+    benchmarks->push_back( new UpdateInOutStatusBenchmark(
+                               sculptureManager ) );
+
+    Color *nearBossGridColor = new Color( 1, 0, 0, 0.5 );
+    Color *farBossGridColor = new Color( 0, 0, 1, 0.5 );
+
+    for( int moveBoss=0; moveBoss<2; moveBoss++ ) {
+        benchmarks->push_back( new UpdateGridColorsBenchmark(
+                                   new GridRenderer( - worldWidth / 2,
+                                                     - worldHeight / 2,
+                                                     worldWidth / 2,
+                                                     worldHeight / 2,
+                                                     benchmarkGridSpacing,
+                                                     nearBossGridColor,
+                                                     farBossGridColor ),
+                                   moveBoss ) );
+        }
+
+    delete nearBossGridColor;
+    delete farBossGridColor;
+
+
+    AllocationProfiler::setEnabled( true );
+
+    printf( "Benchmarks on level %s, %lu ms each:\n",
+            levelName, minMilliseconds );
+    printf( "    %-52s %12s %10s %12s\n",
+            "name", "ns/op", "allocs/op", "bytes/op" );
+
+    SimpleVector<BenchmarkResult> *results =
+        new SimpleVector<BenchmarkResult>();
+
+    int numBenchmarks = benchmarks->size();
+    for( int b=0; b<numBenchmarks; b++ ) {
+        Benchmark *benchmark = *( benchmarks->getElement( b ) );
+
+        if( filter != NULL && strstr( benchmark->mName, filter ) == NULL ) {
+            continue;
+            }
+
+        BenchmarkResult result;
+        runBenchmark( benchmark, minMilliseconds, numSamples, &result );
+
+        printf( "    %-52s %12.1f %10.2f %12.1f\n",
+                result.mName, result.mMedianNanosecondsPerOp,
+                result.mAllocationsPerOp, result.mBytesPerOp );
+
+        results->push_back( result );
+        }
+
+    AllocationProfiler::setEnabled( false );
+
+
+    char jsonWritten = true;
+
+    if( jsonFileName != NULL ) {
+        jsonWritten = writeJSON( jsonFileName, levelName, results );
+        }
+
+    delete results;
+
+    for( int b=0; b<numBenchmarks; b++ ) {
+        delete *( benchmarks->getElement( b ) );
+        }
+    delete benchmarks;
+
+    // the sculpture manager takes the piece arrays and templates
+    delete musicPlayer;
+    delete sculptureManager;
+    delete enemyBulletManager;
+    delete bossBulletManager;
+    delete waveTable;
+
+    delete soundPoint;
+
+    int numShipObjects = shipObjects->size();
+    for( int i=0; i<numShipObjects; i++ ) {
+        delete *( shipObjects->getElement( i ) );
+        }
+    delete shipObjects;
+
+    delete shipPointA;
+    delete shipPointB;
+    delete shipPointMiddle;
+    delete shipSpace;
+    delete enemyTemplate;
+
+    delete randSource;
+
+    if( !jsonWritten ) {
+        return 1;
+        }
+
+    return 0;
+    }
@@ -117,11 +117,50 @@
  *
  * 2005-August-29   Jason Rohrer
  * Disabled the skip-level cheat.
+ *
+ * 2026-October-19   Jason Rohrer
+ * Changed to construct level templates in parallel using a task graph.
+ * Added per-level number of sculpture animation keyframes.
+ * Added command line flags for the level cache.
+ * Added a headless mode that runs the simulation at a fixed timestep
+ * with scripted input and no display or audio device.
+ * Added replay recording and playback, and benchmark timings for
+ * headless runs.
+ * Switched to fixed-length simulation steps, decoupled from the frame
+ * rate, with positions blended between steps when drawing.
+ * Changed to update managers in parallel using a per-step task graph.
+ * Added a thread scaling benchmark for headless runs.
+ * Changed to update batches of enemies in parallel.
+ * Changed to build the drawable objects of each layer in parallel, with
+ * a headless check that the result matches a one-at-a-time build.
+ * Added frame profiler scopes, overlay, and trace output.
+ * Added audio callback telemetry, printed with the frame rate.
+ * Added allocation profiler tags, reports, and a headless budget check.
+ * Added a headless sweep over generated stress levels.
+ * Added a quality governor that lowers rotated copies, grid lines,
+ * sounds, and reverb filters when frames or audio run over budget.
+ * Added a choice of sound outputs, with headless audio written to a file
+ * and a mixing throughput measurement.
+ * Added an audio latency profile read from settings, and a measurement
+ * of callback jitter and underruns for a range of profiles.
+ * Added optional mixing ahead of the audio device on a producer thread.
+ * Latency measurement reports how the audio thread was set up.
+ * Grid drawn from cached vertex arrays, recolored only when the boss or
+ * ship moves.
+ * Off-screen enemies, bullets, and sculpture pieces skipped when drawing,
+ * with counts printed with the frame rate.
+ * Rotated copy stride from the quality governor passed only to the
+ * managers' drawing, so that collisions do not depend on quality.
+ * Level cache made opt-in with -cache.
+ * Mac working directory set before the audio latency profile is read.
+ * Timings now all use the monotonic clock in FrameProfiler.
+ * Headless drivers and latency measurement moved to their own files.
  */
 
 
 #include <GL/glut.h>
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 #include <float.h>
 #include <unistd.h>
@@ -135,6 +174,7 @@
 #include "minorGems/system/Time.h"
 #include "minorGems/system/Thread.h"
 #include "minorGems/io/file/File.h"
+#include "minorGems/util/stringUtils.h"
 
 
 #include "DrawableObject.h"
@@ -149,183 +189,280 @@
 #include "BossManager.h"
 #include "PortalManager.h"
 #include "SoundPlayer.h"
+#include "PortAudioSoundOutput.h"
+#include "NullSoundOutput.h"
+#include "OfflineSoundOutput.h"
+#include "AudioLatencyProfile.h"
+#include "AudioTelemetry.h"
 #include "ReverbSoundFilter.h"
 #include "ParameterizedStereoSound.h"
 #include "MusicPart.h"
 #include "MusicNoteWaveTable.h"
 #include "MusicPlayer.h"
+#include "LevelLoadTaskGraph.h"
+#include "LevelCache.h"
+#include "ReplayLog.h"
+#include "FrameTimingStats.h"
+#include "RenderInterpolation.h"
+#include "WorkStealingThreadPool.h"
+#include "FrameTaskGraph.h"
+#include "FrameProfiler.h"
+#include "AllocationProfiler.h"
+#include "QualityGovernor.h"
+#include "GridRenderer.h"
+#include "ViewBounds.h"
+#include "GameSceneHandler.h"
+
+#ifdef HEADLESS
+    #include "HeadlessRunner.h"
+#else
+    #include "LatencyMeasurement.h"
+#endif
+
+
+
+/**
+ * Level load task that builds the music note wave table.
+ */
+class MusicNoteWaveTableLoadTask : public LevelLoadTask {
 
+    public:
 
-class GameSceneHandler :
-    public SceneHandlerGL, public KeyboardHandlerGL,
-    public RedrawListenerGL { 
-	
-	public:
+        MusicNoteWaveTableLoadTask( unsigned long inSampleRate )
+            : LevelLoadTask( "musicNoteWaveTable" ),
+              mSampleRate( inSampleRate ), mResult( NULL ) {
+            }
 
-        /**
-         * Constructs a sceen handler.
-         *
-         * @param inStartingLevel the level to start on.
-         *   Defaults to 0.
-         */
-        GameSceneHandler( int inStartingLevel = 1 );
+        // implements the LevelLoadTask interface
+        virtual void doWork() {
+            mResult = new MusicNoteWaveTable( mSampleRate );
+            }
 
-        virtual ~GameSceneHandler();
-        
+        unsigned long mSampleRate;
 
-        ScreenGL *mScreen;
+        // must be destroyed by caller
+        MusicNoteWaveTable *mResult;
+    };
 
-        
-        
-		// implements the SceneHandlerGL interface
-		virtual void drawScene();
 
-        // implements the KeyboardHandlerGL interface
-		virtual void keyPressed( unsigned char inKey, int inX, int inY );
-		virtual void specialKeyPressed( int inKey, int inX, int inY );
-		virtual void keyReleased( unsigned char inKey, int inX, int inY );
-		virtual void specialKeyReleased( int inKey, int inX, int inY );
 
-        // implements the RedrawListener interface
-		virtual void fireRedraw();
 
 
+/**
+ * Step task that passes time in a bullet manager.
+ */
+class BulletStepTask : public FrameTask {
 
-        /**
-         * Loads the next level.
-         */
-        void loadNextLevel();
+    public:
 
+        BulletStepTask( char *inName, ShipBulletManager *inManager,
+                        ManagerStepParameters *inParameters )
+            : FrameTask( inName ),
+              mManager( inManager ), mParameters( inParameters ) {
+            }
 
-        /**
-         * Destroys the currently loaded level.
-         */
-        void destroyLevel();
+        // implements the FrameTask interface
+        virtual void doWork( int inThreadIndex ) {
+            mManager->passTime( mParameters->mStepSeconds );
+            }
 
-        
-        
-    protected:
+        ShipBulletManager *mManager;
+        ManagerStepParameters *mParameters;
+    };
 
-        int mLevelNumber;
-        
-        double mFadeLevel;
-        double mFadeTime;
-        
-        // true if ship is in portal to move on to next level
-        char mShipInPortal;
-        
-        double mMaxXPosition;
-        double mMinXPosition;
-        double mMaxYPosition;
-        double mMinYPosition;
 
-        double mGridSpacing;
-        
-        // the time that the last frame was drawn
-        unsigned long mLastFrameSeconds;
-        unsigned long mLastFrameMilliseconds;
 
-        // our current frame rate
-        unsigned long mFrameMillisecondDelta;
+/**
+ * Step task that passes time in the enemy manager.
+ */
+class EnemyStepTask : public FrameTask {
 
+    public:
 
+        EnemyStepTask( EnemyManager *inManager,
+                       ManagerStepParameters *inParameters )
+            : FrameTask( "enemies" ),
+              mManager( inManager ), mParameters( inParameters ) {
+            }
 
-        
-        // tracking our current state of movement
-        double mForwardBackwardMoveRate;
-        double mRightLeftMoveRate;
-        double mMaxMoveRate;
+        // implements the FrameTask interface
+        virtual void doWork( int inThreadIndex ) {
+            mManager->passTime( mParameters->mStepSeconds,
+                                mParameters->mShipPosition,
+                                mPool, inThreadIndex );
+            }
 
-        double mShipAccelleration;
-        double mShipFriction;
-        
-        double mRotationRate;
-        double mBaseRotationRate;
-        double mMaxRotationRate;
-        double mShipRotationAccelleration;
-        
-        double mShipScale;
+        EnemyManager *mManager;
+        ManagerStepParameters *mParameters;
+    };
 
-        double mCurrentShipRadius;
-        
-        char mMovingUp;
-        char mMovingDown;
-        char mMovingLeft;
-        char mMovingRight;
 
-        char mZoomingIn;
-        char mZoomingOut;
 
-        char mRotatingClockwise;
-        char mRotatingCounterClockwise;
+/**
+ * Step task that passes time in the sculpture manager.
+ */
+class SculptureStepTask : public FrameTask {
 
-        Vector3D *mCurrentShipVelocityVector;
-        
-        char mPaused;
-        
-        
-        StdRandomSource *mRandSource;
+    public:
 
-        ParameterizedObject *mShipParameterSpace;
-        
-        ShipBulletManager *mShipBulletManager;
-        double mShipBulletRange;
-        double mShipBulletBaseVelocity;
-        int mMaxNumShipBullets;
-        
-        ShipBulletManager *mEnemyBulletManager;
-        double mEnemyBulletRange;
-        double mEnemyBulletBaseVelocity;
-        double mEnemyBulletsPerSecond;
-        double mEnemyBulletShipJarPower;
-        double mEnemyBulletSculptureJarPower;
-        double mBossBulletShipJarPower;
-        double mBossBulletSculptureJarPower;
-        double mSculptureFriction;
-        double mCurrentShipJarForce;
-
-        ShipBulletManager *mBossBulletManager;
-        ShipBulletManager *mBossDamageManager;
-        
-        EnemyManager *mEnemyManager;
-        int mNumEnemies;
-        
-        SculptureManager *mSculptureManager;
+        SculptureStepTask( SculptureManager *inManager,
+                           ManagerStepParameters *inParameters )
+            : FrameTask( "sculpture" ),
+              mManager( inManager ), mParameters( inParameters ) {
+            }
+
+        // implements the FrameTask interface
+        virtual void doWork( int inThreadIndex ) {
+            mManager->passTime( mParameters->mStepSeconds );
+            }
 
-        BossManager *mBossManager;
-        PortalManager *mPortalManager;
+        SculptureManager *mManager;
+        ManagerStepParameters *mParameters;
+    };
 
-        MusicNoteWaveTable *mWaveTable;
-        MusicPlayer *mMusicPlayer;
-        
-        int mCurrentPieceCarried;
-        double mPiecePickupRadius;
 
-        double mMaxFrameRate;
 
-        char mPrintFrameRate;
-        unsigned long mNumFrames;
-        unsigned long mFrameBatchSize;
-        unsigned long mFrameBatchStartTimeSeconds;
-        unsigned long mFrameBatchStartTimeMilliseconds;
+/**
+ * Step task that passes time in the boss manager.
+ */
+class BossStepTask : public FrameTask {
 
+    public:
 
-        Color *mBackgroundColor;
-        Color *mNearBossGridColor;
-        Color *mFarBossGridColor;
+        BossStepTask( BossManager *inManager,
+                      ManagerStepParameters *inParameters )
+            : FrameTask( "boss" ),
+              mManager( inManager ), mParameters( inParameters ) {
+            }
 
-        Color *mWeakUmbilicalColor;
-        Color *mStrongUmbilicalColor;
-        
-        int mSampleRate;
+        // implements the FrameTask interface
+        virtual void doWork( int inThreadIndex ) {
+            mManager->passTime( mParameters->mStepSeconds,
+                                mParameters->mShipPosition,
+                                mParameters->mShipVelocity );
+            }
+
+        BossManager *mManager;
+        ManagerStepParameters *mParameters;
+    };
+
+
+
+/**
+ * Step task that passes time in the portal manager.
+ */
+class PortalStepTask : public FrameTask {
+
+    public:
+
+        PortalStepTask( PortalManager *inManager,
+                        ManagerStepParameters *inParameters )
+            : FrameTask( "portal" ),
+              mManager( inManager ), mParameters( inParameters ) {
+            }
+
+        // implements the FrameTask interface
+        virtual void doWork( int inThreadIndex ) {
+            mManager->passTime( mParameters->mStepSeconds,
+                                mParameters->mShipPosition );
+            }
+
+        PortalManager *mManager;
+        ManagerStepParameters *mParameters;
+    };
+
+
+
+/**
+ * Task that builds the drawable objects of one layer of the scene.
+ */
+class RenderBuildTask : public FrameTask {
+
+    public:
+
+        RenderBuildTask( char *inName )
+            : FrameTask( inName ), mResult( NULL ) {
+            }
 
-        double mMusicLoudness;
-        int mMaxSimultaneousSounds;
-        SoundPlayer *mSoundPlayer;
         
-        void addRandomEnemy();
+        virtual ~RenderBuildTask() {
+            if( mResult != NULL ) {
+                int numObjects = mResult->size();
+                for( int i=0; i<numObjects; i++ ) {
+                    delete *( mResult->getElement( i ) );
+                    }
+                delete mResult;
+                }
+            }
+
         
-	};
+        /**
+         * Takes the objects built by the last run of this task.
+         *
+         * @return the objects.
+         *   Vector and objects must be destroyed by caller.
+         */
+        SimpleVector<DrawableObject *> *takeResult() {
+            SimpleVector<DrawableObject *> *result = mResult;
+            mResult = NULL;
+            return result;
+            }
+
+    protected:
+        SimpleVector<DrawableObject *> *mResult;
+    };
+
+
+
+/**
+ * Render build task for the objects of one manager.
+ *
+ * Managers only touch their own state when building objects, so tasks
+ * for different managers can run at the same time.
+ */
+template <class Manager>
+class ManagerRenderBuildTask : public RenderBuildTask {
+
+    public:
+
+        /**
+         * @param inInterpolation pointer to the interpolation to pass to
+         *   the manager's getDrawableObjects.
+         * @param inRotatedCopyStride pointer to the rotated copy stride
+         *   to pass to the manager's getDrawableObjects.
+         */
+        ManagerRenderBuildTask( char *inName, Manager *inManager,
+                                double *inInterpolation,
+                                int *inRotatedCopyStride )
+            : RenderBuildTask( inName ),
+              mManager( inManager ), mInterpolation( inInterpolation ),
+              mRotatedCopyStride( inRotatedCopyStride ) {
+            }
+
+        // implements the FrameTask interface
+        virtual void doWork( int inThreadIndex ) {
+            mResult = mManager->getDrawableObjects( *mInterpolation,
+                                                    *mRotatedCopyStride );
+            }
+
+        Manager *mManager;
+        double *mInterpolation;
+        int *mRotatedCopyStride;
+    };
+
+
+
+// the rate of all sound in the game, in samples per second
+// set by main from the audio latency profile before any sound is made
+static unsigned long soundSampleRate = 11025;
+
+// how far ahead of the audio device to mix, or 0 to mix in its callback,
+// and the size of each block mixed ahead
+// also set by main, and left at 0 for outputs driven by the game
+static unsigned long soundLookaheadFrames = 0;
+static unsigned long soundFramesPerBlock = 1024;
+
+
 
 
 
@@ -341,6 +478,18 @@ double baseViewZ = -50;
 void cleanUpAtExit() {
     printf( "exiting\n" );
 
+    #ifdef FRAME_PROFILER
+        if( FrameProfiler::isEnabled() ) {
+            FrameProfiler::printSummary();
+            }
+    #endif
+
+    #ifdef ALLOCATION_PROFILER
+        if( AllocationProfiler::isEnabled() ) {
+            AllocationProfiler::printSummary();
+            }
+    #endif
+
     delete sceneHandler;
     delete screen;
     }
@@ -348,22 +497,381 @@ void cleanUpAtExit() {
 
 
 
+
+#ifdef __mac__
+
+/**
+ * Makes the working directory the one that the app bundle resides in.
+ *
+ * This is especially important on the mac platform, which doesn't set a
+ * proper working directory for double-clicked app bundles.
+ *
+ * @param inAppPath the path to the app executable, as in arg 0.
+ *   Must be destroyed by caller.
+ */
+static void setMacWorkingDirectory( char *inAppPath ) {
+    char *appDirectoryPath = stringDuplicate( inAppPath );
+    
+    char *appNamePointer = strstr( appDirectoryPath,
+                                   "Transcend.app" );
+        
+    // terminate full app path to get parent directory
+    appNamePointer[0] = '\0';
+
+    chdir( appDirectoryPath );
+
+    delete [] appDirectoryPath;
+    }
+
+#endif
+
+
+
+
+
 int main( int inNumArgs, char **inArgs ) {
 
 
     int startingLevel = 1;
-    if( inNumArgs > 1 ) {
-        int numRead = sscanf( inArgs[1], "%d", &startingLevel );
 
-        if( numRead == 1 ) {
-            if( startingLevel < 1 ) {
-                startingLevel = 1;
+    // NULL for no cache
+    char *cacheDirectoryName = NULL;
+    char rebuildCache = false;
+    unsigned long cacheSizeLimitMiB = 32;
+
+    char *recordReplayFileName = NULL;
+
+    unsigned long simulationRate = 60;
+
+    char profile = false;
+    char *profileTraceFileName = NULL;
+
+    char printFrameRate = false;
+    char *audioTelemetryFileName = NULL;
+
+    // 0 to never change quality
+    double frameBudgetMilliseconds = 1000.0 / 60;
+
+    char countAllocations = false;
+    // 0 to only report at exit
+    unsigned long allocationReportInterval = 0;
+    
+    // the manager task graph has little use for more than 4 threads
+    int numThreads = WorkStealingThreadPool::getNumProcessors();
+    if( numThreads > 4 ) {
+        numThreads = 4;
+        }
+    
+    #ifdef HEADLESS
+        // one minute at 60 frames per second by default
+        unsigned long numHeadlessFrames = 3600;
+        unsigned long headlessFrameMilliseconds = 16;
+        char *headlessScriptFileName = NULL;
+        char *replayFileName = NULL;
+        int maxScalingThreads = 0;
+        char checkRenderBuild = false;
+
+        // 0 for no sweep
+        int firstSweepLevel = 0;
+        int lastSweepLevel = 0;
+        char *sweepCSVFileName = NULL;
+
+        // per frame, 0 for no limit
+        unsigned long allocationBudget = 0;
+        unsigned long allocationByteBudget = 0;
+
+        // NULL to discard the sound
+        char *audioFileName = NULL;
+        // 0 for no measurement
+        double audioThroughputSeconds = 0;
+    #else
+        // "portaudio" or "null"
+        char *audioOutputName = "portaudio";
+        // 0 for no measurement
+        double measureLatencySeconds = 0;
+        // -1 to use the setting
+        long audioLookaheadFrames = -1;
+    #endif
+    
+    for( int a=1; a<inNumArgs; a++ ) {
+        if( strcmp( inArgs[a], "-cache" ) == 0 ) {
+            cacheDirectoryName = "cache";
+
+            // directory is optional
+            if( a + 1 < inNumArgs && inArgs[ a + 1 ][0] != '-' ) {
+                cacheDirectoryName = inArgs[ a + 1 ];
+                a++;
+                }
+            }
+        else if( strcmp( inArgs[a], "-rebuildCache" ) == 0 ) {
+            rebuildCache = true;
+            }
+        else if( strcmp( inArgs[a], "-cacheSizeLimit" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            // in MiB
+            sscanf( inArgs[ a + 1 ], "%lu", &cacheSizeLimitMiB );
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-simRate" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            // in simulation steps per second
+            sscanf( inArgs[ a + 1 ], "%lu", &simulationRate );
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-threads" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            sscanf( inArgs[ a + 1 ], "%d", &numThreads );
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-printFrameRate" ) == 0 ) {
+            printFrameRate = true;
+            }
+        else if( strcmp( inArgs[a], "-audioTelemetry" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            audioTelemetryFileName = inArgs[ a + 1 ];
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-noQualityGovernor" ) == 0 ) {
+            frameBudgetMilliseconds = 0;
+            }
+        else if( strcmp( inArgs[a], "-frameBudget" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            // in milliseconds
+            sscanf( inArgs[ a + 1 ], "%lf", &frameBudgetMilliseconds );
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-allocations" ) == 0 ) {
+            countAllocations = true;
+            }
+        else if( strcmp( inArgs[a], "-allocationReport" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            // in frames
+            countAllocations = true;
+            sscanf( inArgs[ a + 1 ], "%lu", &allocationReportInterval );
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-profile" ) == 0 ) {
+            profile = true;
+            }
+        else if( strcmp( inArgs[a], "-profileTrace" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            profileTraceFileName = inArgs[ a + 1 ];
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-recordReplay" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            recordReplayFileName = inArgs[ a + 1 ];
+            a++;
+            }
+        #ifdef HEADLESS
+        else if( strcmp( inArgs[a], "-frames" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            sscanf( inArgs[ a + 1 ], "%lu", &numHeadlessFrames );
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-timestep" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            // in milliseconds
+            sscanf( inArgs[ a + 1 ], "%lu", &headlessFrameMilliseconds );
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-script" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            headlessScriptFileName = inArgs[ a + 1 ];
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-replay" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            replayFileName = inArgs[ a + 1 ];
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-threadScaling" ) == 0 ) {
+            maxScalingThreads = 8;
+            }
+        else if( strcmp( inArgs[a], "-checkRenderBuild" ) == 0 ) {
+            checkRenderBuild = true;
+            }
+        else if( strcmp( inArgs[a], "-stressSweep" ) == 0 &&
+                 a + 2 < inNumArgs ) {
+            sscanf( inArgs[ a + 1 ], "%d", &firstSweepLevel );
+            sscanf( inArgs[ a + 2 ], "%d", &lastSweepLevel );
+            a += 2;
+            }
+        else if( strcmp( inArgs[a], "-sweepCSV" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            sweepCSVFileName = inArgs[ a + 1 ];
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-allocationBudget" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            // mean allocations per frame
+            countAllocations = true;
+            sscanf( inArgs[ a + 1 ], "%lu", &allocationBudget );
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-allocationByteBudget" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            // mean bytes allocated per frame
+            countAllocations = true;
+            sscanf( inArgs[ a + 1 ], "%lu", &allocationByteBudget );
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-audioFile" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            // raw floats if named *.raw, otherwise WAV
+            audioFileName = inArgs[ a + 1 ];
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-audioThroughput" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            // in seconds of sound
+            sscanf( inArgs[ a + 1 ], "%lf", &audioThroughputSeconds );
+            a++;
+            }
+        #else
+        else if( strcmp( inArgs[a], "-audioOutput" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            audioOutputName = inArgs[ a + 1 ];
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-measureLatency" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            // in seconds for each profile
+            sscanf( inArgs[ a + 1 ], "%lf", &measureLatencySeconds );
+            a++;
+            }
+        else if( strcmp( inArgs[a], "-audioLookahead" ) == 0 &&
+                 a + 1 < inNumArgs ) {
+            // in frames, 0 to mix in the device callback
+            sscanf( inArgs[ a + 1 ], "%ld", &audioLookaheadFrames );
+            a++;
+            }
+        #endif
+        else {
+            int numRead = sscanf( inArgs[a], "%d", &startingLevel );
+            
+            if( numRead == 1 ) {
+                if( startingLevel < 1 ) {
+                    startingLevel = 1;
+                    }
                 }
             }
         }
         
+
+    // recorded so that replays can make the same random choices
+    unsigned long randomSeed = time( NULL );
+
+
+    #ifdef __mac__
+        // the settings folder is next to the app bundle, and the profile
+        // is needed before the scene handler opens the audio device
+        setMacWorkingDirectory( inArgs[0] );
+    #endif
+
+    // from the settings folder in the working directory
+    AudioLatencyProfile latencyProfile = AudioLatencyProfile::readSettings();
+
+    soundSampleRate = latencyProfile.mSampleRate;
+    
+    
+    #ifdef HEADLESS
+
+    ReplayPlayer *replayPlayer = NULL;
+
+    if( replayFileName != NULL ) {
+        replayPlayer = new ReplayPlayer( replayFileName );
+
+        if( ! replayPlayer->isValid() ) {
+            delete replayPlayer;
+            return 1;
+            }
+
+        startingLevel = replayPlayer->getStartingLevel();
+        randomSeed = replayPlayer->getRandomSeed();
+        simulationRate = replayPlayer->getSimulationRate();
+        }
+    
+    if( numHeadlessFrames < 1 ) {
+        numHeadlessFrames = 1;
+        }
+    if( headlessFrameMilliseconds < 1 ) {
+        headlessFrameMilliseconds = 1;
+        }
+
+    if( firstSweepLevel > 0 ) {
+        // the first level of the sweep is loaded below, like any other
+        // starting level
+        startingLevel = firstSweepLevel;
+        }
+
+    // no screen and no audio device
+    // the scene handler tracks the ship position itself
+    OfflineSoundOutput *offlineSoundOutput = NULL;
+
+    // runs that replace sceneHandler partway through have no one sound
+    // stream to write
+    if( ( audioFileName != NULL || audioThroughputSeconds > 0 ) &&
+        maxScalingThreads == 0 && firstSweepLevel == 0 ) {
+        
+        int nameLength = 0;
+        if( audioFileName != NULL ) {
+            nameLength = strlen( audioFileName );
+            }
+        
+        char raw = ( nameLength > 4 &&
+                     strcmp( &( audioFileName[ nameLength - 4 ] ),
+                             ".raw" ) == 0 );
+
+        offlineSoundOutput =
+            new OfflineSoundOutput( audioFileName, soundSampleRate, raw,
+                                    latencyProfile.mFramesPerBuffer );
+        }
+    
+    sceneHandler = new GameSceneHandler( startingLevel, offlineSoundOutput,
+                                         randomSeed );
+    screen = NULL;
+
+    sceneHandler->enableBenchmarkTimings();
+
+    if( checkRenderBuild ) {
+        sceneHandler->enableRenderBuildCheck();
+        }
+
+    #else
+
+    if( audioLookaheadFrames >= 0 ) {
+        latencyProfile.mLookaheadFrames = audioLookaheadFrames;
+        }
+    
+    // headless runs drive their outputs from the game, so they never get
+    // here and never mix ahead
+    soundLookaheadFrames = latencyProfile.mLookaheadFrames;
+    soundFramesPerBlock = latencyProfile.mFramesPerBuffer;
+
+    if( measureLatencySeconds > 0 ) {
+        // instead of playing
+        if( LatencyMeasurement::measureProfiles(
+                latencyProfile, measureLatencySeconds ) ) {
+            return 0;
+            }
+        return 1;
+        }
+    
+    SoundOutput *soundOutput;
+
+    if( strcmp( audioOutputName, "null" ) == 0 ) {
+        // mixed in real time, but not played
+        soundOutput =
+            new NullSoundOutput( soundSampleRate,
+                                 latencyProfile.mFramesPerBuffer );
+        }
+    else {
+        soundOutput = new PortAudioSoundOutput( latencyProfile );
+        }
     
-    sceneHandler = new GameSceneHandler( startingLevel );
+    sceneHandler = new GameSceneHandler( startingLevel, soundOutput,
+                                         randomSeed );
 
     // must pass args to GLUT before constructing the screen
     glutInit( &inNumArgs, inArgs );
@@ -374,6 +882,12 @@ int main( int inNumArgs, char **inArgs ) {
 
     sceneHandler->mScreen = screen;
 
+    // headless runs never draw, and keep full quality so that their
+    // results do not depend on how fast they run
+    if( frameBudgetMilliseconds > 0 ) {
+        sceneHandler->enableQualityGovernor( frameBudgetMilliseconds );
+        }
+
     screen->addRedrawListener( sceneHandler );
     
     Vector3D *move = new Vector3D( 0, 0, baseViewZ );
@@ -381,35 +895,177 @@ int main( int inNumArgs, char **inArgs ) {
     delete move;
 
 
-    // do this mac check after constructing scene handler and screen,
-    // since these cause various Mac frameworks to be loaded (which can
-    // change the current working directory out from under us)
+    // do this mac check again after constructing scene handler and
+    // screen, since these cause various Mac frameworks to be loaded (which
+    // can change the current working directory out from under us)
     #ifdef __mac__
-        // make sure working directory is the same as the directory
-        // that the app resides in
-        // this is especially important on the mac platform, which
-        // doesn't set a proper working directory for double-clicked
-        // app bundles
+        setMacWorkingDirectory( inArgs[0] );
+    #endif
+
+    #endif
+
 
-        // arg 0 is the path to the app executable
-        char *appDirectoryPath = stringDuplicate( inArgs[0] );
+    sceneHandler->setSimulationRate( simulationRate );
+    sceneHandler->setNumThreads( numThreads );
+    sceneHandler->setPrintFrameRate( printFrameRate );
+
+    if( audioTelemetryFileName != NULL ) {
+        sceneHandler->setAudioTelemetryFile( audioTelemetryFileName );
+        }
+
+    if( recordReplayFileName != NULL ) {
+        sceneHandler->mReplayRecorder =
+            new ReplayRecorder( recordReplayFileName, startingLevel,
+                                randomSeed,
+                                sceneHandler->getSimulationRate() );
+        }
     
-        char *appNamePointer = strstr( appDirectoryPath,
-                                       "Transcend.app" );
-        
-        // terminate full app path to get parent directory
-        appNamePointer[0] = '\0';
 
-        chdir( appDirectoryPath );
+    // a relative cache directory is relative to the working directory
+    // set above
+    if( cacheDirectoryName != NULL ) {
+        LevelCache::setMaxCacheSize( cacheSizeLimitMiB * 1024 * 1024 );
+        LevelCache::setRebuild( rebuildCache );
+        LevelCache::setCacheDirectory(
+            new File( NULL, cacheDirectoryName ) );
+        }
+
 
-        delete [] appDirectoryPath;
-    #endif
+    if( profile || profileTraceFileName != NULL ) {
+        #ifdef FRAME_PROFILER
+            FrameProfiler::setEnabled( true );
 
+            #ifdef HEADLESS
+                // keep stats for the whole run
+                FrameProfiler::setHistoryLength( numHeadlessFrames );
+            #endif
+        
+            if( profileTraceFileName != NULL ) {
+                FrameProfiler::startTrace( profileTraceFileName );
+                }
+        #else
+            printf( "Frame profiler not compiled in, "
+                    "see FRAME_PROFILER_FLAG in Makefile.common\n" );
+        #endif
+        }
+
+
+    if( countAllocations ) {
+        #ifdef ALLOCATION_PROFILER
+            AllocationProfiler::setEnabled( true );
+            AllocationProfiler::setReportInterval(
+                allocationReportInterval );
+        #else
+            printf( "Allocation profiler not compiled in, "
+                    "see ALLOCATION_PROFILER_FLAG in Makefile.common\n" );
+
+            #ifdef HEADLESS
+                if( allocationBudget > 0 || allocationByteBudget > 0 ) {
+                    // a budget that cannot be checked should not pass
+                    delete sceneHandler;
+                    return 1;
+                    }
+            #endif
+        #endif
+        }
 
 
     
     sceneHandler->loadNextLevel();
 
+
+    #ifdef HEADLESS
+
+    if( replayPlayer != NULL ) {
+        HeadlessRunner::runReplay( replayPlayer );
+
+        delete replayPlayer;
+        }
+    else {
+        SimpleVector<HeadlessInputEvent *> *script = NULL;
+
+        if( headlessScriptFileName != NULL ) {
+            script =
+                HeadlessRunner::readInputScript( headlessScriptFileName );
+            }
+        if( script == NULL ) {
+            script =
+                HeadlessRunner::getDefaultInputScript( numHeadlessFrames );
+            }
+
+        char scalingMatched = true;
+        
+        if( firstSweepLevel > 0 ) {
+            scalingMatched =
+                HeadlessRunner::runStressSweep( firstSweepLevel,
+                                                lastSweepLevel,
+                                                randomSeed, simulationRate,
+                                                numThreads,
+                                                numHeadlessFrames,
+                                                headlessFrameMilliseconds,
+                                                script, sweepCSVFileName );
+            }
+        else if( maxScalingThreads > 0 ) {
+            scalingMatched =
+                HeadlessRunner::runThreadScaling( maxScalingThreads,
+                                                  startingLevel, randomSeed,
+                                                  simulationRate,
+                                                  numHeadlessFrames,
+                                                  headlessFrameMilliseconds,
+                                                  script );
+            }
+        else {
+            HeadlessRunner::runHeadless( numHeadlessFrames,
+                                         headlessFrameMilliseconds,
+                                         script );
+            }
+        
+        int numEvents = script->size();
+        for( int e=0; e<numEvents; e++ ) {
+            delete *( script->getElement( e ) );
+            }
+        delete script;
+
+        if( !scalingMatched ) {
+            delete sceneHandler;
+            return 1;
+            }
+        }
+
+    if( offlineSoundOutput != NULL && audioThroughputSeconds > 0 ) {
+        // continues the sound file, if there is one, after the run's
+        // sound
+        sceneHandler->measureAudioThroughput( offlineSoundOutput,
+                                              audioThroughputSeconds );
+        }
+
+    if( checkRenderBuild ) {
+        unsigned long numMismatches =
+            sceneHandler->getNumRenderBuildMismatches();
+
+        if( numMismatches > 0 ) {
+            printf( "Error:  parallel render build differed from serial "
+                    "build in %lu frames\n", numMismatches );
+            delete sceneHandler;
+            return 1;
+            }
+        printf( "Parallel render build matched serial build in "
+                "every frame\n" );
+        }
+
+    #ifdef ALLOCATION_PROFILER
+        if( ! AllocationProfiler::checkBudget( allocationBudget,
+                                               allocationByteBudget ) ) {
+            delete sceneHandler;
+            return 1;
+            }
+    #endif
+    
+    delete sceneHandler;
+
+    return 0;
+    
+    #else
     
     // register cleanup function, since screen->start() will never return
     atexit( cleanUpAtExit );
@@ -419,15 +1075,20 @@ int main( int inNumArgs, char **inArgs ) {
 
     
     return 0;
-    }
 
+    #endif
+    }
 
 
 
 
 
-GameSceneHandler::GameSceneHandler( int inStartingLevel )
-    : mLevelNumber( inStartingLevel - 1 ),
+GameSceneHandler::GameSceneHandler( int inStartingLevel,
+                                    SoundOutput *inSoundOutput,
+                                    unsigned long inRandomSeed )
+    : mScreen( NULL ),
+      mReplayRecorder( NULL ),
+      mLevelNumber( inStartingLevel - 1 ),
       mFadeLevel( 0 ),   // start fully faded out,
       mFadeTime( 3 ),   // 3 seconds
       mShipInPortal( false ),
@@ -435,6 +1096,9 @@ GameSceneHandler::GameSceneHandler( int inStartingLevel )
       mMaxYPosition( 100 ), mMinYPosition( -100 ),
       mGridSpacing( 10 ),
       mFrameMillisecondDelta( 0 ),
+      mSimulationSecondsOwed( 0 ),
+      mMaxSimulationStepsPerFrame( 5 ),
+      mRenderInterpolation( 1 ),
       mForwardBackwardMoveRate( 0 ),
       mRightLeftMoveRate( 0 ),
       mRotationRate( 0 ),
@@ -442,23 +1106,47 @@ GameSceneHandler::GameSceneHandler( int inStartingLevel )
       mMovingRight( false ), mZoomingIn( false ), mZoomingOut( false ),
       mRotatingClockwise( false ), mRotatingCounterClockwise( false ),
       mPaused( false ),
-      mRandSource( new StdRandomSource() ),
+      mRandSource( new StdRandomSource( inRandomSeed ) ),
+      mThreadPool( new WorkStealingThreadPool( 1 ) ),
+      mManagerTaskGraph( NULL ),
+      mRenderTaskGraph( NULL ),
+      mRenderLayerTasks( new SimpleVector<RenderBuildTask *>() ),
+      mCheckRenderBuild( false ),
+      mNumRenderBuildMismatches( 0 ),
       mMaxFrameRate( 400 ),  // don't limit frame rate
       mPrintFrameRate( false ),
       mNumFrames( 0 ), mFrameBatchSize( 100 ),
       mFrameBatchStartTimeSeconds( time( NULL ) ),
       mFrameBatchStartTimeMilliseconds( 0 ),
+      mNumCulledInBatch( 0 ), mNumDrawnInBatch( 0 ),
+      mShowProfilerOverlay( false ),
+      mAudioTelemetrySummary( new AudioTelemetrySummary() ),
+      mAudioTelemetryFILE( NULL ),
+      mQualityGovernor( NULL ),
+      mRotatedCopyStride( 1 ),
+      mFrameWorkStartMicroseconds( 0 ),
       mMusicLoudness( 0.1 ),
-      mMaxSimultaneousSounds( 2 ) {
+      mMaxSimultaneousSounds( 2 ),
+      mViewPosition( new Vector3D( 0, 0, 0 ) ),
+      mViewOrientation( new Angle3D( 0, 0, 0 ) ),
+      mPreviousViewPosition( new Vector3D( 0, 0, 0 ) ),
+      mPreviousViewOrientation( new Angle3D( 0, 0, 0 ) ),
+      mHeadlessSoundFramesOwed( 0 ),
+      mBenchmarkTimings( NULL ) {
 
 
     Time::getCurrentTime( &mLastFrameSeconds, &mLastFrameMilliseconds );
+
+    setSimulationRate( 60 );
     
-    mSampleRate = 11025;
+    mSampleRate = soundSampleRate;
     
     mSoundPlayer = new SoundPlayer( mSampleRate,
                                     mMaxSimultaneousSounds,
-                                    NULL, mMusicLoudness );
+                                    NULL, mMusicLoudness,
+                                    inSoundOutput,
+                                    soundLookaheadFrames,
+                                    soundFramesPerBlock );
 
     }
 
@@ -466,20 +1154,22 @@ GameSceneHandler::GameSceneHandler( int inStartingLevel )
 
 void GameSceneHandler::loadNextLevel() {
 
+    FRAME_PROFILER_SCOPE( "loadNextLevel" );
+    ALLOCATION_PROFILER_TAG( "loadNextLevel" );
     
     mCurrentShipVelocityVector = new Vector3D( 0, 0, 0 );
 
     // reset ship position and angle
     Vector3D *viewPosition = new Vector3D( 0, 0, baseViewZ );
-    mScreen->setViewPosition( viewPosition );
+    setViewPosition( viewPosition );
     delete viewPosition;
 
     // reset view orientation back to the zero vector
-    Angle3D *viewOrientation = mScreen->getViewOrientation();
+    Angle3D *viewOrientation = getViewOrientation();
     Angle3D *viewRotation = new Angle3D( viewOrientation );
     viewRotation->scale( -1 );
 
-    mScreen->rotateView( viewRotation );
+    rotateView( viewRotation );
     delete viewRotation;
     
     int i;
@@ -616,6 +1306,11 @@ void GameSceneHandler::loadNextLevel() {
         mFarBossGridColor = new Color( 0, 0, 1, 0.5 );
         }
 
+    mGridRenderer = new GridRenderer( mMinXPosition, mMinYPosition,
+                                      mMaxXPosition, mMaxYPosition,
+                                      mGridSpacing,
+                                      mNearBossGridColor, mFarBossGridColor );
+
 
 
     FILE *weakUmbilicalColorFILE =
@@ -647,37 +1342,87 @@ void GameSceneHandler::loadNextLevel() {
 
 
 
-    
-    mWaveTable = new MusicNoteWaveTable( mSampleRate );
 
-    
-    
-    FILE *shipFILE = LevelDirectoryManager::getStdStream( "ship", true );
-    
-    mShipParameterSpace = new ParameterizedObject( shipFILE,
-                                                   &error );
-    if( error ) {
+    // The templates below do not depend on each other, so construct
+    // them all at once on a few threads.
+    // Each task reads its own files through LevelDirectoryManager, which
+    // is safe to use from several threads.
+    LevelLoadTaskGraph *loadGraph = new LevelLoadTaskGraph( 4 );
+
+    MusicNoteWaveTableLoadTask *waveTableTask =
+        new MusicNoteWaveTableLoadTask( mSampleRate );
+    
+    LevelFileLoadTask<ParameterizedObject> *shipTask =
+        new LevelFileLoadTask<ParameterizedObject>( "ship" );
+    LevelFileLoadTask<ParameterizedObject> *firstSculpturePieceTask =
+        new LevelFileLoadTask<ParameterizedObject>( "firstSculpturePiece" );
+    LevelFileLoadTask<ParameterizedObject> *secondSculpturePieceTask =
+        new LevelFileLoadTask<ParameterizedObject>( "secondSculpturePiece" );
+    LevelFileLoadTask<ParameterizedObject> *portalTask =
+        new LevelFileLoadTask<ParameterizedObject>( "portal" );
+
+    LevelFileLoadTask<ShipBullet> *shipBulletTask =
+        new LevelFileLoadTask<ShipBullet>( "shipBullet" );
+    LevelFileLoadTask<ShipBullet> *enemyBulletTask =
+        new LevelFileLoadTask<ShipBullet>( "enemyBullet" );
+    LevelFileLoadTask<ShipBullet> *bossBulletTask =
+        new LevelFileLoadTask<ShipBullet>( "bossBullet" );
+    LevelFileLoadTask<ShipBullet> *bossDamageTask =
+        new LevelFileLoadTask<ShipBullet>( "bossDamage" );
+
+    LevelFileLoadTask<BulletSound> *shipBulletSoundTask =
+        new LevelFileLoadTask<BulletSound>( "shipBulletSound" );
+    LevelFileLoadTask<BulletSound> *enemyBulletSoundTask =
+        new LevelFileLoadTask<BulletSound>( "enemyBulletSound" );
+    LevelFileLoadTask<BulletSound> *bossBulletSoundTask =
+        new LevelFileLoadTask<BulletSound>( "bossBulletSound" );
+    LevelFileLoadTask<BulletSound> *enemyExplosionSoundTask =
+        new LevelFileLoadTask<BulletSound>( "enemyExplosionSound" );
+    LevelFileLoadTask<BulletSound> *bossExplosionSoundTask =
+        new LevelFileLoadTask<BulletSound>( "bossExplosionSound" );
+
+    LevelFileLoadTask<Enemy> *enemyTask =
+        new LevelFileLoadTask<Enemy>( "enemy" );
+    LevelFileLoadTask<Enemy> *bossTask =
+        new LevelFileLoadTask<Enemy>( "boss" );
+
+    // add the slowest tasks first so they start first
+    loadGraph->addTask( waveTableTask );
+    loadGraph->addTask( shipBulletSoundTask );
+    loadGraph->addTask( enemyBulletSoundTask );
+    loadGraph->addTask( bossBulletSoundTask );
+    loadGraph->addTask( enemyExplosionSoundTask );
+    loadGraph->addTask( bossExplosionSoundTask );
+    loadGraph->addTask( shipTask );
+    loadGraph->addTask( shipBulletTask );
+    loadGraph->addTask( enemyBulletTask );
+    loadGraph->addTask( bossBulletTask );
+    loadGraph->addTask( bossDamageTask );
+    loadGraph->addTask( firstSculpturePieceTask );
+    loadGraph->addTask( secondSculpturePieceTask );
+    loadGraph->addTask( enemyTask );
+    loadGraph->addTask( bossTask );
+    loadGraph->addTask( portalTask );
+
+    loadGraph->run();
+    loadGraph->printTimings();
+
+    
+    mWaveTable = waveTableTask->mResult;
+
+    
+    mShipParameterSpace = shipTask->mResult;
+
+    if( shipTask->mError ) {
         printf( "Error reading control points from ship file\n" );
         }
 
-    if( shipFILE != NULL ) {
-        fclose( shipFILE );
-        }
-
-    
-    FILE *shipBulletFILE = LevelDirectoryManager::getStdStream( "shipBullet",
-                                                                true );
     
-    error = false;
-    ShipBullet *shipBulletTemplate = new ShipBullet( shipBulletFILE, &error );
+    ShipBullet *shipBulletTemplate = shipBulletTask->mResult;
 
-    if( error ) {
+    if( shipBulletTask->mError ) {
         printf( "Error reading from shipBullet file\n" );
         }
-    
-    if( shipBulletFILE != NULL ) {
-        fclose( shipBulletFILE );
-        }
 
 
     error = false;
@@ -692,21 +1437,12 @@ void GameSceneHandler::loadNextLevel() {
 
     
 
-    FILE *shipBulletSoundFILE =
-        LevelDirectoryManager::getStdStream( "shipBulletSound", true );
-    
-    error = false;
-    BulletSound *shipBulletSoundTemplate =
-        new BulletSound( shipBulletSoundFILE, &error );
+    BulletSound *shipBulletSoundTemplate = shipBulletSoundTask->mResult;
 
-    if( error ) {
+    if( shipBulletSoundTask->mError ) {
         printf( "Error reading from shipBulletSound file\n" );
         }
     
-    if( shipBulletSoundFILE != NULL ) {
-        fclose( shipBulletSoundFILE );
-        }
-    
     mShipBulletManager =
         new ShipBulletManager( shipBulletTemplate,
                                shipBulletScale,
@@ -753,20 +1489,11 @@ void GameSceneHandler::loadNextLevel() {
         }
     
 
-    FILE *enemyBulletFILE = LevelDirectoryManager::getStdStream( "enemyBullet",
-                                                                 true );
-    
-    error = false;
-    ShipBullet *enemyBulletTemplate =
-        new ShipBullet( enemyBulletFILE, &error );
+    ShipBullet *enemyBulletTemplate = enemyBulletTask->mResult;
 
-    if( error ) {
+    if( enemyBulletTask->mError ) {
         printf( "Error reading from enemyBullet file\n" );
         }
-    
-    if( enemyBulletFILE != NULL ) {
-        fclose( enemyBulletFILE );
-        }
 
 
     error = false;
@@ -780,20 +1507,11 @@ void GameSceneHandler::loadNextLevel() {
         }
     
 
-    FILE *enemyBulletSoundFILE =
-        LevelDirectoryManager::getStdStream( "enemyBulletSound", true );
-    
-    error = false;
-    BulletSound *enemyBulletSoundTemplate =
-        new BulletSound( enemyBulletSoundFILE, &error );
+    BulletSound *enemyBulletSoundTemplate = enemyBulletSoundTask->mResult;
 
-    if( error ) {
+    if( enemyBulletSoundTask->mError ) {
         printf( "Error reading from enemyBulletSound file\n" );
         }
-    
-    if( enemyBulletSoundFILE != NULL ) {
-        fclose( enemyBulletSoundFILE );
-        }
 
 
 
@@ -917,20 +1635,11 @@ void GameSceneHandler::loadNextLevel() {
 
     
 
-    FILE *bossBulletFILE = LevelDirectoryManager::getStdStream( "bossBullet",
-                                                                 true );
-    
-    error = false;
-    ShipBullet *bossBulletTemplate =
-        new ShipBullet( bossBulletFILE, &error );
+    ShipBullet *bossBulletTemplate = bossBulletTask->mResult;
 
-    if( error ) {
+    if( bossBulletTask->mError ) {
         printf( "Error reading from bossBullet file\n" );
         }
-    
-    if( bossBulletFILE != NULL ) {
-        fclose( bossBulletFILE );
-        }
 
     error = false;
     double bossBulletScale =
@@ -943,20 +1652,11 @@ void GameSceneHandler::loadNextLevel() {
         }
     
     
-    FILE *bossBulletSoundFILE =
-        LevelDirectoryManager::getStdStream( "bossBulletSound", true );
-    
-    error = false;
-    BulletSound *bossBulletSoundTemplate =
-        new BulletSound( bossBulletSoundFILE, &error );
+    BulletSound *bossBulletSoundTemplate = bossBulletSoundTask->mResult;
 
-    if( error ) {
+    if( bossBulletSoundTask->mError ) {
         printf( "Error reading from bossBulletSound file\n" );
         }
-    
-    if( bossBulletSoundFILE != NULL ) {
-        fclose( bossBulletSoundFILE );
-        }
 
     
     
@@ -1008,38 +1708,20 @@ void GameSceneHandler::loadNextLevel() {
 
 
 
-    FILE *firstSculpturePieceFILE =
-        LevelDirectoryManager::getStdStream( "firstSculpturePiece", true );
-    
-    error = false;
-    ParameterizedObject *firstPieceSpace =
-        new ParameterizedObject( firstSculpturePieceFILE,
-                                 &error );
-    if( error ) {
+    ParameterizedObject *firstPieceSpace = firstSculpturePieceTask->mResult;
+
+    if( firstSculpturePieceTask->mError ) {
         printf(
             "Error reading control points from firstSculpturePiece file\n" );
         }
 
-    if( firstSculpturePieceFILE != NULL ) {
-        fclose( firstSculpturePieceFILE );
-        }
+    ParameterizedObject *secondPieceSpace = secondSculpturePieceTask->mResult;
 
-    FILE *secondSculpturePieceFILE =
-        LevelDirectoryManager::getStdStream( "secondSculpturePiece", true );
-    
-    error = false;
-    ParameterizedObject *secondPieceSpace =
-        new ParameterizedObject( secondSculpturePieceFILE,
-                                 &error );
-    if( error ) {
+    if( secondSculpturePieceTask->mError ) {
         printf(
             "Error reading control points from secondSculpturePiece file\n" );
         }
 
-    if( secondSculpturePieceFILE != NULL ) {
-        fclose( secondSculpturePieceFILE );
-        }
-
 
     error = false;
     int numPieces =
@@ -1122,6 +1804,18 @@ void GameSceneHandler::loadNextLevel() {
         }
 
 
+    error = false;
+    int sculptureAnimationKeyframes =
+        LevelDirectoryManager::readIntFileContents(
+            "sculptureAnimationKeyframes",
+            &error,
+            true );
+    if( error ) {
+        // default
+        sculptureAnimationKeyframes = 9;
+        }
+
+
     
     
     
@@ -1135,6 +1829,7 @@ void GameSceneHandler::loadNextLevel() {
                                               sculptureScale,
                                               maxDistanceToBePartOfSculpture,
                                               sculptureAnimationTime,
+                                              sculptureAnimationKeyframes,
                                               numPieces,
                                               pieceParameters,
                                               piecePositions,
@@ -1227,19 +1922,11 @@ void GameSceneHandler::loadNextLevel() {
     mCurrentShipJarForce = 0;
 
 
-    FILE *enemyFILE = LevelDirectoryManager::getStdStream( "enemy",
-                                                           true );
-
-    error = false;
-    Enemy *enemyTemplate = new Enemy( enemyFILE, &error );
+    Enemy *enemyTemplate = enemyTask->mResult;
 
-    if( error ) {
+    if( enemyTask->mError ) {
         printf( "Error reading from enemy file\n" );
         }
-    
-    if( enemyFILE != NULL ) {
-        fclose( enemyFILE );
-        }
 
     error = false;
     double enemyScale =
@@ -1274,20 +1961,11 @@ void GameSceneHandler::loadNextLevel() {
         }
 
     
-    FILE *enemyExplosionSoundFILE =
-        LevelDirectoryManager::getStdStream( "enemyExplosionSound", true );
-    
-    error = false;
-    BulletSound *enemyExplosionSoundTemplate =
-        new BulletSound( enemyExplosionSoundFILE, &error );
+    BulletSound *enemyExplosionSoundTemplate = enemyExplosionSoundTask->mResult;
 
-    if( error ) {
+    if( enemyExplosionSoundTask->mError ) {
         printf( "Error reading from enemyExplosionSound file\n" );
         }
-    
-    if( enemyExplosionSoundFILE != NULL ) {
-        fclose( enemyExplosionSoundFILE );
-        }
 
 
     
@@ -1322,20 +2000,12 @@ void GameSceneHandler::loadNextLevel() {
 
     
     
-    FILE *bossFILE = LevelDirectoryManager::getStdStream( "boss",
-                                                           true );
-
-    error = false;
-    Enemy *bossTemplate = new Enemy( bossFILE, &error );
+    Enemy *bossTemplate = bossTask->mResult;
 
-    if( error ) {
+    if( bossTask->mError ) {
         printf( "Error reading from boss file\n" );
         }
 
-    if( bossFILE != NULL ) {
-        fclose( bossFILE );
-        }
-
 
     error = false;
     double bossScale =
@@ -1482,38 +2152,20 @@ void GameSceneHandler::loadNextLevel() {
 
 
     
-    FILE *bossExplosionSoundFILE =
-        LevelDirectoryManager::getStdStream( "bossExplosionSound", true );
-    
-    error = false;
-    BulletSound *bossExplosionSoundTemplate =
-        new BulletSound( bossExplosionSoundFILE, &error );
+    BulletSound *bossExplosionSoundTemplate = bossExplosionSoundTask->mResult;
 
-    if( error ) {
+    if( bossExplosionSoundTask->mError ) {
         printf( "Error reading from bossExplosionSound file\n" );
         }
-    
-    if( bossExplosionSoundFILE != NULL ) {
-        fclose( bossExplosionSoundFILE );
-        }
 
 
     // "stuff" that is spit out when a bullet hits the boss
     // re-use the ShipBullet code for it
-    FILE *bossDamageFILE = LevelDirectoryManager::getStdStream( "bossDamage",
-                                                                 true );
-    
-    error = false;
-    ShipBullet *bossDamageTemplate =
-        new ShipBullet( bossDamageFILE, &error );
+    ShipBullet *bossDamageTemplate = bossDamageTask->mResult;
 
-    if( error ) {
+    if( bossDamageTask->mError ) {
         printf( "Error reading from bossDamage file\n" );
         }
-    
-    if( bossDamageFILE != NULL ) {
-        fclose( bossDamageFILE );
-        }
 
 
     error = false;
@@ -1577,16 +2229,10 @@ void GameSceneHandler::loadNextLevel() {
 
 
     
-    FILE *portalFILE =
-        LevelDirectoryManager::getStdStream( "portal", true );
-    
-    error = false;
-    ParameterizedObject *portalTemplate =
-        new ParameterizedObject( portalFILE, &error );
+    ParameterizedObject *portalTemplate = portalTask->mResult;
 
-    if( portalFILE != NULL ) {
-        fclose( portalFILE );
-        }
+    // done with the task graph (results now owned by managers)
+    delete loadGraph;
 
 
     error = false;
@@ -1631,6 +2277,18 @@ void GameSceneHandler::loadNextLevel() {
     for( i=0; i<mNumEnemies; i++ ) {
         addRandomEnemy();
         }
+
+
+    // don't blend the jump back to the center into the next frame
+    // (the new managers start out with no saved state to blend from)
+    delete mPreviousViewPosition;
+    mPreviousViewPosition = new Vector3D( mViewPosition );
+    delete mPreviousViewOrientation;
+    mPreviousViewOrientation = new Angle3D( mViewOrientation );
+
+
+    buildManagerTaskGraph();
+    buildRenderTaskGraph();
     }
 
 
@@ -1640,11 +2298,112 @@ GameSceneHandler::~GameSceneHandler() {
 
     destroyLevel();
 
+    delete mRenderLayerTasks;
+    delete mThreadPool;
+
     delete mSoundPlayer;
+
+    delete mAudioTelemetrySummary;
+    if( mAudioTelemetryFILE != NULL ) {
+        fclose( mAudioTelemetryFILE );
+        }
+
+    if( mQualityGovernor != NULL ) {
+        delete mQualityGovernor;
+        }
+
+    delete mViewPosition;
+    delete mViewOrientation;
+    delete mPreviousViewPosition;
+    delete mPreviousViewOrientation;
+
+    if( mReplayRecorder != NULL ) {
+        delete mReplayRecorder;
+        }
+
+    if( mBenchmarkTimings != NULL ) {
+        int numTimings = mBenchmarkTimings->size();
+        for( int i=0; i<numTimings; i++ ) {
+            delete *( mBenchmarkTimings->getElement( i ) );
+            }
+        delete mBenchmarkTimings;
+        }
+    }
+
+
+
+Vector3D *GameSceneHandler::getViewPosition() {
+    return new Vector3D( mViewPosition );
+    }
+
+
+
+void GameSceneHandler::setViewPosition( Vector3D *inPosition ) {
+    delete mViewPosition;
+    mViewPosition = new Vector3D( inPosition );
+    }
+
+
+
+void GameSceneHandler::moveView( Vector3D *inPositionChange ) {
+    mViewPosition->add( inPositionChange );
+    }
+
+
+
+Angle3D *GameSceneHandler::getViewOrientation() {
+    return mViewOrientation;
+    }
+
+
+
+void GameSceneHandler::rotateView( Angle3D *inOrientationChange ) {
+    mViewOrientation->add( inOrientationChange );
+    }
+
+
+
+Vector3D *GameSceneHandler::getInterpolatedViewPosition() {
+    return RenderInterpolation::interpolatePosition( mPreviousViewPosition,
+                                                     mViewPosition,
+                                                     mRenderInterpolation );
+    }
+
+
+
+Angle3D *GameSceneHandler::getInterpolatedViewOrientation() {
+    return RenderInterpolation::interpolateRotation( mPreviousViewOrientation,
+                                                     mViewOrientation,
+                                                     mRenderInterpolation );
+    }
+
+
+
+void GameSceneHandler::updateScreenView() {
+    if( mScreen == NULL ) {
+        return;
+        }
+
+    Vector3D *position = getInterpolatedViewPosition();
+    mScreen->setViewPosition( position );
+    delete position;
+
+    // ScreenGL can only rotate its view, so rotate by the difference
+    Angle3D *rotation = getInterpolatedViewOrientation();
+    rotation->subtract( mScreen->getViewOrientation() );
+    mScreen->rotateView( rotation );
+    delete rotation;
     }
 
 
 void GameSceneHandler::destroyLevel() {
+
+    delete mManagerTaskGraph;
+    mManagerTaskGraph = NULL;
+
+    delete mRenderTaskGraph;
+    mRenderTaskGraph = NULL;
+    mRenderLayerTasks->deleteAll();
     
     delete mShipParameterSpace;
     delete mShipBulletManager;
@@ -1665,6 +2424,7 @@ void GameSceneHandler::destroyLevel() {
     delete mBackgroundColor;
     delete mNearBossGridColor;
     delete mFarBossGridColor;
+    delete mGridRenderer;
 
     delete mWeakUmbilicalColor;
     delete mStrongUmbilicalColor;
@@ -1723,7 +2483,97 @@ void GameSceneHandler::addRandomEnemy() {
 
 
 
+/**
+ * Draws the objects in a vector and destroys them.
+ *
+ * @param inObjects the objects to draw.
+ *   Will be destroyed by this call.
+ * @param inRotation the rotation to draw them with.
+ *   Must be destroyed by caller.
+ * @param inOffset the offset to draw them at.
+ *   Must be destroyed by caller.
+ */
+static void drawDrawableObjects( SimpleVector<DrawableObject *> *inObjects,
+                                 Angle3D *inRotation, Vector3D *inOffset ) {
+    FRAME_PROFILER_SCOPE( "drawObjects" );
+    
+    int numObjects = inObjects->size();
+
+    for( int i=0; i<numObjects; i++ ) {
+        DrawableObject *component = *( inObjects->getElement( i ) );
+        component->draw( 1, inRotation, inOffset );
+        delete component;
+        }
+    delete inObjects;
+    }
+
+
+
+#ifdef FRAME_PROFILER
+
+/**
+ * Draws the frame profiler stats as text over the top left corner of
+ * the window.
+ */
+static void drawFrameProfilerOverlay() {
+    SimpleVector<char *> *lines = FrameProfiler::getSummaryLines();
+    int numLines = lines->size();
+    
+    int windowWidth = glutGet( GLUT_WINDOW_WIDTH );
+    int windowHeight = glutGet( GLUT_WINDOW_HEIGHT );
+    
+    // draw in window pixel coordinates
+    glMatrixMode( GL_PROJECTION );
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho( 0, windowWidth, 0, windowHeight, -1, 1 );
+    
+    glMatrixMode( GL_MODELVIEW );
+    glPushMatrix();
+    glLoadIdentity();
+
+    // each line of the 8x13 font is 13 pixels high
+    int lineHeight = 14;
+    int textHeight = lineHeight * numLines + 8;
+
+    // darken the background so the text is readable over the game
+    glBegin( GL_QUADS );
+        glColor4f( 0, 0, 0, 0.6 );
+        glVertex2d( 0, windowHeight );
+        glVertex2d( windowWidth, windowHeight );
+        glVertex2d( windowWidth, windowHeight - textHeight );
+        glVertex2d( 0, windowHeight - textHeight );
+    glEnd();
+
+    glColor4f( 1, 1, 1, 1 );
+    
+    for( int i=0; i<numLines; i++ ) {
+        char *line = *( lines->getElement( i ) );
+
+        glRasterPos2d( 4, windowHeight - lineHeight * ( i + 1 ) );
+        
+        for( int c=0; line[c] != '\0'; c++ ) {
+            glutBitmapCharacter( GLUT_BITMAP_8_BY_13, line[c] );
+            }
+        
+        delete [] line;
+        }
+    delete lines;
+
+    glPopMatrix();
+    glMatrixMode( GL_PROJECTION );
+    glPopMatrix();
+    glMatrixMode( GL_MODELVIEW );
+    }
+
+#endif
+
+
+
 void GameSceneHandler::drawScene() {
+    FRAME_PROFILER_SCOPE( "draw" );
+    ALLOCATION_PROFILER_TAG( "draw" );
+    
     glClearColor( mBackgroundColor->r,
                   mBackgroundColor->g,
                   mBackgroundColor->b,
@@ -1734,7 +2584,8 @@ void GameSceneHandler::drawScene() {
     glDisable( GL_DEPTH_TEST );
 
 
-    Vector3D *viewPosition = mScreen->getViewPosition();
+    // fireRedraw has already run this frame's simulation steps
+    Vector3D *viewPosition = getInterpolatedViewPosition();
     viewPosition->mZ = 0;
 
     // draw a large, semi-transparent square to make trails fade over time
@@ -1755,225 +2606,58 @@ void GameSceneHandler::drawScene() {
     // grid color based on boss position
     Vector3D *bossPostion = mBossManager->getBossPosition();
     
-    glLineWidth( 2 );
-    glBegin( GL_LINES );
-
-        for( double x=mMinXPosition; x<=mMaxXPosition; x+=mGridSpacing ) {
-            for( double y=mMinYPosition; y<=mMaxYPosition; y+=mGridSpacing ) {
-                
-                Vector3D *gridSpot = new Vector3D( x, y, 0 );
-
-                double bossDistance = gridSpot->getDistance( bossPostion );
-
-                double shipDistance = gridSpot->getDistance( viewPosition );
-
-                delete gridSpot;
-                
-                double nearColorWeight = 1 -
-                    bossDistance / ( mMaxXPosition - mMinXPosition );
-
-                if( shipDistance < 20 ) {
-                    // ship override's boss' effect on grid
-                    double shipFactor = 1 - ( shipDistance / 19 );
-
-                    nearColorWeight -= shipFactor;
-                    }
-
-                if( nearColorWeight < 0 ) {
-                    nearColorWeight = 0;
-                    }
-
-                
-                double farColorWeight = 1 - nearColorWeight;
-
-                glColor4f( nearColorWeight * mNearBossGridColor->r +
-                               farColorWeight * mFarBossGridColor->r,
-                           nearColorWeight * mNearBossGridColor->g +
-                               farColorWeight * mFarBossGridColor->g,
-                           nearColorWeight * mNearBossGridColor->b +
-                               farColorWeight * mFarBossGridColor->b,
-                           nearColorWeight * mNearBossGridColor->a +
-                               farColorWeight * mFarBossGridColor->a );
-            
-                glVertex2d( x, y );
-
-                if( y != mMinYPosition &&
-                    y != mMaxYPosition ) {
-
-                    // draw start vertex for next segment
-                    glVertex2d( x, y );
-                    }                
-                }
-            
-            }
-        for( double y=mMinYPosition; y<=mMaxYPosition; y+=mGridSpacing ) {
-            for( double x=mMinXPosition; x<=mMaxXPosition; x+=mGridSpacing ) {
-                
-                Vector3D *gridSpot = new Vector3D( x, y, 0 );
-
-                double bossDistance = gridSpot->getDistance( bossPostion );
-                
-                double shipDistance = gridSpot->getDistance( viewPosition );
-                
-                delete gridSpot;
-                
-                double nearColorWeight = 1 -
-                    bossDistance / ( mMaxXPosition - mMinXPosition );
-
-                if( shipDistance < 20 ) {
-                    // ship override's boss' effect on grid
-                    double shipFactor = 1 - ( shipDistance / 19 );
-
-                    nearColorWeight -= shipFactor;
-                    }
-                
-                if( nearColorWeight < 0 ) {
-                    nearColorWeight = 0;
-                    }
-                double farColorWeight = 1 - nearColorWeight;
-
-                glColor4f( nearColorWeight * mNearBossGridColor->r +
-                               farColorWeight * mFarBossGridColor->r,
-                           nearColorWeight * mNearBossGridColor->g +
-                               farColorWeight * mFarBossGridColor->g,
-                           nearColorWeight * mNearBossGridColor->b +
-                               farColorWeight * mFarBossGridColor->b,
-                           nearColorWeight * mNearBossGridColor->a +
-                               farColorWeight * mFarBossGridColor->a );
-            
-                glVertex2d( x, y );
-
-                if( x != mMinXPosition &&
-                    x != mMaxXPosition ) {
+    // fewer lines when the quality governor asks for them
+    int gridStride = 1;
+    if( mQualityGovernor != NULL ) {
+        gridStride = mQualityGovernor->getGridStride();
+        }
 
-                    // draw start vertex for next segment
-                    glVertex2d( x, y );
-                    }                
-                }
-            }
-    glEnd();
+    mGridRenderer->draw( bossPostion, viewPosition, gridStride );
 
     delete bossPostion;
     
-
-    unsigned long lastMillisecondDelta = mFrameMillisecondDelta;
     
-    // how many milliseconds have passed since the last frame
-    mFrameMillisecondDelta =
-        Time::getMillisecondsSince( mLastFrameSeconds,
-                                    mLastFrameMilliseconds );
 
+    // skip objects that are off screen
+    // the view was set up by ScreenGL before calling drawScene
+    ViewBounds *viewBounds = ViewBounds::readFromGL();
+    setManagerViewBounds( viewBounds );
     
-    // lock down to 30 frames per second
-    unsigned long minFrameTime = (unsigned long)( 1000 / mMaxFrameRate );
-    if( mFrameMillisecondDelta < minFrameTime ) {
-        unsigned long timeToSleep = minFrameTime - mFrameMillisecondDelta;
-        Thread::staticSleep( timeToSleep );
-
-        // get new frame second delta, including sleep time
-        mFrameMillisecondDelta =
-            Time::getMillisecondsSince( mLastFrameSeconds,
-                                        mLastFrameMilliseconds );
-        }
+    // build objects for all managers at once
+    buildDrawableObjects();
 
-    // avoid huge position "jumps" if we have a very large delay during a frame
-    // (possibly caused by something going on in the background)
-    // This will favor a slight visual slow down, but this is better than
-    // a disorienting jump
-
-    // skip this check if we are just starting up
-    if( lastMillisecondDelta != 0 ) {
-        if( mFrameMillisecondDelta > 6 * lastMillisecondDelta ) {
-            // limit:  this frame represents at most twice the jump of the last
-            // frame
-            // printf( "Limiting time jump (requested=%lu ms, last=%lu ms)\n",
-            //        mFrameMillisecondDelta, lastMillisecondDelta );
-
-            if( mFrameMillisecondDelta > 10000 ) {
-                printf( "Time between frames more than 10 seconds:\n" );
-                // way too big... investigate
-                printf( "Last time = %lu s, %lu ms\n",
-                        mLastFrameSeconds, mLastFrameMilliseconds );
-
-                Time::getCurrentTime( &mLastFrameSeconds,
-                                      &mLastFrameMilliseconds );
-                printf( "current time = %lu s, %lu ms\n",
-                        mLastFrameSeconds, mLastFrameMilliseconds );
-
-                }
-            
-            mFrameMillisecondDelta = 2 * lastMillisecondDelta;
-            
-            }
+    setManagerViewBounds( NULL );
+    if( viewBounds != NULL ) {
+        delete viewBounds;
         }
-    
-    double frameSecondsDelta = (double)mFrameMillisecondDelta / 1000.0;
-
-    
-    // record the time that this frame was drawn
-    Time::getCurrentTime( &mLastFrameSeconds, &mLastFrameMilliseconds );
-
-
-    
 
-    if( !mPaused ) {
-        // tell managers about the time delta
-        mShipBulletManager->passTime( frameSecondsDelta );
-        mEnemyBulletManager->passTime( frameSecondsDelta );
-        mEnemyManager->passTime( frameSecondsDelta, viewPosition );
-        mSculptureManager->passTime( frameSecondsDelta );
-        mBossBulletManager->passTime( frameSecondsDelta );
-        mBossDamageManager->passTime( frameSecondsDelta );
-        mBossManager->passTime( frameSecondsDelta, viewPosition,
-                                mCurrentShipVelocityVector );
-        mPortalManager->passTime( frameSecondsDelta, viewPosition );
-
-        // don't add enemies if boss is dead
-        if( ! mBossManager->isBossDead() ) {
-            // replenish enemy force
-            while( mEnemyManager->getEnemyCount() < mNumEnemies ) {
-                addRandomEnemy();
-                }
-            }
-        }
+    addManagerCullCounts();
     
-    int i;
-
-
-
     SimpleVector<DrawableObject *> *shipBulletObjects =
-        mShipBulletManager->getDrawableObjects();
-    int numShipBulletObjects = shipBulletObjects->size();
+        mShipBulletRenderTask->takeResult();
 
     SimpleVector<DrawableObject *> *enemyBulletObjects =
-        mEnemyBulletManager->getDrawableObjects();
-    int numEnemyBulletObjects = enemyBulletObjects->size();
+        mEnemyBulletRenderTask->takeResult();
 
     SimpleVector<DrawableObject *> *enemyObjects =
-        mEnemyManager->getDrawableObjects();
-    int numEnemyObjects = enemyObjects->size();
+        mEnemyRenderTask->takeResult();
 
     SimpleVector<DrawableObject *> *sculptureObjects =
-        mSculptureManager->getDrawableObjects();
-    int numSculptureObjects = sculptureObjects->size();
+        mSculptureRenderTask->takeResult();
 
 
     SimpleVector<DrawableObject *> *bossBulletObjects =
-        mBossBulletManager->getDrawableObjects();
-    int numBossBulletObjects = bossBulletObjects->size();
+        mBossBulletRenderTask->takeResult();
 
     SimpleVector<DrawableObject *> *bossObjects =
-        mBossManager->getDrawableObjects();
-    int numBossObjects = bossObjects->size();
+        mBossRenderTask->takeResult();
 
     // draw boss damage on top of boss
     SimpleVector<DrawableObject *> *bossDamageObjects =
-        mBossDamageManager->getDrawableObjects();
-    int numBossDamageObjects = bossDamageObjects->size();
+        mBossDamageRenderTask->takeResult();
     
     SimpleVector<DrawableObject *> *portalObjects =
-        mPortalManager->getDrawableObjects();
-    int numPortalObjects = portalObjects->size();
+        mPortalRenderTask->takeResult();
 
 
 
@@ -2018,13 +2702,7 @@ void GameSceneHandler::drawScene() {
     Angle3D *zeroAngle = new Angle3D( 0, 0, 0 );
 
     // bottom layer is sculpture
-    for( i=0; i<numSculptureObjects; i++ ) {
-        DrawableObject *component =
-            *( sculptureObjects->getElement( i ) );
-        component->draw( 1, zeroAngle, offsetVector );
-        delete component;
-        }
-    delete sculptureObjects;
+    drawDrawableObjects( sculptureObjects, zeroAngle, offsetVector );
 
 
 
@@ -2086,87 +2764,328 @@ void GameSceneHandler::drawScene() {
 
     
     // next layer is bullets
+    drawDrawableObjects( enemyBulletObjects, zeroAngle, offsetVector );
+    drawDrawableObjects( bossBulletObjects, zeroAngle, offsetVector );
+    drawDrawableObjects( shipBulletObjects, zeroAngle, offsetVector );
 
-    for( i=0; i<numEnemyBulletObjects; i++ ) {
-        DrawableObject *component =
-            *( enemyBulletObjects->getElement( i ) );
-        component->draw( 1, zeroAngle, offsetVector );
-        delete component;
-        }
-    delete enemyBulletObjects;
     
-    for( i=0; i<numBossBulletObjects; i++ ) {
-        DrawableObject *component =
-            *( bossBulletObjects->getElement( i ) );
-        component->draw( 1, zeroAngle, offsetVector );
-        delete component;
-        }
-    delete bossBulletObjects;
+    // then enemies
+    drawDrawableObjects( enemyObjects, zeroAngle, offsetVector );
+    drawDrawableObjects( bossObjects, zeroAngle, offsetVector );
 
+    // then boss damage
+    drawDrawableObjects( bossDamageObjects, zeroAngle, offsetVector );
 
-    for( i=0; i<numShipBulletObjects; i++ ) {
-        DrawableObject *component =
-            *( shipBulletObjects->getElement( i ) );
-        component->draw( 1, zeroAngle, offsetVector );
-        delete component;
-        }
-    delete shipBulletObjects;
+    // finally portal
+    drawDrawableObjects( portalObjects, zeroAngle, offsetVector );
 
-    
-    // then enemies
-    for( i=0; i<numEnemyObjects; i++ ) {
-        DrawableObject *component =
-            *( enemyObjects->getElement( i ) );
-        component->draw( 1, zeroAngle, offsetVector );
-        delete component;
+
+                
+    delete zeroAngle;
+    
+    delete offsetVector;
+
+
+
+
+
+    
+
+    // ship on top of everything
+    Angle3D *viewOrientation = getInterpolatedViewOrientation();
+    
+    updateShipRadius( viewPosition, viewOrientation, true );
+
+    delete viewOrientation;
+    delete viewPosition;
+
+
+    // draw an overlay rectangle if we are fading out
+    if( mFadeLevel < 1 ) {
+
+        glBegin( GL_QUADS );
+            glColor4f( 0, 0, 0, 1 - mFadeLevel );
+
+            glVertex2d( 20 * mMinXPosition, 20 * mMinYPosition );
+            glVertex2d( 20 * mMinXPosition, 20 * mMaxYPosition );
+            glVertex2d( 20 * mMaxXPosition, 20 * mMaxYPosition );
+            glVertex2d( 20 * mMaxXPosition, 20 * mMinYPosition );
+
+        glEnd();
         }
-    delete enemyObjects;
+
+
+    #ifdef FRAME_PROFILER
+        if( mShowProfilerOverlay ) {
+            drawFrameProfilerOverlay();
+            }
+    #endif
+
     
-    for( i=0; i<numBossObjects; i++ ) {
-        DrawableObject *component =
-            *( bossObjects->getElement( i ) );
-        component->draw( 1, zeroAngle, offsetVector );
-        delete component;
+    mNumFrames ++;
+
+    readAudioTelemetry();
+
+    if( mQualityGovernor != NULL ) {
+        mQualityGovernor->addFrameTime(
+            FrameProfiler::getCurrentMicroseconds() -
+            mFrameWorkStartMicroseconds );
+
+        // every drawable object for this frame has been built, so the
+        // settings can change
+        if( mQualityGovernor->endFrame() ) {
+            applyQualityLevels();
+            }
         }
-    delete bossObjects;
+    
+    if( mPrintFrameRate ) {
+        
+        if( mNumFrames % mFrameBatchSize == 0 ) {
+            // finished a batch
+            
+            unsigned long timeDelta =
+                Time::getMillisecondsSince( mFrameBatchStartTimeSeconds,
+                                            mFrameBatchStartTimeMilliseconds );
 
-    // then boss damage
-    for( i=0; i<numBossDamageObjects; i++ ) {
-        DrawableObject *component =
-            *( bossDamageObjects->getElement( i ) );
-        component->draw( 1, zeroAngle, offsetVector );
-        delete component;
+            double frameRate =
+                1000 * (double)mFrameBatchSize / (double)timeDelta;
+            
+            printf( "Frame rate = %f frames/second\n", frameRate );
+
+            printf( "  Objects per frame:  %.1f drawn, %.1f off screen\n",
+                    (double)mNumDrawnInBatch / (double)mFrameBatchSize,
+                    (double)mNumCulledInBatch / (double)mFrameBatchSize );
+            mNumDrawnInBatch = 0;
+            mNumCulledInBatch = 0;
+
+            printAudioTelemetry();
+            mAudioTelemetrySummary->reset();
+
+            if( mQualityGovernor != NULL ) {
+                mQualityGovernor->printSummary();
+                }
+
+            mFrameBatchStartTimeSeconds = mLastFrameSeconds;
+            mFrameBatchStartTimeMilliseconds = mLastFrameMilliseconds;
+            }
         }
-    delete bossDamageObjects;
+        
+    }
 
-    // finally portal
-    for( i=0; i<numPortalObjects; i++ ) {
-        DrawableObject *component =
-            *( portalObjects->getElement( i ) );
-        component->draw( 1, zeroAngle, offsetVector );
-        delete component;
+
+
+void GameSceneHandler::advanceSimulation(
+    unsigned long inFrameMilliseconds ) {
+
+    FRAME_PROFILER_SCOPE( "simulation" );
+
+    mFrameMillisecondDelta = inFrameMilliseconds;
+    
+    if( mReplayRecorder != NULL ) {
+        mReplayRecorder->finishFrame( mFrameMillisecondDelta );
         }
-    delete portalObjects;
 
+    if( mPaused ) {
+        // freeze everything, including the blend between steps
+        return;
+        }
+    
+    mSimulationSecondsOwed += (double)mFrameMillisecondDelta / 1000.0;
 
-                
-    delete zeroAngle;
+    int numSteps = 0;
     
-    delete offsetVector;
+    while( mSimulationSecondsOwed >= mSimulationStepSeconds ) {
 
+        if( numSteps == mMaxSimulationStepsPerFrame ) {
+            // avoid a huge position "jump" if we have a very large delay
+            // during a frame (possibly caused by something going on in
+            // the background)
+            // This will favor a slight visual slow down, but this is better
+            // than a disorienting jump
+            mSimulationSecondsOwed = 0;
+            break;
+            }
+        
+        simulateStep();
+        
+        mSimulationSecondsOwed -= mSimulationStepSeconds;
+        numSteps++;
+        }
+
+    mRenderInterpolation = mSimulationSecondsOwed / mSimulationStepSeconds;
+    }
 
 
 
+void GameSceneHandler::simulateStep() {
 
+    FRAME_PROFILER_SCOPE( "step" );
+    ALLOCATION_PROFILER_TAG( "step" );
     
+    saveInterpolationState();
+
+    double mark = getTimingMark();
+    
+    stepShip( mSimulationStepSeconds );
+    addTimingSample( mShipTiming, &mark );
+
+    Vector3D *viewPosition = getViewPosition();
+    viewPosition->mZ = 0;
+
+    passTimeInManagers( mSimulationStepSeconds, viewPosition );
+
+    delete viewPosition;
+    }
+
+
+
+void GameSceneHandler::saveInterpolationState() {
+    delete mPreviousViewPosition;
+    mPreviousViewPosition = new Vector3D( mViewPosition );
+    delete mPreviousViewOrientation;
+    mPreviousViewOrientation = new Angle3D( mViewOrientation );
+
+    mShipBulletManager->saveInterpolationState();
+    mEnemyBulletManager->saveInterpolationState();
+    mEnemyManager->saveInterpolationState();
+    mSculptureManager->saveInterpolationState();
+    mBossBulletManager->saveInterpolationState();
+    mBossDamageManager->saveInterpolationState();
+    mBossManager->saveInterpolationState();
+    mPortalManager->saveInterpolationState();
+    }
+
+
+
+void GameSceneHandler::setSimulationRate( unsigned long inStepsPerSecond ) {
+    if( inStepsPerSecond < 1 ) {
+        inStepsPerSecond = 1;
+        }
+    
+    mSimulationStepsPerSecond = inStepsPerSecond;
+    mSimulationStepSeconds = 1.0 / (double)mSimulationStepsPerSecond;
+    }
+
+
+
+unsigned long GameSceneHandler::getSimulationRate() {
+    return mSimulationStepsPerSecond;
+    }
+
+
+
+void GameSceneHandler::setNumThreads( int inNumThreads ) {
+    delete mThreadPool;
+    mThreadPool = new WorkStealingThreadPool( inNumThreads );
+    }
+
+
+
+void GameSceneHandler::buildManagerTaskGraph() {
+    mManagerTaskGraph = new FrameTaskGraph();
+
+    ManagerStepParameters *parameters = &mManagerStepParameters;
+    
+    mShipBulletTask = new BulletStepTask( "shipBullets", mShipBulletManager,
+                                          parameters );
+    mEnemyBulletTask = new BulletStepTask( "enemyBullets",
+                                           mEnemyBulletManager,
+                                           parameters );
+    mEnemyTask = new EnemyStepTask( mEnemyManager, parameters );
+    mSculptureTask = new SculptureStepTask( mSculptureManager, parameters );
+    mBossBulletTask = new BulletStepTask( "bossBullets", mBossBulletManager,
+                                          parameters );
+    mBossDamageTask = new BulletStepTask( "bossDamage", mBossDamageManager,
+                                          parameters );
+    mBossTask = new BossStepTask( mBossManager, parameters );
+    mPortalTask = new PortalStepTask( mPortalManager, parameters );
+
+    
+    // enemies check for hits by ship bullets and fire enemy bullets
+    mEnemyTask->addDependency( mShipBulletTask );
+    mEnemyTask->addDependency( mEnemyBulletTask );
+
+    // sculpture checks for hits by the enemy bullets fired above, and
+    // enemies check where the sculpture pieces are
+    // (boss bullets are checked using a snapshot, so the boss bullet
+    //  task can run at the same time)
+    mSculptureTask->addDependency( mEnemyTask );
+
+    // boss checks for hits by ship bullets and fires boss bullets and
+    // boss damage
+    // it waits for the enemies only so that sounds start in order
+    mBossTask->addDependency( mShipBulletTask );
+    mBossTask->addDependency( mBossBulletTask );
+    mBossTask->addDependency( mBossDamageTask );
+    mBossTask->addDependency( mEnemyTask );
+
+    // portal depends on nothing
+
+    
+    mManagerTaskGraph->addTask( mShipBulletTask );
+    mManagerTaskGraph->addTask( mEnemyBulletTask );
+    mManagerTaskGraph->addTask( mEnemyTask );
+    mManagerTaskGraph->addTask( mSculptureTask );
+    mManagerTaskGraph->addTask( mBossBulletTask );
+    mManagerTaskGraph->addTask( mBossDamageTask );
+    mManagerTaskGraph->addTask( mBossTask );
+    mManagerTaskGraph->addTask( mPortalTask );
+    }
+
+
+
+void GameSceneHandler::passTimeInManagers( double inStepSeconds,
+                                           Vector3D *inViewPosition ) {
+
+    FRAME_PROFILER_SCOPE( "managers" );
+    
+    double mark = getTimingMark();
+
+    mManagerStepParameters.mStepSeconds = inStepSeconds;
+    mManagerStepParameters.mShipPosition = inViewPosition;
+    mManagerStepParameters.mShipVelocity = mCurrentShipVelocityVector;
+
+    // sculpture checks boss bullets as they were before this step
+    mBossBulletManager->saveSnapshot();
+    
+    // tell managers about the time delta
+    mManagerTaskGraph->run( mThreadPool );
+    addTimingSample( mManagerGraphTiming, &mark );
+
+    if( mBenchmarkTimings != NULL ) {
+        mShipBulletTiming->addSample( mShipBulletTask->mRunMicroseconds );
+        mEnemyBulletTiming->addSample( mEnemyBulletTask->mRunMicroseconds );
+        mEnemyTiming->addSample( mEnemyTask->mRunMicroseconds );
+        mSculptureTiming->addSample( mSculptureTask->mRunMicroseconds );
+        mBossBulletTiming->addSample( mBossBulletTask->mRunMicroseconds );
+        mBossDamageTiming->addSample( mBossDamageTask->mRunMicroseconds );
+        mBossTiming->addSample( mBossTask->mRunMicroseconds );
+        mPortalTiming->addSample( mPortalTask->mRunMicroseconds );
+        }
+    
+    // don't add enemies if boss is dead
+    // (done after the graph, since it uses our random source)
+    if( ! mBossManager->isBossDead() ) {
+        // replenish enemy force
+        while( mEnemyManager->getEnemyCount() < mNumEnemies ) {
+            addRandomEnemy();
+            }
+        }
+    addTimingSample( mEnemySpawnTiming, &mark );
+    }
+
+
+
+void GameSceneHandler::updateShipRadius( Vector3D *inViewPosition,
+                                         Angle3D *inViewOrientation,
+                                         char inDraw ) {
 
     // map the speed into the range [0,1], with full-speed backward at 0,
     // stationary at 0.5, and full-speed forward at 1
     double shipParameter =
         ( ( mForwardBackwardMoveRate / mMaxMoveRate ) / 2 ) + 0.5;
-    
-    Angle3D *viewOrientation = mScreen->getViewOrientation();
 
+    // every rotated copy, since the ship's radius is measured from them
     double rotationRate;
     SimpleVector<DrawableObject*> *shipObjects =
         mShipParameterSpace->getDrawableObjects( shipParameter,
@@ -2174,26 +3093,29 @@ void GameSceneHandler::drawScene() {
 
     int numComponentObjects = shipObjects->size();
 
-    // compute the half radius of this ship as we draw it
+    // compute the half radius of this ship as we build it
     double minRadius = DBL_MAX;
     double maxRadius = 0;
 
-    // draw ship components
+    // build ship components
     for( int j=0; j<numComponentObjects; j++ ) {
         
         DrawableObject *component =
             *( shipObjects->getElement( j ) );
         
-        component->draw( mShipScale, viewOrientation, viewPosition );
+        if( inDraw ) {
+            component->draw( mShipScale, inViewOrientation,
+                             inViewPosition );
+            }
 
         component->scale( mShipScale );
-        component->rotate( viewOrientation );
-        component->move( viewPosition );
+        component->rotate( inViewOrientation );
+        component->move( inViewPosition );
         
         double componentMinRadius =
-            component->getBorderMinDistance( viewPosition );
+            component->getBorderMinDistance( inViewPosition );
         double componentMaxRadius =
-            component->getBorderMaxDistance( viewPosition );
+            component->getBorderMaxDistance( inViewPosition );
 
         if( componentMinRadius < minRadius ) {
             minRadius = componentMinRadius;
@@ -2208,48 +3130,569 @@ void GameSceneHandler::drawScene() {
     mCurrentShipRadius = ( minRadius + maxRadius ) / 2;
     
     delete shipObjects;
+    }
 
 
-    delete viewPosition;
 
+/**
+ * Destroys a vector of drawable objects along with the objects in it.
+ *
+ * @param inObjects the objects to destroy.
+ */
+static void destroyDrawableObjects(
+    SimpleVector<DrawableObject *> *inObjects ) {
+    int numObjects = inObjects->size();
 
-    // draw an overlay rectangle if we are fading out
-    if( mFadeLevel < 1 ) {
+    for( int i=0; i<numObjects; i++ ) {
+        delete *( inObjects->getElement( i ) );
+        }
+    delete inObjects;
+    }
 
-        glBegin( GL_QUADS );
-            glColor4f( 0, 0, 0, 1 - mFadeLevel );
 
-            glVertex2d( 20 * mMinXPosition, 20 * mMinYPosition );
-            glVertex2d( 20 * mMinXPosition, 20 * mMaxYPosition );
-            glVertex2d( 20 * mMaxXPosition, 20 * mMaxYPosition );
-            glVertex2d( 20 * mMaxXPosition, 20 * mMinYPosition );
 
-        glEnd();
+/**
+ * Moves the objects in one vector to the end of another.
+ *
+ * @param inObjects the objects to move.
+ *   Vector will be destroyed by this call.
+ * @param inDestination the vector to add the objects to.
+ *   Must be destroyed by caller.
+ */
+static void appendDrawableObjects(
+    SimpleVector<DrawableObject *> *inObjects,
+    SimpleVector<DrawableObject *> *inDestination ) {
+    int numObjects = inObjects->size();
+
+    for( int i=0; i<numObjects; i++ ) {
+        inDestination->push_back( *( inObjects->getElement( i ) ) );
         }
+    delete inObjects;
+    }
+
 
 
+void GameSceneHandler::buildRenderTaskGraph() {
+    mRenderTaskGraph = new FrameTaskGraph();
+
+    double *interpolation = &mRenderInterpolation;
+    int *stride = &mRotatedCopyStride;
+
+    mSculptureRenderTask =
+        new ManagerRenderBuildTask<SculptureManager>(
+            "sculptureRender", mSculptureManager, interpolation, stride );
+    mEnemyBulletRenderTask =
+        new ManagerRenderBuildTask<ShipBulletManager>(
+            "enemyBulletRender", mEnemyBulletManager, interpolation, stride );
+    mBossBulletRenderTask =
+        new ManagerRenderBuildTask<ShipBulletManager>(
+            "bossBulletRender", mBossBulletManager, interpolation, stride );
+    mShipBulletRenderTask =
+        new ManagerRenderBuildTask<ShipBulletManager>(
+            "shipBulletRender", mShipBulletManager, interpolation, stride );
+    mEnemyRenderTask =
+        new ManagerRenderBuildTask<EnemyManager>(
+            "enemyRender", mEnemyManager, interpolation, stride );
+    mBossRenderTask =
+        new ManagerRenderBuildTask<BossManager>(
+            "bossRender", mBossManager, interpolation, stride );
+    mBossDamageRenderTask =
+        new ManagerRenderBuildTask<ShipBulletManager>(
+            "bossDamageRender", mBossDamageManager, interpolation, stride );
+    mPortalRenderTask =
+        new ManagerRenderBuildTask<PortalManager>(
+            "portalRender", mPortalManager, interpolation, stride );
+
+    // same order that drawScene draws them in
+    // (the ship is drawn last, but it is built separately as it is drawn)
+    mRenderLayerTasks->push_back( mSculptureRenderTask );
+    mRenderLayerTasks->push_back( mEnemyBulletRenderTask );
+    mRenderLayerTasks->push_back( mBossBulletRenderTask );
+    mRenderLayerTasks->push_back( mShipBulletRenderTask );
+    mRenderLayerTasks->push_back( mEnemyRenderTask );
+    mRenderLayerTasks->push_back( mBossRenderTask );
+    mRenderLayerTasks->push_back( mBossDamageRenderTask );
+    mRenderLayerTasks->push_back( mPortalRenderTask );
+
+    // tasks are independent
+    int numTasks = mRenderLayerTasks->size();
+    for( int i=0; i<numTasks; i++ ) {
+        mRenderTaskGraph->addTask( *( mRenderLayerTasks->getElement( i ) ) );
+        }
+    }
+
+
+
+void GameSceneHandler::buildDrawableObjects() {
+    FRAME_PROFILER_SCOPE( "buildDrawables" );
+    ALLOCATION_PROFILER_TAG( "buildDrawables" );
     
-    mNumFrames ++;
+    mRenderTaskGraph->run( mThreadPool );
+    }
 
-    if( mPrintFrameRate ) {
+
+
+void GameSceneHandler::setManagerViewBounds( ViewBounds *inBounds ) {
+    mSculptureManager->setViewBounds( inBounds );
+    mEnemyBulletManager->setViewBounds( inBounds );
+    mBossBulletManager->setViewBounds( inBounds );
+    mShipBulletManager->setViewBounds( inBounds );
+    mEnemyManager->setViewBounds( inBounds );
+    mBossDamageManager->setViewBounds( inBounds );
+    }
+
+
+
+void GameSceneHandler::addManagerCullCounts() {
+    mNumCulledInBatch +=
+        mSculptureManager->getNumCulled() +
+        mEnemyBulletManager->getNumCulled() +
+        mBossBulletManager->getNumCulled() +
+        mShipBulletManager->getNumCulled() +
+        mEnemyManager->getNumCulled() +
+        mBossDamageManager->getNumCulled();
+
+    mNumDrawnInBatch +=
+        mSculptureManager->getNumDrawn() +
+        mEnemyBulletManager->getNumDrawn() +
+        mBossBulletManager->getNumDrawn() +
+        mShipBulletManager->getNumDrawn() +
+        mEnemyManager->getNumDrawn() +
+        mBossDamageManager->getNumDrawn();
+    }
+
+
+
+SimpleVector<DrawableObject *> *
+GameSceneHandler::takeLayeredDrawableObjects() {
+
+    SimpleVector<DrawableObject *> *objects =
+        new SimpleVector<DrawableObject *>();
+
+    int numTasks = mRenderLayerTasks->size();
+    for( int i=0; i<numTasks; i++ ) {
+        appendDrawableObjects(
+            ( *( mRenderLayerTasks->getElement( i ) ) )->takeResult(),
+            objects );
+        }
+
+    return objects;
+    }
+
+
+
+SimpleVector<DrawableObject *> *
+GameSceneHandler::buildLayeredDrawableObjectsSerially() {
+
+    SimpleVector<DrawableObject *> *objects =
+        new SimpleVector<DrawableObject *>();
+
+    appendDrawableObjects(
+        mSculptureManager->getDrawableObjects(
+            mRenderInterpolation, mRotatedCopyStride ),
+        objects );
+    appendDrawableObjects(
+        mEnemyBulletManager->getDrawableObjects(
+            mRenderInterpolation, mRotatedCopyStride ),
+        objects );
+    appendDrawableObjects(
+        mBossBulletManager->getDrawableObjects(
+            mRenderInterpolation, mRotatedCopyStride ),
+        objects );
+    appendDrawableObjects(
+        mShipBulletManager->getDrawableObjects(
+            mRenderInterpolation, mRotatedCopyStride ),
+        objects );
+    appendDrawableObjects(
+        mEnemyManager->getDrawableObjects(
+            mRenderInterpolation, mRotatedCopyStride ),
+        objects );
+    appendDrawableObjects(
+        mBossManager->getDrawableObjects(
+            mRenderInterpolation, mRotatedCopyStride ),
+        objects );
+    appendDrawableObjects(
+        mBossDamageManager->getDrawableObjects(
+            mRenderInterpolation, mRotatedCopyStride ),
+        objects );
+    appendDrawableObjects(
+        mPortalManager->getDrawableObjects(
+            mRenderInterpolation, mRotatedCopyStride ),
+        objects );
+
+    return objects;
+    }
+
+
+
+void GameSceneHandler::enableRenderBuildCheck() {
+    mCheckRenderBuild = true;
+    }
+
+
+
+unsigned long GameSceneHandler::getNumRenderBuildMismatches() {
+    return mNumRenderBuildMismatches;
+    }
+
+
+
+void GameSceneHandler::stepSimulation( unsigned long inFrameMilliseconds ) {
+
+    double frameMark = getTimingMark();
+    
+    // same order as a windowed frame, where ScreenGL fires redraw
+    // listeners (which run the simulation steps) before calling drawScene
+    advanceSimulation( inFrameMilliseconds );
+
+    double mark = getTimingMark();
+
+    Vector3D *viewPosition = getInterpolatedViewPosition();
+    viewPosition->mZ = 0;
+
+    Angle3D *viewOrientation = getInterpolatedViewOrientation();
+    
+    // build everything the same way that drawScene does
+    buildDrawableObjects();
+    
+    SimpleVector<DrawableObject *> *objects = takeLayeredDrawableObjects();
+
+    updateShipRadius( viewPosition, viewOrientation, false );
+
+    addTimingSample( mRenderBuildTiming, &mark );
+
+
+    if( mCheckRenderBuild ) {
+        SimpleVector<DrawableObject *> *serialObjects =
+            buildLayeredDrawableObjectsSerially();
+
+        char match = ( objects->size() == serialObjects->size() );
+
+        int numObjects = objects->size();
+        for( int i=0; i<numObjects && match; i++ ) {
+            match = ( *( objects->getElement( i ) ) )->isSameAs(
+                *( serialObjects->getElement( i ) ) );
+            }
+
+        if( !match ) {
+            mNumRenderBuildMismatches++;
+            }
         
-        if( mNumFrames % mFrameBatchSize == 0 ) {
-            // finished a batch
-            
-            unsigned long timeDelta =
-                Time::getMillisecondsSince( mFrameBatchStartTimeSeconds,
-                                            mFrameBatchStartTimeMilliseconds );
+        destroyDrawableObjects( serialObjects );
 
-            double frameRate =
-                1000 * (double)mFrameBatchSize / (double)timeDelta;
-            
-            printf( "Frame rate = %f frames/second\n", frameRate );
+        // don't count the check in the audio timing
+        mark = getTimingMark();
+        }
 
-            mFrameBatchStartTimeSeconds = mLastFrameSeconds;
-            mFrameBatchStartTimeMilliseconds = mLastFrameMilliseconds;
+    destroyDrawableObjects( objects );
+    
+    delete viewPosition;
+    delete viewOrientation;
+
+    mNumFrames ++;
+
+
+    // pull the sound for this frame, as the audio device would have,
+    // since music only advances as its samples are pulled
+    mHeadlessSoundFramesOwed +=
+        mSampleRate * (double)inFrameMilliseconds / 1000.0;
+
+    unsigned long numSoundFrames =
+        (unsigned long)( mHeadlessSoundFramesOwed );
+
+    if( numSoundFrames > 0 ) {
+        mHeadlessSoundFramesOwed -= numSoundFrames;
+
+        // to the sound file, if there is one
+        mSoundPlayer->pullSamples( numSoundFrames );
+        }
+
+    readAudioTelemetry();
+
+    addTimingSample( mAudioTiming, &mark );
+
+    addTimingSample( mFrameTiming, &frameMark );
+
+    #ifdef FRAME_PROFILER
+        FrameProfiler::endFrame();
+    #endif
+
+    #ifdef ALLOCATION_PROFILER
+        AllocationProfiler::endFrame();
+    #endif
+    }
+
+
+
+void GameSceneHandler::enableBenchmarkTimings() {
+    if( mBenchmarkTimings != NULL ) {
+        return;
+        }
+
+    mBenchmarkTimings = new SimpleVector<FrameTimingStats *>();
+
+    mShipTiming = new FrameTimingStats( "ship" );
+    mShipBulletTiming = new FrameTimingStats( "shipBullets" );
+    mEnemyBulletTiming = new FrameTimingStats( "enemyBullets" );
+    mEnemyTiming = new FrameTimingStats( "enemies" );
+    mSculptureTiming = new FrameTimingStats( "sculpture" );
+    mBossBulletTiming = new FrameTimingStats( "bossBullets" );
+    mBossDamageTiming = new FrameTimingStats( "bossDamage" );
+    mBossTiming = new FrameTimingStats( "boss" );
+    mPortalTiming = new FrameTimingStats( "portal" );
+    mManagerGraphTiming = new FrameTimingStats( "managerGraph" );
+    mEnemySpawnTiming = new FrameTimingStats( "enemySpawn" );
+    mRenderBuildTiming = new FrameTimingStats( "renderBuild" );
+    mAudioTiming = new FrameTimingStats( "audio" );
+    mFrameTiming = new FrameTimingStats( "wholeFrame" );
+    
+    mBenchmarkTimings->push_back( mShipTiming );
+    mBenchmarkTimings->push_back( mShipBulletTiming );
+    mBenchmarkTimings->push_back( mEnemyBulletTiming );
+    mBenchmarkTimings->push_back( mEnemyTiming );
+    mBenchmarkTimings->push_back( mSculptureTiming );
+    mBenchmarkTimings->push_back( mBossBulletTiming );
+    mBenchmarkTimings->push_back( mBossDamageTiming );
+    mBenchmarkTimings->push_back( mBossTiming );
+    mBenchmarkTimings->push_back( mPortalTiming );
+    mBenchmarkTimings->push_back( mManagerGraphTiming );
+    mBenchmarkTimings->push_back( mEnemySpawnTiming );
+    mBenchmarkTimings->push_back( mRenderBuildTiming );
+    mBenchmarkTimings->push_back( mAudioTiming );
+    mBenchmarkTimings->push_back( mFrameTiming );
+    }
+
+
+
+void GameSceneHandler::printBenchmarkTimings() {
+    if( mBenchmarkTimings == NULL ) {
+        return;
+        }
+
+    FrameTimingStats::printSummaryHeader();
+    
+    int numTimings = mBenchmarkTimings->size();
+    for( int i=0; i<numTimings; i++ ) {
+        ( *( mBenchmarkTimings->getElement( i ) ) )->printSummary();
+        }
+    }
+
+
+
+SimpleVector<FrameTimingStats *> *GameSceneHandler::getBenchmarkTimings() {
+    return mBenchmarkTimings;
+    }
+
+
+
+void GameSceneHandler::setPrintFrameRate( char inPrint ) {
+    mPrintFrameRate = inPrint;
+    }
+
+
+
+void GameSceneHandler::enableQualityGovernor(
+    double inFrameBudgetMilliseconds ) {
+
+    if( mQualityGovernor != NULL ) {
+        delete mQualityGovernor;
+        }
+    
+    mQualityGovernor =
+        new QualityGovernor( 1000 * inFrameBudgetMilliseconds );
+
+    applyQualityLevels();
+    }
+
+
+
+void GameSceneHandler::applyQualityLevels() {
+    mRotatedCopyStride = mQualityGovernor->getRotatedCopyStride();
+
+    mSoundPlayer->setMaxSimultaneousRealtimeSounds(
+        mQualityGovernor->getMaxSimultaneousSounds(
+            mMaxSimultaneousSounds ) );
+    mSoundPlayer->setMaxActiveFilters(
+        mQualityGovernor->getMaxActiveFilters() );
+
+    #ifdef FRAME_PROFILER
+        FrameProfiler::addTraceCounter(
+            "visualQuality", mQualityGovernor->getVisualLevel() );
+        FrameProfiler::addTraceCounter(
+            "audioQuality", mQualityGovernor->getAudioLevel() );
+    #endif
+    }
+
+
+
+void GameSceneHandler::setAudioTelemetryFile( char *inFileName ) {
+    if( mAudioTelemetryFILE != NULL ) {
+        fclose( mAudioTelemetryFILE );
+        }
+
+    mAudioTelemetryFILE = fopen( inFileName, "w" );
+
+    if( mAudioTelemetryFILE == NULL ) {
+        printf( "Failed to open audio telemetry file %s for writing\n",
+                inFileName );
+        return;
+        }
+
+    AudioTelemetry::writeCSVHeader( mAudioTelemetryFILE );
+    }
+
+
+
+void GameSceneHandler::readAudioTelemetry() {
+    AudioTelemetry *telemetry = mSoundPlayer->getTelemetry();
+
+    AudioCallbackRecord record;
+
+    while( telemetry->readRecord( &record ) ) {
+        mAudioTelemetrySummary->addRecord( &record );
+
+        if( mQualityGovernor != NULL ) {
+            mQualityGovernor->addAudioCallback( &record );
+            }
+
+        if( mAudioTelemetryFILE != NULL ) {
+            AudioTelemetry::writeCSVLine( mAudioTelemetryFILE, &record );
+            }
+        }
+
+    #ifdef FRAME_PROFILER
+        AudioProducer *producer = mSoundPlayer->getProducer();
+
+        if( producer != NULL ) {
+            FrameProfiler::addTraceCounter( "audioRingFill",
+                                            producer->getFillFrames() );
+            }
+    #endif
+    }
+
+
+
+void GameSceneHandler::printAudioTelemetry() {
+    mAudioTelemetrySummary->printSummary(
+        mSoundPlayer->getTelemetry()->getNumDropped() );
+
+    AudioProducer *producer = mSoundPlayer->getProducer();
+    
+    if( producer != NULL ) {
+        producer->printSummary();
+        }
+    }
+
+
+
+void GameSceneHandler::measureAudioThroughput( OfflineSoundOutput *inOutput,
+                                               double inSeconds ) {
+    // only count the callbacks made while measuring
+    readAudioTelemetry();
+    mAudioTelemetrySummary->reset();
+
+    unsigned long startBuffers = inOutput->getNumBuffersRendered();
+    double startMicroseconds = inOutput->getRenderMicroseconds();
+
+    unsigned long framesLeft = (unsigned long)( inSeconds * mSampleRate );
+
+    // in pieces, so that the telemetry ring never fills
+    unsigned long piece = 64 * 1024;
+    
+    while( framesLeft > 0 ) {
+        unsigned long numFrames = piece;
+        if( numFrames > framesLeft ) {
+            numFrames = framesLeft;
             }
+
+        inOutput->render( numFrames );
+        readAudioTelemetry();
+
+        framesLeft -= numFrames;
+        }
+
+    unsigned long numBuffers =
+        inOutput->getNumBuffersRendered() - startBuffers;
+    double microseconds =
+        inOutput->getRenderMicroseconds() - startMicroseconds;
+
+    double realtimeFactor = 0;
+    double buffersPerSecond = 0;
+    if( microseconds > 0 ) {
+        realtimeFactor = 1000000 * inSeconds / microseconds;
+        buffersPerSecond = 1000000 * numBuffers / microseconds;
+        }
+
+    printf( "Audio throughput:  %.1f seconds of sound mixed in %.1f ms, "
+            "%.0f buffers/second, %.1fx real time\n",
+            inSeconds, microseconds / 1000,
+            buffersPerSecond, realtimeFactor );
+
+    printAudioTelemetry();
+    }
+
+
+
+void GameSceneHandler::printStateSummary() {
+    char *summary = getStateSummary();
+    
+    printf( "%s\n", summary );
+
+    delete [] summary;
+    }
+
+
+
+char *GameSceneHandler::getStateSummary() {
+    Vector3D *viewPosition = getViewPosition();
+
+    char *summary = new char[200];
+    
+    sprintf( summary,
+             "Level %d, ship at (%f, %f), %d enemies, "
+             "%d sculpture pieces placed",
+             mLevelNumber, viewPosition->mX, viewPosition->mY,
+             mEnemyManager->getEnemyCount(),
+             mSculptureManager->getNumPiecesInSculpture() );
+
+    delete viewPosition;
+
+    return summary;
+    }
+
+
+
+double GameSceneHandler::getTimingMark() {
+    if( mBenchmarkTimings == NULL ) {
+        return 0;
+        }
+    return FrameProfiler::getCurrentMicroseconds();
+    }
+
+
+
+void GameSceneHandler::addTimingSample( FrameTimingStats *inTiming,
+                                        double *inoutMark ) {
+    if( mBenchmarkTimings == NULL ) {
+        return;
         }
+
+    double now = FrameProfiler::getCurrentMicroseconds();
+    
+    inTiming->addSample( now - *inoutMark );
+
+    *inoutMark = now;
+    }
+
+
+
+void GameSceneHandler::recordInputEvent( char inPress, char inSpecial,
+                                         int inKey ) {
+    if( mReplayRecorder != NULL ) {
+        ReplayInputEvent event( inPress, inSpecial, inKey );
         
+        mReplayRecorder->addEvent( &event );
+        }
     }
 
 
@@ -2257,6 +3700,8 @@ void GameSceneHandler::drawScene() {
 void GameSceneHandler::keyPressed(
 	unsigned char inKey, int inX, int inY ) {
 
+    recordInputEvent( true, false, inKey );
+
     if( mPaused ) {
         // ignore all keys except for un-pause and quit
         if( inKey == 'p' || inKey == 'P' ) {
@@ -2283,10 +3728,10 @@ void GameSceneHandler::keyPressed(
 
             // fire a bullet
 
-            Vector3D *viewPosition = mScreen->getViewPosition();
+            Vector3D *viewPosition = getViewPosition();
             viewPosition->mZ = 0;
             
-            Angle3D *viewAngle = new Angle3D( mScreen->getViewOrientation() );
+            Angle3D *viewAngle = new Angle3D( getViewOrientation() );
 
             Vector3D *velocityVector =
                 new Vector3D( 0, mShipBulletBaseVelocity, 0 );
@@ -2312,7 +3757,7 @@ void GameSceneHandler::keyPressed(
     if( inKey == 'd' || inKey == 'D' ) {
 		if( mCurrentPieceCarried != -1 ) {
             // drop the piece and align it to the grid
-            Vector3D *droppedPiecePosition = mScreen->getViewPosition();
+            Vector3D *droppedPiecePosition = getViewPosition();
             double pieceX = droppedPiecePosition->mX;
             double pieceY = droppedPiecePosition->mY;
 
@@ -2338,7 +3783,7 @@ void GameSceneHandler::keyPressed(
             }
         else {
             // try picking up a piece;
-            Vector3D *viewPosition = mScreen->getViewPosition();
+            Vector3D *viewPosition = getViewPosition();
             viewPosition->mZ = 0;
 
             // double ship radius to make piece pick-up easier
@@ -2378,6 +3823,8 @@ void GameSceneHandler::keyPressed(
 void GameSceneHandler::keyReleased(
 	unsigned char inKey, int inX, int inY ) {
 
+    recordInputEvent( false, false, inKey );
+
     // never ignore key releases
     
     if( inKey == 's' || inKey == 'S' ) {
@@ -2405,6 +3852,31 @@ void GameSceneHandler::keyReleased(
 void GameSceneHandler::specialKeyPressed(
 	int inKey, int inX, int inY ) {
 
+    #ifdef FRAME_PROFILER
+        // profiler keys don't affect the game, so they are not recorded
+        if( inKey == GLUT_KEY_F2 ) {
+            mShowProfilerOverlay = !mShowProfilerOverlay;
+
+            if( mShowProfilerOverlay ) {
+                FrameProfiler::setEnabled( true );
+                }
+            return;
+            }
+        else if( inKey == GLUT_KEY_F3 ) {
+            // start or stop a trace
+            if( FrameProfiler::isTracing() ) {
+                FrameProfiler::stopTrace();
+                }
+            else {
+                FrameProfiler::setEnabled( true );
+                FrameProfiler::startTrace( "profileTrace.json" );
+                }
+            return;
+            }
+    #endif
+
+    recordInputEvent( true, true, inKey );
+
     if( mPaused || mShipInPortal ) {
         // ignore keys
         return;
@@ -2432,6 +3904,14 @@ void GameSceneHandler::specialKeyPressed(
 void GameSceneHandler::specialKeyReleased(
 	int inKey, int inX, int inY ) {
 
+    #ifdef FRAME_PROFILER
+        if( inKey == GLUT_KEY_F2 || inKey == GLUT_KEY_F3 ) {
+            return;
+            }
+    #endif
+
+    recordInputEvent( false, true, inKey );
+
     // never ignore key releases
     
     if( inKey == GLUT_KEY_UP ) {
@@ -2453,25 +3933,62 @@ void GameSceneHandler::specialKeyReleased(
 
 void GameSceneHandler::fireRedraw() {
 
-    if( mPaused ) {
-        // ignore redraw event
-        return;
+    #ifdef FRAME_PROFILER
+        // the last frame ended when its drawScene returned
+        FrameProfiler::endFrame();
+    #endif
+
+    #ifdef ALLOCATION_PROFILER
+        AllocationProfiler::endFrame();
+    #endif
+    
+    // how many milliseconds have passed since the last frame
+    unsigned long frameMilliseconds =
+        Time::getMillisecondsSince( mLastFrameSeconds,
+                                    mLastFrameMilliseconds );
+    
+    // lock down to our maximum frame rate
+    unsigned long minFrameTime = (unsigned long)( 1000 / mMaxFrameRate );
+    if( frameMilliseconds < minFrameTime ) {
+        unsigned long timeToSleep = minFrameTime - frameMilliseconds;
+        Thread::staticSleep( timeToSleep );
+
+        // get new frame delta, including sleep time
+        frameMilliseconds =
+            Time::getMillisecondsSince( mLastFrameSeconds,
+                                        mLastFrameMilliseconds );
         }
     
-    double frameSecondsDelta = (double)mFrameMillisecondDelta / 1000.0;
+    // record the time that this frame was drawn
+    Time::getCurrentTime( &mLastFrameSeconds, &mLastFrameMilliseconds );
+
+    mFrameWorkStartMicroseconds = FrameProfiler::getCurrentMicroseconds();
+
+    
+    advanceSimulation( frameMilliseconds );
+
+    // drawScene is called next, after ScreenGL applies its view
+    updateScreenView();
+    }
+
+
+
+void GameSceneHandler::stepShip( double inStepSeconds ) {
+
+    FRAME_PROFILER_SCOPE( "ship" );
+    ALLOCATION_PROFILER_TAG( "ship" );
 
-        
     Vector3D *moveVector = new Vector3D( 0, 0, 0 );
     
     if( mMovingUp ) {
-        mForwardBackwardMoveRate += mShipAccelleration * frameSecondsDelta;
+        mForwardBackwardMoveRate += mShipAccelleration * inStepSeconds;
         if( mForwardBackwardMoveRate > mMaxMoveRate ) {
             mForwardBackwardMoveRate = mMaxMoveRate;
             }
         
         }
     if( mMovingDown ) {
-        mForwardBackwardMoveRate -= mShipAccelleration * frameSecondsDelta;
+        mForwardBackwardMoveRate -= mShipAccelleration * inStepSeconds;
         if( mForwardBackwardMoveRate < -mMaxMoveRate ) {
             mForwardBackwardMoveRate = -mMaxMoveRate;
             }
@@ -2482,14 +3999,14 @@ void GameSceneHandler::fireRedraw() {
 
 
     if( mMovingRight ) {
-        mRightLeftMoveRate += mShipAccelleration * frameSecondsDelta;
+        mRightLeftMoveRate += mShipAccelleration * inStepSeconds;
         if( mRightLeftMoveRate > mMaxMoveRate ) {
             mRightLeftMoveRate = mMaxMoveRate;
             }
         
         }
     if( mMovingLeft ) {
-        mRightLeftMoveRate -= mShipAccelleration * frameSecondsDelta;
+        mRightLeftMoveRate -= mShipAccelleration * inStepSeconds;
         if( mRightLeftMoveRate < -mMaxMoveRate ) {
             mRightLeftMoveRate = -mMaxMoveRate;
             }
@@ -2500,7 +4017,7 @@ void GameSceneHandler::fireRedraw() {
 
     // friction to slow ship down
     if( !mMovingUp && mForwardBackwardMoveRate > 0 ) {
-        mForwardBackwardMoveRate -= mShipFriction * frameSecondsDelta;
+        mForwardBackwardMoveRate -= mShipFriction * inStepSeconds;
 
         if( mForwardBackwardMoveRate < 0 ) {
             mForwardBackwardMoveRate = 0;
@@ -2508,7 +4025,7 @@ void GameSceneHandler::fireRedraw() {
         }
 
     if( !mMovingDown && mForwardBackwardMoveRate < 0 ) {
-        mForwardBackwardMoveRate += mShipFriction * frameSecondsDelta;
+        mForwardBackwardMoveRate += mShipFriction * inStepSeconds;
 
         if( mForwardBackwardMoveRate > 0 ) {
             mForwardBackwardMoveRate = 0;
@@ -2516,7 +4033,7 @@ void GameSceneHandler::fireRedraw() {
         }
 
     if( !mMovingRight && mRightLeftMoveRate > 0 ) {
-        mRightLeftMoveRate -= mShipFriction * frameSecondsDelta;
+        mRightLeftMoveRate -= mShipFriction * inStepSeconds;
 
         if( mRightLeftMoveRate < 0 ) {
             mRightLeftMoveRate = 0;
@@ -2524,7 +4041,7 @@ void GameSceneHandler::fireRedraw() {
         }
 
     if( !mMovingLeft && mRightLeftMoveRate < 0 ) {
-        mRightLeftMoveRate += mShipFriction * frameSecondsDelta;
+        mRightLeftMoveRate += mShipFriction * inStepSeconds;
 
         if( mRightLeftMoveRate > 0 ) {
             mRightLeftMoveRate = 0;
@@ -2532,7 +4049,7 @@ void GameSceneHandler::fireRedraw() {
         }
     
     
-    Vector3D *viewPosition = mScreen->getViewPosition();
+    Vector3D *viewPosition = getViewPosition();
 
     // zoom out at high speeds
     double netMotionRate =
@@ -2547,7 +4064,7 @@ void GameSceneHandler::fireRedraw() {
     // and zoom to way out when we are fading out
     viewPosition->mZ -= 1000 * ( 1 - mFadeLevel ); 
     
-    mScreen->setViewPosition( viewPosition );
+    setViewPosition( viewPosition );
 
     delete viewPosition;
 
@@ -2560,7 +4077,7 @@ void GameSceneHandler::fireRedraw() {
             mRotationRate = mBaseRotationRate;
             }
         // add accelleration
-        mRotationRate += mShipRotationAccelleration * frameSecondsDelta;
+        mRotationRate += mShipRotationAccelleration * inStepSeconds;
         if( mRotationRate > mMaxRotationRate ) {
             mRotationRate = mMaxRotationRate;
             }
@@ -2572,7 +4089,7 @@ void GameSceneHandler::fireRedraw() {
             mRotationRate = -mBaseRotationRate;
             }
         // add accelleration
-        mRotationRate -= mShipRotationAccelleration * frameSecondsDelta;
+        mRotationRate -= mShipRotationAccelleration * inStepSeconds;
         if( mRotationRate < -mMaxRotationRate ) {
             mRotationRate = -mMaxRotationRate;
             }
@@ -2583,15 +4100,15 @@ void GameSceneHandler::fireRedraw() {
         }
 
     Angle3D *rotationDelta =
-        new Angle3D( 0, 0, mRotationRate * frameSecondsDelta );
+        new Angle3D( 0, 0, mRotationRate * inStepSeconds );
 
     if( !mShipInPortal ) {
-        mScreen->rotateView( rotationDelta );
+        rotateView( rotationDelta );
         }
     
     delete rotationDelta;
     
-    Angle3D *rotation = new Angle3D( mScreen->getViewOrientation() );
+    Angle3D *rotation = new Angle3D( getViewOrientation() );
 
 
     moveVector->rotate( rotation );
@@ -2602,11 +4119,11 @@ void GameSceneHandler::fireRedraw() {
     delete mCurrentShipVelocityVector;
     mCurrentShipVelocityVector = new Vector3D( moveVector );
     
-    // must be scaled by how many seconds are in our frame
-    moveVector->scale( frameSecondsDelta );
+    // must be scaled by how many seconds are in our step
+    moveVector->scale( inStepSeconds );
 
     if( !mShipInPortal ) {
-        mScreen->moveView( moveVector );
+        moveView( moveVector );
         }
     
     delete rotation;
@@ -2617,7 +4134,7 @@ void GameSceneHandler::fireRedraw() {
     
     Vector3D *jumpToWrapVector = new Vector3D( 0, 0, 0 );
     
-    Vector3D *currentPosition = mScreen->getViewPosition();
+    Vector3D *currentPosition = getViewPosition();
 
     if( currentPosition->mX > mMaxXPosition ) {
         //jumpToWrapVector->mX = -100;
@@ -2641,12 +4158,12 @@ void GameSceneHandler::fireRedraw() {
         }
 
     if( !mShipInPortal ) {
-        mScreen->moveView( jumpToWrapVector );
+        moveView( jumpToWrapVector );
         }
     delete jumpToWrapVector;
 
     delete currentPosition;
-    currentPosition = mScreen->getViewPosition();
+    currentPosition = getViewPosition();
     currentPosition->mZ = 0;
     
     // test if we have been hit by an enemy bullet    
@@ -2660,15 +4177,15 @@ void GameSceneHandler::fireRedraw() {
 
     // scale bullet powers by time delta to make it framerate independent
     double jarForceIncrease =
-        frameSecondsDelta * enemyBulletPower * mEnemyBulletShipJarPower +
-        frameSecondsDelta * bossBulletPower * mBossBulletShipJarPower;
+        inStepSeconds * enemyBulletPower * mEnemyBulletShipJarPower +
+        inStepSeconds * bossBulletPower * mBossBulletShipJarPower;
 
         
     // increased by being hit by bullets
     mCurrentShipJarForce += jarForceIncrease;
         
     // decayed by friction
-    mCurrentShipJarForce -= mShipAccelleration * frameSecondsDelta;
+    mCurrentShipJarForce -= mShipAccelleration * inStepSeconds;
 
     // never negative
     if( mCurrentShipJarForce < 0 ) {
@@ -2692,8 +4209,8 @@ void GameSceneHandler::fireRedraw() {
 
         //mCurrentShipVelocityVector->add( jarVector );
 
-        // scale by time delta to get actual distance jarred during this frame
-        jarVector->scale( frameSecondsDelta );
+        // scale by time delta to get actual distance jarred during this step
+        jarVector->scale( inStepSeconds );
 
         if( jarVector->getLength() > distanceFromCenter ) {
             // this jar vector will move us past the center
@@ -2706,13 +4223,13 @@ void GameSceneHandler::fireRedraw() {
             moveToCenterVector->subtract( currentPosition );
             
             if( !mShipInPortal ) {
-                mScreen->moveView( moveToCenterVector );
+                moveView( moveToCenterVector );
                 }
             delete moveToCenterVector;
             }
         else {
             if( !mShipInPortal ) {
-                mScreen->moveView( jarVector );
+                moveView( jarVector );
                 }
             }
         }
@@ -2725,7 +4242,7 @@ void GameSceneHandler::fireRedraw() {
 
     
     delete currentPosition;
-    currentPosition = mScreen->getViewPosition();
+    currentPosition = getViewPosition();
     currentPosition->mZ = 0;
 
     
@@ -2761,7 +4278,7 @@ void GameSceneHandler::fireRedraw() {
         
         if( mFadeLevel > 0 ) {
             // fade out more
-            double fadeDelta = frameSecondsDelta / mFadeTime;
+            double fadeDelta = inStepSeconds / mFadeTime;
 
             mFadeLevel -= fadeDelta;
             if( mFadeLevel < 0 ) {
@@ -2787,7 +4304,7 @@ void GameSceneHandler::fireRedraw() {
     // handle fade in
     if( ! mBossManager->isBossDead() && mFadeLevel < 1 ) {
         // fade in more
-        double fadeDelta = frameSecondsDelta / mFadeTime;
+        double fadeDelta = inStepSeconds / mFadeTime;
 
         mFadeLevel += fadeDelta;
         if( mFadeLevel > 1 ) {
@@ -4,13 +4,17 @@
  *
  *  Created by Phil Burk on Mon Mar 18 2002.
  *
+ *  JCR20261019 - Jason Rohrer - fixed CLIP, which clipped everything in
+ *                range to the maximum.  Contiguous float to Int16 and Int32
+ *                conversions use the block converters in pa_lib.c.  Int32
+ *                samples are int, not long, which is 64 bits on some hosts.
  */
 #include <stdio.h>
 
 #include "portaudio.h"
 #include "pa_host.h"
 
-#define CLIP( val, min, max )  { val = ((val) < (min)) ? min : (((val) < (max)) ? (max) : (val)); }
+#define CLIP( val, min, max )  { val = ((val) < (min)) ? min : (((val) > (max)) ? (max) : (val)); }
 
 /*************************************************************************/
 static void PaConvert_Float32_Int16(
@@ -19,6 +23,11 @@ static void PaConvert_Float32_Int16(
     int numSamples )
 {
 	int i;
+    if( sourceStride == 1 && targetStride == 1 )
+    {
+        PaConvert_Float32_Int16_Block( sourceBuffer, targetBuffer, numSamples, 32767.0f, 0, 0 );
+        return;
+    }
 	for( i=0; i<numSamples; i++ )
 	{
         short samp = (short) (*sourceBuffer * (32767.0f));
@@ -35,6 +44,11 @@ static void PaConvert_Float32_Int16_Clip(
     int numSamples )
 {
 	int i;
+    if( sourceStride == 1 && targetStride == 1 )
+    {
+        PaConvert_Float32_Int16_Block( sourceBuffer, targetBuffer, numSamples, 32767.0f, 1, 0 );
+        return;
+    }
 	for( i=0; i<numSamples; i++ )
 	{
         long samp = (long) (*sourceBuffer * (32767.0f));
@@ -52,6 +66,11 @@ static void PaConvert_Float32_Int16_ClipDither(
     int numSamples )
 {
 	int i;
+    if( sourceStride == 1 && targetStride == 1 )
+    {
+        PaConvert_Float32_Int16_Block( sourceBuffer, targetBuffer, numSamples, 32766.0f, 1, 1 );
+        return;
+    }
 	for( i=0; i<numSamples; i++ )
 	{
     // use smaller scaler to prevent overflow when we add the dither
@@ -72,6 +91,11 @@ static void PaConvert_Float32_Int16_Dither(
     int numSamples )
 {
 	int i;
+    if( sourceStride == 1 && targetStride == 1 )
+    {
+        PaConvert_Float32_Int16_Block( sourceBuffer, targetBuffer, numSamples, 32766.0f, 0, 1 );
+        return;
+    }
 	for( i=0; i<numSamples; i++ )
 	{
     // use smaller scaler to prevent overflow when we add the dither
@@ -224,10 +248,15 @@ static void PaConvert_UInt8_Float32(
 /*************************************************************************/
 static void PaConvert_Float32_Int32(
     float *sourceBuffer, int sourceStride,
-    long *targetBuffer, int targetStride,
+    int *targetBuffer, int targetStride,
     int numSamples )
 {
 	int i;
+    if( sourceStride == 1 && targetStride == 1 )
+    {
+        PaConvert_Float32_Int32_Block( sourceBuffer, targetBuffer, numSamples, 0 );
+        return;
+    }
 	for( i=0; i<numSamples; i++ )
 	{
         int samp = (int) (*sourceBuffer * 0x7FFFFFFF);
@@ -240,16 +269,21 @@ static void PaConvert_Float32_Int32(
 /*************************************************************************/
 static void PaConvert_Float32_Int32_Clip(
     float *sourceBuffer, int sourceStride,
-    long *targetBuffer, int targetStride,
+    int *targetBuffer, int targetStride,
     int numSamples )
 {
 	int i;
+    if( sourceStride == 1 && targetStride == 1 )
+    {
+        PaConvert_Float32_Int32_Block( sourceBuffer, targetBuffer, numSamples, 1 );
+        return;
+    }
 	for( i=0; i<numSamples; i++ )
 	{
         int samp;
         float fs = *sourceBuffer;
         CLIP( fs, -1.0f, 0.999999f );
-        samp = (int) (*sourceBuffer * 0x7FFFFFFF);
+        samp = (int) (fs * 0x7FFFFFFF);
         *targetBuffer = samp;
         sourceBuffer += sourceStride;
         targetBuffer += targetStride;
@@ -258,7 +292,7 @@ static void PaConvert_Float32_Int32_Clip(
 
 /*************************************************************************/
 static void PaConvert_Int32_Float32(
-    long *sourceBuffer, int sourceStride,
+    int *sourceBuffer, int sourceStride,
     float *targetBuffer, int targetStride,
     int numSamples )
 {
@@ -113,6 +113,18 @@ typedef struct internalPortAudioStream
     double                    past_AverageTotalCount;
     double                    past_Usage;
     int                       past_IfLastExitValid;
+    /* For measuring callback timing, on hosts that support it. */
+    uint32                    past_NumTimedCallbacks;
+    double                    past_PeriodSum;        /* Microseconds between callbacks. */
+    double                    past_PeriodSquaredSum;
+    double                    past_MaxPeriod;
+    uint32                    past_NumLateCallbacks; /* Took longer than a buffer to run. */
+    uint32                    past_NumUnderruns;     /* Gap longer than all queued buffers. */
+    /* How the callback thread was set up, on hosts that support it. */
+    volatile int              past_IsThreadSetUp;
+    int                       past_ThreadPriority;   /* Real-time priority, or 0. */
+    int                       past_ThreadCPU;        /* Pinned to this CPU, or -1. */
+    uint32                    past_NumLockedBytes;
     /* Format Conversion */
     /* These are setup by PaConversion_Setup() */
     PortAudioConverter       *past_InputConversionProc;
@@ -173,6 +185,27 @@ long Pa_CallConvertInt16( internalPortAudioStream   *past,
 #define PA_DITHER_SCALE  (1.0f / ((1<<PA_DITHER_BITS)-1))
 long PaConvert_TriangularDither( void );
 
+/* Restart the dither sequence from the beginning, for repeatable tests. */
+void PaConvert_ResetDither( void );
+
+/* Convert a contiguous block of float samples to integers, using SSE2 when
+** the CPU has it.  Float samples are multiplied by scale, usually 32767.0f,
+** and have dither added before any clipping.  Samples out of range are
+** only handled well when clipping. */
+void PaConvert_Float32_Int16_Block( float *source, short *target,
+        int numSamples, float scale, int ifClip, int ifDither );
+
+/* Convert to 32 bit integers.  32 bits are never dithered. */
+void PaConvert_Float32_Int32_Block( float *source, int *target,
+        int numSamples, int ifClip );
+
+/* Non-zero if the block converters are using SIMD instructions. */
+int PaConvert_IsSIMDEnabled( void );
+
+/* Turn SIMD conversion off, or back on if the CPU supports it, so that
+** the two can be compared. */
+void PaConvert_SetSIMDEnabled( int ifEnabled );
+
 PaError PaConvert_SetupInput( internalPortAudioStream   *past,
     PaSampleFormat   nativeInputSampleFormat );
 
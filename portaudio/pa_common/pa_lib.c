@@ -34,6 +34,10 @@
 /* Modification History:
  PLB20010422 - apply Mike Berry's changes for CodeWarrior on PC
  PLB20010820 - fix dither and shift for recording PaUInt8 format 
+ JCR20261019 - Jason Rohrer - added Pa_GetStreamTimingInfo()
+ JCR20261019 - Jason Rohrer - added float to integer block converters with
+               SSE2 versions picked at run time, fixed dither on 64 bit hosts
+ JCR20261019 - Jason Rohrer - added Pa_GetStreamThreadInfo()
 */
 
 #include <stdio.h>
@@ -352,6 +356,18 @@ PaError Pa_StartStream( PortAudioStream *stream )
 
     past->past_FrameCount = 0.0;
 
+    past->past_NumTimedCallbacks = 0;
+    past->past_PeriodSum = 0.0;
+    past->past_PeriodSquaredSum = 0.0;
+    past->past_MaxPeriod = 0.0;
+    past->past_NumLateCallbacks = 0;
+    past->past_NumUnderruns = 0;
+
+    past->past_IsThreadSetUp = 0;
+    past->past_ThreadPriority = 0;
+    past->past_ThreadCPU = -1;
+    past->past_NumLockedBytes = 0;
+
     if( past->past_NumInputChannels > 0 )
     {
         result = PaHost_StartInput( past );
@@ -478,6 +494,50 @@ double Pa_GetCPULoad(  PortAudioStream* stream)
     return past->past_Usage;
 }
 
+/*************************************************************************/
+PaError Pa_GetStreamTimingInfo( PortAudioStream* stream, PaTimingInfo *info )
+{
+    internalPortAudioStream   *past;
+    double meanPeriod;
+    double variance;
+    if( stream == NULL ) return paBadStreamPtr;
+    past = (internalPortAudioStream *) stream;
+
+    memset( info, 0, sizeof(PaTimingInfo) );
+    if( past->past_NumTimedCallbacks == 0 ) return paNoError;
+
+    meanPeriod = past->past_PeriodSum / past->past_NumTimedCallbacks;
+    variance = ( past->past_PeriodSquaredSum / past->past_NumTimedCallbacks ) -
+               ( meanPeriod * meanPeriod );
+    if( variance < 0.0 ) variance = 0.0; /* Rounding. */
+
+    info->numCallbacks = past->past_NumTimedCallbacks;
+    info->meanPeriodMsec = meanPeriod * 0.001;
+    info->periodJitterMsec = sqrt( variance ) * 0.001;
+    info->maxPeriodMsec = past->past_MaxPeriod * 0.001;
+    info->numLateCallbacks = past->past_NumLateCallbacks;
+    info->numUnderruns = past->past_NumUnderruns;
+    return paNoError;
+}
+
+/*************************************************************************/
+PaError Pa_GetStreamThreadInfo( PortAudioStream* stream, PaThreadInfo *info )
+{
+    internalPortAudioStream   *past;
+    if( stream == NULL ) return paBadStreamPtr;
+    past = (internalPortAudioStream *) stream;
+
+    memset( info, 0, sizeof(PaThreadInfo) );
+    info->cpu = -1;
+    if( !past->past_IsThreadSetUp ) return paNoError;
+
+    info->isSetUp = 1;
+    info->realTimePriority = past->past_ThreadPriority;
+    info->cpu = past->past_ThreadCPU;
+    info->numLockedBytes = past->past_NumLockedBytes;
+    return paNoError;
+}
+
 /*************************************************************************/
 internalPortAudioStream* PaHost_GetStreamRepresentation( PortAudioStream *stream )
 {
@@ -493,30 +553,307 @@ internalPortAudioStream* PaHost_GetStreamRepresentation( PortAudioStream *stream
 ** Calculate 2 LSB dither signal with a triangular distribution.
 ** Ranged properly for adding to a 32 bit integer prior to >>15.
 ** Range of output is +/- 32767
+**
+** JCR20261019 - The seeds are 32 bits, since on 64 bit hosts unsigned long
+** seeds grew past 32 bits and gave dither values far out of range.  The
+** state is shared with the SSE2 converters below so that both produce the
+** same sequence.
 */
 #define PA_DITHER_BITS   (15)
 #define PA_DITHER_SCALE  (1.0f / ((1<<PA_DITHER_BITS)-1))
+#define PA_DITHER_MULTIPLIER  (196314165u)
+#define PA_DITHER_INCREMENT   (907633515u)
+#define DITHER_SHIFT  ((32 - PA_DITHER_BITS) + 1)
+#define PA_DITHER_SEED1  (22222u)
+#define PA_DITHER_SEED2  (5555555u)
+
+static int gDitherPrevious = 0;
+static unsigned int gDitherSeed1 = PA_DITHER_SEED1;
+static unsigned int gDitherSeed2 = PA_DITHER_SEED2;
+
 long PaConvert_TriangularDither( void )
 {
-    static unsigned long previous = 0;
-    static unsigned long randSeed1 = 22222;
-    static unsigned long randSeed2 = 5555555;
-    long current, highPass;
+    int current, highPass;
     /* Generate two random numbers. */
-    randSeed1 = (randSeed1 * 196314165) + 907633515;
-    randSeed2 = (randSeed2 * 196314165) + 907633515;
+    gDitherSeed1 = (gDitherSeed1 * PA_DITHER_MULTIPLIER) + PA_DITHER_INCREMENT;
+    gDitherSeed2 = (gDitherSeed2 * PA_DITHER_MULTIPLIER) + PA_DITHER_INCREMENT;
     /* Generate triangular distribution about 0.
      * Shift before adding to prevent overflow which would skew the distribution.
      * Also shift an extra bit for the high pass filter. 
      */
-#define DITHER_SHIFT  ((32 - PA_DITHER_BITS) + 1)
-    current = (((long)randSeed1)>>DITHER_SHIFT) + (((long)randSeed2)>>DITHER_SHIFT);
+    current = (((int)gDitherSeed1)>>DITHER_SHIFT) + (((int)gDitherSeed2)>>DITHER_SHIFT);
     /* High pass filter to reduce audibility. */
-    highPass = current - previous;
-    previous = current;
+    highPass = current - gDitherPrevious;
+    gDitherPrevious = current;
     return highPass;
 }
 
+/*************************************************************************/
+void PaConvert_ResetDither( void )
+{
+    gDitherPrevious = 0;
+    gDitherSeed1 = PA_DITHER_SEED1;
+    gDitherSeed2 = PA_DITHER_SEED2;
+}
+
+/*************************************************************************
+** Block converters from float to integer samples.
+** Each has a portable version and, on x86 with GCC or Clang, an SSE2
+** version that is picked at run time if the CPU has SSE2.  Both give
+** identical results, including the dither, for samples in range.
+*/
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__i386__) || defined(__x86_64__)) && \
+    (defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))
+#define PA_CONVERT_SSE2  (1)
+#include <emmintrin.h>
+/* So that the SSE2 versions build without -msse2 on 32 bit x86. */
+#define PA_SSE2_FUNCTION  __attribute__((target("sse2")))
+#else
+#define PA_CONVERT_SSE2  (0)
+#endif
+
+/* -1 until the CPU has been checked */
+static int gConvertSIMDEnabled = -1;
+
+static int PaConvert_CPUHasSSE2( void )
+{
+#if PA_CONVERT_SSE2
+#if defined(__x86_64__)
+    return 1; /* part of every x86-64 CPU */
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports( "sse2" ) != 0;
+#endif
+#else
+    return 0;
+#endif
+}
+
+int PaConvert_IsSIMDEnabled( void )
+{
+    if( gConvertSIMDEnabled < 0 ) gConvertSIMDEnabled = PaConvert_CPUHasSSE2();
+    return gConvertSIMDEnabled;
+}
+
+void PaConvert_SetSIMDEnabled( int ifEnabled )
+{
+    gConvertSIMDEnabled = ifEnabled && PaConvert_CPUHasSSE2();
+}
+
+/*************************************************************************/
+static void PaConvert_Float32_Int16_Portable( float *source, short *target,
+        int numSamples, float scale, int ifClip, int ifDither )
+{
+    int i;
+    for( i=0; i<numSamples; i++ )
+    {
+        float scaled = source[i] * scale;
+        if( ifDither )
+        {
+            float dither  = PaConvert_TriangularDither()*PA_DITHER_SCALE;
+            scaled = scaled + dither;
+        }
+        if( ifClip )
+        {
+            long temp = (long) scaled;
+            target[i] = (short)((temp < -0x8000) ? -0x8000 : ((temp > 0x7FFF) ? 0x7FFF : temp));
+        }
+        else
+        {
+            target[i] = (short) scaled;
+        }
+    }
+}
+
+/*************************************************************************/
+static void PaConvert_Float32_Int32_Portable( float *source, int *target,
+        int numSamples, int ifClip )
+{
+    int i;
+    for( i=0; i<numSamples; i++ )
+    {
+        float fs = source[i];
+        if( ifClip ) fs = (fs < -1.0f) ? -1.0f : ((fs > 0.999999f) ? 0.999999f : fs);
+        target[i] = (int) (fs * 0x7FFFFFFF);
+    }
+}
+
+#if PA_CONVERT_SSE2
+/*************************************************************************
+** SSE2 has no 32 bit low multiply, so multiply even and odd lanes into
+** 64 bit products and gather the low halves.
+*/
+static PA_SSE2_FUNCTION __m128i PaConvert_MultiplyLow32( __m128i a, __m128i b )
+{
+    __m128i even = _mm_mul_epu32( a, b );
+    __m128i odd = _mm_mul_epu32( _mm_srli_epi64( a, 32 ), _mm_srli_epi64( b, 32 ) );
+    return _mm_unpacklo_epi32( _mm_shuffle_epi32( even, _MM_SHUFFLE(0,0,2,0) ),
+                               _mm_shuffle_epi32( odd, _MM_SHUFFLE(0,0,2,0) ) );
+}
+
+/*************************************************************************
+** Runs four steps of the dither generator at once.  Lane i holds the
+** seeds for step i+1, and every lane jumps four steps ahead at a time,
+** so the lanes produce exactly the sequence of PaConvert_TriangularDither.
+*/
+typedef struct PaDitherVector
+{
+    __m128i seed1;
+    __m128i seed2;
+    __m128i jumpMultiplier;
+    __m128i jumpIncrement;
+    __m128i lastCurrent;  /* lane 3 is the previous step's value */
+    __m128i lastSeed1;    /* seeds of the last step taken */
+    __m128i lastSeed2;
+}
+PaDitherVector;
+
+static PA_SSE2_FUNCTION void PaConvert_StartDitherVector( PaDitherVector *dither )
+{
+    unsigned int seeds1[4], seeds2[4];
+    unsigned int seed1 = gDitherSeed1;
+    unsigned int seed2 = gDitherSeed2;
+    unsigned int multiplier = 1;
+    unsigned int increment = 0;
+    int i;
+    for( i=0; i<4; i++ )
+    {
+        seed1 = (seed1 * PA_DITHER_MULTIPLIER) + PA_DITHER_INCREMENT;
+        seed2 = (seed2 * PA_DITHER_MULTIPLIER) + PA_DITHER_INCREMENT;
+        seeds1[i] = seed1;
+        seeds2[i] = seed2;
+        /* compose one more step: x -> M*x + I */
+        increment = (increment * PA_DITHER_MULTIPLIER) + PA_DITHER_INCREMENT;
+        multiplier = multiplier * PA_DITHER_MULTIPLIER;
+    }
+    dither->seed1 = _mm_loadu_si128( (__m128i *) seeds1 );
+    dither->seed2 = _mm_loadu_si128( (__m128i *) seeds2 );
+    dither->jumpMultiplier = _mm_set1_epi32( (int) multiplier );
+    dither->jumpIncrement = _mm_set1_epi32( (int) increment );
+    dither->lastCurrent = _mm_set_epi32( gDitherPrevious, 0, 0, 0 );
+    dither->lastSeed1 = _mm_set_epi32( (int) gDitherSeed1, 0, 0, 0 );
+    dither->lastSeed2 = _mm_set_epi32( (int) gDitherSeed2, 0, 0, 0 );
+}
+
+static PA_SSE2_FUNCTION __m128 PaConvert_NextDitherVector( PaDitherVector *dither )
+{
+    __m128i current = _mm_add_epi32( _mm_srai_epi32( dither->seed1, DITHER_SHIFT ),
+                                     _mm_srai_epi32( dither->seed2, DITHER_SHIFT ) );
+    /* each lane's previous value is in the lane before it */
+    __m128i previous = _mm_or_si128( _mm_slli_si128( current, 4 ),
+                                     _mm_srli_si128( dither->lastCurrent, 12 ) );
+    __m128i highPass = _mm_sub_epi32( current, previous );
+    dither->lastCurrent = current;
+    dither->lastSeed1 = dither->seed1;
+    dither->lastSeed2 = dither->seed2;
+    dither->seed1 = _mm_add_epi32( PaConvert_MultiplyLow32( dither->seed1, dither->jumpMultiplier ),
+                                   dither->jumpIncrement );
+    dither->seed2 = _mm_add_epi32( PaConvert_MultiplyLow32( dither->seed2, dither->jumpMultiplier ),
+                                   dither->jumpIncrement );
+    return _mm_mul_ps( _mm_cvtepi32_ps( highPass ), _mm_set1_ps( PA_DITHER_SCALE ) );
+}
+
+/* Leaves the shared state where the scalar generator would have left it. */
+static PA_SSE2_FUNCTION void PaConvert_FinishDitherVector( PaDitherVector *dither )
+{
+    gDitherPrevious = _mm_cvtsi128_si32( _mm_shuffle_epi32( dither->lastCurrent, 0xFF ) );
+    gDitherSeed1 = (unsigned int) _mm_cvtsi128_si32( _mm_shuffle_epi32( dither->lastSeed1, 0xFF ) );
+    gDitherSeed2 = (unsigned int) _mm_cvtsi128_si32( _mm_shuffle_epi32( dither->lastSeed2, 0xFF ) );
+}
+
+/*************************************************************************/
+static PA_SSE2_FUNCTION void PaConvert_Float32_Int16_SSE2( float *source, short *target,
+        int numSamples, float scale, int ifClip, int ifDither )
+{
+    __m128 scaleVector = _mm_set1_ps( scale );
+    __m128 minVector = _mm_set1_ps( -32768.0f );
+    __m128 maxVector = _mm_set1_ps( 32767.0f );
+    PaDitherVector dither;
+    int numBlocks = numSamples / 8;
+    int i;
+
+    if( numBlocks > 0 && ifDither ) PaConvert_StartDitherVector( &dither );
+
+    for( i=0; i<numBlocks; i++ )
+    {
+        __m128 low = _mm_mul_ps( _mm_loadu_ps( source ), scaleVector );
+        __m128 high = _mm_mul_ps( _mm_loadu_ps( source + 4 ), scaleVector );
+        if( ifDither )
+        {
+            low = _mm_add_ps( low, PaConvert_NextDitherVector( &dither ) );
+            high = _mm_add_ps( high, PaConvert_NextDitherVector( &dither ) );
+        }
+        if( ifClip )
+        {
+            /* Clipping before truncating gives the same result as the
+             * portable version, which truncates and then clips. */
+            low = _mm_min_ps( _mm_max_ps( low, minVector ), maxVector );
+            high = _mm_min_ps( _mm_max_ps( high, minVector ), maxVector );
+        }
+        _mm_storeu_si128( (__m128i *) target,
+                          _mm_packs_epi32( _mm_cvttps_epi32( low ), _mm_cvttps_epi32( high ) ) );
+        source += 8;
+        target += 8;
+    }
+
+    if( numBlocks > 0 && ifDither ) PaConvert_FinishDitherVector( &dither );
+
+    PaConvert_Float32_Int16_Portable( source, target, numSamples - 8 * numBlocks,
+                                      scale, ifClip, ifDither );
+}
+
+/*************************************************************************/
+static PA_SSE2_FUNCTION void PaConvert_Float32_Int32_SSE2( float *source, int *target,
+        int numSamples, int ifClip )
+{
+    __m128 scaleVector = _mm_set1_ps( (float) 0x7FFFFFFF );
+    __m128 minVector = _mm_set1_ps( -1.0f );
+    __m128 maxVector = _mm_set1_ps( 0.999999f );
+    int numBlocks = numSamples / 4;
+    int i;
+
+    for( i=0; i<numBlocks; i++ )
+    {
+        __m128 fs = _mm_loadu_ps( source );
+        if( ifClip ) fs = _mm_min_ps( _mm_max_ps( fs, minVector ), maxVector );
+        _mm_storeu_si128( (__m128i *) target, _mm_cvttps_epi32( _mm_mul_ps( fs, scaleVector ) ) );
+        source += 4;
+        target += 4;
+    }
+
+    PaConvert_Float32_Int32_Portable( source, target, numSamples - 4 * numBlocks, ifClip );
+}
+#endif /* PA_CONVERT_SSE2 */
+
+/*************************************************************************/
+void PaConvert_Float32_Int16_Block( float *source, short *target,
+        int numSamples, float scale, int ifClip, int ifDither )
+{
+#if PA_CONVERT_SSE2
+    if( PaConvert_IsSIMDEnabled() )
+    {
+        PaConvert_Float32_Int16_SSE2( source, target, numSamples, scale, ifClip, ifDither );
+        return;
+    }
+#endif
+    PaConvert_Float32_Int16_Portable( source, target, numSamples, scale, ifClip, ifDither );
+}
+
+/*************************************************************************/
+void PaConvert_Float32_Int32_Block( float *source, int *target,
+        int numSamples, int ifClip )
+{
+#if PA_CONVERT_SSE2
+    if( PaConvert_IsSIMDEnabled() )
+    {
+        PaConvert_Float32_Int32_SSE2( source, target, numSamples, ifClip );
+        return;
+    }
+#endif
+    PaConvert_Float32_Int32_Portable( source, target, numSamples, ifClip );
+}
+
 /*************************************************************************
 ** Called by host code.
 ** Convert input from Int16, call user code, then convert output
@@ -662,32 +999,14 @@ long Pa_CallConvertInt16( internalPortAudioStream   *past,
                 float *outBufPtr = (float *) past->past_OutputBuffer;
                 if( past->past_Flags & paDitherOff )
                 {
-                    if( past->past_Flags & paClipOff ) /* NOTHING */
-                    {
-                        for( i=0; i<samplesPerBuffer; i++ )
-                        {
-                            *nativeOutputBuffer++ = (short) (outBufPtr[i] * (32767.0f));
-                        }
-                    }
-                    else /* CLIP */
-                    {
-                        for( i=0; i<samplesPerBuffer; i++ )
-                        {
-                            temp = (long)(outBufPtr[i] * 32767.0f);
-                            *nativeOutputBuffer++ = (short)((temp < -0x8000) ? -0x8000 : ((temp > 0x7FFF) ? 0x7FFF : temp));
-                        }
-                    }
+                    PaConvert_Float32_Int16_Block( outBufPtr, nativeOutputBuffer, samplesPerBuffer,
+                                                   32767.0f, (past->past_Flags & paClipOff) == 0, 0 );
                 }
                 else
                 {
                     /* If you dither then you have to clip because dithering could push the signal out of range! */
-                    for( i=0; i<samplesPerBuffer; i++ )
-                    {
-                        float dither  = PaConvert_TriangularDither()*PA_DITHER_SCALE;
-                        float dithered = (outBufPtr[i] * (32767.0f)) + dither;
-                        temp = (long) (dithered);
-                        *nativeOutputBuffer++ = (short)((temp < -0x8000) ? -0x8000 : ((temp > 0x7FFF) ? 0x7FFF : temp));
-                    }
+                    PaConvert_Float32_Int16_Block( outBufPtr, nativeOutputBuffer, samplesPerBuffer,
+                                                   32767.0f, 1, 1 );
                 }
                 break;
             }
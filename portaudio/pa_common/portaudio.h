@@ -418,6 +418,56 @@ PaTimestamp Pa_StreamTime( PortAudioStream *stream );
 
 double Pa_GetCPULoad( PortAudioStream* stream );
 
+/*
+ Pa_GetStreamTimingInfo() fills in how regularly the stream's callback has
+ been called since the stream was started, as measured by the host along
+ with the CPU Load.
+ A callback is late if it took longer to run than its buffer takes to play.
+ An underrun is counted when the time between two callbacks is longer than
+ all of the buffers the host had queued, so the device must have run dry.
+ Hosts that do not measure callback timing leave numCallbacks at zero.
+ This function may be called from the application while the stream runs.
+
+*/
+
+typedef struct
+{
+    long numCallbacks;
+    double meanPeriodMsec;     /* Mean time from one callback to the next. */
+    double periodJitterMsec;   /* Standard deviation of that time. */
+    double maxPeriodMsec;
+    long numLateCallbacks;
+    long numUnderruns;
+}
+PaTimingInfo;
+
+PaError Pa_GetStreamTimingInfo( PortAudioStream* stream, PaTimingInfo *info );
+
+/*
+ Pa_GetStreamThreadInfo() fills in how the host set up the thread that runs
+ the stream's callback: whether it got real-time priority, which CPU it was
+ pinned to, and how many bytes of the stream's buffers were locked into
+ memory so that touching them from the callback cannot cause a page fault.
+ On Unix, real-time priority is used if the process is allowed it, either
+ as the superuser or, on Linux, up to RLIMIT_RTPRIO. The thread is pinned
+ to a CPU only if the PA_AUDIO_CPU environment variable names one,
+ e.g. PA_AUDIO_CPU=1
+ Hosts that do not set up their thread leave isSetUp at zero.
+ This function may be called from the application while the stream runs.
+
+*/
+
+typedef struct
+{
+    int isSetUp;            /* Non-zero once the callback thread is set up. */
+    int realTimePriority;   /* Zero if the thread runs at normal priority. */
+    int cpu;                /* -1 if the thread may run on any CPU. */
+    long numLockedBytes;
+}
+PaThreadInfo;
+
+PaError Pa_GetStreamThreadInfo( PortAudioStream* stream, PaThreadInfo *info );
+
 /*
  Pa_GetMinNumBuffers() returns the minimum number of buffers required by
  the current host based on minimum latency.
@@ -0,0 +1,100 @@
+/*
+ * pabench_convert.c
+ * Measure the throughput of the float to integer block converters, with
+ * and without SIMD.  Needs no audio device.
+ *
+ * Author: Jason Rohrer
+ *
+ * This program uses the PortAudio Portable Audio Library.
+ * For more information see: http://www.portaudio.com
+ * Copyright (c) 1999-2000 Ross Bencina and Phil Burk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files
+ * (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * Any person wishing to distribute modifications to the Software is
+ * requested to send the modifications to the original developer so that
+ * they can be incorporated into the canonical version.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR
+ * ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include "portaudio.h"
+#include "pa_host.h"
+#define SAMPLES_PER_BUFFER   (2 * 1024)   /* 1024 stereo frames */
+#define MIN_SECONDS          (0.5)
+#ifndef M_PI
+#define M_PI  (3.14159265)
+#endif
+static float  gSource[SAMPLES_PER_BUFFER];
+static short  gInt16[SAMPLES_PER_BUFFER];
+static int    gInt32[SAMPLES_PER_BUFFER];
+/*******************************************************************/
+/* Convert buffers until MIN_SECONDS pass, and return millions of samples
+** converted per second. */
+static double TimeConverter( int ifInt32, int ifClip, int ifDither )
+{
+    long numBuffers = 0;
+    double seconds;
+    clock_t start = clock();
+    do
+    {
+        int i;
+        for( i=0; i<100; i++ )
+        {
+            if( ifInt32 ) PaConvert_Float32_Int32_Block( gSource, gInt32, SAMPLES_PER_BUFFER, ifClip );
+            else PaConvert_Float32_Int16_Block( gSource, gInt16, SAMPLES_PER_BUFFER, 32767.0f, ifClip, ifDither );
+        }
+        numBuffers += 100;
+        seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    } while( seconds < MIN_SECONDS );
+    return (numBuffers * (double)SAMPLES_PER_BUFFER) / (seconds * 1000000.0);
+}
+/*******************************************************************/
+static void TimeBoth( const char *name, int ifInt32, int ifClip, int ifDither )
+{
+    double portable, simd = 0.0;
+    PaConvert_SetSIMDEnabled( 0 );
+    portable = TimeConverter( ifInt32, ifClip, ifDither );
+    PaConvert_SetSIMDEnabled( 1 );
+    if( PaConvert_IsSIMDEnabled() ) simd = TimeConverter( ifInt32, ifClip, ifDither );
+    printf("%-24s %10.1f %10.1f %8.2fx\n", name, portable, simd,
+           (simd > 0.0) ? (simd / portable) : 0.0 );
+}
+/*******************************************************************/
+int main(void);
+int main(void)
+{
+    int i;
+    for( i=0; i<SAMPLES_PER_BUFFER; i++ )
+    {
+        gSource[i] = (float) (0.8 * sin( i * 0.01 * M_PI ));
+    }
+    PaConvert_SetSIMDEnabled( 1 );
+    printf("Million samples per second, %s SIMD:\n",
+           PaConvert_IsSIMDEnabled() ? "with" : "without" );
+    printf("%-24s %10s %10s %9s\n", "converter", "portable", "SIMD", "speedup" );
+    TimeBoth( "Float32 to Int16", 0, 0, 0 );
+    TimeBoth( "Float32 to Int16 clip", 0, 1, 0 );
+    TimeBoth( "Float32 to Int16 dither", 0, 1, 1 );
+    TimeBoth( "Float32 to Int32", 1, 0, 0 );
+    TimeBoth( "Float32 to Int32 clip", 1, 1, 0 );
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * paqa_convert.c
+ * Self Testing Quality Assurance app for PortAudio
+ * Check that the SIMD float to integer block converters give exactly the
+ * same samples as the portable ones.  Needs no audio device.
+ *
+ * Author: Jason Rohrer
+ *
+ * This program uses the PortAudio Portable Audio Library.
+ * For more information see: http://www.portaudio.com
+ * Copyright (c) 1999-2000 Ross Bencina and Phil Burk
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files
+ * (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * Any person wishing to distribute modifications to the Software is
+ * requested to send the modifications to the original developer so that
+ * they can be incorporated into the canonical version.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR
+ * ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include "portaudio.h"
+#include "pa_host.h"
+/****************************************** Definitions ***********/
+#define MAX_SAMPLES      (4099)
+#define NUM_SMALL_SIZES  (37)
+/****************************************** Globals ***********/
+static int gNumPassed = 0;
+static int gNumFailed = 0;
+static float  gSource[MAX_SAMPLES];
+static short  gPortableInt16[MAX_SAMPLES];
+static short  gSIMDInt16[MAX_SAMPLES];
+static int    gPortableInt32[MAX_SAMPLES];
+static int    gSIMDInt32[MAX_SAMPLES];
+/****************************************** Macros ***********/
+/* Print ERROR if it fails. Tally success or failure. */
+#define HOPEFOR( msg, _exp) \
+    do \
+    { \
+        if ((_exp)) {\
+            gNumPassed++; \
+        } \
+        else { \
+            printf("\nERROR %s\n    - for %s\n", (msg), #_exp ); \
+            gNumFailed++; \
+        } \
+    } while(0)
+/*******************************************************************/
+/* Fill the source with repeatable noise between -range and +range,
+** with full scale and zero samples mixed in. */
+static void FillSource( int numSamples, float range )
+{
+    static unsigned int seed = 12345;
+    int i;
+    for( i=0; i<numSamples; i++ )
+    {
+        seed = (seed * 1664525) + 1013904223;
+        gSource[i] = range * ((seed >> 8) * (2.0f / (1<<24)) - 1.0f);
+    }
+    if( numSamples > 3 )
+    {
+        gSource[0] = 0.0f;
+        gSource[1] = range;
+        gSource[2] = -range;
+    }
+}
+/*******************************************************************/
+/* Convert the same samples with both converters, the SIMD one in uneven
+** pieces to check that the dither carries across calls. */
+static void TestInt16( const char *name, int numSamples, float range,
+                       float scale, int ifClip, int ifDither )
+{
+    int done = 0;
+    int piece = 1;
+    FillSource( numSamples, range );
+
+    PaConvert_SetSIMDEnabled( 0 );
+    PaConvert_ResetDither();
+    PaConvert_Float32_Int16_Block( gSource, gPortableInt16, numSamples, scale, ifClip, ifDither );
+
+    PaConvert_SetSIMDEnabled( 1 );
+    PaConvert_ResetDither();
+    while( done < numSamples )
+    {
+        int count = (piece < numSamples - done) ? piece : (numSamples - done);
+        PaConvert_Float32_Int16_Block( gSource + done, gSIMDInt16 + done, count, scale, ifClip, ifDither );
+        done += count;
+        piece = (piece * 3) + 1;
+    }
+
+    HOPEFOR( name, memcmp( gPortableInt16, gSIMDInt16, numSamples * sizeof(short) ) == 0 );
+}
+/*******************************************************************/
+static void TestInt32( const char *name, int numSamples, float range, int ifClip )
+{
+    FillSource( numSamples, range );
+
+    PaConvert_SetSIMDEnabled( 0 );
+    PaConvert_Float32_Int32_Block( gSource, gPortableInt32, numSamples, ifClip );
+
+    PaConvert_SetSIMDEnabled( 1 );
+    PaConvert_Float32_Int32_Block( gSource, gSIMDInt32, numSamples, ifClip );
+
+    HOPEFOR( name, memcmp( gPortableInt32, gSIMDInt32, numSamples * sizeof(int) ) == 0 );
+}
+/*******************************************************************/
+static void TestSize( int numSamples )
+{
+    /* Without clipping, only samples in range are defined. */
+    TestInt16( "Int16", numSamples, 1.0f, 32767.0f, 0, 0 );
+    TestInt16( "Int16 clip", numSamples, 4.0f, 32767.0f, 1, 0 );
+    TestInt16( "Int16 dither", numSamples, 0.99f, 32766.0f, 0, 1 );
+    TestInt16( "Int16 clip dither", numSamples, 4.0f, 32767.0f, 1, 1 );
+    TestInt16( "Int16 clip dither in range", numSamples, 1.0f, 32766.0f, 1, 1 );
+    TestInt32( "Int32", numSamples, 0.999f, 0 );
+    TestInt32( "Int32 clip", numSamples, 4.0f, 1 );
+}
+/*******************************************************************/
+int main(void);
+int main(void)
+{
+    int i;
+    PaConvert_SetSIMDEnabled( 1 );
+    if( !PaConvert_IsSIMDEnabled() )
+    {
+        printf("No SIMD converters on this CPU, nothing to compare.\n");
+        return 0;
+    }
+    /* Every size up to a few vectors, to cover the leftover samples. */
+    for( i=0; i<=NUM_SMALL_SIZES; i++ ) TestSize( i );
+    TestSize( MAX_SAMPLES );
+    printf("QA Report: %d passed, %d failed.\n", gNumPassed, gNumFailed );
+    return (gNumFailed > 0);
+}
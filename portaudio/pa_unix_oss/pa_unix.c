@@ -79,6 +79,15 @@ Modification History
   
   20030630 - Thomas Richter - eliminated unused variable warnings.
 
+  JCR20261019 - Jason Rohrer - usage calculation also measures the period
+                between callbacks, and counts late callbacks and underruns,
+                for Pa_GetStreamTimingInfo().
+  JCR20261019 - Jason Rohrer - audio thread uses real-time priority up to
+                RLIMIT_RTPRIO when not the superuser, may be pinned to the
+                CPU in PA_AUDIO_CPU, pre-faults its stack and locks its
+                buffers, and reports this through Pa_GetStreamThreadInfo().
+                Watchdog lowers the audio thread rather than the process.
+
 TODO
 O- put semaphore lock around shared data?
 O- handle native formats better
@@ -87,6 +96,12 @@ O- what if input and output of a device capabilities differ (e.g. es1371) ???
 */
 
 
+#ifdef __linux__
+ #ifndef _GNU_SOURCE
+  #define _GNU_SOURCE /* For sched_setaffinity() and CPU_SET(). */
+ #endif
+#endif
+
 #include "pa_unix.h"
 
 typedef void *(*pthread_function_t)(void *);
@@ -99,20 +114,47 @@ static int sDefaultOutputDeviceID = paNoDevice;
 static int sPaHostError = 0;
 
 /********************************* BEGIN CPU UTILIZATION MEASUREMENT ****/
+static long SubtractTime_AminusB( struct timeval *timeA, struct timeval *timeB )
+{
+    long secs = timeA->tv_sec - timeB->tv_sec;
+    long usecs = secs * 1000000;
+    usecs += (timeA->tv_usec - timeB->tv_usec);
+    return usecs;
+}
+
 static void Pa_StartUsageCalculation( internalPortAudioStream   *past )
 {
+    long  usecsPeriod;
+    double queuedBuffers;
+
     PaHostSoundControl *pahsc = (PaHostSoundControl *) past->past_DeviceData;
     if( pahsc == NULL ) return;
     /* Query system timer for usage analysis and to prevent overuse of CPU. */
     gettimeofday( &pahsc->pahsc_EntryTime, NULL );
-}
 
-static long SubtractTime_AminusB( struct timeval *timeA, struct timeval *timeB )
-{
-    long secs = timeA->tv_sec - timeB->tv_sec;
-    long usecs = secs * 1000000;
-    usecs += (timeA->tv_usec - timeB->tv_usec);
-    return usecs;
+    /* Measure the period since the previous callback. */
+    if( pahsc->pahsc_IsLastEntryTimeValid )
+    {
+        usecsPeriod = SubtractTime_AminusB( &pahsc->pahsc_EntryTime,
+                                            &pahsc->pahsc_LastEntryTime );
+
+        past->past_NumTimedCallbacks++;
+        past->past_PeriodSum += usecsPeriod;
+        past->past_PeriodSquaredSum += (double) usecsPeriod * usecsPeriod;
+        if( usecsPeriod > past->past_MaxPeriod ) past->past_MaxPeriod = usecsPeriod;
+
+        /* Each write returns once the device has room for one more buffer,
+         * so the device runs dry if the next write comes later than all
+         * of the buffers it holds can play. */
+        queuedBuffers = past->past_NumUserBuffers;
+        if( queuedBuffers < 1 ) queuedBuffers = 1;
+        if( usecsPeriod * pahsc->pahsc_InverseMicrosPerBuffer > queuedBuffers )
+        {
+            past->past_NumUnderruns++;
+        }
+    }
+    pahsc->pahsc_LastEntryTime = pahsc->pahsc_EntryTime;
+    pahsc->pahsc_IsLastEntryTimeValid = 1;
 }
 
 /******************************************************************************
@@ -140,6 +182,8 @@ static void Pa_EndUsageCalculation( internalPortAudioStream   *past )
         past->past_Usage = (LOWPASS_COEFFICIENT_0 * past->past_Usage) +
                            (LOWPASS_COEFFICIENT_1 * newUsage);
 
+        /* Took longer than the buffer takes to play. */
+        if( newUsage > 1.0 ) past->past_NumLateCallbacks++;
     }
 }
 /****************************************** END CPU UTILIZATION *******/
@@ -378,6 +422,7 @@ PaError PaHost_Init( void )
 #define SCHEDULER_POLICY         SCHED_RR
 #define WATCHDOG_MAX_SECONDS    (3)
 #define WATCHDOG_INTERVAL_USEC  (1000000)
+#define WATCHDOG_PRIORITY_BOOST (4)
 
 static int PaHost_CanaryProc( PaHostSoundControl   *pahsc )
 {
@@ -420,8 +465,8 @@ static PaError PaHost_WatchDogProc( PaHostSoundControl   *pahsc )
 
 /* Run at a priority level above audio thread so we can still run if it hangs. */
 /* Rise more than 1 because of rumored off-by-one scheduler bugs. */
-    schp.sched_priority = pahsc->pahsc_AudioPriority + 4;
-    maxPri = sched_get_priority_max(SCHEDULER_POLICY);
+    schp.sched_priority = pahsc->pahsc_AudioPriority + WATCHDOG_PRIORITY_BOOST;
+    maxPri = pahsc->pahsc_MaxPriority;
     if( schp.sched_priority > maxPri ) schp.sched_priority = maxPri;
 
     if (sched_setscheduler(0, SCHEDULER_POLICY, &schp) != 0)
@@ -567,7 +612,51 @@ error:
 }
 
 /*******************************************************************************************
- * Bump priority of audio thread if running with superuser priveledges.
+ * Get the ID that sched_setscheduler() needs to change just this thread.
+ * On Linux getpid() would change the whole process.
+ */
+static pid_t PaHost_GetThreadID( void )
+{
+#if defined(__linux__) && defined(SYS_gettid)
+    return (pid_t) syscall( SYS_gettid );
+#else
+    return getpid();
+#endif
+}
+
+/*******************************************************************************************
+ * Raise our soft RLIMIT_RTPRIO to the hard limit, which audio users are often
+ * granted in /etc/security/limits.conf, so that real-time priority can be used
+ * without superuser privileges.
+ * Return the highest priority allowed, or -1 if none is.
+ */
+static int PaHost_RaiseRealTimeLimit( void )
+{
+#ifdef RLIMIT_RTPRIO
+    struct rlimit   rlim;
+    int             maxPri = sched_get_priority_max(SCHEDULER_POLICY);
+
+    if( getrlimit( RLIMIT_RTPRIO, &rlim ) != 0 ) return -1;
+
+    if( rlim.rlim_cur != rlim.rlim_max )
+    {
+        rlim_t softLimit = rlim.rlim_cur;
+        rlim.rlim_cur = rlim.rlim_max;
+        if( setrlimit( RLIMIT_RTPRIO, &rlim ) != 0 ) rlim.rlim_cur = softLimit;
+    }
+    DBUG(("PaHost_RaiseRealTimeLimit: RLIMIT_RTPRIO = %ld\n", (long) rlim.rlim_cur ));
+
+    if( rlim.rlim_cur == RLIM_INFINITY || rlim.rlim_cur >= (rlim_t) maxPri ) return maxPri;
+    if( rlim.rlim_cur == 0 ) return -1;
+    return (int) rlim.rlim_cur;
+#else
+    return -1;
+#endif
+}
+
+/*******************************************************************************************
+ * Bump priority of audio thread if running with superuser priveledges,
+ * or within RLIMIT_RTPRIO otherwise.
  * if priority bumped then launch a watchdog.
  */
 static PaError PaHost_BoostPriority( internalPortAudioStream *past )
@@ -575,25 +664,48 @@ static PaError PaHost_BoostPriority( internalPortAudioStream *past )
     PaHostSoundControl  *pahsc;
     PaError              result = paNoError;
     struct sched_param   schp = { 0 };
+    int                  minPri;
+    int                  boosted;
 
     pahsc = (PaHostSoundControl *) past->past_DeviceData;
     if( pahsc == NULL ) return paInternalError;
 
-    pahsc->pahsc_AudioThreadPID = getpid();
-    DBUG(("PaHost_BoostPriority: audio PID = %d\n", pahsc->pahsc_AudioThreadPID ));
+    pahsc->pahsc_AudioThreadPID = PaHost_GetThreadID();
+    DBUG(("PaHost_BoostPriority: audio thread ID = %d\n", pahsc->pahsc_AudioThreadPID ));
 
     /* Choose a priority in the middle of the range. */
-    pahsc->pahsc_AudioPriority = (sched_get_priority_max(SCHEDULER_POLICY) -
-                                  sched_get_priority_min(SCHEDULER_POLICY)) / 2;
+    minPri = sched_get_priority_min(SCHEDULER_POLICY);
+    pahsc->pahsc_MaxPriority = sched_get_priority_max(SCHEDULER_POLICY);
+    pahsc->pahsc_AudioPriority = (pahsc->pahsc_MaxPriority - minPri) / 2;
     schp.sched_priority = pahsc->pahsc_AudioPriority;
 
-    if (sched_setscheduler(0, SCHEDULER_POLICY, &schp) != 0)
+    boosted = (sched_setscheduler(0, SCHEDULER_POLICY, &schp) == 0);
+    if( !boosted )
+    {
+        /* Not the superuser, so stay within our limit, leaving room above for the watchdog. */
+        pahsc->pahsc_MaxPriority = PaHost_RaiseRealTimeLimit();
+        if( pahsc->pahsc_MaxPriority >= minPri )
+        {
+            if( pahsc->pahsc_AudioPriority > pahsc->pahsc_MaxPriority - WATCHDOG_PRIORITY_BOOST )
+            {
+                pahsc->pahsc_AudioPriority = pahsc->pahsc_MaxPriority - WATCHDOG_PRIORITY_BOOST;
+            }
+            if( pahsc->pahsc_AudioPriority < minPri ) pahsc->pahsc_AudioPriority = minPri;
+            schp.sched_priority = pahsc->pahsc_AudioPriority;
+
+            boosted = (sched_setscheduler(0, SCHEDULER_POLICY, &schp) == 0);
+        }
+    }
+
+    if( !boosted )
     {
-        DBUG(("PortAudio: only superuser can use real-time priority.\n"));
+        DBUG(("PortAudio: real-time priority not allowed by RLIMIT_RTPRIO.\n"));
+        past->past_ThreadPriority = 0;
     }
     else
     {
         DBUG(("PortAudio: audio callback priority set to level %d!\n", schp.sched_priority));
+        past->past_ThreadPriority = schp.sched_priority;
         /* We are running at high priority so we should have a watchdog in case audio goes wild. */
         result = PaHost_StartWatchDog( pahsc );
     }
@@ -601,6 +713,116 @@ static PaError PaHost_BoostPriority( internalPortAudioStream *past )
     return result;
 }
 
+/*******************************************************************************************
+ * Pin the calling thread to the CPU named by PA_AUDIO_CPU, if set, so that the
+ * scheduler does not move it and its cache is not shared with busy game threads.
+ * Return the CPU, or -1 if not pinned.
+ */
+#define PA_AUDIO_CPU_ENV_NAME  ("PA_AUDIO_CPU")
+
+static int PaHost_PinToCPU( void )
+{
+    const char *cpuText = getenv( PA_AUDIO_CPU_ENV_NAME );
+    char       *endText;
+    long        cpu;
+
+    if( cpuText == NULL ) return -1;
+
+    cpu = strtol( cpuText, &endText, 10 );
+    if( endText == cpuText || *endText != '\0' || cpu < 0 )
+    {
+        ERR_RPT(("PortAudio: %s = %s is not a CPU number.\n", PA_AUDIO_CPU_ENV_NAME, cpuText ));
+        return -1;
+    }
+
+#if defined(__linux__) && defined(CPU_SET)
+    {
+        cpu_set_t   cpuSet;
+
+        if( cpu >= CPU_SETSIZE )
+        {
+            ERR_RPT(("PortAudio: %s = %ld is too large.\n", PA_AUDIO_CPU_ENV_NAME, cpu ));
+            return -1;
+        }
+
+        CPU_ZERO( &cpuSet );
+        CPU_SET( (int) cpu, &cpuSet );
+        if( sched_setaffinity( 0, sizeof(cpuSet), &cpuSet ) != 0 )
+        {
+            ERR_RPT(("PortAudio: could not pin audio thread to CPU %ld. errno = %d\n", cpu, errno ));
+            return -1;
+        }
+        DBUG(("PortAudio: audio thread pinned to CPU %ld.\n", cpu ));
+        return (int) cpu;
+    }
+#else
+    ERR_RPT(("PortAudio: %s is not supported on this host.\n", PA_AUDIO_CPU_ENV_NAME ));
+    return -1;
+#endif
+}
+
+/*******************************************************************************************
+ * Touch the stack that the callback will use, so that it does not page fault
+ * the first time it calls deeper than before.
+ */
+#define STACK_PREFAULT_BYTES   (64 * 1024)
+#define PREFAULT_STRIDE        (1024)
+
+static void PaHost_PrefaultStack( void )
+{
+    volatile char   stack[STACK_PREFAULT_BYTES];
+    int             i;
+
+    for( i=0; i<STACK_PREFAULT_BYTES; i+=PREFAULT_STRIDE ) stack[i] = 0;
+    (void) stack[0];
+}
+
+/*******************************************************************************************
+ * Fault in a buffer, which must not yet hold data, and lock it into memory.
+ * Return the number of bytes locked.
+ */
+static long PaHost_LockBuffer( void *addr, long numBytes )
+{
+    if( (addr == NULL) || (numBytes <= 0) ) return 0;
+
+    memset( addr, 0, numBytes );
+    if( mlock( addr, numBytes ) != 0 )
+    {
+        DBUG(("PaHost_LockBuffer: mlock failed. errno = %d\n", errno ));
+        return 0;
+    }
+    return numBytes;
+}
+
+/*******************************************************************************************
+ * Lock the native and conversion buffers that the audio thread mixes into.
+ * Return the number of bytes locked.
+ */
+static long PaHost_LockBuffers( internalPortAudioStream *past )
+{
+    PaHostSoundControl  *pahsc = (PaHostSoundControl *) past->past_DeviceData;
+    long                 numBytes = 0;
+
+    numBytes += PaHost_LockBuffer( pahsc->pahsc_NativeInputBuffer, pahsc->pahsc_BytesPerInputBuffer );
+    numBytes += PaHost_LockBuffer( pahsc->pahsc_NativeOutputBuffer, pahsc->pahsc_BytesPerOutputBuffer );
+    numBytes += PaHost_LockBuffer( past->past_InputBuffer, past->past_InputBufferSize );
+    numBytes += PaHost_LockBuffer( past->past_OutputBuffer, past->past_OutputBufferSize );
+    return numBytes;
+}
+
+/*******************************************************************************************/
+static void PaHost_UnlockBuffers( internalPortAudioStream *past )
+{
+    PaHostSoundControl  *pahsc = (PaHostSoundControl *) past->past_DeviceData;
+
+    if( past->past_NumLockedBytes == 0 ) return;
+
+    if( pahsc->pahsc_NativeInputBuffer ) munlock( pahsc->pahsc_NativeInputBuffer, pahsc->pahsc_BytesPerInputBuffer );
+    if( pahsc->pahsc_NativeOutputBuffer ) munlock( pahsc->pahsc_NativeOutputBuffer, pahsc->pahsc_BytesPerOutputBuffer );
+    if( past->past_InputBuffer ) munlock( past->past_InputBuffer, past->past_InputBufferSize );
+    if( past->past_OutputBuffer ) munlock( past->past_OutputBuffer, past->past_OutputBufferSize );
+}
+
 /*******************************************************************************************/
 static PaError Pa_AudioThreadProc( internalPortAudioStream   *past )
 {
@@ -618,6 +840,12 @@ static PaError Pa_AudioThreadProc( internalPortAudioStream   *past )
     result = PaHost_BoostPriority( past );
     if( result < 0 ) goto error;
 
+    /* Keep the callback from waiting on the scheduler or on page faults. */
+    past->past_ThreadCPU = PaHost_PinToCPU();
+    PaHost_PrefaultStack();
+    past->past_NumLockedBytes = PaHost_LockBuffers( past );
+    past->past_IsThreadSetUp = 1;
+
     past->past_IsActive = 1;
     DBUG(("entering thread.\n"));
 
@@ -683,6 +911,7 @@ static PaError Pa_AudioThreadProc( internalPortAudioStream   *past )
 
     past->past_IsActive = 0;
     PaHost_StopWatchDog( pahsc );
+    PaHost_UnlockBuffers( past );
 
 error:
     DBUG(("leaving audio thread.\n"));
@@ -913,6 +1142,9 @@ PaError PaHost_StartEngine( internalPortAudioStream *past )
     past->past_StopNow = 0;
     past->past_IsActive = 1;
 
+    /* The first callback has no period to measure. */
+    pahsc->pahsc_IsLastEntryTimeValid = 0;
+
     /* Use pthread_create() instead of __clone() because:
      *   - pthread_create also works for other UNIX systems like Solaris,
      *   - the Java HotSpot VM crashes in pthread_setcanceltype() when using __clone()
@@ -32,7 +32,10 @@
 
 /* Modification history:
    20020621: pa_unix_oss.c split into pa_unix.c, pa_unix.h, pa_unix_oss.c by
-   Augustus Saunders. See pa_unix.c for previous history. */
+   Augustus Saunders. See pa_unix.c for previous history.
+   JCR20261019: Jason Rohrer - added fields for measuring callback timing.
+   JCR20261019: Jason Rohrer - added fields for the watchdog priority limit,
+   includes for real-time thread setup. */
 
 /*
  PROPOSED - should we add this to "portaudio.h". Problem with 
@@ -65,6 +68,11 @@ PaDriverInfo;
 #include <sched.h>
 #include <pthread.h>
 #include <errno.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#ifdef __linux__
+ #include <sys/syscall.h>
+#endif
 
 #include "portaudio.h"
 #include "pa_host.h"
@@ -105,6 +113,7 @@ typedef struct PaHostSoundControl
     int              pahsc_OutputHandle;
     int              pahsc_InputHandle;
     int              pahsc_AudioPriority;          /* priority of background audio thread */
+    int              pahsc_MaxPriority;            /* highest priority we are allowed to use */
     pthread_t        pahsc_AudioThread;            /* background audio thread */
     int              pahsc_IsAudioThreadValid;     /* Is pahsc_AudioThread valid?*/    pid_t            pahsc_AudioThreadPID;         /* background audio thread */
     pthread_t        pahsc_WatchDogThread;         /* highest priority thread that protects system */
@@ -121,6 +130,9 @@ typedef struct PaHostSoundControl
     /* For measuring CPU utilization. */
     struct timeval   pahsc_EntryTime;
     double           pahsc_InverseMicrosPerBuffer; /* 1/Microseconds of real-time audio per user buffer. */
+    /* For measuring callback timing. */
+    struct timeval   pahsc_LastEntryTime;
+    int              pahsc_IsLastEntryTimeValid;
 
    /* For calculating stream time */
     int              pahsc_LastPosPtr;